@@ -0,0 +1,2 @@
+#include "../../src/Testing/source/BenchmarkLogging.h"
+
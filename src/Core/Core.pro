@@ -39,9 +39,13 @@ HEADERS += source/QtilitiesCore_global.h \
     source/Observer.h \
     source/PointerList.h \
     source/ObserverData.h \
+    source/ParallelExport.h \
     source/AbstractSubjectFilter.h \
+    source/AbstractTreeVisitor.h \
     source/ActivityPolicyFilter.h \
     source/ObjectManager.h \
+    source/ObjectPropertyStore.h \
+    source/ParentObserverIndex.h \
     source/QtilitiesPropertyChangeEvent.h \
     source/ObserverMimeData.h \
     source/IObjectManager.h \
@@ -68,6 +72,7 @@ HEADERS += source/QtilitiesCore_global.h \
     source/IIterator.h \
     source/SubjectIterator.h \
     source/TreeIterator.h \
+    source/TreeTraversal.h \
     source/IExportableObserver.h \
     source/ITask.h \
     source/Task.h \
@@ -84,15 +89,19 @@ SOURCES += source/QtilitiesCoreApplication.cpp \
     source/Observer.cpp \
     source/ActivityPolicyFilter.cpp \
     source/ObjectManager.cpp \
+    source/ObjectPropertyStore.cpp \
+    source/ParentObserverIndex.cpp \
     source/QtilitiesPropertyChangeEvent.cpp \
     source/SubjectTypeFilter.cpp \
     source/ObserverData.cpp \
+    source/ParallelExport.cpp \
     source/ObserverRelationalTable.cpp \
     source/ContextManager.cpp \
     source/ObserverHints.cpp \
     source/SubjectFilterTemplate.cpp \
     source/QtilitiesCategory.cpp \
     source/PointerList.cpp \
+    source/TreeTraversal.cpp \
     source/QtilitiesFileInfo.cpp \
     source/ObserverDotWriter.cpp \
     source/VersionInformation.cpp \
@@ -175,6 +175,97 @@ namespace Qtilities {
                 Q_UNUSED(subject_deleted)
             }
 
+            // --------------------------------
+            // Batch Operations
+            // --------------------------------
+            //! Indicates if this subject filter supports batch attachments and detachments.
+            /*!
+                When all subject filters installed in an observer context support batch operations, Observer::attachSubjects() and
+                Observer::detachSubjects() pass all objects through the batch functions at once: initializeAttachments(), finalizeAttachments(),
+                initializeDetachments() and finalizeDetachments(). In that case all objects are initialized before any of them is finalized,
+                and all successfully initialized attachments are already part of the observer context when finalizeAttachments() is called.
+
+                When one or more installed filters do not support batch operations, each object is passed through the single object functions
+                in turn, thus filters which keep state between initializeAttachment() and finalizeAttachment() should return false here.
+
+                \note By default false is returned by the base class.
+
+                <i>This function was added in %Qtilities v1.5.</i>
+              */
+            virtual bool supportsBatchOperations() const {
+                return false;
+            }
+            //! Initialize the attachment of a batch of new subjects to the filter's observer context.
+            /*!
+                \param objects The objects to be added. The objects are not yet attached to the observer context when this function is called.
+                \param rejectMsg Provides a reject message when the initialization of one or more objects failed.
+                \param import_cycle Indicates if the attachment call was made during an observer import cycle, see initializeAttachment().
+                \returns A list with the initialization result for each object in \p objects.
+
+                \note By default the base class calls initializeAttachment() for each object.
+
+                <i>This function was added in %Qtilities v1.5.</i>
+
+                \sa supportsBatchOperations()
+              */
+            virtual QList<bool> initializeAttachments(const QList<QObject*>& objects, QString* rejectMsg = 0, bool import_cycle = false) {
+                QList<bool> results;
+                for (int i = 0; i < objects.count(); ++i)
+                    results << initializeAttachment(objects.at(i),rejectMsg,import_cycle);
+                return results;
+            }
+            //! Finalize the attachment of a batch of subjects to the filter's observer context.
+            /*!
+                \param objects The objects which were added.
+                \param attachment_successful True if the attachment of \p objects was successful, false otherwise.
+                \param import_cycle Indicates if the attachment call was made during an observer import cycle, see finalizeAttachment().
+
+                \note By default the base class calls finalizeAttachment() for each object.
+
+                <i>This function was added in %Qtilities v1.5.</i>
+
+                \sa supportsBatchOperations()
+              */
+            virtual void finalizeAttachments(const QList<QObject*>& objects, bool attachment_successful, bool import_cycle = false) {
+                for (int i = 0; i < objects.count(); ++i)
+                    finalizeAttachment(objects.at(i),attachment_successful,import_cycle);
+            }
+            //! Initialize the detachment of a batch of subjects from the filter's observer context.
+            /*!
+                \param objects The objects to be detached.
+                \param rejectMsg A reject message when the initialization of one or more objects failed.
+                \param subject_deleted Indicates if the detachment operation is happening because the subjects were deleted.
+                \returns A list with the initialization result for each object in \p objects.
+
+                \note By default the base class calls initializeDetachment() for each object.
+
+                <i>This function was added in %Qtilities v1.5.</i>
+
+                \sa supportsBatchOperations()
+              */
+            virtual QList<bool> initializeDetachments(const QList<QObject*>& objects, QString* rejectMsg = 0, bool subject_deleted = false) {
+                QList<bool> results;
+                for (int i = 0; i < objects.count(); ++i)
+                    results << initializeDetachment(objects.at(i),rejectMsg,subject_deleted);
+                return results;
+            }
+            //! Finalize the detachment of a batch of subjects from the filter's observer context.
+            /*!
+                \param objects The objects to be detached.
+                \param detachment_successful True if the detachment of \p objects was successful, false otherwise.
+                \param subject_deleted Indicates if the detachment operation is happening because the subjects were deleted.
+
+                \note By default the base class calls finalizeDetachment() for each object.
+
+                <i>This function was added in %Qtilities v1.5.</i>
+
+                \sa supportsBatchOperations()
+              */
+            virtual void finalizeDetachments(const QList<QObject*>& objects, bool detachment_successful, bool subject_deleted = false) {
+                for (int i = 0; i < objects.count(); ++i)
+                    finalizeDetachment(objects.at(i),detachment_successful,subject_deleted);
+            }
+
         protected:
             //! Function which should react to QDynamicPropertyChangeEvents on properties which are reserved by the subject filter.
             /*!
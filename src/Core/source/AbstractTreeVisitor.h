@@ -0,0 +1,81 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#ifndef ABSTRACT_TREE_VISITOR_H
+#define ABSTRACT_TREE_VISITOR_H
+
+#include "QtilitiesCore_global.h"
+
+#include <QObject>
+
+namespace Qtilities {
+    namespace Core {
+        class Observer;
+
+        /*!
+          \class AbstractTreeVisitor
+          \brief The AbstractTreeVisitor class is the base class of visitors which visit the items in an Observer tree in parallel.
+
+          Visitors are used with Observer::visitTree(), which divides the tree underneath an observer into parts and visits the parts on a thread pool.
+          Every part is visited by its own partial visitor, created using createPartialVisitor(), thus visit() is never called on the same visitor
+          from more than one thread. When all parts were visited, the results of the partial visitors are combined in the visitor passed to
+          Observer::visitTree() by calling reduce() once for each partial visitor, in the order in which the parts appear in the tree.
+
+          The example below counts the number of items in a tree which has a specific property:
+
+\code
+class PropertyCounter : public AbstractTreeVisitor {
+public:
+    PropertyCounter() : count(0) {}
+    AbstractTreeVisitor* createPartialVisitor() const { return new PropertyCounter; }
+    void visit(QObject* obj, Observer* parent) { Q_UNUSED(parent) if (obj->property("Checked").toBool()) ++count; }
+    void reduce(AbstractTreeVisitor* partial_visitor) { count += static_cast<PropertyCounter*> (partial_visitor)->count; }
+
+    int count;
+};
+
+PropertyCounter counter;
+rootNode->visitTree(&counter);
+qDebug() << counter.count;
+\endcode
+
+          \note visit() is called from threads in the thread pool. Visitors must only read from the objects they visit, or make sure that
+          the objects they change can be changed from other threads.
+
+          <i>This class was added in %Qtilities v1.5.</i>
+          */
+        class QTILIITES_CORE_SHARED_EXPORT AbstractTreeVisitor
+        {
+        public:
+            AbstractTreeVisitor() {}
+            virtual ~AbstractTreeVisitor() {}
+
+            //! Creates a new visitor with an empty result which will visit a part of the tree.
+            /*!
+              Partial visitors are created in the thread calling Observer::visitTree(). They are deleted after they were passed to reduce().
+              */
+            virtual AbstractTreeVisitor* createPartialVisitor() const = 0;
+            //! Visits an item in the tree.
+            /*!
+              \param obj The item.
+              \param parent The observer in which context \p obj was reached. Items which are attached to more than one observer in the tree are visited once in the context of each observer.
+              */
+            virtual void visit(QObject* obj, Observer* parent) = 0;
+            //! Adds the result of a partial visitor to the result of this visitor.
+            /*!
+              Called in the thread calling Observer::visitTree().
+              */
+            virtual void reduce(AbstractTreeVisitor* partial_visitor) = 0;
+        };
+    }
+}
+
+#endif // ABSTRACT_TREE_VISITOR_H
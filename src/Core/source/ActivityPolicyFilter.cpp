@@ -19,6 +19,8 @@
 #include <QVariant>
 #include <QCoreApplication>
 #include <QDomElement>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 using namespace Qtilities::Core::Properties;
 using namespace Qtilities::Core::Constants;
@@ -615,6 +617,83 @@ void Qtilities::Core::ActivityPolicyFilter::finalizeAttachment(QObject* obj, boo
     }
 }
 
+void Qtilities::Core::ActivityPolicyFilter::finalizeAttachments(const QList<QObject*>& objects, bool attachment_successful, bool import_cycle) {
+    if (!attachment_successful || import_cycle || objects.isEmpty())
+        return;
+
+    if (!observer) {
+        LOG_TRACE(QString(tr("Cannot evaluate an attachment in a subject filter without an observer context.")));
+        return;
+    }
+
+    // Ensure that property changes are not handled by the QDynamicPropertyChangeEvent handler.
+    filter_mutex.tryLock();
+
+    // All objects in the batch are already attached at this stage. Determine the activity of each new subject
+    // so that the end result is the same as when the objects were attached one after the other.
+    int previous_subject_count = observer->subjectCount() - objects.count();
+    bool unique_new_active = (d->new_subject_activity_policy == ActivityPolicyFilter::SetNewActive &&
+                              d->activity_policy == ActivityPolicyFilter::UniqueActivity && d->enforce_activity_policy);
+    if (unique_new_active) {
+        for (int i = 0; i < previous_subject_count; ++i)
+            observer->setMultiContextPropertyValue(observer->subjectAt(i),qti_prop_ACTIVITY_MAP,QVariant(false));
+    }
+
+    bool any_new_active = false;
+    bool current_subject_event_filter = observer->subjectEventFilteringEnabled();
+    observer->toggleSubjectEventFiltering(false);
+    for (int i = 0; i < objects.count(); ++i) {
+        QObject* obj = objects.at(i);
+        bool new_activity = false;
+        if (unique_new_active)
+            new_activity = (i == objects.count() - 1);
+        else if (previous_subject_count + i == 0)
+            new_activity = (d->minimum_activity_policy == ActivityPolicyFilter::ProhibitNoneActive || d->new_subject_activity_policy == ActivityPolicyFilter::SetNewActive);
+        else
+            new_activity = (d->new_subject_activity_policy == ActivityPolicyFilter::SetNewActive);
+
+        MultiContextProperty subject_activity_property = ObjectManager::getMultiContextProperty(obj,qti_prop_ACTIVITY_MAP);
+        if (subject_activity_property.isValid()) {
+            // Thus, the property already exists
+            subject_activity_property.addContext(new_activity,observer->observerID());
+            ObjectManager::setMultiContextProperty(obj,subject_activity_property);
+        } else {
+            // We need to create the property and add it to the object
+            MultiContextProperty new_subject_activity_property(qti_prop_ACTIVITY_MAP);
+            new_subject_activity_property.setIsExportable(true);
+            new_subject_activity_property.addContext(new_activity,observer->observerID());
+            ObjectManager::setMultiContextProperty(obj,new_subject_activity_property);
+        }
+
+        // When tracking parent activity, we need to listen to activity changes on the subjects
+        // in order to make parent partially checked if needed to:
+        if (d->parent_tracking_policy == ActivityPolicyFilter::ParentFollowActivity)
+            obj->installEventFilter(this);
+
+        if (new_activity) {
+            any_new_active = true;
+            if (obj->thread() == thread() && observer->qtilitiesPropertyChangeEventsEnabled()) {
+                QByteArray property_name_byte_array = QByteArray(qti_prop_ACTIVITY_MAP);
+                QtilitiesPropertyChangeEvent* user_event = new QtilitiesPropertyChangeEvent(property_name_byte_array,observer->observerID());
+                QCoreApplication::postEvent(obj,user_event);
+            }
+        }
+    }
+    observer->toggleSubjectEventFiltering(current_subject_event_filter);
+
+    if (any_new_active) {
+        if (!observer->isProcessingCycleActive()) {
+            emit monitoredPropertyChanged(qti_prop_ACTIVITY_MAP,observer->subjectReferences());
+            emit activeSubjectsChanged(activeSubjects(),inactiveSubjects());
+            setModificationState(true);
+        } else {
+            setModificationState(true,IModificationNotifier::NotifyNone);
+        }
+    }
+
+    filter_mutex.unlock();
+}
+
 void Qtilities::Core::ActivityPolicyFilter::finalizeDetachment(QObject* obj, bool detachment_successful, bool subject_deleted) {
     #ifndef QT_NO_DEBUG
         Q_ASSERT(observer != 0);
@@ -759,6 +838,7 @@ Qtilities::Core::Interfaces::IExportable::ExportModeFlags Qtilities::Core::Activ
     IExportable::ExportModeFlags flags = 0;
     flags |= IExportable::Binary;
     flags |= IExportable::XML;
+    flags |= IExportable::XMLStream;
     return flags;
 }
 
@@ -839,6 +919,47 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Act
     return IExportable::Complete;
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::ActivityPolicyFilter::exportXmlStream(QXmlStreamWriter& writer) const {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    writer.writeAttribute("ActivityPolicy",activityPolicyToString(d->activity_policy));
+    writer.writeAttribute("MinimumActivityPolicy",minimumActivityPolicyToString(d->minimum_activity_policy));
+    writer.writeAttribute("NewSubjectActivityPolicy",newSubjectActivityPolicyToString(d->new_subject_activity_policy));
+    writer.writeAttribute("ParentTrackingPolicy",parentTrackingPolicyToString(d->parent_tracking_policy));
+    if (!filter_is_modification_state_monitored)
+        writer.writeAttribute("IsModificationStateMonitored","false");
+    return IExportable::Complete;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::ActivityPolicyFilter::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    Q_UNUSED(import_list)
+
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesImportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    QXmlStreamAttributes attributes = reader.attributes();
+    if (attributes.hasAttribute("ActivityPolicy"))
+        d->activity_policy = stringToActivityPolicy(attributes.value("ActivityPolicy").toString());
+    if (attributes.hasAttribute("MinimumActivityPolicy"))
+        d->minimum_activity_policy = stringToMinimumActivityPolicy(attributes.value("MinimumActivityPolicy").toString());
+    if (attributes.hasAttribute("NewSubjectActivityPolicy"))
+        d->new_subject_activity_policy = stringToNewSubjectActivityPolicy(attributes.value("NewSubjectActivityPolicy").toString());
+    if (attributes.hasAttribute("ParentTrackingPolicy"))
+        d->parent_tracking_policy = stringToParentTrackingPolicy(attributes.value("ParentTrackingPolicy").toString());
+    if (attributes.hasAttribute("IsModificationStateMonitored")) {
+        if (attributes.value("IsModificationStateMonitored") == QLatin1String("true"))
+            filter_is_modification_state_monitored = true;
+        else
+            filter_is_modification_state_monitored = false;
+    }
+    reader.skipCurrentElement();
+
+    return IExportable::Complete;
+}
+
 bool Qtilities::Core::ActivityPolicyFilter::eventFilter(QObject *object, QEvent *event) {
     if (!observer)
         return false;
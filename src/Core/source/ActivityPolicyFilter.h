@@ -232,6 +232,8 @@ ActivityPolicyFilter* activity_filter = tree_node->enableActivityControl(Observe
             bool initializeAttachment(QObject* obj, QString* rejectMsg = 0, bool import_cycle = false);
             void finalizeAttachment(QObject* obj, bool attachment_successful, bool import_cycle = false);
             void finalizeDetachment(QObject* obj, bool detachment_successful, bool subject_deleted = false);
+            bool supportsBatchOperations() const { return true; }
+            void finalizeAttachments(const QList<QObject*>& objects, bool attachment_successful, bool import_cycle = false);
             QString filterName() const { return qti_def_FACTORY_TAG_ACTIVITY_FILTER; }
             QStringList monitoredProperties() const;
         protected:
@@ -247,6 +249,8 @@ ActivityPolicyFilter* activity_filter = tree_node->enableActivityControl(Observe
             IExportable::ExportResultFlags importBinary(QDataStream& stream, QList<QPointer<QObject> >& import_list);
             IExportable::ExportResultFlags exportXml(QDomDocument* doc, QDomElement* object_node) const;
             IExportable::ExportResultFlags importXml(QDomDocument* doc, QDomElement* object_node, QList<QPointer<QObject> >& import_list);
+            IExportable::ExportResultFlags exportXmlStream(QXmlStreamWriter& writer) const;
+            IExportable::ExportResultFlags importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list);
 
             // --------------------------------
             // IObjectBase Implementation
@@ -13,6 +13,8 @@
 #include "QtilitiesCoreApplication.h"
 
 #include <QDomElement>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 Qtilities::Core::Interfaces::IExportable::IExportable() {
     d_export_version = Qtilities::Qtilities_Latest;
@@ -80,6 +82,76 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Int
     return IExportable::Complete;
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Interfaces::IExportable::exportXmlStream(QXmlStreamWriter& writer) const {
+    QDomDocument doc;
+    QDomElement object_node = doc.createElement("Object");
+    doc.appendChild(object_node);
+
+    ExportResultFlags result = exportXml(&doc,&object_node);
+    if (!(result & IExportable::FailedResult))
+        writeXmlStreamContent(writer,object_node);
+    return result;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Interfaces::IExportable::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    QDomDocument doc;
+    QDomElement object_node = readXmlStreamElement(reader,&doc);
+    if (reader.hasError())
+        return IExportable::Failed;
+    doc.appendChild(object_node);
+
+    return importXml(&doc,&object_node,import_list);
+}
+
+void Qtilities::Core::Interfaces::IExportable::writeXmlStreamContent(QXmlStreamWriter& writer, const QDomElement& element) {
+    QDomNamedNodeMap attributes = element.attributes();
+    for (int i = 0; i < attributes.count(); ++i) {
+        QDomAttr attribute = attributes.item(i).toAttr();
+        writer.writeAttribute(attribute.name(),attribute.value());
+    }
+
+    for (QDomNode child = element.firstChild(); !child.isNull(); child = child.nextSibling()) {
+        // CDATA sections are also text nodes, thus they are checked first:
+        if (child.isElement())
+            writeXmlStreamElement(writer,child.toElement());
+        else if (child.isCDATASection())
+            writer.writeCDATA(child.toCDATASection().data());
+        else if (child.isText())
+            writer.writeCharacters(child.toText().data());
+        else if (child.isComment())
+            writer.writeComment(child.toComment().data());
+    }
+}
+
+void Qtilities::Core::Interfaces::IExportable::writeXmlStreamElement(QXmlStreamWriter& writer, const QDomElement& element) {
+    writer.writeStartElement(element.tagName());
+    writeXmlStreamContent(writer,element);
+    writer.writeEndElement();
+}
+
+QDomElement Qtilities::Core::Interfaces::IExportable::readXmlStreamElement(QXmlStreamReader& reader, QDomDocument* doc) {
+    QDomElement element = doc->createElement(reader.name().toString());
+    QXmlStreamAttributes attributes = reader.attributes();
+    for (int i = 0; i < attributes.count(); ++i)
+        element.setAttribute(attributes.at(i).name().toString(),attributes.at(i).value().toString());
+
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (reader.isStartElement())
+            element.appendChild(readXmlStreamElement(reader,doc));
+        else if (reader.isEndElement())
+            break;
+        else if (reader.isCDATA())
+            element.appendChild(doc->createCDATASection(reader.text().toString()));
+        else if (reader.isCharacters() && !reader.isWhitespace())
+            element.appendChild(doc->createTextNode(reader.text().toString()));
+        else if (reader.isComment())
+            element.appendChild(doc->createComment(reader.text().toString()));
+    }
+
+    return element;
+}
+
 void Qtilities::Core::Interfaces::IExportable::setApplicationExportVersion(quint32 version) {
     d_application_export_version_set = true;
     d_export_application_version = version;
@@ -192,6 +264,8 @@ QString Qtilities::Core::Interfaces::IExportable::exportModeToString(ExportMode
         return "Binary";
     } else if (export_mode == XML) {
         return "XML";
+    } else if (export_mode == XMLStream) {
+        return "XMLStream";
     }
 
     return QString();
@@ -204,6 +278,8 @@ Qtilities::Core::Interfaces::IExportable::ExportMode Qtilities::Core::Interfaces
         return Binary;
     } else if (export_mode_string == QLatin1String("XML")) {
         return XML;
+    } else if (export_mode_string == QLatin1String("XMLStream")) {
+        return XMLStream;
     }
 
     Q_ASSERT(0);
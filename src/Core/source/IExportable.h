@@ -26,6 +26,8 @@
 
 class QDomDocument;
 class QDomElement;
+class QXmlStreamReader;
+class QXmlStreamWriter;
 
 namespace Qtilities {
     namespace Core {
@@ -37,9 +39,10 @@ namespace Qtilities {
             \class IExportable
             \brief Objects can implement this interface if they are able to export and reconstruct themselves.
 
-            IExportable is an interface used throughout %Qtilities by classes in order to stream their data. At present two export options are supported:
+            IExportable is an interface used throughout %Qtilities by classes in order to stream their data. At present three export options are supported:
             - Serialized binary streaming
             - QDomDocument construction
+            - XML streaming using QXmlStreamWriter and QXmlStreamReader
 
             Any object that implements this interface can specify which of the above export formats it supports through the supportedFormats() function. The interface also allows you to provide the needed information about reconstructing your object through the instanceFactoryInfo() function. In short, this allows your object to specify the factory that should be used to reconstruct it as well as the factory tag to use in that factory. For a detailed overview of the factory architecture used in %Qtilities, please refer to \ref page_factories.
 
@@ -59,6 +62,18 @@ namespace Qtilities {
 
             See the \ref iexportable_comparison section of this page for a comparison between Binary and XML exports.
 
+            \section iexportable_xml_stream XML Streaming
+
+            Building a QDomDocument requires the complete document to be in memory, which becomes a problem for very large documents such as big projects.
+            The exportXmlStream() and importXmlStream() functions write and read the same XML format as exportXml() and importXml(), using a QXmlStreamWriter
+            and QXmlStreamReader instead. Thus only the part of the document which is being written or read is kept in memory. Because attributes must be written
+            before child elements on a stream, the order of elements can differ from documents created using exportXml(), however documents created using either approach
+            can be read by both importXml() and importXmlStream().
+
+            The default implementations of these functions construct a small QDomDocument for the object and call exportXml() or importXml(), thus all exportable objects
+            can be streamed. Classes which implement the streaming functions directly indicate it by adding IExportable::XMLStream to their supportedFormats(). Callers
+            can use this to decide if streaming is worth it, for example Qtilities::ProjectManagement::Project only streams projects when all its project items support it.
+
             \section iexportable_comparison Binary vs. XML Exports
 
             Both binary and XML imports have their advantages and disadvantages and when using %Qtilities projects, observers or export functions on the object manager, additional advantages and disadvantages applies.
@@ -275,7 +290,8 @@ int main(int argc, char *argv[])
                 enum ExportMode {
                     None = 0,      /*!< Does not support any export modes. */
                     Binary = 1,    /*!< Binary exporting using QDataStream. \sa exportBinary(), importBinary() */
-                    XML = 2        /*!< XML exporting using QDomDocument. \sa exportXml(), importXml() */
+                    XML = 2,       /*!< XML exporting using QDomDocument. \sa exportXml(), importXml() */
+                    XMLStream = 4  /*!< XML exporting using QXmlStreamWriter and QXmlStreamReader, implemented directly instead of through a QDomDocument. \sa exportXmlStream(), importXmlStream() */
                 };
                 Q_DECLARE_FLAGS(ExportModeFlags, ExportMode)
                 Q_FLAGS(ExportModeFlags)
@@ -444,6 +460,24 @@ TreeNode* duplicated_node = IExportable::duplicateInstance<TreeNode>(&node);
                     return d_is_exportable;
                 }
 
+                //----------------------------
+                // Concurrent Exporting
+                //----------------------------
+                //! Indicates if this object can be exported in a thread other than the thread in which it lives.
+                /*!
+                  When true, exportBinary() can be called from a thread in a thread pool while other objects are exported in other threads.
+                  This is used by Qtilities::Core::ParallelExport, for example to export project items and large subtrees of observers in
+                  parallel. Objects are not changed while they are exported, but implementations must not access objects which can only be
+                  used in the GUI thread, such as widgets. Objects exported in other threads do not have an exportTask().
+
+                  False by default.
+
+                  <i>This function was added in %Qtilities v1.5.</i>
+                  */
+                virtual bool supportsConcurrentExport() const {
+                    return false;
+                }
+
                 //----------------------------
                 // Binary Exporting
                 //----------------------------
@@ -495,6 +529,58 @@ TreeNode* duplicated_node = IExportable::duplicateInstance<TreeNode>(&node);
                   */
                 virtual ExportResultFlags importXml(QDomDocument* doc, QDomElement* object_node, QList<QPointer<QObject> >& import_list);
 
+                //----------------------------
+                // XML Streaming
+                //----------------------------
+                //! Allows exporting to an XML stream, producing the same XML format as exportXml().
+                /*!
+                    The start element which represents the object was written to \p writer by the caller, which might also have written some attributes on it. Implementations
+                    first write their own attributes on the element, followed by any child elements. The element must not be closed by the implementation, and callers only
+                    add child elements of their own to it after this function returns.
+
+                    The default implementation exports the object using exportXml() to a temporary QDomDocument and writes the result to \p writer. Implementations
+                    which override this function should add IExportable::XMLStream to their supportedFormats().
+
+                    See \ref iexportable_xml_stream for more information.
+
+                    <i>This function was added in %Qtilities v1.5.</i>
+                  */
+                virtual ExportResultFlags exportXmlStream(QXmlStreamWriter& writer) const;
+                //! Allows importing and reconstruction of data from an XML stream, reading the XML produced by exportXmlStream() or exportXml().
+                /*!
+                    When called, \p reader is positioned at the start element which represents the object. Implementations read its attributes and its child elements,
+                    skipping child elements they do not know, up to and including the end element of the object.
+
+                    The default implementation reads the element into a temporary QDomDocument and imports the object from it using importXml().
+
+                    See \ref iexportable_xml_stream for more information.
+
+                    <i>This function was added in %Qtilities v1.5.</i>
+                  */
+                virtual ExportResultFlags importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list);
+
+                //! Writes the attributes and child nodes of a QDomElement to the element which is currently open on an XML stream.
+                /*!
+                  This allows parts of an export which are only available through a QDomDocument to be added to an XML stream.
+
+                  <i>This function was added in %Qtilities v1.5.</i>
+                  */
+                static void writeXmlStreamContent(QXmlStreamWriter& writer, const QDomElement& element);
+                //! Writes a QDomElement, with its attributes and child nodes, to an XML stream.
+                /*!
+                  <i>This function was added in %Qtilities v1.5.</i>
+                  */
+                static void writeXmlStreamElement(QXmlStreamWriter& writer, const QDomElement& element);
+                //! Reads the element at which an XML stream is positioned into a QDomElement.
+                /*!
+                  \param reader The reader, positioned at the start element of the element to read. When the function returns, it is positioned at the end element.
+                  \param doc The document used to create the element and its child nodes. The element is not added to the document.
+                  \returns The element read from the stream.
+
+                  <i>This function was added in %Qtilities v1.5.</i>
+                  */
+                static QDomElement readXmlStreamElement(QXmlStreamReader& reader, QDomDocument* doc);
+
                 //----------------------------
                 // Enum <-> String Functions
                 //----------------------------
@@ -43,6 +43,29 @@ namespace Qtilities {
                     Q_UNUSED(object_node)
                     Q_UNUSED(export_flags)
 
+                    return IExportable::Complete;
+                }
+                //! Extended XML stream export function.
+                /*!
+                  <i>This function was added in %Qtilities v1.5.</i>
+                  */
+                virtual IExportable::ExportResultFlags exportXmlStreamExt(QXmlStreamWriter& writer, ObserverData::ExportItemFlags export_flags = ObserverData::ExportData) const {
+                    Q_UNUSED(writer)
+                    Q_UNUSED(export_flags)
+
+                    return IExportable::Complete;
+                }
+                //! Extended XML stream import function.
+                /*!
+                  \param item_category When valid, the category found in the element of the observer is imported into it. See Qtilities::Core::ObserverData::importXmlStreamExt() for more information.
+
+                  <i>This function was added in %Qtilities v1.5.</i>
+                  */
+                virtual IExportable::ExportResultFlags importXmlStreamExt(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list, QtilitiesCategory* item_category = 0) {
+                    Q_UNUSED(reader)
+                    Q_UNUSED(import_list)
+                    Q_UNUSED(item_category)
+
                     return IExportable::Complete;
                 }
             };
@@ -13,6 +13,8 @@
 #include "QtilitiesCoreConstants.h"
 
 #include <QtXml>
+#include <QXmlStreamAttributes>
+#include <QXmlStreamWriter>
 
 using namespace Qtilities::Core::Constants;
 
@@ -96,3 +98,35 @@ bool Qtilities::Core::InstanceFactoryInfo::importXml(QDomDocument* doc, QDomElem
 
     return true;
 }
+
+bool Qtilities::Core::InstanceFactoryInfo::exportXmlStream(QXmlStreamWriter& writer, Qtilities::ExportVersion version) const {
+    Q_UNUSED(version)
+
+    if (d_factory_tag != QString(qti_def_FACTORY_QTILITIES))
+        writer.writeAttribute("FactoryTag", d_factory_tag);
+    writer.writeAttribute("InstanceFactoryInfo", d_instance_tag);
+    if (d_instance_tag != d_instance_name)
+        writer.writeAttribute("Name", d_instance_name);
+
+    return true;
+}
+
+bool Qtilities::Core::InstanceFactoryInfo::importXmlStream(const QXmlStreamAttributes& attributes, Qtilities::ExportVersion version) {
+    Q_UNUSED(version)
+
+    // We don't do a version check here. Observer will do it for us.
+
+    if (attributes.hasAttribute("FactoryTag"))
+        d_factory_tag = attributes.value("FactoryTag").toString();
+    else
+        d_factory_tag = QString(qti_def_FACTORY_QTILITIES);
+
+    d_instance_tag = attributes.value("InstanceFactoryInfo").toString();
+
+    if (!attributes.hasAttribute("Name"))
+        d_instance_name = d_instance_tag;
+    else
+        d_instance_name = attributes.value("Name").toString();
+
+    return true;
+}
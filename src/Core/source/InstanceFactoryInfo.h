@@ -17,6 +17,8 @@
 
 class QDomDocument;
 class QDomElement;
+class QXmlStreamAttributes;
+class QXmlStreamWriter;
 
 namespace Qtilities {
     namespace Core {
@@ -114,6 +116,18 @@ namespace Qtilities {
               the %Qtilities factory tag is used by default.
               */
             virtual bool importXml(QDomDocument* doc, QDomElement* object_node, Qtilities::ExportVersion version);
+            //! Writes the factory tag, instance tag etc. as attributes on the element which is currently open on \p writer.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            virtual bool exportXmlStream(QXmlStreamWriter& writer, Qtilities::ExportVersion version) const;
+            //! Reads the factory tag, instance tag etc. from the attributes of an element read from an XML stream.
+            /*!
+              \note If \p attributes does not contain a \p FactoryTag attribute, the %Qtilities factory tag is used by default.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            virtual bool importXmlStream(const QXmlStreamAttributes& attributes, Qtilities::ExportVersion version);
 
             //! The name of the factory which must be used to create the instance.
             QString d_factory_tag;
@@ -11,6 +11,8 @@
 
 #include "ObjectManager.h"
 #include "QtilitiesProperty.h"
+#include "ObjectPropertyStore.h"
+#include "ParentObserverIndex.h"
 #include "QtilitiesCoreConstants.h"
 #include "Observer.h"
 #include "ObserverHints.h"
@@ -807,7 +809,9 @@ bool Qtilities::Core::ObjectManager::setMultiContextProperty(QObject* obj, Multi
     }
 
     QVariant property = qVariantFromValue(multi_context_property);
-    return !obj->setProperty(multi_context_property.propertyNameString().toUtf8().data(),property);
+    bool result = !obj->setProperty(multi_context_property.propertyNameString().toUtf8().data(),property);
+    ObjectPropertyStore::instance()->update(obj,multi_context_property,property);
+    return result;
 }
 
 Qtilities::Core::SharedProperty Qtilities::Core::ObjectManager::getSharedProperty(const QObject* obj, const char* property_name) {
@@ -846,7 +850,9 @@ bool Qtilities::Core::ObjectManager::setSharedProperty(QObject* obj, SharedPrope
     }
 
     QVariant property = qVariantFromValue(shared_property);
-    return !obj->setProperty(shared_property.propertyNameString().toUtf8().data(),property);
+    bool result = !obj->setProperty(shared_property.propertyNameString().toUtf8().data(),property);
+    ObjectPropertyStore::instance()->update(obj,shared_property,property);
+    return result;
 }
 
 bool Qtilities::Core::ObjectManager::setSharedProperty(QObject* obj, const char* property_name, QVariant property_value) {
@@ -854,6 +860,28 @@ bool Qtilities::Core::ObjectManager::setSharedProperty(QObject* obj, const char*
     return ObjectManager::setSharedProperty(obj,sp);
 }
 
+int Qtilities::Core::ObjectManager::parentObserverCount(const QObject* obj) {
+    if (!obj)
+        return -1;
+
+    return ParentObserverIndex::instance()->parentCount(obj);
+}
+
+QList<Qtilities::Core::Observer*> Qtilities::Core::ObjectManager::parentObservers(const QObject* obj) {
+    if (!obj)
+        return QList<Observer*>();
+
+    return ParentObserverIndex::instance()->parents(obj);
+}
+
+void Qtilities::Core::ObjectManager::addParentObserver(const QObject* obj, Observer* observer) {
+    ParentObserverIndex::instance()->addParent(obj,observer);
+}
+
+void Qtilities::Core::ObjectManager::removeParentObserver(const QObject* obj, Observer* observer) {
+    ParentObserverIndex::instance()->removeParent(obj,observer);
+}
+
 bool ObjectManager::setSharedProperty(QObject *obj, PropertySpecification property_specification) {
     SharedProperty* sp = ObjectManager::constructPropertyFromSpecification(property_specification);
     if (sp)
@@ -862,6 +890,20 @@ bool ObjectManager::setSharedProperty(QObject *obj, PropertySpecification proper
         return false;
 }
 
+QVariant Qtilities::Core::ObjectManager::getPropertyValue(const QObject* obj, const char* property_name, int context_id) {
+    #ifndef QT_NO_DEBUG
+        if (!obj)
+            qDebug() << "Failed to get property value \"" << property_name << "\" on null object";
+        Q_ASSERT(obj != 0);
+    #endif
+    #ifdef QT_NO_DEBUG
+        if (!obj)
+            return QVariant();
+    #endif
+
+    return ObjectPropertyStore::instance()->value(obj,property_name,context_id);
+}
+
 bool Qtilities::Core::ObjectManager::propertyExists(const QObject* obj, const char* property_name) {
     if (!obj)
         return false;
@@ -274,6 +274,44 @@ if (ObjectManager::propertyExists(iface->objectBase(),qti_prop_CATEGORY_MAP)) {
               This function was added in %Qtilities v1.2.
               */
             static bool setSharedProperty(QObject* obj, PropertySpecification property_specification);
+            //! Convenience function which will get the value of a SharedProperty or MultiContextProperty in the specified context.
+            /*!
+              Values are read through the Qtilities::Core::ObjectPropertyStore which keeps a decoded copy of the property. Unlike
+              getMultiContextProperty() and getSharedProperty() the property and its context map are not copied on every call. The
+              dynamic property is still looked up on \p obj to check that the decoded copy is current.
+
+              \param obj The object on which the property is set.
+              \param property_name The name of the property.
+              \param context_id The context for which the value is required. The context is ignored for shared properties.
+              \returns The value of the property, or an invalid QVariant when the property does not exist or does not have a value for \p context_id.
+
+              \sa getMultiContextProperty(), getSharedProperty()
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            static QVariant getPropertyValue(const QObject* obj, const char* property_name, int context_id = -1);
+            //! Returns the number of observers observing the specified object.
+            /*!
+              The object manager keeps a reverse index of the observers observing each object, which is updated when objects are attached to,
+              detached from or deleted while being observed by observers. Thus, unlike unpacking the qti_prop_OBSERVER_MAP property, this is a
+              constant time lookup which does not allocate memory. This function is thread safe.
+
+              \returns The number of observers observing \p obj, -1 when \p obj is null.
+
+              \sa parentObservers(), Observer::parentCount()
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            static int parentObserverCount(const QObject* obj);
+            //! Returns the observers observing the specified object, sorted on their observer IDs.
+            /*!
+              This function is thread safe.
+
+              \sa parentObserverCount(), Observer::parentReferences()
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            static QList<Observer*> parentObservers(const QObject* obj);
             //! Convenience function to check if a dynamic property exists on a object.
             static bool propertyExists(const QObject* obj, const char* property_name);
             //! Convenience function to remove all properties that match the PropertyTypeFlags from an object.
@@ -334,6 +372,11 @@ if (ObjectManager::propertyExists(iface->objectBase(),qti_prop_CATEGORY_MAP)) {
             const QObject* objectBase() const { return this; }
 
         private:
+            //! Adds \p observer to the parent observer index of \p obj. Called by Observer when it adds \p obj to its context.
+            static void addParentObserver(const QObject* obj, Observer* observer);
+            //! Removes \p observer from the parent observer index of \p obj. Called by Observer when \p obj leaves its context.
+            static void removeParentObserver(const QObject* obj, Observer* observer);
+
             ObjectManagerPrivateData* d;
         };
     }
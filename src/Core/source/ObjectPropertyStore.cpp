@@ -0,0 +1,255 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#include "ObjectPropertyStore.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QVarLengthArray>
+#include <QVector>
+
+namespace Qtilities {
+    namespace Core {
+        // A single context value of a decoded property.
+        struct StoredContextValue {
+            int         context_id;
+            QVariant    value;
+        };
+
+        // A decoded property. The view is the dynamic property QVariant this slot was decoded from. Since the slot holds a
+        // reference to the view's data, the data pointer of the view can't be reused for another property while the slot exists.
+        struct StoredProperty {
+            StoredProperty() : is_shared(false) { }
+
+            bool isCurrent(const QVariant& current_view) const {
+                return view.isValid() && view.constData() == current_view.constData();
+            }
+
+            QVariant valueInContext(int context_id) const {
+                if (is_shared)
+                    return shared_value;
+
+                // The context values are sorted on their context IDs:
+                int low = 0;
+                int high = context_values.count() - 1;
+                while (low <= high) {
+                    int mid = (low + high) / 2;
+                    const StoredContextValue& context_value = context_values.at(mid);
+                    if (context_value.context_id == context_id)
+                        return context_value.value;
+                    else if (context_value.context_id < context_id)
+                        low = mid + 1;
+                    else
+                        high = mid - 1;
+                }
+                return QVariant();
+            }
+
+            QByteArray                  name;
+            QVariant                    view;
+            bool                        is_shared;
+            QVariant                    shared_value;
+            QVector<StoredContextValue> context_values;
+        };
+
+        // The entry of a single object. Objects typically carry only a few Qtilities properties, thus a linear search is used.
+        // Only room for the most common case of a name and one other property is reserved inline, since every stored object pays for it.
+        struct StoredObject {
+            StoredProperty* find(const char* property_name) {
+                for (int i = 0; i < properties.count(); ++i) {
+                    if (properties[i].name == property_name)
+                        return &properties[i];
+                }
+                return 0;
+            }
+
+            StoredProperty* findOrAppend(const QByteArray& property_name) {
+                StoredProperty* stored = find(property_name.constData());
+                if (stored)
+                    return stored;
+
+                StoredProperty new_stored;
+                new_stored.name = property_name;
+                properties.append(new_stored);
+                return &properties[properties.count()-1];
+            }
+
+            QVarLengthArray<StoredProperty,2> properties;
+        };
+    }
+}
+
+struct Qtilities::Core::ObjectPropertyStorePrivateData {
+    // Must be called with the lock held for writing.
+    StoredObject* storedObject(const QObject* obj, const ObjectPropertyStore* store) {
+        StoredObject* stored_object = objects.value(obj);
+        if (!stored_object) {
+            stored_object = new StoredObject;
+            objects[obj] = stored_object;
+            QObject::connect(obj,SIGNAL(destroyed(QObject*)),store,SLOT(handle_objectDestroyed(QObject*)),Qt::DirectConnection);
+        }
+        return stored_object;
+    }
+
+    QHash<const QObject*,StoredObject*> objects;
+    mutable QReadWriteLock              lock;
+};
+
+Qtilities::Core::ObjectPropertyStore* Qtilities::Core::ObjectPropertyStore::m_Instance = 0;
+
+Qtilities::Core::ObjectPropertyStore* Qtilities::Core::ObjectPropertyStore::instance() {
+    static QMutex mutex;
+    if (!m_Instance)
+    {
+        mutex.lock();
+
+        if (!m_Instance)
+            m_Instance = new ObjectPropertyStore;
+
+        mutex.unlock();
+    }
+
+    return m_Instance;
+}
+
+Qtilities::Core::ObjectPropertyStore::ObjectPropertyStore() : QObject() {
+    d = new ObjectPropertyStorePrivateData;
+}
+
+Qtilities::Core::ObjectPropertyStore::~ObjectPropertyStore() {
+    clear();
+    delete d;
+}
+
+namespace {
+    using namespace Qtilities::Core;
+
+    void decodeMultiContextProperty(const MultiContextProperty& property, StoredProperty* stored) {
+        stored->is_shared = false;
+        stored->shared_value = QVariant();
+        stored->context_values.clear();
+
+        // QMap iterates in key order, thus the flat array is sorted on context IDs:
+        QMap<quint32,QVariant> context_map = property.contextMap();
+        stored->context_values.reserve(context_map.count());
+        QMap<quint32,QVariant>::const_iterator itr = context_map.constBegin();
+        while (itr != context_map.constEnd()) {
+            StoredContextValue context_value;
+            context_value.context_id = (int) itr.key();
+            context_value.value = itr.value();
+            stored->context_values.append(context_value);
+            ++itr;
+        }
+    }
+
+    void decodeSharedProperty(const SharedProperty& property, StoredProperty* stored) {
+        stored->is_shared = true;
+        stored->shared_value = property.value();
+        stored->context_values.clear();
+    }
+}
+
+QVariant Qtilities::Core::ObjectPropertyStore::value(const QObject* obj, const char* property_name, int context_id) const {
+    if (!obj || !property_name)
+        return QVariant();
+
+    // Getting the dynamic property only shares its data, it does not copy the property:
+    QVariant current_view = obj->property(property_name);
+    if (!current_view.isValid())
+        return QVariant();
+
+    {
+        QReadLocker locker(&d->lock);
+        StoredObject* stored_object = d->objects.value(obj);
+        if (stored_object) {
+            StoredProperty* stored = stored_object->find(property_name);
+            if (stored && stored->isCurrent(current_view))
+                return stored->valueInContext(context_id);
+        }
+    }
+
+    // The property was not decoded yet, or it was changed without going through the store:
+    StoredProperty decoded;
+    decoded.name = QByteArray(property_name);
+    decoded.view = current_view;
+    if (current_view.canConvert<SharedProperty>())
+        decodeSharedProperty(current_view.value<SharedProperty>(),&decoded);
+    else if (current_view.canConvert<MultiContextProperty>())
+        decodeMultiContextProperty(current_view.value<MultiContextProperty>(),&decoded);
+    else
+        return QVariant();
+
+    QVariant result = decoded.valueInContext(context_id);
+
+    QWriteLocker locker(&d->lock);
+    StoredObject* stored_object = d->storedObject(obj,this);
+    *stored_object->findOrAppend(decoded.name) = decoded;
+
+    return result;
+}
+
+void Qtilities::Core::ObjectPropertyStore::update(const QObject* obj, const MultiContextProperty& property, const QVariant& view) {
+    if (!obj)
+        return;
+
+    QByteArray property_name = property.propertyNameString().toUtf8();
+
+    QWriteLocker locker(&d->lock);
+    StoredObject* stored_object = d->storedObject(obj,this);
+    StoredProperty* stored = stored_object->findOrAppend(property_name);
+    stored->view = view;
+    decodeMultiContextProperty(property,stored);
+}
+
+void Qtilities::Core::ObjectPropertyStore::update(const QObject* obj, const SharedProperty& property, const QVariant& view) {
+    if (!obj)
+        return;
+
+    QByteArray property_name = property.propertyNameString().toUtf8();
+
+    QWriteLocker locker(&d->lock);
+    StoredObject* stored_object = d->storedObject(obj,this);
+    StoredProperty* stored = stored_object->findOrAppend(property_name);
+    stored->view = view;
+    decodeSharedProperty(property,stored);
+}
+
+void Qtilities::Core::ObjectPropertyStore::remove(const QObject* obj) {
+    QWriteLocker locker(&d->lock);
+    StoredObject* stored_object = d->objects.take(obj);
+    if (stored_object) {
+        disconnect(obj,SIGNAL(destroyed(QObject*)),this,SLOT(handle_objectDestroyed(QObject*)));
+        delete stored_object;
+    }
+}
+
+void Qtilities::Core::ObjectPropertyStore::clear() {
+    QWriteLocker locker(&d->lock);
+    QHash<const QObject*,StoredObject*>::const_iterator itr = d->objects.constBegin();
+    while (itr != d->objects.constEnd()) {
+        disconnect(itr.key(),SIGNAL(destroyed(QObject*)),this,SLOT(handle_objectDestroyed(QObject*)));
+        delete itr.value();
+        ++itr;
+    }
+    d->objects.clear();
+}
+
+int Qtilities::Core::ObjectPropertyStore::count() const {
+    QReadLocker locker(&d->lock);
+    return d->objects.count();
+}
+
+void Qtilities::Core::ObjectPropertyStore::handle_objectDestroyed(QObject* obj) {
+    // Don't use sender() here, it is not valid for direct connections made from other threads.
+    QWriteLocker locker(&d->lock);
+    delete d->objects.take(obj);
+}
@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#ifndef OBJECT_PROPERTY_STORE_H
+#define OBJECT_PROPERTY_STORE_H
+
+#include "QtilitiesCore_global.h"
+#include "QtilitiesProperty.h"
+
+#include <QObject>
+#include <QVariant>
+
+namespace Qtilities {
+    namespace Core {
+        /*!
+        \struct ObjectPropertyStorePrivateData
+        \brief Structure used by ObjectPropertyStore to store private data.
+          */
+        struct ObjectPropertyStorePrivateData;
+
+        /*!
+          \class ObjectPropertyStore
+          \brief The ObjectPropertyStore class keeps decoded copies of the %Qtilities properties set on objects.
+
+          %Qtilities properties (SharedProperty and MultiContextProperty) are stored as dynamic properties on objects. Getting
+          a value from such a property requires the property to be converted from its QVariant representation, which copies the
+          complete property including its context map. The object property store is a side table which keeps, for each object, one
+          entry holding a flat context to value array for every %Qtilities property that was accessed through the store, thus repeated
+          reads of the same property do not decode it again.
+
+          The dynamic properties remain the representation which is used for change notification (QDynamicPropertyChangeEvent),
+          exporting and property editors. Every entry in the store remembers the dynamic property it was decoded from and is only
+          used while the object still carries that exact property. Properties which are changed directly through QObject::setProperty()
+          are therefore picked up automatically the next time they are accessed.
+
+          You should not need to use this class directly, ObjectManager::getPropertyValue(), ObjectManager::setSharedProperty() and
+          ObjectManager::setMultiContextProperty() use it internally.
+
+          The store is thread safe.
+
+          <i>This class was added in %Qtilities v1.5.</i>
+          */
+        class QTILIITES_CORE_SHARED_EXPORT ObjectPropertyStore : public QObject
+        {
+            Q_OBJECT
+
+        public:
+            static ObjectPropertyStore* instance();
+            ~ObjectPropertyStore();
+
+            //! Gets the value of a %Qtilities property in the specified context.
+            /*!
+              \param obj The object on which the property is set.
+              \param property_name The name of the property.
+              \param context_id The context for which the value is required. The context is ignored for SharedProperty properties.
+              \returns The value of the property, or an invalid QVariant when the property does not exist, is not a %Qtilities property or
+              does not have a value for the specified context.
+
+              The dynamic property is still read through QObject::property() to check that the entry in the store is current, thus this function
+              avoids decoding the property and copying its context map, but not the cost of the dynamic property lookup itself.
+              */
+            QVariant value(const QObject* obj, const char* property_name, int context_id) const;
+            //! Updates the store after a MultiContextProperty was set on an object.
+            /*!
+              \param obj The object on which the property was set.
+              \param property The property which was set.
+              \param view The QVariant which was set as the dynamic property on the object.
+              */
+            void update(const QObject* obj, const MultiContextProperty& property, const QVariant& view);
+            //! Updates the store after a SharedProperty was set on an object.
+            /*!
+              \param obj The object on which the property was set.
+              \param property The property which was set.
+              \param view The QVariant which was set as the dynamic property on the object.
+              */
+            void update(const QObject* obj, const SharedProperty& property, const QVariant& view);
+            //! Removes the entry of the specified object from the store.
+            void remove(const QObject* obj);
+            //! Removes all entries from the store.
+            void clear();
+            //! Returns the number of objects which have entries in the store.
+            int count() const;
+
+        private slots:
+            void handle_objectDestroyed(QObject* obj);
+
+        private:
+            ObjectPropertyStore();
+
+            static ObjectPropertyStore* m_Instance;
+            ObjectPropertyStorePrivateData* d;
+        };
+    }
+}
+
+#endif // OBJECT_PROPERTY_STORE_H
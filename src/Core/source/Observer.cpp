@@ -11,6 +11,8 @@
 
 #include "Observer.h"
 #include "TreeIterator.h"
+#include "TreeTraversal.h"
+#include "AbstractTreeVisitor.h"
 #include "QtilitiesCoreConstants.h"
 #include "QtilitiesProperty.h"
 #include "ActivityPolicyFilter.h"
@@ -18,6 +20,7 @@
 #include "ObserverMimeData.h"
 #include "ObserverHints.h"
 #include "IExportableFormatting.h"
+#include "ParallelExport.h"
 
 #include <Logger>
 
@@ -27,7 +30,15 @@
 #include <QEvent>
 #include <QDynamicPropertyChangeEvent>
 #include <QCoreApplication>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include <QVector>
 #include <QMutableListIterator>
+#include <QSet>
 #include <QDomElement>
 #include <QDomDocument>
 
@@ -51,6 +62,7 @@ Qtilities::Core::Observer::Observer(const QString& observer_name, const QString&
     observerData->object_deletion_policy = DeleteImmediately;
     observerData->filter_subject_events_enabled = true;
     connect(&observerData->subject_list,SIGNAL(objectDestroyed(QObject*)),SLOT(handle_deletedSubject(QObject*)));
+    rebuildPropertyDispatchTable();
 
     // Register this observer with the observer manager
     if (observer_name != QString(qti_def_GLOBAL_OBJECT_POOL))
@@ -80,6 +92,11 @@ Qtilities::Core::Observer::Observer(const Observer &other) : QObject(other.paren
 Qtilities::Core::Observer::~Observer() {
     startProcessingCycle();
 
+    // Changes which were not notified yet are dropped:
+    if (observerData->deferred_notification_timer)
+        observerData->deferred_notification_timer->stop();
+    observerData->clearDeferredNotifications();
+
     emit aboutToBeDeleted();
 
     observerData->number_of_subjects_start_of_proc_cycle = -1;
@@ -149,6 +166,7 @@ Qtilities::Core::Observer::~Observer() {
         delete observerData->subject_filters.at(0);
         observerData->subject_filters.pop_front();
     }
+    rebuildPropertyDispatchTable();
 
     if (objectName() != QLatin1String(qti_def_GLOBAL_OBJECT_POOL)) {
         LOG_TRACE("Removing any trace of this observer from remaining children.");
@@ -196,6 +214,41 @@ QStringList Qtilities::Core::Observer::reservedProperties() const {
     return properties;
 }
 
+void Qtilities::Core::Observer::rebuildPropertyDispatchTable() {
+    QHash<QByteArray,PropertyDispatchEntry> table;
+
+    QStringList reserved_properties = reservedProperties();
+    for (int i = 0; i < reserved_properties.count(); ++i)
+        table[reserved_properties.at(i).toUtf8()].reserved = true;
+
+    QStringList monitored_properties = monitoredProperties();
+    for (int i = 0; i < monitored_properties.count(); ++i)
+        table[monitored_properties.at(i).toUtf8()].monitored = true;
+
+    for (int i = 0; i < observerData->subject_filters.count(); ++i) {
+        AbstractSubjectFilter* filter = observerData->subject_filters.at(i);
+        if (!filter)
+            continue;
+        QStringList filter_properties = filter->monitoredProperties();
+        for (int p = 0; p < filter_properties.count(); ++p) {
+            PropertyDispatchEntry& entry = table[filter_properties.at(p).toUtf8()];
+            if (!entry.filters.contains(filter))
+                entry.filters << filter;
+        }
+    }
+
+    // Role properties for which views must be notified that data changed:
+    table[QByteArray(qti_prop_DECORATION)].refreshes_data = true;
+    table[QByteArray(qti_prop_FOREGROUND)].refreshes_data = true;
+    table[QByteArray(qti_prop_BACKGROUND)].refreshes_data = true;
+    table[QByteArray(qti_prop_TEXT_ALIGNMENT)].refreshes_data = true;
+    table[QByteArray(qti_prop_FONT)].refreshes_data = true;
+    table[QByteArray(qti_prop_SIZE_HINT)].refreshes_data = true;
+    table[QByteArray(qti_prop_CATEGORY_MAP)].refreshes_layout = true;
+
+    observerData->property_dispatch_table = table;
+}
+
 void Qtilities::Core::Observer::toggleSubjectEventFiltering(bool toggle) {
     //qDebug() << "toggleSubjectEventFiltering on observer" << observerName() << "set to" << toggle;
     observerData->filter_subject_events_enabled = toggle;
@@ -231,9 +284,14 @@ Qtilities::Core::Interfaces::IExportable::ExportModeFlags Qtilities::Core::Obser
     IExportable::ExportModeFlags flags = 0;
     flags |= IExportable::Binary;
     flags |= IExportable::XML;
+    flags |= IExportable::XMLStream;
     return flags;
 }
 
+bool Qtilities::Core::Observer::supportsConcurrentExport() const {
+    return ObserverData::concurrentExportTreeSize(this) >= 0;
+}
+
 void Qtilities::Core::Observer::setExportVersion(Qtilities::ExportVersion version) {
     IExportable::setExportVersion(version);
     observerData->setExportVersion(version);
@@ -278,6 +336,22 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Obs
     return observerData->exportXmlExt(doc,object_node,export_flags);
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Observer::exportXmlStream(QXmlStreamWriter& writer) const {
+    return observerData->exportXmlStream(writer);
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Observer::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    return observerData->importXmlStream(reader,import_list);
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Observer::exportXmlStreamExt(QXmlStreamWriter& writer, ObserverData::ExportItemFlags export_flags) const {
+    return observerData->exportXmlStreamExt(writer,export_flags);
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Observer::importXmlStreamExt(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list, QtilitiesCategory* item_category) {
+    return observerData->importXmlStreamExt(reader,import_list,item_category);
+}
+
 bool Observer::setMonitorSubjectModificationState(QObject *obj, bool monitor) {
     if (!contains(obj))
         return false;
@@ -312,13 +386,8 @@ bool Observer::monitorSubjectModificationState(QObject *obj) {
     if (!contains(obj))
         return false;
 
-    MultiContextProperty ignore_modification_state_prop = ObjectManager::getMultiContextProperty(obj,qti_prop_SUBJECT_IGNORE_MODIFICATION_STATE);
-    if (ignore_modification_state_prop.isValid()) {
-        if (ignore_modification_state_prop.hasContext(observerID())) {
-            if (ignore_modification_state_prop.value(observerID()).toBool())
-                return false;
-        }
-    }
+    if (ObjectManager::getPropertyValue(obj,qti_prop_SUBJECT_IGNORE_MODIFICATION_STATE,observerID()).toBool())
+        return false;
 
     return true;
 }
@@ -336,13 +405,8 @@ bool Qtilities::Core::Observer::isModified() const {
         IModificationNotifier* mod_iface = qobject_cast<IModificationNotifier*> (observerData->subject_list.at(i));
         if (mod_iface) {
             // Check if this subject must be monitored:
-            MultiContextProperty ignore_modification_state_prop = ObjectManager::getMultiContextProperty(observerData->subject_list.at(i),qti_prop_SUBJECT_IGNORE_MODIFICATION_STATE);
-            if (ignore_modification_state_prop.isValid()) {
-                if (ignore_modification_state_prop.hasContext(observerID())) {
-                    if (ignore_modification_state_prop.value(observerID()).toBool())
-                        continue;
-                }
-            }
+            if (ObjectManager::getPropertyValue(observerData->subject_list.at(i),qti_prop_SUBJECT_IGNORE_MODIFICATION_STATE,observerID()).toBool())
+                continue;
 
             if (mod_iface->isModified())
                 return true;
@@ -396,10 +460,18 @@ void Qtilities::Core::Observer::setModificationState(bool new_state, IModificati
 
     // For observers we only notify targets if the actual state changed:
     if (observerData->is_modified != new_state || force_notifications) {
+        bool deferred = deferChangeNotifications(observerData->is_modified);
         observerData->is_modified = new_state;
         if (!observerData->process_cycle_active) {
-            if (notification_targets & IModificationNotifier::NotifyListeners)
-                emit modificationStateChanged(new_state);
+            if (notification_targets & IModificationNotifier::NotifyListeners) {
+                if (deferred) {
+                    observerData->deferred_modification_state_changed = true;
+                    if (force_notifications)
+                        observerData->deferred_modification_state_forced = true;
+                } else {
+                    emit modificationStateChanged(new_state);
+                }
+            }
 
             if (observerData->display_hints) {
                 if (observerData->display_hints->modificationStateDisplayHint() != ObserverHints::NoModificationStateDisplayHint)
@@ -410,12 +482,18 @@ void Qtilities::Core::Observer::setModificationState(bool new_state, IModificati
 }
 
 void Qtilities::Core::Observer::refreshViewsLayout(QList<QPointer<QObject> > new_selection, bool force) {
-    if (!observerData->process_cycle_active || force)
+    if (!force && deferChangeNotifications(observerData->is_modified)) {
+        observerData->deferred_layout_selection.append(new_selection);
+        observerData->deferred_layout_changed = true;
+    } else if (!observerData->process_cycle_active || force) {
         emit layoutChanged(new_selection);
+    }
 }
 
 void Qtilities::Core::Observer::refreshViewsData(bool force) {
-    if (!observerData->process_cycle_active || force)
+    if (!force && deferChangeNotifications(observerData->is_modified))
+        observerData->recordDeferredDataChange(this);
+    else if (!observerData->process_cycle_active || force)
         emit dataChanged(this);
 }
 
@@ -468,7 +546,12 @@ void Qtilities::Core::Observer::endProcessingCycle(bool broadcast) {
 
         // TODO: Send processing cycle end to subject filters in order for activity filter to emit the active subjects after the processing cycle if they changed. Note that TreeNode does this already.
         observerData->process_cycle_active = false;
+        publishSubjectSnapshot();
         emit processingCycleEnded();
+
+        // Changes collected before the processing cycle started were held back by it:
+        if (observerData->deferred_notifications_pending)
+            flushDeferredNotifications();
     }
 }
 
@@ -507,6 +590,113 @@ void Qtilities::Core::Observer::endTreeProcessingCycle(bool broadcast) {
     endProcessingCycle(broadcast);
 }
 
+void Qtilities::Core::Observer::setDeferredNotificationsEnabled(bool enabled, int latency) {
+    observerData->deferred_notification_latency = qMax(0,latency);
+    if (observerData->deferred_notifications_enabled == enabled)
+        return;
+
+    if (enabled) {
+        if (!observerData->deferred_notification_timer) {
+            observerData->deferred_notification_timer = new QTimer(this);
+            observerData->deferred_notification_timer->setSingleShot(true);
+            connect(observerData->deferred_notification_timer,SIGNAL(timeout()),SLOT(flushDeferredNotifications()));
+        }
+        observerData->deferred_notifications_enabled = true;
+    } else {
+        observerData->deferred_notifications_enabled = false;
+        flushDeferredNotifications();
+    }
+}
+
+bool Qtilities::Core::Observer::deferredNotificationsEnabled() const {
+    return observerData->deferred_notifications_enabled;
+}
+
+int Qtilities::Core::Observer::deferredNotificationLatency() const {
+    return observerData->deferred_notification_latency;
+}
+
+bool Qtilities::Core::Observer::hasPendingNotifications() const {
+    return observerData->deferred_notifications_pending;
+}
+
+bool Qtilities::Core::Observer::deferChangeNotifications(bool modification_state_before_change) {
+    if (!observerData->deferred_notifications_enabled || observerData->process_cycle_active)
+        return false;
+
+    if (!observerData->deferred_notifications_pending) {
+        observerData->deferred_notifications_pending = true;
+        observerData->deferred_modification_state_start = modification_state_before_change;
+        observerData->deferred_notification_timer->start(observerData->deferred_notification_latency);
+    }
+    return true;
+}
+
+void Qtilities::Core::Observer::flushDeferredNotifications() {
+    if (!observerData->deferred_notifications_pending || observerData->process_cycle_active)
+        return;
+
+    if (observerData->deferred_notification_timer)
+        observerData->deferred_notification_timer->stop();
+
+    // Take the change set before emitting anything, receivers might change the observer again:
+    QList<QPointer<QObject> > added;
+    QList<QPointer<QObject> > pending = observerData->deferred_added.objects();
+    for (int i = 0; i < pending.count(); ++i) {
+        if (pending.at(i))
+            added << pending.at(i);
+    }
+    QList<QPointer<QObject> > changed;
+    pending = observerData->deferred_changed.objects();
+    for (int i = 0; i < pending.count(); ++i) {
+        if (pending.at(i))
+            changed << pending.at(i);
+    }
+    QList<QPointer<QObject> > removed = observerData->deferred_removed.objects();
+    QList<QPointer<QObject> > layout_selection = observerData->deferred_layout_selection.objects();
+    bool layout_changed = observerData->deferred_layout_changed;
+    bool notify_modification_state = observerData->deferred_modification_state_changed &&
+            (observerData->deferred_modification_state_forced || observerData->is_modified != observerData->deferred_modification_state_start);
+    observerData->clearDeferredNotifications();
+
+    if (notify_modification_state)
+        emit modificationStateChanged(observerData->is_modified);
+
+    if (!added.isEmpty() && !removed.isEmpty())
+        emit numberOfSubjectsChanged(Observer::CyclicProcess, added + removed);
+    else if (!added.isEmpty())
+        emit numberOfSubjectsChanged(Observer::SubjectAdded, added);
+    else if (!removed.isEmpty())
+        emit numberOfSubjectsChanged(Observer::SubjectRemoved, removed);
+
+    // Views rebuild everything on layout changes, thus data changes only need to be emitted on their own:
+    if (layout_changed) {
+        emit layoutChanged(layout_selection);
+    } else {
+        for (int i = 0; i < changed.count(); ++i)
+            emit dataChanged(qobject_cast<Observer*> (changed.at(i)));
+    }
+
+    if (!added.isEmpty() || !removed.isEmpty() || !changed.isEmpty())
+        emit deferredNotificationsFlushed(added,removed,changed);
+}
+
+void Qtilities::Core::Observer::handle_subjectObserverDataChanged(Observer* observer) {
+    if (deferChangeNotifications(observerData->is_modified))
+        observerData->recordDeferredDataChange(observer ? observer : this);
+    else
+        emit dataChanged(observer);
+}
+
+void Qtilities::Core::Observer::handle_subjectObserverLayoutChanged(const QList<QPointer<QObject> >& new_selection) {
+    if (deferChangeNotifications(observerData->is_modified)) {
+        observerData->deferred_layout_selection.append(new_selection);
+        observerData->deferred_layout_changed = true;
+    } else {
+        emit layoutChanged(new_selection);
+    }
+}
+
 void Qtilities::Core::Observer::setFactoryData(Qtilities::Core::InstanceFactoryInfo factory_data) {
     if (factory_data.isValid())
         observerData->factory_data = factory_data;
@@ -559,10 +749,43 @@ bool Qtilities::Core::Observer::attachSubject(QObject* obj, Observer::ObjectOwne
         return false;
     }
 
+    // Add the object to this context:
+    addSubjectToContext(obj,object_ownership);
+    if (objectName() != QString(qti_def_GLOBAL_OBJECT_POOL))
+        setModificationState(true);
+
+    observerData->observer_mutex.tryLock();
+    // Finalize the attachment in all subject filters, indicating that the attachment was succesfull.
+    for (int i = 0; i < observerData->subject_filters.count(); ++i) {
+        observerData->subject_filters.at(i)->finalizeAttachment(obj,true,import_cycle);
+    }
+    observerData->observer_mutex.unlock();
+
+    if (objectName() != QString(qti_def_GLOBAL_OBJECT_POOL)) {
+        QList<QPointer<QObject> > objects;
+        objects << safe_obj;
+
+        // Change layout only after finalzeAttachment() in all filters since they might add properties
+        // used by views (activity policy filter for example)
+        if (!observerData->process_cycle_active) {
+            if (deferChangeNotifications(observerData->is_modified)) {
+                observerData->recordDeferredAddition(safe_obj);
+            } else {
+                emit numberOfSubjectsChanged(Observer::SubjectAdded, objects);
+                emit layoutChanged(objects);
+            }
+        }
+    }
+
+    return true;
+}
+
+void Qtilities::Core::Observer::addSubjectToContext(QObject* obj, Observer::ObjectOwnership object_ownership) {
     // Details of the global object pool observer is not added to any objects:
     if (objectName() != QString(qti_def_GLOBAL_OBJECT_POOL)) {
         // Now, add observer details to needed properties
         // Add observer details to property: qti_prop_OBSERVER_MAP
+        int subject_id = observerData->subject_id_counter;
         MultiContextProperty subject_id_property = ObjectManager::getMultiContextProperty(obj,qti_prop_OBSERVER_MAP);
         if (subject_id_property.isValid()) {
             // Thus, the property already exists
@@ -575,9 +798,11 @@ bool Qtilities::Core::Observer::attachSubject(QObject* obj, Observer::ObjectOwne
             ObjectManager::setMultiContextProperty(obj,new_subject_id_property);
         }
         observerData->subject_id_counter += 1;
+        ObjectManager::addParentObserver(obj,this);
 
         // Now that the object has the properties needed, we add it:
         observerData->subject_list.append(obj);
+        indexSubject(obj,subject_id,obj->thread() == thread() && observerData->filter_subject_events_enabled);
 
         // Handle object ownership
         #ifndef QT_NO_DEBUG
@@ -663,10 +888,9 @@ bool Qtilities::Core::Observer::attachSubject(QObject* obj, Observer::ObjectOwne
                 #endif
             }
         } else {
-            SharedProperty ownership_property(qti_prop_OWNERSHIP,QVariant(object_ownership));
-            ObjectManager::setSharedProperty(obj,ownership_property);
-            SharedProperty observer_parent_property(qti_prop_PARENT_ID,QVariant(-1));
-            ObjectManager::setSharedProperty(obj,observer_parent_property);
+            // Determine the final ownership details first in order to set the ownership properties only once:
+            int ownership_value = object_ownership;
+            int parent_id_value = -1;
             if (object_ownership == ManualOwnership) {
                 // We don't care about this object's lifetime, its up to the user to manage the lifetime of this object.
                 #ifndef QT_NO_DEBUG
@@ -675,41 +899,49 @@ bool Qtilities::Core::Observer::attachSubject(QObject* obj, Observer::ObjectOwne
             } else if (object_ownership == AutoOwnership) {
                 // Check if the object already has a parent, otherwise we handle it as ObserverScopeOwnership.
                 if (!obj->parent()) {
-                    setMultiContextPropertyValue(obj,qti_prop_OWNERSHIP,QVariant(ObserverScopeOwnership));
+                    ownership_value = ObserverScopeOwnership;
                     #ifndef QT_NO_DEBUG
                         management_policy_string = "Auto Ownership (had no parent, using Observer Scope Ownership)";
                     #endif
                 } else {
-                    setMultiContextPropertyValue(obj,qti_prop_OWNERSHIP,QVariant(ManualOwnership));
+                    ownership_value = ManualOwnership;
                     #ifndef QT_NO_DEBUG
                         management_policy_string = "Auto Ownership (had parent, leave as Manual Ownership)";
                     #endif
                 }
             } else if (object_ownership == SpecificObserverOwnership) {
                 // This observer must be its parent.
-                setMultiContextPropertyValue(obj,qti_prop_OWNERSHIP,QVariant(SpecificObserverOwnership));
-                setMultiContextPropertyValue(obj,qti_prop_PARENT_ID,QVariant(observerID()));
+                parent_id_value = observerID();
                 #ifndef QT_NO_DEBUG
                     management_policy_string = "Specific Observer Ownership";
                 #endif
+            } else if (object_ownership == ObserverScopeOwnership) {
+                #ifndef QT_NO_DEBUG
+                    management_policy_string = "Observer Scope Ownership";
+                #endif
+            } else if (object_ownership == OwnedBySubjectOwnership) {
+                #ifndef QT_NO_DEBUG
+                    management_policy_string = "Owned By Subject Ownership";
+                #endif
+            }
+
+            SharedProperty ownership_property(qti_prop_OWNERSHIP,QVariant(ownership_value));
+            ObjectManager::setSharedProperty(obj,ownership_property);
+            SharedProperty observer_parent_property(qti_prop_PARENT_ID,QVariant(parent_id_value));
+            ObjectManager::setSharedProperty(obj,observer_parent_property);
+
+            if (object_ownership == SpecificObserverOwnership) {
                 // QWidget's parent must be another QWidget, thus the rules don't apply to QWidgets.
                 if (!obj->inherits("QWidget"))
                     obj->setParent(this);
             } else if (object_ownership == ObserverScopeOwnership) {
                 // This object must be deleted as soon as its not observed by any observers any more.
-                //obj->setParent(0);
-                #ifndef QT_NO_DEBUG
-                    management_policy_string = "Observer Scope Ownership";
-                #endif
                 // Don't set parent to 0 if its a widget.
                 if (!obj->inherits("QWidget"))
                     obj->setParent(0);
             } else if (object_ownership == OwnedBySubjectOwnership) {
                 // This observer must be deleted as soon as this subject is deleted.
                 connect(obj,SIGNAL(destroyed()),SLOT(deleteLater()));
-                #ifndef QT_NO_DEBUG
-                    management_policy_string = "Owned By Subject Ownership";
-                #endif
                 if (!obj->inherits("QWidget"))
                     obj->setParent(0);
             }
@@ -726,8 +958,8 @@ bool Qtilities::Core::Observer::attachSubject(QObject* obj, Observer::ObjectOwne
         if (obs) {
             has_mod_iface = true;
             connect(obs,SIGNAL(modificationStateChanged(bool)),SLOT(setModificationState(bool)));
-            connect(obs,SIGNAL(dataChanged(Observer*)),SIGNAL(dataChanged(Observer*)));
-            connect(obs,SIGNAL(layoutChanged(QList<QPointer<QObject> >)),SIGNAL(layoutChanged(QList<QPointer<QObject> >)));
+            connect(obs,SIGNAL(dataChanged(Observer*)),SLOT(handle_subjectObserverDataChanged(Observer*)));
+            connect(obs,SIGNAL(layoutChanged(QList<QPointer<QObject> >)),SLOT(handle_subjectObserverLayoutChanged(QList<QPointer<QObject> >)));
 
             observerData->subject_observer_list.append(obj);
         } else {
@@ -742,9 +974,6 @@ bool Qtilities::Core::Observer::attachSubject(QObject* obj, Observer::ObjectOwne
             }
         }
 
-        // Emit neccesarry signals
-        setModificationState(true);
-
         #ifndef QT_NO_DEBUG
         if (!observerData->process_cycle_active) {
             if (has_mod_iface)
@@ -756,6 +985,7 @@ bool Qtilities::Core::Observer::attachSubject(QObject* obj, Observer::ObjectOwne
     } else {
         // If it is the global object manager it will get here.
         observerData->subject_list.append(obj);
+        indexSubject(obj,-1,obj->thread() == thread() && observerData->filter_subject_events_enabled);
 
         Observer* obs = qobject_cast<Observer*> (obj);
         if (obs)
@@ -766,60 +996,121 @@ bool Qtilities::Core::Observer::attachSubject(QObject* obj, Observer::ObjectOwne
         if (obj->thread() == thread() && observerData->filter_subject_events_enabled)
             obj->installEventFilter(this);
 
-        // Emit neccesarry signals
-        QList<QPointer<QObject> > objects;
-        objects << obj;
-//        if (!observerData->process_cycle_active) {
-//            emit numberOfSubjectsChanged(Observer::SubjectAdded, objects);
-//            emit layoutChanged(objects);
-//        }
-
         LOG_TRACE(QString("Object \"%1\" is now visible in the global object pool.").arg(obj->objectName()));
     }
 
-    observerData->observer_mutex.tryLock();
-    // Finalize the attachment in all subject filters, indicating that the attachment was succesfull.
-    for (int i = 0; i < observerData->subject_filters.count(); ++i) {
-        observerData->subject_filters.at(i)->finalizeAttachment(obj,true,import_cycle);
+    invalidateTreeCache();
+    publishSubjectSnapshot();
+}
+
+QList<QPointer<QObject> > Qtilities::Core::Observer::attachSubjects(QList<QObject*> objects, Observer::ObjectOwnership ownership, QString* rejectMsg, bool import_cycle) {
+    QList<QPointer<QObject> > success_list;
+    if (objects.isEmpty())
+        return success_list;
+
+    // The changes are broadcast once for the complete batch, unless a processing cycle was already active:
+    bool broadcast = !observerData->process_cycle_active;
+    startProcessingCycle();
+
+    if (!subjectFiltersSupportBatchOperations()) {
+        for (int i = 0; i < objects.count(); ++i) {
+            if (attachSubject(objects.at(i), ownership, rejectMsg, import_cycle))
+                success_list << objects.at(i);
+        }
+        endBatchProcessingCycle(broadcast,Observer::SubjectAdded,success_list);
+        return success_list;
     }
-    observerData->observer_mutex.unlock();
 
-    if (objectName() != QString(qti_def_GLOBAL_OBJECT_POOL)) {
-        QList<QPointer<QObject> > objects;
-        objects << safe_obj;
+    // Evaluate all objects first:
+    QList<QObject*> candidates;
+    QSet<QObject*> candidate_set;
+    for (int i = 0; i < objects.count(); ++i) {
+        QObject* obj = objects.at(i);
+        if (!obj || candidate_set.contains(obj))
+            continue;
 
-        // Change layout only after finalzeAttachment() in all filters since they might add properties
-        // used by views (activity policy filter for example)
-        if (!observerData->process_cycle_active) {
-            emit numberOfSubjectsChanged(Observer::SubjectAdded, objects);
-            emit layoutChanged(objects);
+        // canAttach() checks the subject limit against the current number of subjects, thus we must count the candidates here:
+        if (observerData->subject_limit != -1 && (observerData->subject_list.count() + candidates.count() >= observerData->subject_limit)) {
+            QString reject_string = QString(tr("Observer (%1): Object (%2) attachment failed, subject limit reached.")).arg(objectName()).arg(obj->objectName());
+            LOG_WARNING(reject_string);
+            if (rejectMsg)
+                *rejectMsg = reject_string;
+            break;
         }
+
+        // If objectName() is empty, set the object name using the objects meta type info:
+        if (obj->objectName().isEmpty())
+            obj->setObjectName(obj->metaObject()->className());
+
+        if (canAttach(obj,ownership,rejectMsg) == Rejected)
+            continue;
+
+        candidates << obj;
+        candidate_set << obj;
     }
 
-    return true;
-}
+    // Pass the candidates through all installed subject filters:
+    QList<bool> passed_filters;
+    for (int i = 0; i < candidates.count(); ++i)
+        passed_filters << true;
+    for (int f = 0; f < observerData->subject_filters.count(); ++f) {
+        QList<bool> results = observerData->subject_filters.at(f)->initializeAttachments(candidates,rejectMsg,import_cycle);
+        for (int i = 0; i < candidates.count() && i < results.count(); ++i) {
+            if (!results.at(i))
+                passed_filters[i] = false;
+        }
+    }
 
-QList<QPointer<QObject> > Qtilities::Core::Observer::attachSubjects(QList<QObject*> objects, Observer::ObjectOwnership ownership, QString* rejectMsg, bool import_cycle) {
-    QList<QPointer<QObject> > success_list;
-    startProcessingCycle();
-    for (int i = 0; i < objects.count(); ++i) {
-        if (attachSubject(objects.at(i), ownership, rejectMsg, import_cycle))
-            success_list << objects.at(i);
+    QList<QObject*> accepted;
+    QList<QObject*> rejected;
+    for (int i = 0; i < candidates.count(); ++i) {
+        if (passed_filters.at(i))
+            accepted << candidates.at(i);
+        else
+            rejected << candidates.at(i);
     }
-    endProcessingCycle(true);
+
+    if (!rejected.isEmpty()) {
+        LOG_DEBUG(QString("Observer (%1): Attachment of %2 object(s) failed, attachment was rejected by one or more subject filter.").arg(objectName()).arg(rejected.count()));
+        for (int f = 0; f < observerData->subject_filters.count(); ++f)
+            observerData->subject_filters.at(f)->finalizeAttachments(rejected,false,import_cycle);
+        for (int i = 0; i < rejected.count(); ++i)
+            removeQtilitiesProperties(rejected.at(i));
+    }
+
+    // Add all accepted objects to this context:
+    observerData->subject_list.reserve(observerData->subject_list.count() + accepted.count());
+    for (int i = 0; i < accepted.count(); ++i)
+        addSubjectToContext(accepted.at(i),ownership);
+    if (!accepted.isEmpty() && objectName() != QString(qti_def_GLOBAL_OBJECT_POOL))
+        setModificationState(true);
+
+    observerData->observer_mutex.tryLock();
+    // Finalize the attachment in all subject filters, indicating that the attachment was succesfull.
+    for (int f = 0; f < observerData->subject_filters.count(); ++f)
+        observerData->subject_filters.at(f)->finalizeAttachments(accepted,true,import_cycle);
+    observerData->observer_mutex.unlock();
+
+    // Subject filters could have deleted some of the objects during finalization, thus use QPointers:
+    for (int i = 0; i < accepted.count(); ++i)
+        success_list << accepted.at(i);
+
+    LOG_TRACE(QString("Observer (%1): Attached %2 of %3 object(s) in a single batch.").arg(objectName()).arg(accepted.count()).arg(objects.count()));
+
+    // Change layout only after finalizeAttachments() in all filters since they might add properties
+    // used by views (activity policy filter for example)
+    endBatchProcessingCycle(broadcast,Observer::SubjectAdded,success_list);
     return success_list;
 }
 
 QList<QPointer<QObject> > Qtilities::Core::Observer::attachSubjects(ObserverMimeData* mime_data_object, Observer::ObjectOwnership ownership, QString* rejectMsg, bool import_cycle) {
-    QList<QPointer<QObject> > success_list;
-    startProcessingCycle();
-    for (int i = 0; i < mime_data_object->subjectList().count(); ++i) {
-        if (attachSubject(mime_data_object->subjectList().at(i), ownership, rejectMsg, import_cycle)) {
-            success_list << mime_data_object->subjectList().at(i);
-        }
+    QList<QObject*> objects;
+    QList<QPointer<QObject> > subject_list = mime_data_object->subjectList();
+    for (int i = 0; i < subject_list.count(); ++i) {
+        if (subject_list.at(i))
+            objects << subject_list.at(i);
     }
-    endProcessingCycle(true);
-    return success_list;
+    return attachSubjects(objects, ownership, rejectMsg, import_cycle);
 }
 
 Qtilities::Core::Observer::EvaluationResult Qtilities::Core::Observer::canAttach(QObject* obj, Observer::ObjectOwnership, QString* rejectMsg, bool silent) const {
@@ -964,6 +1255,14 @@ void Qtilities::Core::Observer::handle_deletedSubject(QObject* obj) {
             return;
     #endif
 
+    // The pointer list already removed the object, thus we must always remove it from the lookup index. Deleted
+    // objects are removed from the subject snapshot right away, even when a processing cycle is active:
+    observerData->unindexSubject(obj);
+    ObjectManager::removeParentObserver(obj,this);
+    invalidateTreeCache();
+    if (observerData->concurrent_reads_enabled)
+        observerData->publishSubjectSnapshot();
+
     if (!observerData->observer_mutex.tryLock())
         return;
 
@@ -988,8 +1287,12 @@ void Qtilities::Core::Observer::handle_deletedSubject(QObject* obj) {
     // Emit neccesarry signals
     setModificationState(true);
     if (!observerData->process_cycle_active) {
-        emit numberOfSubjectsChanged(SubjectRemoved, QList<QPointer<QObject> >());
-        emit layoutChanged(QList<QPointer<QObject> >());
+        if (deferChangeNotifications(observerData->is_modified)) {
+            observerData->recordDeferredRemoval(0);
+        } else {
+            emit numberOfSubjectsChanged(SubjectRemoved, QList<QPointer<QObject> >());
+            emit layoutChanged(QList<QPointer<QObject> >());
+        }
     }
 
     observerData->observer_mutex.unlock();
@@ -1059,6 +1362,7 @@ bool Qtilities::Core::Observer::detachSubject(QObject* obj, QString* rejectMsg)
                 removeQtilitiesProperties(obj);
                 observerData->subject_list.removeOne(obj);
                 observerData->subject_observer_list.removeOne(obj);
+                observerData->unindexSubject(obj);
             }
         } else if (ownership_variant.isValid() && ((ObjectOwnership) ownership_variant.toInt() == SpecificObserverOwnership)) {
             QVariant observer_parent = getMultiContextPropertyValue(obj,qti_prop_PARENT_ID);
@@ -1071,11 +1375,13 @@ bool Qtilities::Core::Observer::detachSubject(QObject* obj, QString* rejectMsg)
                 removeQtilitiesProperties(obj);
                 observerData->subject_list.removeOne(obj);
                 observerData->subject_observer_list.removeOne(obj);
+                observerData->unindexSubject(obj);
             }
         } else {
             removeQtilitiesProperties(obj);
             observerData->subject_list.removeOne(obj);
             observerData->subject_observer_list.removeOne(obj);
+            observerData->unindexSubject(obj);
         }
 
         #ifndef QT_NO_DEBUG
@@ -1088,15 +1394,21 @@ bool Qtilities::Core::Observer::detachSubject(QObject* obj, QString* rejectMsg)
         obj->disconnect(this);
         obj->removeEventFilter(this);
     }
+    invalidateTreeCache();
+    publishSubjectSnapshot();
 
     // Broadcast if neccesarry:
     setModificationState(true);
     if (!observerData->process_cycle_active) {
-        QList<QPointer<QObject> > objects;
-        if (!lost_scope)
-            objects << obj;
-        emit numberOfSubjectsChanged(SubjectRemoved, objects);
-        emit layoutChanged(QList<QPointer<QObject> >());
+        if (deferChangeNotifications(observerData->is_modified)) {
+            observerData->recordDeferredRemoval(lost_scope ? 0 : obj);
+        } else {
+            QList<QPointer<QObject> > objects;
+            if (!lost_scope)
+                objects << obj;
+            emit numberOfSubjectsChanged(SubjectRemoved, objects);
+            emit layoutChanged(QList<QPointer<QObject> >());
+        }
     }
 
     observerData->filter_subject_events_enabled = currrent_filter_subject_events_enabled;
@@ -1105,31 +1417,197 @@ bool Qtilities::Core::Observer::detachSubject(QObject* obj, QString* rejectMsg)
 
 QList<QPointer<QObject> > Qtilities::Core::Observer::detachSubjects(QList<QObject*> objects, QString* rejectMsg) {
     QList<QPointer<QObject> > success_list;
+    if (objects.isEmpty())
+        return success_list;
+
+    // The changes are broadcast once for the complete batch, unless a processing cycle was already active:
+    bool broadcast = !observerData->process_cycle_active;
     startProcessingCycle();
 
-    QList<QPointer<QObject> > safe_list;
-    for (int i = 0; i < objects.count(); ++i) {
-        if (objects.at(i)) {
-            safe_list << objects.at(i);
-            QString tmp_rejectMsg;
-            if (detachSubject(safe_list.at(i),&tmp_rejectMsg)) {
-                // The object could have been deleted in detach subject, thus we must use some
-                // safe QPointers here:
-                if (safe_list.at(i))
-                    success_list << safe_list.at(i);
-            } else {
-                if (rejectMsg) {
-                    rejectMsg->append(tmp_rejectMsg);
-                    rejectMsg->append("\n");
+    if (!subjectFiltersSupportBatchOperations()) {
+        QList<QPointer<QObject> > safe_list;
+        for (int i = 0; i < objects.count(); ++i) {
+            if (objects.at(i)) {
+                safe_list << objects.at(i);
+                QString tmp_rejectMsg;
+                if (detachSubject(safe_list.last(),&tmp_rejectMsg)) {
+                    // The object could have been deleted in detach subject, thus we must use some
+                    // safe QPointers here:
+                    if (safe_list.last())
+                        success_list << safe_list.last();
+                } else {
+                    if (rejectMsg) {
+                        rejectMsg->append(tmp_rejectMsg);
+                        rejectMsg->append("\n");
+                    }
                 }
             }
         }
+
+        endBatchProcessingCycle(broadcast,Observer::SubjectRemoved,success_list);
+        return success_list;
+    }
+
+    // Evaluate all objects first:
+    QList<QObject*> candidates;
+    QSet<QObject*> candidate_set;
+    for (int i = 0; i < objects.count(); ++i) {
+        QObject* obj = objects.at(i);
+        if (!obj || candidate_set.contains(obj))
+            continue;
+
+        QString tmp_rejectMsg;
+        if (canDetach(obj,&tmp_rejectMsg) == Rejected) {
+            if (rejectMsg && !tmp_rejectMsg.isEmpty()) {
+                rejectMsg->append(tmp_rejectMsg);
+                rejectMsg->append("\n");
+            }
+            continue;
+        }
+
+        candidates << obj;
+        candidate_set << obj;
+    }
+
+    bool currrent_filter_subject_events_enabled = observerData->filter_subject_events_enabled;
+    observerData->filter_subject_events_enabled = false;
+
+    // Pass the candidates through all installed subject filters:
+    QList<bool> passed_filters;
+    for (int i = 0; i < candidates.count(); ++i)
+        passed_filters << true;
+    for (int f = 0; f < observerData->subject_filters.count(); ++f) {
+        QList<bool> results = observerData->subject_filters.at(f)->initializeDetachments(candidates);
+        for (int i = 0; i < candidates.count() && i < results.count(); ++i) {
+            if (!results.at(i))
+                passed_filters[i] = false;
+        }
+    }
+
+    QList<QObject*> accepted;
+    QList<QObject*> rejected;
+    for (int i = 0; i < candidates.count(); ++i) {
+        if (passed_filters.at(i))
+            accepted << candidates.at(i);
+        else
+            rejected << candidates.at(i);
     }
 
-    endProcessingCycle();
+    if (!rejected.isEmpty()) {
+        QString reject_string = QString(tr("Observer (%1): Detachment of %2 object(s) failed, detachment was rejected by one or more subject filters.")).arg(objectName()).arg(rejected.count());
+        LOG_WARNING(reject_string);
+        if (rejectMsg) {
+            rejectMsg->append(reject_string);
+            rejectMsg->append("\n");
+        }
+        for (int f = 0; f < observerData->subject_filters.count(); ++f)
+            observerData->subject_filters.at(f)->finalizeDetachments(rejected,false);
+    }
+    for (int f = 0; f < observerData->subject_filters.count(); ++f)
+        observerData->subject_filters.at(f)->finalizeDetachments(accepted,true);
+
+    // Work out which objects go out of scope, the rest are removed from the subject lists in a single pass:
+    QList<QPointer<QObject> > safe_accepted;
+    QList<QObject*> to_delete;
+    QList<QObject*> to_remove;
+    bool is_global_pool = (objectName() == QString(qti_def_GLOBAL_OBJECT_POOL));
+    for (int i = 0; i < accepted.count(); ++i) {
+        QObject* obj = accepted.at(i);
+        bool lost_scope = false;
+        if (!is_global_pool) {
+            QVariant ownership_variant = getMultiContextPropertyValue(obj,qti_prop_OWNERSHIP);
+            if (ownership_variant.isValid() && ((ObjectOwnership) ownership_variant.toInt() == ObserverScopeOwnership)) {
+                lost_scope = (parentCount(obj) == 1);
+            } else if (ownership_variant.isValid() && ((ObjectOwnership) ownership_variant.toInt() == SpecificObserverOwnership)) {
+                QVariant observer_parent = getMultiContextPropertyValue(obj,qti_prop_PARENT_ID);
+                lost_scope = (observer_parent.isValid() && (observer_parent.toInt() == observerID()));
+            }
+        }
+
+        if (lost_scope) {
+            LOG_DEBUG(QString("Object (%1) went out of scope, it will be deleted.").arg(obj->objectName()));
+            to_delete << obj;
+        } else {
+            if (!is_global_pool)
+                removeQtilitiesProperties(obj);
+            to_remove << obj;
+            safe_accepted << obj;
+        }
+    }
+
+    observerData->subject_list.removeObjects(to_remove);
+    observerData->subject_observer_list.removeObjects(to_remove);
+    for (int i = 0; i < to_remove.count(); ++i) {
+        QObject* obj = to_remove.at(i);
+        observerData->unindexSubject(obj);
+        obj->disconnect(this);
+        obj->removeEventFilter(this);
+    }
+    invalidateTreeCache();
+    publishSubjectSnapshot();
+
+    for (int i = 0; i < to_delete.count(); ++i)
+        deleteObject(to_delete.at(i));
+    if (!to_delete.isEmpty())
+        QCoreApplication::processEvents();
+
+    for (int i = 0; i < safe_accepted.count(); ++i) {
+        if (safe_accepted.at(i))
+            success_list << safe_accepted.at(i);
+    }
+
+    if (!accepted.isEmpty())
+        setModificationState(true);
+
+    LOG_DEBUG(QString("Observer (%1): Detached %2 of %3 object(s) in a single batch.").arg(objectName()).arg(accepted.count()).arg(objects.count()));
+
+    observerData->filter_subject_events_enabled = currrent_filter_subject_events_enabled;
+    endBatchProcessingCycle(broadcast,Observer::SubjectRemoved,success_list);
     return success_list;
 }
 
+bool Qtilities::Core::Observer::subjectFiltersSupportBatchOperations() const {
+    for (int i = 0; i < observerData->subject_filters.count(); ++i) {
+        if (!observerData->subject_filters.at(i)->supportsBatchOperations())
+            return false;
+    }
+    return true;
+}
+
+void Qtilities::Core::Observer::endBatchProcessingCycle(bool broadcast, Observer::SubjectChangeIndication change_indication, const QList<QPointer<QObject> >& objects) {
+    if (!broadcast) {
+        endProcessingCycle(false);
+        return;
+    }
+
+    bool modification_state_start_of_batch = observerData->modification_state_start_of_proc_cycle;
+    endProcessingCycle(false);
+
+    if (deferChangeNotifications(modification_state_start_of_batch)) {
+        observerData->deferred_modification_state_changed = true;
+        for (int i = 0; i < objects.count(); ++i) {
+            if (change_indication == Observer::SubjectAdded)
+                observerData->recordDeferredAddition(objects.at(i));
+            else
+                observerData->recordDeferredRemoval(objects.at(i));
+        }
+        return;
+    }
+
+    bool is_modified = isModified();
+    if (is_modified != modification_state_start_of_batch)
+        emit modificationStateChanged(is_modified);
+
+    // Emit a single change notification carrying all the objects in the batch:
+    if (!objects.isEmpty()) {
+        emit numberOfSubjectsChanged(change_indication, objects);
+        if (change_indication == Observer::SubjectAdded)
+            emit layoutChanged(objects);
+        else
+            emit layoutChanged(QList<QPointer<QObject> >());
+    }
+}
+
 Qtilities::Core::Observer::EvaluationResult Qtilities::Core::Observer::canDetach(QObject* obj, QString* rejectMsg) const {
     if (objectName() != QString(qti_def_GLOBAL_OBJECT_POOL)) {
         // Check if this subject is observed by this observer. If its not observed by this observer, we can't detach it.
@@ -1260,21 +1738,8 @@ QVariant Qtilities::Core::Observer::getMultiContextPropertyValue(const QObject*
             return QVariant();
     #endif
 
-    QVariant prop;
-    prop = obj->property(property_name);
-
-    if (prop.isValid() && prop.canConvert<SharedProperty>()) {
-        // This is a shared property
-        return (prop.value<SharedProperty>()).value();
-    } else if (prop.isValid() && prop.canConvert<MultiContextProperty>()) {
-        // This is a normal multi context property (not shared)
-        return (prop.value<MultiContextProperty>()).value(observerData->observer_id);
-    } else if (!prop.isValid()) {
-        return QVariant();
-    } else {
-        LOG_TRACE(QString("Observer (%1): Getting of property (%2) failed, property not recognized as a qtilities property type.").arg(objectName()).arg(property_name));
-        return QVariant();
-    }
+    // The object property store returns the value for our context without copying the property:
+    return ObjectManager::getPropertyValue(obj,property_name,observerData->observer_id);
 }
 
 bool Qtilities::Core::Observer::setMultiContextPropertyValue(QObject* obj, const char* property_name, const QVariant& new_value) const {
@@ -1350,6 +1815,8 @@ void Qtilities::Core::Observer::removeQtilitiesProperties(QObject* obj) {
         }
     }
 
+    ObjectManager::removeParentObserver(obj,this);
+
     // If the count is zero after removing the contexts, remove all properties:
     if (parentCount(obj) == 0) {
         foreach (const QString& property_name, added_properties) {
@@ -1362,6 +1829,35 @@ void Qtilities::Core::Observer::removeQtilitiesProperties(QObject* obj) {
     observerData->deliver_qtilities_property_changed_events = currrent_deliver_qtilities_property_changed_events;
 }
 
+void Qtilities::Core::Observer::indexSubject(QObject* obj, int subject_id, bool event_filter_installed) {
+    // Changes to qti_prop_NAME are picked up in the event filter, and changes to objectName() through the
+    // objectNameChanged() signal which is only available in Qt 5. In Qt 4 we can only track names of
+    // subjects which already have qti_prop_NAME set.
+    bool name_tracked = event_filter_installed;
+    #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    connect(obj,SIGNAL(objectNameChanged(QString)),SLOT(handle_subjectObjectNameChanged()));
+    #else
+    if (name_tracked)
+        name_tracked = ObjectManager::propertyExists(obj,qti_prop_NAME);
+    #endif
+
+    observerData->indexSubject(obj,subject_id,subjectLookupName(obj),name_tracked);
+}
+
+QString Qtilities::Core::Observer::subjectLookupName(const QObject* obj) const {
+    QVariant prop = getMultiContextPropertyValue(obj,qti_prop_NAME);
+    if (prop.isValid())
+        return prop.toString();
+    else
+        return obj->objectName();
+}
+
+void Qtilities::Core::Observer::handle_subjectObjectNameChanged() {
+    QObject* obj = sender();
+    if (obj)
+        observerData->reindexSubjectName(obj,subjectLookupName(obj));
+}
+
 bool Qtilities::Core::Observer::isParentInHierarchy(const Observer* obj_to_check, const Observer* observer) {
     // Get all the parents of observer
     MultiContextProperty context_map_prop = ObjectManager::getMultiContextProperty(observer, qti_prop_OBSERVER_MAP);
@@ -1599,11 +2095,31 @@ int Qtilities::Core::Observer::treeCount(const QString& base_class_name) {
     time.start();
     #endif
 
-    int count = subjectCount(base_class_name);
-    QList<QPointer<Observer> > observers = subjectObserverReferences();
-    for (int i = 0; i < observers.count(); ++i) {
-        if (observers.at(i))
-            count += observers.at(i)->treeCount(base_class_name);
+    int count = 0;
+    if (treeCacheUsable()) {
+        updateTreeCache();
+        if (base_class_name.isEmpty()) {
+            count = observerData->tree_cache.count();
+        } else {
+            QHash<QString,int>::const_iterator itr = observerData->tree_cache_counts.constFind(base_class_name);
+            if (itr != observerData->tree_cache_counts.constEnd()) {
+                count = itr.value();
+            } else {
+                QByteArray base_class_name_bytes = base_class_name.toUtf8();
+                for (int i = 0; i < observerData->tree_cache.count(); ++i) {
+                    if (observerData->tree_cache.at(i)->inherits(base_class_name_bytes.constData()))
+                        ++count;
+                }
+                observerData->tree_cache_counts[base_class_name] = count;
+            }
+        }
+    } else {
+        count = subjectCount(base_class_name);
+        QList<QPointer<Observer> > observers = subjectObserverReferences();
+        for (int i = 0; i < observers.count(); ++i) {
+            if (observers.at(i))
+                count += observers.at(i)->treeCount(base_class_name);
+        }
     }
 
     #ifdef QTILITIES_BENCHMARKING
@@ -1616,8 +2132,11 @@ int Qtilities::Core::Observer::treeCount(const QString& base_class_name) {
 }
 
 int Qtilities::Core::Observer::subjectCount(const QString& base_class_name) const {
-    if (base_class_name.isEmpty())
+    if (base_class_name.isEmpty()) {
+        if (readsSubjectSnapshot())
+            return observerData->subjectSnapshot().count();
         return observerData->subject_list.count();
+    }
     else
         return subjectReferences(base_class_name).count();
 }
@@ -1626,6 +2145,13 @@ QObject* Qtilities::Core::Observer::treeAt(int i) const {
     if (i < 0)
         return 0;
 
+    if (treeCacheUsable()) {
+        updateTreeCache();
+        if (i >= observerData->tree_cache.count())
+            return 0;
+        return observerData->tree_cache.at(i);
+    }
+
     QList<QObject*> list = treeChildren(QString(),i);
     if (i >= list.count())
         return 0;
@@ -1634,36 +2160,205 @@ QObject* Qtilities::Core::Observer::treeAt(int i) const {
 }
 
 bool Qtilities::Core::Observer::treeContains(QObject* tree_item) const {
-     return treeChildren().contains(tree_item);
+    if (treeCacheUsable()) {
+        updateTreeCache();
+        if (!observerData->tree_cache_set_valid) {
+            observerData->tree_cache_set.clear();
+            observerData->tree_cache_set.reserve(observerData->tree_cache.count());
+            for (int i = 0; i < observerData->tree_cache.count(); ++i)
+                observerData->tree_cache_set.insert(observerData->tree_cache.at(i));
+            observerData->tree_cache_set_valid = true;
+        }
+        return observerData->tree_cache_set.contains(tree_item);
+    }
+
+    return treeChildren().contains(tree_item);
+}
+
+int Qtilities::Core::Observer::treeGeneration() const {
+    return observerData->tree_generation;
+}
+
+void Qtilities::Core::Observer::invalidateTreeCache() {
+    // The tree of every observer above this observer changed as well. Observers can't be attached to
+    // observers underneath them, but the same observer can be reached through more than one parent:
+    QList<Observer*> pending;
+    QSet<Observer*> visited;
+    pending << this;
+    while (!pending.isEmpty()) {
+        Observer* obs = pending.takeLast();
+        if (visited.contains(obs))
+            continue;
+        visited.insert(obs);
+
+        ++obs->observerData->tree_generation;
+        pending << parentReferences(obs);
+    }
+}
+
+bool Qtilities::Core::Observer::treeCacheUsable() const {
+    // Subjects attached to the global object pool are not aware of it, thus it is not notified when the trees underneath its subjects change.
+    if (objectName() == QLatin1String(qti_def_GLOBAL_OBJECT_POOL))
+        return false;
+    return QThread::currentThread() == thread();
+}
+
+void Qtilities::Core::Observer::updateTreeCache() const {
+    if (observerData->tree_cache_generation == observerData->tree_generation)
+        return;
+
+    observerData->tree_cache = TreeTraversal::collect(this);
+    observerData->tree_cache_set.clear();
+    observerData->tree_cache_set_valid = false;
+    observerData->tree_cache_counts.clear();
+    observerData->tree_cache_generation = observerData->tree_generation;
 }
 
 QList<QObject*> Qtilities::Core::Observer::treeChildren(const QString& iface, int limit, int iterator_id) const {
+    Q_UNUSED(iterator_id)
+
+    bool all_children = iface.isEmpty() || iface == QLatin1String("QObject");
+    if (!treeCacheUsable())
+        return TreeTraversal::collect(this,TreeTraversal::PreOrder,false,all_children ? QString() : iface,limit);
+
+    updateTreeCache();
+    if (all_children && limit == -1)
+        return observerData->tree_cache;
+
     QList<QObject*> children;
     int count = 0;
-
-    TreeIterator itr(this,iterator_id);
-    while (itr.hasNext()) {
-        QObject* obj = itr.next();
-        if (iface.isEmpty()) {
+    QByteArray iface_bytes = iface.toUtf8();
+    for (int i = 0; i < observerData->tree_cache.count(); ++i) {
+        QObject* obj = observerData->tree_cache.at(i);
+        if (all_children || obj->inherits(iface_bytes.constData())) {
             children << obj;
             if (limit != -1) {
                 ++count;
                 if (count > limit)
                     break;
             }
-        } else {
-            if (obj->inherits(iface.toUtf8().data())) {
-                children << obj;
-                if (limit != -1) {
-                    ++count;
-                    if (count > limit)
-                        break;
-                }
+        }
+    }
+    return children;
+}
+
+namespace {
+    using namespace Qtilities::Core;
+
+    // An item in the snapshot of a tree which is visited.
+    struct TreeVisitItem {
+        TreeVisitItem(QObject* item_object = 0, Observer* item_parent = 0) : object(item_object), parent(item_parent) {}
+        QObject*    object;
+        Observer*   parent;
+    };
+
+    // Appends the tree underneath observer in pre-order. Every observer's subjects are taken from a single snapshot.
+    void appendTreeVisitItems(const Observer* observer, QVector<TreeVisitItem>& items) {
+        QList<QObject*> subjects = observer->subjectSnapshot();
+        for (int i = 0; i < subjects.count(); ++i) {
+            items.append(TreeVisitItem(subjects.at(i),const_cast<Observer*> (observer)));
+            Observer* obs = qobject_cast<Observer*> (subjects.at(i));
+            if (obs)
+                appendTreeVisitItems(obs,items);
+        }
+    }
+
+    // The state shared by all threads visiting a tree.
+    struct TreeVisitState {
+        TreeVisitState() : part_size(0),
+            part_count(0),
+            completed_parts_data(0) {}
+
+        QVector<TreeVisitItem>          items;
+        int                             part_size;
+        int                             part_count;
+        QVector<AbstractTreeVisitor*>   partial_visitors;
+        // Parts which were not visited completely because the visit was cancelled are not reduced:
+        QVector<bool>                   completed_parts;
+        bool*                           completed_parts_data;
+        QAtomicInt                      next_part;
+        // Set by a ParallelExportTaskMonitor, thus workers never access the task:
+        QAtomicInt                      cancelled;
+        QSemaphore                      finished_workers;
+
+        bool isCancelled() {
+            return cancelled.fetchAndAddOrdered(0) != 0;
+        }
+
+        // Visits parts until all parts were taken by this or other threads:
+        void visitParts() {
+            int part = next_part.fetchAndAddOrdered(1);
+            while (part < part_count) {
+                if (isCancelled())
+                    return;
+
+                AbstractTreeVisitor* partial_visitor = partial_visitors.at(part);
+                int end = qMin(items.count(),(part + 1) * part_size);
+                for (int i = part * part_size; i < end; ++i)
+                    partial_visitor->visit(items.at(i).object,items.at(i).parent);
+                completed_parts_data[part] = true;
+
+                part = next_part.fetchAndAddOrdered(1);
             }
         }
+    };
+
+    class TreeVisitWorker : public QRunnable {
+    public:
+        TreeVisitWorker(TreeVisitState* state) : QRunnable(), d_state(state) {}
+        void run() {
+            d_state->visitParts();
+            d_state->finished_workers.release();
+        }
+
+    private:
+        TreeVisitState* d_state;
+    };
+}
+
+bool Qtilities::Core::Observer::visitTree(AbstractTreeVisitor* visitor, ITask* task, QThreadPool* thread_pool) const {
+    if (!visitor)
+        return false;
+    if (!thread_pool)
+        thread_pool = QThreadPool::globalInstance();
+
+    TreeVisitState state;
+    // Also checks if the task was already stopped or completed:
+    ParallelExportTaskMonitor task_monitor(task,&state.cancelled);
+    appendTreeVisitItems(this,state.items);
+    if (state.items.isEmpty())
+        return !state.isCancelled();
+
+    // Use a few parts per thread in order to balance subtrees of different sizes between threads:
+    int thread_count = qMax(1,thread_pool->maxThreadCount());
+    state.part_size = qMax(64,state.items.count() / (thread_count * 8));
+    state.part_count = (state.items.count() + state.part_size - 1) / state.part_size;
+    state.partial_visitors.resize(state.part_count);
+    state.completed_parts.fill(false,state.part_count);
+    state.completed_parts_data = state.completed_parts.data();
+    for (int i = 0; i < state.part_count; ++i)
+        state.partial_visitors[i] = visitor->createPartialVisitor();
+
+    // Only use idle threads. If the pool is busy, the calling thread does the work:
+    int started_workers = 0;
+    for (int i = 1; i < qMin(thread_count,state.part_count); ++i) {
+        TreeVisitWorker* worker = new TreeVisitWorker(&state);
+        if (!thread_pool->tryStart(worker)) {
+            delete worker;
+            break;
+        }
+        ++started_workers;
     }
+    state.visitParts();
+    state.finished_workers.acquire(started_workers);
 
-    return children;
+    for (int i = 0; i < state.part_count; ++i) {
+        if (state.completed_parts.at(i) && state.partial_visitors.at(i))
+            visitor->reduce(state.partial_visitors.at(i));
+        delete state.partial_visitors.at(i);
+    }
+
+    return !state.cancelled.fetchAndAddOrdered(0);
 }
 
 QStringList Qtilities::Core::Observer::subjectNames(const QString& iface) const {
@@ -1854,22 +2549,28 @@ QList<Qtilities::Core::QtilitiesCategory> Qtilities::Core::Observer::subjectCate
 }
 
 QObject* Qtilities::Core::Observer::subjectAt(int i) const {
+    if (readsSubjectSnapshot()) {
+        // The snapshot might have changed since the caller got the subject count:
+        QList<QObject*> snapshot = observerData->subjectSnapshot();
+        if (i < 0 || i >= snapshot.count())
+            return 0;
+        return snapshot.at(i);
+    }
     return observerData->subject_list.at(i);
 }
 
 int Qtilities::Core::Observer::subjectID(int i) const {
-    if (i < observerData->subject_list.count()) {
-        QVariant prop = getMultiContextPropertyValue(observerData->subject_list.at(i),qti_prop_OBSERVER_MAP);
-        return prop.toInt();
-    } else
+    if (i < observerData->subject_list.count())
+        return observerData->subject_pointer_index.value(observerData->subject_list.at(i),-1);
+    else
         return -1;
 }
 
 int Qtilities::Core::Observer::subjectID(const QString& subject_name, Qt::CaseSensitivity cs) const {
-    if (containsSubjectWithName(subject_name,cs)) {
-        QVariant prop = getMultiContextPropertyValue(subjectReference(subject_name,cs),qti_prop_OBSERVER_MAP);
-        return prop.toInt();
-    } else
+    QObject* obj = subjectReference(subject_name,cs);
+    if (obj)
+        return observerData->subject_pointer_index.value(obj,-1);
+    else
         return -1;
 }
 
@@ -1877,11 +2578,26 @@ QList<int> Qtilities::Core::Observer::subjectIDs() const {
     QList<int> subject_ids;
     int count = observerData->subject_list.count();
     for (int i = 0; i < count; ++i)
-        subject_ids << getMultiContextPropertyValue(observerData->subject_list.at(i),qti_prop_OBSERVER_MAP).toInt();
+        subject_ids << observerData->subject_pointer_index.value(observerData->subject_list.at(i),-1);
     return subject_ids;
 }
 
 QList<QObject*> Qtilities::Core::Observer::subjectReferences(const QString& iface) const {
+    if (readsSubjectSnapshot()) {
+        QList<QObject*> snapshot = observerData->subjectSnapshot();
+        if (iface.isEmpty())
+            return snapshot;
+
+        QByteArray iface_name = iface.toUtf8();
+        QList<QObject*> subjects;
+        int count = snapshot.count();
+        for (int i = 0; i < count; ++i) {
+            if (snapshot.at(i)->inherits(iface_name.constData()))
+                subjects << snapshot.at(i);
+        }
+        return subjects;
+    }
+
     if (iface.isEmpty())
         return observerData->subject_list.toQList();
 
@@ -1894,6 +2610,40 @@ QList<QObject*> Qtilities::Core::Observer::subjectReferences(const QString& ifac
     return subjects;
 }
 
+void Qtilities::Core::Observer::setConcurrentReadsEnabled(bool enabled) {
+    if (observerData->concurrent_reads_enabled == enabled)
+        return;
+
+    observerData->concurrent_reads_enabled = enabled;
+    if (enabled) {
+        // Publish the current subjects, even when a processing cycle is active:
+        observerData->publishSubjectSnapshot();
+    } else {
+        QWriteLocker locker(&observerData->subject_snapshot_lock);
+        observerData->subject_snapshot.clear();
+    }
+}
+
+bool Qtilities::Core::Observer::concurrentReadsEnabled() const {
+    return observerData->concurrent_reads_enabled;
+}
+
+QList<QObject*> Qtilities::Core::Observer::subjectSnapshot() const {
+    if (readsSubjectSnapshot())
+        return observerData->subjectSnapshot();
+    else
+        return observerData->subject_list.toQList();
+}
+
+void Qtilities::Core::Observer::publishSubjectSnapshot() {
+    if (observerData->concurrent_reads_enabled && !observerData->process_cycle_active)
+        observerData->publishSubjectSnapshot();
+}
+
+bool Qtilities::Core::Observer::readsSubjectSnapshot() const {
+    return observerData->concurrent_reads_enabled && QThread::currentThread() != thread();
+}
+
 QList<QObject*> Qtilities::Core::Observer::subjectReferencesByCategory(const QtilitiesCategory& category) const {
     // Get all subjects which has the qti_prop_CATEGORY_MAP property set to category.
     QList<QObject*> list;
@@ -1949,44 +2699,48 @@ QList<QPointer<Observer> > Observer::subjectObserverReferences() const {
 }
 
 QObject* Qtilities::Core::Observer::subjectReference(int ID) const {
-    int count = observerData->subject_list.count();
-    for (int i = 0; i < count; ++i) {
-        QObject* obj = observerData->subject_list.at(i);
-        QVariant prop = getMultiContextPropertyValue(obj,qti_prop_OBSERVER_MAP);
-        if (!prop.isValid()) {
-            LOG_TRACE(QString("Observer (%1): Looking for subject ID (%2) failed, property 'Subject ID' contains invalid variant for this context.").arg(objectName()).arg(ID));
-            return 0;
-        }
-        if (prop.toInt() == ID)
-            return obj;
-    }
-    return 0;
+    return observerData->subject_id_index.value(ID,0);
 }
 
 QObject* Qtilities::Core::Observer::subjectReference(const QString& subject_name, Qt::CaseSensitivity cs) const {
-    int count = observerData->subject_list.count();
-    for (int i = 0; i < count; ++i) {
-        QObject* obj = observerData->subject_list.at(i);
-        QVariant prop = getMultiContextPropertyValue(obj,qti_prop_NAME);
-        if (!prop.isValid()) {
-            if (obj->objectName().compare(subject_name,cs) == 0)
-                return obj;
-        } else {
-            if (prop.toString().compare(subject_name,cs) == 0)
+    QList<QObject*> candidates;
+    if (cs == Qt::CaseSensitive)
+        candidates = observerData->subject_name_index.value(subject_name);
+    else
+        candidates = observerData->subject_name_index_ci.value(subject_name.toCaseFolded());
+
+    for (int i = 0; i < candidates.count(); ++i) {
+        QObject* obj = candidates.at(i);
+        QString current_name = subjectLookupName(obj);
+        if (current_name.compare(subject_name,cs) == 0)
+            return obj;
+        // The index is stale for this subject, fix it:
+        observerData->reindexSubjectName(obj,current_name);
+    }
+
+    // Names of subjects for which we cannot track name changes might have changed without us knowing about it:
+    if (!observerData->subject_untracked_names.isEmpty()) {
+        int count = observerData->subject_list.count();
+        for (int i = 0; i < count; ++i) {
+            QObject* obj = observerData->subject_list.at(i);
+            if (!observerData->subject_untracked_names.contains(obj))
+                continue;
+
+            QString current_name = subjectLookupName(obj);
+            observerData->reindexSubjectName(obj,current_name);
+            if (current_name.compare(subject_name,cs) == 0)
                 return obj;
         }
     }
+
     return 0;
 }
 
 bool Qtilities::Core::Observer::contains(const QObject* object) const {
-    int count = observerData->subject_list.count();
-    for (int i = 0; i < count; ++i) {
-        if (observerData->subject_list.at(i) == object)
-            return true;
-    }
+    if (!object)
+        return false;
 
-    return false;
+    return observerData->subject_pointer_index.contains(object);
 }
 
 bool Qtilities::Core::Observer::containsSubjectWithName(const QString& subject_name, Qt::CaseSensitivity cs) const {
@@ -2011,7 +2765,9 @@ bool Qtilities::Core::Observer::installSubjectFilter(AbstractSubjectFilter* subj
     observerData->subject_filters.append(subject_filter);
 
     // Set the observer context of the filter
-    if (!subject_filter->setObserverContext(this)) {
+    bool context_set = subject_filter->setObserverContext(this);
+    rebuildPropertyDispatchTable();
+    if (!context_set) {
         LOG_ERROR(QString(tr("Observer (%1): Subject filter installation failed. Setting the observer context on the subject filter failed.")).arg(objectName()));
         return false;
     }
@@ -2042,6 +2798,7 @@ bool Qtilities::Core::Observer::uninstallSubjectFilter(AbstractSubjectFilter* su
     }
 
     observerData->subject_filters.removeOne(subject_filter);
+    rebuildPropertyDispatchTable();
     subject_filter->disconnect(this);
     delete subject_filter;
     subject_filter = 0;
@@ -2093,12 +2850,25 @@ Qtilities::Core::ObserverHints* Qtilities::Core::Observer::useDisplayHints() {
 bool Qtilities::Core::Observer::eventFilter(QObject *object, QEvent *event) {
 //    if (observerName() != "qti.def.ObjectPool")
 //        qDebug() << "Observer::eventFilter(): " << observerName() << ", filter subject events enabled: " << observerData->filter_subject_events_enabled;
+    // The subject lookup index must follow name changes, even when subject event filtering is disabled:
+    if (event->type() == QEvent::DynamicPropertyChange) {
+        if (!qstrcmp(static_cast<QDynamicPropertyChangeEvent *>(event)->propertyName().data(),qti_prop_NAME))
+            observerData->reindexSubjectName(object,subjectLookupName(object));
+    }
+
     if ((event->type() == QEvent::DynamicPropertyChange) && observerData->filter_subject_events_enabled) {
         // Get the event in the correct format
         QDynamicPropertyChangeEvent* propertyChangeEvent = static_cast<QDynamicPropertyChangeEvent *>(event);
 
+        // Properties which are not reserved or monitored in this context don't have entries in the dispatch table:
+        QHash<QByteArray,PropertyDispatchEntry>::const_iterator dispatch_itr = observerData->property_dispatch_table.constFind(propertyChangeEvent->propertyName());
+        if (dispatch_itr == observerData->property_dispatch_table.constEnd())
+            return false;
+        // Copy the entry, the table might be rebuilt by the subject filters handling the change:
+        const PropertyDispatchEntry dispatch_entry = dispatch_itr.value();
+
         // First check is to see if it is a reserved property. In that case we filter it directly.
-        if (reservedProperties().contains(QString(propertyChangeEvent->propertyName().data()))) {
+        if (dispatch_entry.reserved) {
             QList<QObject*> filtered_list;
             filtered_list << object;
             emit propertyChangeFiltered(propertyChangeEvent->propertyName().data(),filtered_list);
@@ -2106,7 +2876,7 @@ bool Qtilities::Core::Observer::eventFilter(QObject *object, QEvent *event) {
         }
 
         // Next check if it is a monitored property.
-        if (monitoredProperties().contains(QString(propertyChangeEvent->propertyName().data()))) {
+        if (dispatch_entry.monitored) {
             // Handle changes from different threads:
             if (!observerData->filter_subject_events_enabled) {
                 QList<QObject*> filtered_list;
@@ -2117,18 +2887,14 @@ bool Qtilities::Core::Observer::eventFilter(QObject *object, QEvent *event) {
 
             observerData->filter_subject_events_enabled = false;
 
-            // We now route the event that changed to the subject filter responsible for this property to validate the change.
+            // We now route the event that changed to the subject filters responsible for this property to validate the change.
             // If no subject filter is responsible, the observer needs to handle it itself.
             QPointer<QObject> safe_object = object;
             bool filter_event = false;
-            for (int i = 0; i < observerData->subject_filters.count(); ++i) {
-                if (observerData->subject_filters.at(i)) {
-                    if (observerData->subject_filters.at(i)->monitoredProperties().contains(QString(propertyChangeEvent->propertyName().data()))) {
-                        bool int_filter_event = observerData->subject_filters.at(i)->handleMonitoredPropertyChange(object, propertyChangeEvent->propertyName().data(),propertyChangeEvent);
-                        if (!filter_event && int_filter_event)
-                            filter_event = true;
-                    }
-                }
+            for (int i = 0; i < dispatch_entry.filters.count(); ++i) {
+                bool int_filter_event = dispatch_entry.filters.at(i)->handleMonitoredPropertyChange(object, propertyChangeEvent->propertyName().data(),propertyChangeEvent);
+                if (!filter_event && int_filter_event)
+                    filter_event = true;
             }
             if (!safe_object)
                 return true;
@@ -2163,18 +2929,11 @@ bool Qtilities::Core::Observer::eventFilter(QObject *object, QEvent *event) {
                 emit monitoredPropertyChanged(propertyChangeEvent->propertyName(),changed_objects);
 
                 // 3. For specific role properties, we need to notify views that the data changed:
-                if ((!qstrcmp(propertyChangeEvent->propertyName().data(),qti_prop_DECORATION)) ||
-                    (!qstrcmp(propertyChangeEvent->propertyName().data(),qti_prop_FOREGROUND)) ||
-                    (!qstrcmp(propertyChangeEvent->propertyName().data(),qti_prop_BACKGROUND)) ||
-                    (!qstrcmp(propertyChangeEvent->propertyName().data(),qti_prop_TEXT_ALIGNMENT)) ||
-                    (!qstrcmp(propertyChangeEvent->propertyName().data(),qti_prop_FONT)) ||
-                    (!qstrcmp(propertyChangeEvent->propertyName().data(),qti_prop_SIZE_HINT))) {
-
+                if (dispatch_entry.refreshes_data)
                     refreshViewsData();
-                }
 
                 // 4. For specific role properties, we need to notify views that layout changed:
-                if (!qstrcmp(propertyChangeEvent->propertyName().data(),qti_prop_CATEGORY_MAP)) {
+                if (dispatch_entry.refreshes_layout) {
                     // Get the property and check its last changed context:
                     MultiContextProperty prop = ObjectManager::getMultiContextProperty(object,qti_prop_CATEGORY_MAP);
                     if (prop.isValid()) {
@@ -2308,34 +3067,11 @@ QList<Qtilities::Core::Observer*> Qtilities::Core::Observer::observerList(QList<
 }
 
 int Qtilities::Core::Observer::parentCount(const QObject* obj) {
-    if (!obj)
-        return -1;
-
-    MultiContextProperty prop = ObjectManager::getMultiContextProperty(obj, Qtilities::Core::Properties::qti_prop_OBSERVER_MAP);
-    if (prop.isValid()) {
-        return prop.contextMap().count();
-    }
-
-    return 0;
+    return ObjectManager::parentObserverCount(obj);
 }
 
 QList<Qtilities::Core::Observer*> Qtilities::Core::Observer::parentReferences(const QObject* obj) {
-    QList<Observer*> parents;
-    if (!obj)
-        return parents;
-
-    MultiContextProperty prop = ObjectManager::getMultiContextProperty(obj, Qtilities::Core::Properties::qti_prop_OBSERVER_MAP);
-    if (prop.isValid()) {
-        int count = prop.contextMap().count();
-        QList<quint32> parent_ids = prop.contextMap().keys();
-        for (int i = 0; i < count; ++i) {
-            Observer* obs = OBJECT_MANAGER->observerReference(parent_ids.at(i));
-            if (obs)
-                parents << obs;
-        }
-    }
-
-    return parents;
+    return ObjectManager::parentObservers(obj);
 }
 
 bool Qtilities::Core::Observer::isSupportedType(const QString& meta_type, Observer* observer) {
@@ -2366,6 +3102,10 @@ void Qtilities::Core::Observer::deleteObject(QObject* object) {
     if ((ObjectDeletionPolicy) observerData->object_deletion_policy == DeleteLater) {
         observerData->subject_list.removeOne(object);
         observerData->subject_observer_list.removeOne(object);
+        observerData->unindexSubject(object);
+        ObjectManager::removeParentObserver(object,this);
+        invalidateTreeCache();
+        publishSubjectSnapshot();
         object->deleteLater();
     } else if ((ObjectDeletionPolicy) observerData->object_deletion_policy == DeleteImmediately) {
         // The destroyed() signal on the object will cause it to be removed from the subject_list immediately.
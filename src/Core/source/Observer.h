@@ -31,9 +31,12 @@
 #include <QList>
 #include <QStringList>
 
+class QThreadPool;
+
 namespace Qtilities {
     namespace Core {
         class AbstractSubjectFilter;
+        class AbstractTreeVisitor;
         class ObserverMimeData;
 
         using namespace Qtilities::Core::Interfaces;
@@ -492,6 +495,13 @@ In this example \p observerA will be deleted as soon as \p object1 is deleted.
             // --------------------------------
             ExportModeFlags supportedFormats() const;
             InstanceFactoryInfo instanceFactoryInfo() const;
+            /*!
+              Observers support concurrent exports when all exportable objects in the tree underneath them support concurrent exports
+              and none of these objects are observed in more than one context.
+
+              \sa ObserverData::concurrentExportTreeSize()
+              */
+            virtual bool supportsConcurrentExport() const;
             virtual void setExportVersion(Qtilities::ExportVersion version);
             virtual void setExportTask(ITask* task);
             virtual void clearExportTask();
@@ -520,12 +530,21 @@ In this example \p observerA will be deleted as soon as \p object1 is deleted.
               \note This function does not call detachAll() before doing the import.
               */
             virtual IExportable::ExportResultFlags importXml(QDomDocument* doc, QDomElement* object_node, QList<QPointer<QObject> >& import_list);
+            virtual IExportable::ExportResultFlags exportXmlStream(QXmlStreamWriter& writer) const;
+            /*!
+              Subjects are reconstructed in the same way as importXml(), except that the category of a subject is set after its importXml() function was called.
+
+              \note This function does not call detachAll() before doing the import.
+              */
+            virtual IExportable::ExportResultFlags importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list);
 
             // --------------------------------
             // IExportableObserver Implementation
             // --------------------------------
             virtual IExportable::ExportResultFlags exportBinaryExt(QDataStream& stream, ObserverData::ExportItemFlags export_flags = ObserverData::ExportData) const;
             virtual IExportable::ExportResultFlags exportXmlExt(QDomDocument* doc, QDomElement* object_node, ObserverData::ExportItemFlags export_flags = ObserverData::ExportData) const;
+            virtual IExportable::ExportResultFlags exportXmlStreamExt(QXmlStreamWriter& writer, ObserverData::ExportItemFlags export_flags = ObserverData::ExportData) const;
+            virtual IExportable::ExportResultFlags importXmlStreamExt(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list, QtilitiesCategory* item_category = 0);
 
             // --------------------------------
             // IModificationNotifier Implementation
@@ -674,6 +693,80 @@ obs.endProcessingCycle(); // Internal count = 0;
               \sa startTreeProcessingCycle(), endProcessingCycle(), subjectEventFilteringEnabled(), toggleSubjectEventFiltering(), isProcessingCycleActive(), processingCycleStarted()
               */
             virtual void endTreeProcessingCycle(bool broadcast = true);
+            //! Enables or disables deferred change notifications on this observer.
+            /*!
+              By default the observer emits its change notification signals as soon as a change happens outside of a processing cycle. Attaching
+              many subjects one by one, or changes in many observers underneath this observer, therefore cause many refreshes in views showing this
+              observer. When deferred change notifications are enabled, changes are collected in a change set instead, and the notifications
+              for all the changes in the change set are emitted together when control returns to the event loop, or after \p latency
+              milliseconds when specified. This works like a processing cycle which is started by the first change and ended automatically.
+
+              When the change set is flushed, the observer emits:
+              - modificationStateChanged() when the modification state of the observer differs from its state before the first change.
+              - numberOfSubjectsChanged() once with all attached and detached subjects. The change indication is Observer::CyclicProcess when subjects were attached and detached.
+              - layoutChanged() once when subjects were attached or detached, or when refreshViewsLayout() was called. Otherwise dataChanged() once for every changed observer.
+              - deferredNotificationsFlushed() with the complete change set.
+
+              The layoutChanged() and dataChanged() signals of observers attached to this observer are forwarded through this observer and are
+              collected in the change set as well. Thus when deferred change notifications are enabled on the top level observer of a tree, views connected
+              to the top level observer refresh once for all changes in the tree.
+
+              Changes made during processing cycles are handled by the processing cycle as before. Disabling deferred notifications flushes the pending change set.
+
+              \param enabled True to enable deferred notifications, false to disable them.
+              \param latency The time in milliseconds for which changes are collected. When 0, changes are collected until control returns to the event loop.
+
+              \note The notifications are emitted from the event loop of the thread in which the observer lives, thus deferred notifications require a running event loop.
+
+              \sa flushDeferredNotifications(), startProcessingCycle()
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            void setDeferredNotificationsEnabled(bool enabled, int latency = 0);
+            //! Indicates if deferred change notifications are enabled. \sa setDeferredNotificationsEnabled()
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            bool deferredNotificationsEnabled() const;
+            //! The time in milliseconds for which changes are collected when deferred change notifications are enabled. \sa setDeferredNotificationsEnabled()
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            int deferredNotificationLatency() const;
+            //! Indicates if changes are waiting to be notified. \sa setDeferredNotificationsEnabled()
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            bool hasPendingNotifications() const;
+        public slots:
+            //! Emits the notifications for the pending change set right away. Does nothing when no changes are pending.
+            /*!
+              When a processing cycle is active, the change set is flushed when the processing cycle ends.
+
+              \sa setDeferredNotificationsEnabled()
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            void flushDeferredNotifications();
+        private slots:
+            //! Forwards or collects the dataChanged() signal of an observer attached to this observer.
+            void handle_subjectObserverDataChanged(Observer* observer);
+            //! Forwards or collects the layoutChanged() signal of an observer attached to this observer.
+            void handle_subjectObserverLayoutChanged(const QList<QPointer<QObject> >& new_selection);
+        signals:
+            //! Signal which is emitted when a change set collected while deferred change notifications are enabled is flushed.
+            /*!
+              \param added The subjects which were attached.
+              \param removed The subjects which were detached. Null items indicate subjects which were deleted.
+              \param changed The objects of which the data changed. Subjects which were detached and attached again are also reported as changed.
+
+              \sa setDeferredNotificationsEnabled()
+
+              <i>This signal was added in %Qtilities v1.5.</i>
+              */
+            void deferredNotificationsFlushed(QList<QPointer<QObject> > added, QList<QPointer<QObject> > removed, QList<QPointer<QObject> > changed);
+
+        public:
 
             // --------------------------------
             // Functions to attach / detach subjects
@@ -697,7 +790,12 @@ obs.endProcessingCycle(); // Internal count = 0;
             virtual bool attachSubject(QObject* obj, Observer::ObjectOwnership ownership = Observer::ManualOwnership, QString* rejectMsg = 0, bool import_cycle = false);
             //! Will attempt to attach the specified objects to the observer.
             /*!
-              This function will call startProcessingCycle() when it starts and endProcessingCycle() when it is done.
+              This function will call startProcessingCycle() when it starts and endProcessingCycle() when it is done. When no processing cycle was
+              active before the call, numberOfSubjectsChanged() and layoutChanged() are emitted once afterwards with all the attached objects.
+
+              When all installed subject filters support batch operations (see AbstractSubjectFilter::supportsBatchOperations()), the objects are
+              attached as a single batch: each filter initializes and finalizes all objects in one call and the subject list grows once. Otherwise
+              each object is attached using attachSubject().
 
               \param objects A list of objects which must be attached.
               \param ownership The ownership that the observer should use to manage the object. The default is Observer::ManualOwnership.
@@ -762,6 +860,10 @@ obs.endProcessingCycle(); // Internal count = 0;
              * it has SpecificObserverOwnership set to this Observer, or when it has ObserverScopeOwnership and this
              * is the last observer that it is attached to. Note that the deletion method used depends on the
              * objectDeletionPolicy() of this observer.
+             *
+             * When all installed subject filters support batch operations (see AbstractSubjectFilter::supportsBatchOperations()), the objects are
+             * detached as a single batch and removed from the subject list in a single pass. When no processing cycle was active before the call,
+             * numberOfSubjectsChanged() is emitted once afterwards with all the detached objects which were not deleted.
              *
               \param objects A list of objects which must be detached.
               \param rejectMsg When this function fails and rejectMsg will be populated with an rejection message when valid.
@@ -786,6 +888,8 @@ obs.endProcessingCycle(); // Internal count = 0;
         private slots:
             //! Will handle an object which has been deleted somewhere else in the application.
             void handle_deletedSubject(QObject* obj);
+            //! Keeps the subject lookup index up to date when the objectName() of a subject changes.
+            void handle_subjectObjectNameChanged();
         signals:
             //! Will be emitted when a subject is deleted.
             void subjectDeleted(QObject* obj);
@@ -816,11 +920,15 @@ obs.endProcessingCycle(); // Internal count = 0;
             static QList<Observer*> observerList(QList<QPointer<QObject> >& object_list);
             //! Convenience function to get the number of observers observing the specified object. Thus the number of parents of this object.
             /*!
+              Since %Qtilities v1.5 this is a constant time lookup in the parent observer index of the object manager, see ObjectManager::parentObserverCount().
+
               \sa parentReferences()
               */
             static int parentCount(const QObject* obj);
             //! Convenience function to get the a list of parent observers for this object.
             /*!
+              The observers are sorted on their observer IDs. Since %Qtilities v1.5 the observers are taken from the parent observer index of the object manager, see ObjectManager::parentObservers().
+
               \sa parentCount()
               */
             static QList<Observer*> parentReferences(const QObject* obj);
@@ -833,6 +941,39 @@ obs.endProcessingCycle(); // Internal count = 0;
         private:
             //! This function will remove all the properties which this observer might have added to an obj.
             void removeQtilitiesProperties(QObject* obj);
+            //! Adds a subject which was just appended to the subject list to the subject lookup index.
+            void indexSubject(QObject* obj, int subject_id, bool event_filter_installed);
+            //! Returns the name of a subject as used by the name based subject lookup functions.
+            /*!
+              This is the value of the qti_prop_NAME property when the subject has it, otherwise the objectName() of the subject.
+              */
+            QString subjectLookupName(const QObject* obj) const;
+            //! Adds an object which passed all subject filters to this context: sets its observer properties, handles its ownership and appends it to the subject list.
+            void addSubjectToContext(QObject* obj, Observer::ObjectOwnership object_ownership);
+            //! Returns true when all installed subject filters support batch operations, see AbstractSubjectFilter::supportsBatchOperations().
+            bool subjectFiltersSupportBatchOperations() const;
+            //! Ends the processing cycle started by a batch operation and emits a single change notification for all \p objects when \p broadcast is true.
+            void endBatchProcessingCycle(bool broadcast, Observer::SubjectChangeIndication change_indication, const QList<QPointer<QObject> >& objects);
+            //! Publishes a new subject snapshot for concurrent readers when concurrent reads are enabled and no processing cycle is active.
+            void publishSubjectSnapshot();
+            //! Returns true when the calling thread must read the subject snapshot instead of the subject list itself.
+            bool readsSubjectSnapshot() const;
+            //! Rebuilds the property dispatch table used by eventFilter() from the reserved and monitored properties of this observer and its subject filters.
+            void rebuildPropertyDispatchTable();
+            //! Changes the tree generation of this observer and all observers above it, which invalidates their tree caches.
+            void invalidateTreeCache();
+            //! Returns true when the tree functions can use the tree cache of this observer in the calling thread.
+            bool treeCacheUsable() const;
+            //! Rebuilds the tree cache when the tree changed since it was built.
+            void updateTreeCache() const;
+            //! Adds the change about to happen to the pending change set when deferred notifications are enabled and no processing cycle is active.
+            /*!
+              Schedules a flush when this is the first change in the change set.
+
+              \param modification_state_before_change The modification state of the observer before the change.
+              \returns True when the notifications for the change must be deferred, false when they must be emitted as usual.
+              */
+            bool deferChangeNotifications(bool modification_state_before_change);
 
         public:
             // --------------------------------
@@ -929,13 +1070,47 @@ obs.endProcessingCycle(); // Internal count = 0;
             QObject* treeAt(int i) const;
             //! Function to check if a specific AbstractTreeItem is contained in the tree underneath this node.
             bool treeContains(QObject* tree_item) const;
+            //! Returns the structural generation of the tree underneath this observer.
+            /*!
+              The generation changes every time a subject is attached to, detached from or deleted in this observer or any observer in the tree
+              underneath it. treeCount(), treeAt(), treeContains() and treeChildren() share a flattened copy of the tree which is built the first time it is needed
+              and reused until the generation changes. Thus, repeated calls to these functions on a tree which did not change do not iterate through the tree.
+
+              The generation can be used to check if the structure of a tree changed since it was last inspected.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            int treeGeneration() const;
+            //! Visits all items in the tree underneath this observer in parallel.
+            /*!
+              Takes a snapshot of the tree underneath this observer, divides it into parts and visits the parts on \p thread_pool.
+              Every part is visited by a partial visitor created by \p visitor, and the results of the partial visitors are combined in \p visitor
+              in the order in which the parts appear in the tree. Threads take the next unvisited part as soon as they are done with a part, thus
+              trees with subtrees of very different sizes keep all threads busy. The calling thread visits parts as well and this function only
+              returns when the complete tree was visited, or the visit was cancelled.
+
+              Since the snapshot of every observer is taken using subjectSnapshot(), observers with concurrent reads enabled can be visited from
+              any thread while the thread in which they live keeps changing them. The snapshot only protects the structure of the tree: objects
+              in the tree must not be deleted while it is visited.
+
+              \param visitor The visitor. See AbstractTreeVisitor for details.
+              \param task When specified, the visit is cancelled as soon as the task is stopped or completed. The task must be started before calling this function.
+              \param thread_pool The thread pool to use. When 0, QThreadPool::globalInstance() is used. Only idle threads in the pool are used, thus
+              this function can be called from threads in the pool itself.
+              \returns True when the complete tree was visited, false when the visit was cancelled.
+
+              \note This observer itself is not visited.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            bool visitTree(AbstractTreeVisitor* visitor, ITask* task = 0, QThreadPool* thread_pool = 0) const;
             //! Function to get the QObject references of all items in the tree underneath this observer.
             /*!
               Returns a list of QObjects* in tree underneath this observer where the list is populated in the same order in which Qtilities::Core::TreeIterator iterates through the tree.
 
               \param base_class_name The name of the base class of children you are looking for. By default, all children underneath this observer is returned.
               \param limit When defined, the tree children will be search up until the limit count is reached. This allows you to stop when a tree gets too big. By default all children are returned.
-              *\param iterator_id Internal iterator ID. You should never use this directly.
+              *\param iterator_id Not used since %Qtilities v1.5, tree traversals do not set properties on the items in the tree anymore.
 
               For example:
 
@@ -982,6 +1157,49 @@ QVERIFY(items_verify.count() == 5);
             QList<int> subjectIDs() const;
             //! Returns a list with the subject references of all the observed subjects which inherits a specific base class. If you don't specify an interface, all QObjects in the observer are returned.
             QList<QObject*> subjectReferences(const QString& base_class_name = QString()) const;
+            //! Enables or disables concurrent reads on this observer.
+            /*!
+              By default observers are not thread safe: reading the subjects of an observer from a worker thread while the thread in which the observer
+              lives changes its subjects is unsafe. When concurrent reads are enabled, the observer publishes an immutable snapshot of its subject list
+              every time the list changes. When a processing cycle is active, a single snapshot is published when the processing cycle ends.
+
+              Calls to subjectAt(), subjectCount() and subjectReferences() made from threads other than the thread in which the observer lives
+              operate on the last published snapshot, and never block the thread in which the observer lives for longer than the time it takes to swap
+              the snapshot. Note that subjectCount() and subjectAt() can see different snapshots when they are called one after the other,
+              in which case subjectAt() returns 0 for positions that are out of range. Readers which need a consistent view of the subjects must
+              get it once using subjectSnapshot().
+
+              \note The snapshot protects the subject list, not the subjects themselves. Readers are responsible for making sure that the subjects they
+              access are not deleted while they use them, for example by checking them through QPointer.
+
+              Concurrent reads must be enabled from the thread in which the observer lives, before other threads start reading the observer.
+
+              \sa concurrentReadsEnabled(), subjectSnapshot()
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            void setConcurrentReadsEnabled(bool enabled);
+            //! Indicates if concurrent reads are enabled on this observer.
+            /*!
+              False by default.
+
+              \sa setConcurrentReadsEnabled()
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            bool concurrentReadsEnabled() const;
+            //! Returns a consistent list of all subjects in this observer which is safe to get from any thread when concurrent reads are enabled.
+            /*!
+              When concurrent reads are enabled and this function is called from a thread other than the thread in which the observer lives, the last
+              published snapshot is returned. In all other cases the current subjects are returned, the same as subjectReferences().
+
+              Since the returned list is implicitly shared with the snapshot, getting it does not copy the subject list.
+
+              \sa setConcurrentReadsEnabled()
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            QList<QObject*> subjectSnapshot() const;
             //! Return a QMap with references to all subjects as keys with the names used for the subjects in this context as values.
             QMap<QPointer<QObject>, QString> subjectMap();
             //! Returns a list of observers under this observer.
@@ -1113,7 +1331,8 @@ QVERIFY(items_verify.count() == 5);
               When property changes are valid, the monitoredPropertyChanged() signal is emitted as soon as the property change
               is completed.
 
-              \note The list of monitored properties includes monitored properties of any installed subject filters.
+              \note The list of monitored properties includes monitored properties of any installed subject filters. The monitored
+              properties of a subject filter are captured when it is installed, thus subject filters must not change them afterwards.
 
               \sa monitoredPropertyChanged(), toggleSubjectEventFiltering(), propertyChangeFiltered()
               */
@@ -1124,7 +1343,8 @@ QVERIFY(items_verify.count() == 5);
               these properties. To check if a property is reserved, see the \p Permission attribute in the property documentation.
               All %Qtilities properties are defined in the Qtilities::Core::Properties namespace.
 
-              \note The list of reserved properties includes reserved properties of any installed subject filters.
+              \note The list of reserved properties includes reserved properties of any installed subject filters. The reserved
+              properties of a subject filter are captured when it is installed, thus subject filters must not change them afterwards.
 
               \sa propertyChangeFiltered()
               */
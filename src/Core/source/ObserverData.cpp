@@ -15,15 +15,96 @@
 #include "ActivityPolicyFilter.h"
 #include "ObserverRelationalTable.h"
 #include "ITask.h"
+#include "ParallelExport.h"
 
 #include <stdio.h>
 #include <time.h>
 
 #include <QDomElement>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <QThreadStorage>
 
 using namespace Qtilities::Core::Interfaces;
 
 quint32 MARKER_OBS_DATA_SECTION = 0xDEADBEEF;
+// Subtrees underneath observers with fewer exportable objects than this are not worth exporting in another thread:
+int PARALLEL_EXPORT_MIN_TREE_SIZE = 256;
+
+namespace {
+    typedef QHash<const Qtilities::Core::Observer*,int> ExportTreeSizes;
+
+    // The sizes of the subtrees in the tree of which a binary export is busy in the current thread, 0 when no export is busy:
+    struct CurrentExportTreeSizes {
+        CurrentExportTreeSizes() : tree_sizes(0) {}
+        const ExportTreeSizes* tree_sizes;
+    };
+    QThreadStorage<CurrentExportTreeSizes*> current_export_tree_sizes;
+
+    const ExportTreeSizes* currentExportTreeSizes() {
+        if (!current_export_tree_sizes.hasLocalData())
+            current_export_tree_sizes.setLocalData(new CurrentExportTreeSizes);
+        return current_export_tree_sizes.localData()->tree_sizes;
+    }
+
+    // Returns the previous tree sizes of the current thread, which must be restored when the export is done:
+    const ExportTreeSizes* setCurrentExportTreeSizes(const ExportTreeSizes* tree_sizes) {
+        const ExportTreeSizes* previous_tree_sizes = currentExportTreeSizes();
+        current_export_tree_sizes.localData()->tree_sizes = tree_sizes;
+        return previous_tree_sizes;
+    }
+
+    // Provides the subtree sizes used to decide which subject observers are exported in parallel. The sizes of the complete tree are
+    // computed once by the observer at the top of the export, and used by the exports of all observers underneath it.
+    class ExportTreeSizesScope {
+    public:
+        ExportTreeSizesScope(const Qtilities::Core::Observer* observer) : d_observer(observer), d_owner(false) {}
+        ~ExportTreeSizesScope() {
+            if (d_owner)
+                setCurrentExportTreeSizes(0);
+        }
+
+        int treeSize(const Qtilities::Core::Observer* obs) {
+            const ExportTreeSizes* tree_sizes = currentExportTreeSizes();
+            if (!tree_sizes) {
+                Qtilities::Core::ObserverData::concurrentExportTreeSize(d_observer,&d_tree_sizes);
+                setCurrentExportTreeSizes(&d_tree_sizes);
+                tree_sizes = &d_tree_sizes;
+                d_owner = true;
+            }
+            return tree_sizes->value(obs,-1);
+        }
+
+    private:
+        const Qtilities::Core::Observer* d_observer;
+        ExportTreeSizes d_tree_sizes;
+        bool d_owner;
+    };
+
+    // Exports the subtree underneath a subject observer during binary exports.
+    class ObserverSubtreeExportPart : public Qtilities::Core::AbstractExportPart {
+    public:
+        ObserverSubtreeExportPart(IExportableObserver* export_iface_obs, Qtilities::Core::ObserverData::ExportItemFlags export_flags, const ExportTreeSizes* tree_sizes) :
+            d_export_iface_obs(export_iface_obs),
+            d_export_flags(export_flags),
+            d_tree_sizes(tree_sizes) {}
+
+        bool isThreadSafe() const { return true; }
+        IExportable::ExportResultFlags exportPart(QDataStream& stream, ITask* task) {
+            Q_UNUSED(task)
+            // Parts exported in other threads use the tree sizes of the observer which started the export:
+            const ExportTreeSizes* previous_tree_sizes = setCurrentExportTreeSizes(d_tree_sizes);
+            IExportable::ExportResultFlags result = d_export_iface_obs->exportBinaryExt(stream,d_export_flags);
+            setCurrentExportTreeSizes(previous_tree_sizes);
+            return result;
+        }
+
+    private:
+        IExportableObserver* d_export_iface_obs;
+        Qtilities::Core::ObserverData::ExportItemFlags d_export_flags;
+        const ExportTreeSizes* d_tree_sizes;
+    };
+}
 
 void Qtilities::Core::ObserverData::setExportVersion(Qtilities::ExportVersion version) {
     IExportable::setExportVersion(version);
@@ -83,10 +164,169 @@ void Qtilities::Core::ObserverData::clearExportTask() {
     IExportable::clearExportTask();
 }
 
+void Qtilities::Core::ObserverData::indexSubject(QObject* obj, int subject_id, const QString& name, bool name_tracked) {
+    if (!obj)
+        return;
+
+    subject_pointer_index[obj] = subject_id;
+    if (subject_id >= 0)
+        subject_id_index[subject_id] = obj;
+
+    subject_indexed_names[obj] = name;
+    subject_name_index[name].append(obj);
+    subject_name_index_ci[name.toCaseFolded()].append(obj);
+
+    if (!name_tracked)
+        subject_untracked_names.insert(obj);
+}
+
+void Qtilities::Core::ObserverData::unindexSubject(QObject* obj) {
+    QHash<const QObject*,int>::iterator itr = subject_pointer_index.find(obj);
+    if (itr == subject_pointer_index.end())
+        return;
+
+    if (itr.value() >= 0)
+        subject_id_index.remove(itr.value());
+    subject_pointer_index.erase(itr);
+
+    removeIndexedName(obj,subject_indexed_names.take(obj));
+    subject_untracked_names.remove(obj);
+}
+
+void Qtilities::Core::ObserverData::reindexSubjectName(QObject* obj, const QString& new_name) {
+    QHash<const QObject*,QString>::iterator itr = subject_indexed_names.find(obj);
+    if (itr == subject_indexed_names.end())
+        return;
+    if (itr.value() == new_name)
+        return;
+
+    removeIndexedName(obj,itr.value());
+    itr.value() = new_name;
+    subject_name_index[new_name].append(obj);
+    subject_name_index_ci[new_name.toCaseFolded()].append(obj);
+}
+
+void Qtilities::Core::ObserverData::publishSubjectSnapshot() {
+    // Build the new version outside the lock, readers only wait for the swap:
+    QList<QObject*> new_snapshot = subject_list.toQList();
+    QWriteLocker locker(&subject_snapshot_lock);
+    subject_snapshot = new_snapshot;
+}
+
+QList<QObject*> Qtilities::Core::ObserverData::subjectSnapshot() const {
+    QReadLocker locker(&subject_snapshot_lock);
+    return subject_snapshot;
+}
+
+bool Qtilities::Core::DeferredObjectSet::contains(const QObject* obj) const {
+    if (!obj)
+        return false;
+    QHash<const QObject*,int>::const_iterator itr = index.constFind(obj);
+    // The address of a deleted object can be reused by a new object, thus the guarded pointer is compared as well:
+    return itr != index.constEnd() && items.at(itr.value()).data() == obj;
+}
+
+void Qtilities::Core::DeferredObjectSet::append(QObject* obj, bool allow_null) {
+    if (!obj) {
+        if (allow_null) {
+            items << QPointer<QObject>();
+            removed << false;
+        }
+        return;
+    }
+    if (contains(obj))
+        return;
+
+    index[obj] = items.count();
+    items << obj;
+    removed << false;
+}
+
+void Qtilities::Core::DeferredObjectSet::append(const QList<QPointer<QObject> >& objects) {
+    for (int i = 0; i < objects.count(); ++i)
+        append(objects.at(i).data());
+}
+
+bool Qtilities::Core::DeferredObjectSet::remove(const QObject* obj) {
+    if (!contains(obj))
+        return false;
+    removed[index.take(obj)] = true;
+    return true;
+}
+
+QList<QPointer<QObject> > Qtilities::Core::DeferredObjectSet::objects() const {
+    QList<QPointer<QObject> > result;
+    for (int i = 0; i < items.count(); ++i) {
+        if (!removed.at(i))
+            result << items.at(i);
+    }
+    return result;
+}
+
+void Qtilities::Core::DeferredObjectSet::clear() {
+    items.clear();
+    removed.clear();
+    index.clear();
+}
+
+void Qtilities::Core::ObserverData::recordDeferredAddition(QObject* obj) {
+    if (deferred_removed.remove(obj)) {
+        // Detached and attached again, for listeners the subject only changed:
+        recordDeferredDataChange(obj);
+    } else {
+        deferred_added.append(obj);
+    }
+
+    deferred_layout_selection.append(obj);
+    deferred_layout_changed = true;
+}
+
+void Qtilities::Core::ObserverData::recordDeferredRemoval(QObject* obj) {
+    // Attached and detached again, listeners never saw the subject:
+    if (!deferred_added.remove(obj))
+        deferred_removed.append(obj,true);
+
+    deferred_layout_selection.remove(obj);
+    deferred_changed.remove(obj);
+    deferred_layout_changed = true;
+}
+
+void Qtilities::Core::ObserverData::recordDeferredDataChange(QObject* obj) {
+    deferred_changed.append(obj);
+}
+
+void Qtilities::Core::ObserverData::clearDeferredNotifications() {
+    deferred_notifications_pending = false;
+    deferred_added.clear();
+    deferred_removed.clear();
+    deferred_changed.clear();
+    deferred_layout_selection.clear();
+    deferred_layout_changed = false;
+    deferred_modification_state_changed = false;
+    deferred_modification_state_forced = false;
+}
+
+void Qtilities::Core::ObserverData::removeIndexedName(QObject* obj, const QString& name) {
+    QHash<QString,QList<QObject*> >::iterator name_itr = subject_name_index.find(name);
+    if (name_itr != subject_name_index.end()) {
+        name_itr.value().removeOne(obj);
+        if (name_itr.value().isEmpty())
+            subject_name_index.erase(name_itr);
+    }
+
+    name_itr = subject_name_index_ci.find(name.toCaseFolded());
+    if (name_itr != subject_name_index_ci.end()) {
+        name_itr.value().removeOne(obj);
+        if (name_itr.value().isEmpty())
+            subject_name_index_ci.erase(name_itr);
+    }
+}
+
 Qtilities::Core::Interfaces::IExportable::ExportModeFlags Qtilities::Core::ObserverData::supportedFormats() const {
     IExportable::ExportModeFlags flags = 0;
     flags |= IExportable::Binary;
     flags |= IExportable::XML;
+    flags |= IExportable::XMLStream;
     return flags;
 }
 
@@ -182,6 +422,38 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Obs
     return IExportable::Incomplete;
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::ObserverData::exportXmlStream(QXmlStreamWriter& writer) const {
+    #ifdef QTILITIES_BENCHMARKING
+    time_t start,end;
+    time(&start);
+    #endif
+
+    IExportable::ExportResultFlags result = exportXmlStreamExt(writer,ExportData);
+
+    #ifdef QTILITIES_BENCHMARKING
+    time(&end);
+    double diff = difftime(end,start);
+    LOG_TASK_WARNING("Observer (" + observer->observerName() + ") took " + QString::number(diff) + " seconds to export (exportXmlStreamExt_1_0).",exportTask());
+    #endif
+    return result;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::ObserverData::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    #ifdef QTILITIES_BENCHMARKING
+    time_t start,end;
+    time(&start);
+    #endif
+
+    IExportable::ExportResultFlags result = importXmlStreamExt(reader,import_list);
+
+    #ifdef QTILITIES_BENCHMARKING
+    time(&end);
+    double diff = difftime(end,start);
+    LOG_TASK_WARNING("Observer (" + observer->observerName() + ") took " + QString::number(diff) + " seconds to import (importXmlStreamExt_1_0).",exportTask());
+    #endif
+    return result;
+}
+
 IExportable::ExportResultFlags Qtilities::Core::ObserverData::exportBinaryExt(QDataStream& stream, ExportItemFlags export_flags) const {
         IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(exportVersion(),exportTask());
     if (version_check_result != IExportable::VersionSupported)
@@ -193,6 +465,40 @@ IExportable::ExportResultFlags Qtilities::Core::ObserverData::exportBinaryExt(QD
     return IExportable::Incomplete;
 }
 
+int Qtilities::Core::ObserverData::concurrentExportTreeSize(const Observer* obs, QHash<const Observer*,int>* tree_sizes) {
+    if (!obs)
+        return -1;
+
+    // When the sizes of all subtrees are needed, the complete tree is visited even when it can't be exported concurrently:
+    int tree_size = 0;
+    QList<QObject*> subjects = obs->subjectReferences();
+    for (int i = 0; i < subjects.count() && (tree_size >= 0 || tree_sizes); ++i) {
+        QObject* obj = subjects.at(i);
+        IExportable* iface = qobject_cast<IExportable*> (obj);
+        if (!iface)
+            continue;
+
+        // Objects observed in more than one context can be exported from more than one subtree:
+        bool concurrent = (Observer::parentCount(obj) == 1);
+
+        Observer* child_obs = qobject_cast<Observer*> (obj);
+        int child_tree_size = 0;
+        if (child_obs && (concurrent || tree_sizes))
+            child_tree_size = concurrentExportTreeSize(child_obs,tree_sizes);
+        else if (!child_obs && !iface->supportsConcurrentExport())
+            concurrent = false;
+
+        if (!concurrent || child_tree_size < 0)
+            tree_size = -1;
+        else if (tree_size >= 0)
+            tree_size += child_tree_size + 1;
+    }
+
+    if (tree_sizes)
+        tree_sizes->insert(obs,tree_size);
+    return tree_size;
+}
+
 IExportable::ExportResultFlags Qtilities::Core::ObserverData::exportXmlExt(QDomDocument* doc, QDomElement* object_node, ExportItemFlags export_flags) const {
     IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(exportVersion(),exportTask());
     if (version_check_result != IExportable::VersionSupported)
@@ -204,6 +510,60 @@ IExportable::ExportResultFlags Qtilities::Core::ObserverData::exportXmlExt(QDomD
     return IExportable::Incomplete;
 }
 
+IExportable::ExportResultFlags Qtilities::Core::ObserverData::exportXmlStreamExt(QXmlStreamWriter& writer, ExportItemFlags export_flags) const {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    if (exportVersion() == Qtilities::Qtilities_1_0 || exportVersion() == Qtilities::Qtilities_1_1 || exportVersion() == Qtilities::Qtilities_1_2) {
+        if (export_flags & ExportRelationalData) {
+            // The relational data describes the complete tree and is verified against it during import, thus the DOM export is used:
+            QDomDocument doc;
+            QDomElement object_node = doc.createElement("Observer");
+            doc.appendChild(object_node);
+            IExportable::ExportResultFlags result = exportXmlExt_1_0(&doc,&object_node,export_flags);
+            if (!(result & IExportable::FailedResult))
+                IExportable::writeXmlStreamContent(writer,object_node);
+            return result;
+        }
+
+        return exportXmlStreamExt_1_0(writer,export_flags);
+    }
+
+    return IExportable::Incomplete;
+}
+
+IExportable::ExportResultFlags Qtilities::Core::ObserverData::importXmlStreamExt(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list, QtilitiesCategory* item_category) {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesImportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    if (exportVersion() == Qtilities::Qtilities_1_0 || exportVersion() == Qtilities::Qtilities_1_1 || exportVersion() == Qtilities::Qtilities_1_2) {
+        ExportItemFlags export_flags = ExportData;
+        if (reader.attributes().hasAttribute("ExportFlags"))
+            export_flags = (ExportItemFlags) reader.attributes().value("ExportFlags").toString().toInt();
+
+        if (export_flags & ExportRelationalData) {
+            // Relationships can only be constructed once the complete tree is available, thus the DOM import is used:
+            QDomDocument doc;
+            QDomElement object_node = IExportable::readXmlStreamElement(reader,&doc);
+            doc.appendChild(object_node);
+
+            QDomElement category_node = object_node.firstChildElement("Category");
+            if (item_category && !category_node.isNull()) {
+                item_category->setExportVersion(exportVersion());
+                item_category->importXml(&doc,&category_node,import_list);
+            }
+
+            return importXmlExt_1_0(&doc,&object_node,import_list);
+        }
+
+        return importXmlStreamExt_1_0(reader,import_list,item_category);
+    }
+
+    return IExportable::Incomplete;
+}
+
 IExportable::ExportResultFlags Qtilities::Core::ObserverData::exportBinaryExt_1_0(QDataStream& stream, ExportItemFlags export_flags) const {
     stream << MARKER_OBS_DATA_SECTION;
     // Export the flags used:
@@ -345,10 +705,42 @@ IExportable::ExportResultFlags Qtilities::Core::ObserverData::exportBinaryExt_1_
         qint32 iface_count = exportable_list.count();
         stream << iface_count;
 
+        // Large subtrees underneath subject observers are exported in parallel into separate buffers which are written to the stream in order below.
+        // This is not done when visitor IDs are exported, since the limited exports list of every subtree sets properties on the objects in it.
+        ExportItemFlags child_obs_flags = export_flags;
+        child_obs_flags &= ~ExportRelationalData;
+        QHash<IExportable*,int> parallel_parts;
+        ParallelExport parallel_export(stream.version());
+        ExportTreeSizesScope tree_sizes_scope(observer);
+        if (!(export_flags & ExportVisitorIDs)) {
+            for (int i = 0; i < exportable_list.count(); ++i) {
+                Observer* obs = qobject_cast<Observer*> (exportable_list.at(i)->objectBase());
+                if (!obs)
+                    continue;
+                if (tree_sizes_scope.treeSize(obs) < PARALLEL_EXPORT_MIN_TREE_SIZE)
+                    continue;
+
+                IExportableObserver* export_iface_obs = qobject_cast<IExportableObserver*> (obs->objectBase());
+                Q_ASSERT(export_iface_obs);
+                exportable_list.at(i)->setExportVersion(exportVersion());
+                exportable_list.at(i)->setApplicationExportVersion(applicationExportVersion());
+                parallel_parts[exportable_list.at(i)] = parallel_export.partCount();
+                parallel_export.addPart(new ObserverSubtreeExportPart(export_iface_obs,child_obs_flags,currentExportTreeSizes()));
+            }
+
+            if (parallel_export.partCount() > 1) {
+                LOG_TASK_TRACE(QString(QObject::tr("Exporting %1 subject observers in parallel...")).arg(parallel_export.partCount()),exportTask());
+                parallel_export.exportParts();
+            } else {
+                parallel_parts.clear();
+            }
+        }
 
         // Now check all subjects for the IExportable interface.
         for (int i = 0; i < exportable_list.count(); ++i) {
-            QCoreApplication::processEvents();
+            // Events can change objects which are being exported in other threads:
+            if (!ParallelExport::isBusy())
+                QCoreApplication::processEvents();
             IExportable* iface = exportable_list.at(i);
             QObject* obj = iface->objectBase();
             LOG_TASK_TRACE(QString("%1/%2: Exporting \"%3\"...").arg(i).arg(iface_count).arg(observer->subjectNameInContext(obj)),exportTask());
@@ -379,10 +771,12 @@ IExportable::ExportResultFlags Qtilities::Core::ObserverData::exportBinaryExt_1_
             // Check if it is an observer:
             IExportable::ExportResultFlags result;
             Observer* obs = qobject_cast<Observer*> (iface->objectBase());
-            if (obs) {
-                ExportItemFlags child_obs_flags = export_flags;
-                child_obs_flags &= ~ExportRelationalData;
-
+            if (parallel_parts.contains(iface)) {
+                int part_index = parallel_parts.value(iface);
+                QByteArray part_data = parallel_export.partData(part_index);
+                stream.writeRawData(part_data.constData(),part_data.size());
+                result = parallel_export.partResult(part_index);
+            } else if (obs) {
                 IExportableObserver* export_iface_obs = qobject_cast<IExportableObserver*> (obs->objectBase());
                 Q_ASSERT(export_iface_obs);
                 obs->setExportTask(exportTask());
@@ -1266,6 +1660,517 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Obs
     return result;
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::ObserverData::exportXmlStreamExt_1_0(QXmlStreamWriter& writer, ExportItemFlags export_flags) const {
+    writer.writeAttribute("ExportFlags",QString::number(export_flags));
+
+    IExportable::ExportResultFlags result = IExportable::Complete;
+    bool complete = true;
+
+    if (export_flags & ExportData) {
+        // Visitor ID (only when needed)
+        if (export_flags & ExportVisitorIDs) {
+            int visitor_id = -1;
+            if (ObjectManager::propertyExists(observer,qti_prop_VISITOR_ID)) {
+                QVariant prop_variant = observer->property(qti_prop_VISITOR_ID);
+                if (prop_variant.isValid() && prop_variant.canConvert<SharedProperty>()) {
+                    SharedProperty prop = prop_variant.value<SharedProperty>();
+                    if (prop.isValid()) {
+                         visitor_id = prop.value().toInt();
+                    }
+                }
+            }
+            writer.writeAttribute("VisitorID",QString::number(visitor_id));
+        }
+
+        // Categories:
+        if (categories.count() > 0) {
+            writer.writeStartElement("Categories");
+            for (int i = 0; i < categories.count(); ++i) {
+                writer.writeStartElement("Category");
+                categories.at(i).exportXmlStream(writer);
+                writer.writeEndElement();
+            }
+            writer.writeEndElement();
+        }
+
+        // 1. The data of this item is only added when it is not empty, thus we check what it will contain first:
+        bool has_observer_data = subject_limit != -1 || !observer_description.isEmpty() || access_mode != Observer::FullAccess
+                || access_mode != Observer::GlobalScope || object_deletion_policy != Observer::DeleteImmediately;
+        bool has_hints = display_hints && display_hints->isExportable();
+        bool has_subject_filters = false;
+        for (int i = 0; i < subject_filters.count(); ++i) {
+            if (subject_filters.at(i)->isExportable()) {
+                has_subject_filters = true;
+                break;
+            }
+        }
+
+        // Formatting is only available through the DOM export, it is small thus we construct it first:
+        QDomDocument formatting_doc;
+        QDomElement formatting_data = formatting_doc.createElement("Data");
+        formatting_doc.appendChild(formatting_data);
+        IExportableFormatting* formatting_iface = qobject_cast<IExportableFormatting*> (objectBase());
+        if (formatting_iface) {
+            if (formatting_iface->exportFormattingXML(&formatting_doc,&formatting_data,exportVersion()) == IExportable::Failed)
+                return IExportable::Failed;
+        }
+
+        if (has_observer_data || has_hints || has_subject_filters || formatting_data.hasChildNodes()) {
+            writer.writeStartElement("Data");
+
+            // Observer data:
+            if (has_observer_data) {
+                writer.writeStartElement("ObserverData");
+                if (subject_limit != -1)
+                    writer.writeAttribute("SubjectLimit",QString::number(subject_limit));
+                if (!observer_description.isEmpty())
+                    writer.writeAttribute("Description",observer_description);
+                if (access_mode != Observer::FullAccess)
+                    writer.writeAttribute("AccessMode",Observer::accessModeToString((Observer::AccessMode) access_mode));
+                if (access_mode != Observer::GlobalScope)
+                    writer.writeAttribute("AccessModeScope",Observer::accessModeScopeToString((Observer::AccessModeScope) access_mode_scope));
+                if (object_deletion_policy != Observer::DeleteImmediately)
+                    writer.writeAttribute("ObjectDeletionPolicy",Observer::objectDeletionPolicyToString((Observer::ObjectDeletionPolicy) object_deletion_policy));
+                writer.writeEndElement();
+            }
+
+            // Observer hints:
+            if (has_hints) {
+                writer.writeStartElement("ObserverHints");
+                display_hints->setExportVersion(exportVersion());
+                display_hints->setExportTask(exportTask());
+                if (display_hints->exportXmlStream(writer) == IExportable::Failed) {
+                    display_hints->clearExportTask();
+                    return IExportable::Failed;
+                }
+                display_hints->clearExportTask();
+                writer.writeEndElement();
+            }
+
+            // Subject filters:
+            for (int i = 0; i < subject_filters.count(); ++i) {
+                if (subject_filters.at(i)->isExportable()) {
+                    writer.writeStartElement("SubjectFilter");
+                    if (!subject_filters.at(i)->instanceFactoryInfo().exportXmlStream(writer,exportVersion()))
+                        return IExportable::Failed;
+                    subject_filters.at(i)->setExportVersion(exportVersion());
+                    subject_filters.at(i)->setExportTask(exportTask());
+                    if (subject_filters.at(i)->exportXmlStream(writer) == IExportable::Failed) {
+                        subject_filters.at(i)->clearExportTask();
+                        return IExportable::Failed;
+                    }
+                    subject_filters.at(i)->clearExportTask();
+                    writer.writeEndElement();
+                }
+            }
+
+            // Formatting:
+            for (QDomElement formatting_item = formatting_data.firstChildElement(); !formatting_item.isNull(); formatting_item = formatting_item.nextSiblingElement())
+                IExportable::writeXmlStreamElement(writer,formatting_item);
+
+            writer.writeEndElement();
+        }
+
+        // Make List Of Exportable Subjects
+        QList<IExportable*> exportable_list;
+        if (export_flags & ExportVisitorIDs)
+            exportable_list = getLimitedExportsList(subject_list.toQList(),IExportable::XML,&complete);
+        else {
+            for (int l = 0; l < subject_list.count(); l++) {
+                IExportable* iface = qobject_cast<IExportable*> (subject_list.at(l));
+                if (iface)
+                    exportable_list << iface;
+            }
+
+            if (exportable_list.count() < subject_list.count()) {
+                LOG_TASK_TRACE(QString(QObject::tr("%1 exportable subjects found under this observer's level of hierarchy. This list is incomplete.")).arg(exportable_list.count()),exportTask());
+                complete = false;
+            } else {
+                LOG_TASK_TRACE(QString(QObject::tr("%1 exportable subjects found under this observer's level of hierarchy. This list is complete.")).arg(exportable_list.count()),exportTask());
+            }
+        }
+
+        // Export exportable subjects:
+        if (exportable_list.count() > 0)
+            writer.writeStartElement("Children");
+        for (int i = 0; i < exportable_list.count(); ++i) {
+            Observer* obs = qobject_cast<Observer*> (exportable_list.at(i)->objectBase());
+            IExportable* export_iface = exportable_list.at(i);
+            if (export_iface->supportedFormats() & IExportable::XML) {
+                // The item and its factory data:
+                writer.writeStartElement("TreeItem");
+
+                // All attributes must be written before the item exports its own data:
+                // 1. Is Active:
+                if (ObjectManager::propertyExists(export_iface->objectBase(),qti_prop_ACTIVITY_MAP)) {
+                    bool activity = observer->getMultiContextPropertyValue(export_iface->objectBase(),qti_prop_ACTIVITY_MAP).toBool();
+                    if (activity)
+                        writer.writeAttribute("Activity","Active");
+                    else
+                        writer.writeAttribute("Activity","Inactive");
+                }
+                // 2. Ownership:
+                Observer::ObjectOwnership ownership = observer->subjectOwnershipInContext(export_iface->objectBase());
+                if (ownership != Observer::ObserverScopeOwnership)
+                    writer.writeAttribute("Ownership",Observer::objectOwnershipToString(ownership));
+
+                // 3. Factory Data:
+                if (!export_iface->instanceFactoryInfo().exportXmlStream(writer,exportVersion()))
+                    return IExportable::Failed;
+
+                // 4. Visitor ID (only when needed). Observers write their own visitor ID:
+                if ((export_flags & ExportVisitorIDs) && !obs) {
+                    int visitor_id = -1;
+                    if (ObjectManager::propertyExists(export_iface->objectBase(),qti_prop_VISITOR_ID)) {
+                        QVariant prop_variant = export_iface->objectBase()->property(qti_prop_VISITOR_ID);
+                        if (prop_variant.isValid() && prop_variant.canConvert<SharedProperty>()) {
+                            SharedProperty prop = prop_variant.value<SharedProperty>();
+                            if (prop.isValid()) {
+                                 visitor_id = prop.value().toInt();
+                            }
+                        }
+                    }
+                    writer.writeAttribute("VisitorID",QString::number(visitor_id));
+                }
+
+                // Now we let the export iface export whatever it need to export:
+                export_iface->setExportVersion(exportVersion());
+                export_iface->setApplicationExportVersion(applicationExportVersion());
+
+                IExportable::ExportResultFlags intermediate_result;
+                if (obs) {
+                    ExportItemFlags child_obs_flags = export_flags;
+                    child_obs_flags &= ~ExportRelationalData;
+                    IExportableObserver* export_iface_obs = qobject_cast<IExportableObserver*> (obs->objectBase());
+                    Q_ASSERT(export_iface_obs);
+
+                    obs->setExportTask(exportTask());
+                    intermediate_result = export_iface_obs->exportXmlStreamExt(writer,child_obs_flags);
+                } else {
+                    // Items which do not implement XML streaming are exported using exportXml() by the default implementation:
+                    export_iface->setExportTask(exportTask());
+                    intermediate_result = export_iface->exportXmlStream(writer);
+                }
+
+                export_iface->clearExportTask();
+
+                if (intermediate_result == IExportable::Failed || intermediate_result == IExportable::VersionTooOld || intermediate_result == IExportable::VersionTooNew) {
+                    LOG_TASK_TRACE("TreeItem (" + export_iface->objectBase()->objectName() + ") failed.",exportTask());
+                    return intermediate_result;
+                } else if (intermediate_result == IExportable::Incomplete) {
+                    result = IExportable::Incomplete;
+                    LOG_TASK_TRACE("TreeItem (" + export_iface->objectBase()->objectName() + ") is incomplete.",exportTask());
+                } else if (intermediate_result == IExportable::Complete) {
+                    LOG_TASK_TRACE("TreeItem (" + export_iface->objectBase()->objectName() + ") is complete.",exportTask());
+                }
+
+                // 5. Category. This is written last since the item might have written attributes above:
+                if (ObjectManager::propertyExists(export_iface->objectBase(),qti_prop_CATEGORY_MAP)) {
+                    QVariant category_variant = observer->getMultiContextPropertyValue(export_iface->objectBase(),qti_prop_CATEGORY_MAP);
+                    if (category_variant.isValid()) {
+                        QtilitiesCategory category = category_variant.value<QtilitiesCategory>();
+                        writer.writeStartElement("Category");
+                        category.setExportVersion(exportVersion());
+                        category.setExportTask(exportTask());
+                        category.exportXmlStream(writer);
+                        category.clearExportTask();
+                        writer.writeEndElement();
+                    }
+                }
+
+                writer.writeEndElement();
+            } else {
+                LOG_TASK_WARNING(QObject::tr("XML export found an interface (") + observer->subjectNameInContext(export_iface->objectBase()) + QObject::tr(" in context ") + observer->observerName() + QObject::tr(") which does not support XML exporting. XML export will be incomplete."),exportTask());
+                result = IExportable::Incomplete;
+            }
+        }
+        if (exportable_list.count() > 0)
+            writer.writeEndElement();
+    }
+
+    if (writer.hasError()) {
+        LOG_TASK_ERROR(QObject::tr("Xml export of observer ") + observer->observerName() + QObject::tr(" failed while writing to the output device."),exportTask());
+        return IExportable::Failed;
+    }
+
+    if (result == IExportable::Incomplete || !complete) {
+        LOG_TASK_DEBUG(QObject::tr("Xml export of observer ") + observer->observerName() + QString(QObject::tr(" was successful (incomplete).")),exportTask());
+        return IExportable::Incomplete;
+    } else {
+        LOG_TASK_DEBUG(QObject::tr("Xml export of observer ") + observer->observerName() + QString(QObject::tr(" was successful (complete).")),exportTask());
+        return IExportable::Complete;
+    }
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::ObserverData::importXmlStreamExt_1_0(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list, QtilitiesCategory* item_category) {
+    QList<QPointer<QObject> > active_subjects;
+    observer->startProcessingCycle();
+    IExportable::ExportResultFlags result = IExportable::Complete;
+
+    // Create a custom internal import list which will only store the children of child observers, as done in importXml():
+    QList<QPointer<QObject> > internal_import_list;
+
+    QXmlStreamAttributes attributes = reader.attributes();
+    ExportItemFlags export_flags = ExportData;
+    if (attributes.hasAttribute("ExportFlags"))
+        export_flags = (ExportItemFlags) attributes.value("ExportFlags").toString().toInt();
+
+    if (export_flags & ExportVisitorIDs) {
+        if (attributes.hasAttribute("VisitorID")) {
+            SharedProperty visitor_id_prop(qti_prop_VISITOR_ID,attributes.value("VisitorID").toString().toInt());
+            ObjectManager::setSharedProperty(observer,visitor_id_prop);
+        }
+    }
+
+    while (reader.readNextStartElement()) {
+        if ((export_flags & ExportData) && reader.name() == QLatin1String("Data")) {
+            while (reader.readNextStartElement()) {
+                if (reader.name() == QLatin1String("ObserverHints")) {
+                    observer->useDisplayHints();
+                    display_hints->setExportVersion(exportVersion());
+                    display_hints->setExportTask(exportTask());
+                    if (display_hints->importXmlStream(reader,import_list) == IExportable::Failed) {
+                        display_hints->clearExportTask();
+                        observer->endProcessingCycle();
+                        return IExportable::Failed;
+                    }
+                    display_hints->clearExportTask();
+                } else if (reader.name() == QLatin1String("ObserverData")) {
+                    QXmlStreamAttributes data_attributes = reader.attributes();
+                    if (data_attributes.hasAttribute("SubjectLimit"))
+                        subject_limit = data_attributes.value("SubjectLimit").toString().toInt();
+                    if (data_attributes.hasAttribute("Description"))
+                        observer_description = data_attributes.value("Description").toString();
+                    if (data_attributes.hasAttribute("AccessMode"))
+                        access_mode = Observer::stringToAccessMode(data_attributes.value("AccessMode").toString());
+                    if (data_attributes.hasAttribute("AccessModeScope"))
+                        access_mode_scope = Observer::stringToAccessModeScope(data_attributes.value("AccessModeScope").toString());
+                    if (data_attributes.hasAttribute("ObjectDeletionPolicy"))
+                        object_deletion_policy = Observer::stringToObjectDeletionPolicy(data_attributes.value("ObjectDeletionPolicy").toString());
+                    reader.skipCurrentElement();
+                } else if (reader.name() == QLatin1String("SubjectFilter")) {
+                    // Construct and init the subject filter:
+                    InstanceFactoryInfo instanceFactoryInfo;
+                    instanceFactoryInfo.importXmlStream(reader.attributes(),exportVersion());
+                    AbstractSubjectFilter* abstract_filter = 0;
+                    if (instanceFactoryInfo.isValid()) {
+                        LOG_TASK_TRACE(QString(QObject::tr("Importing subject type \"%1\" in factory \"%2\"...")).arg(instanceFactoryInfo.d_instance_tag).arg(instanceFactoryInfo.d_factory_tag),exportTask());
+
+                        IFactoryProvider* ifactory = OBJECT_MANAGER->referenceIFactoryProvider(instanceFactoryInfo.d_factory_tag);
+                        if (ifactory) {
+                            QObject* obj = ifactory->createInstance(instanceFactoryInfo);
+                            if (obj) {
+                                obj->setObjectName(instanceFactoryInfo.d_instance_name);
+                                abstract_filter = qobject_cast<AbstractSubjectFilter*> (obj);
+                                if (!abstract_filter)
+                                    delete obj;
+                            }
+                        }
+                    } else
+                        LOG_TASK_WARNING(QString(QObject::tr("Found invalid factory data for subject filter on tree node: %1")).arg(observer->observerName()),exportTask());
+
+                    if (abstract_filter) {
+                        abstract_filter->setExportVersion(exportVersion());
+                        abstract_filter->setExportTask(exportTask());
+                        IExportable::ExportResultFlags filter_result = abstract_filter->importXmlStream(reader,import_list);
+                        abstract_filter->clearExportTask();
+                        if (filter_result == IExportable::Failed) {
+                            LOG_TASK_ERROR(QString(QObject::tr("Failed to import subject filter \"%1\" for tree node: \"%2\". Importing will not continue.")).arg(instanceFactoryInfo.d_instance_tag).arg(observer->observerName()),exportTask());
+                            delete abstract_filter;
+                            result = IExportable::Failed;
+                        } else if (!observer->installSubjectFilter(abstract_filter)) {
+                            LOG_TASK_DEBUG(QString(QObject::tr("Failed to install subject filter \"%1\" for tree node: \"%2\". If this filter already existed this is not a problem.")).arg(instanceFactoryInfo.d_instance_tag).arg(observer->observerName()),exportTask());
+                            delete abstract_filter;
+                        }
+                    } else {
+                        reader.skipCurrentElement();
+                    }
+                } else if (reader.name() == QLatin1String("Formatting")) {
+                    // Formatting is only available through the DOM import, it is small thus we read it into a document:
+                    QDomDocument formatting_doc;
+                    QDomElement formatting_data = IExportable::readXmlStreamElement(reader,&formatting_doc);
+                    formatting_doc.appendChild(formatting_data);
+                    IExportableFormatting* formatting_iface = qobject_cast<IExportableFormatting*> (observer->objectBase());
+                    if (formatting_iface) {
+                        if (formatting_iface->importFormattingXML(&formatting_doc,&formatting_data,exportVersion()) != IExportable::Complete) {
+                            LOG_TASK_WARNING(QString(QObject::tr("Failed to import formatting for tree node: \"%1\"")).arg(observer->observerName()),exportTask());
+                            result = IExportable::Incomplete;
+                        }
+                    }
+                } else {
+                    reader.skipCurrentElement();
+                }
+            }
+        } else if ((export_flags & ExportData) && reader.name() == QLatin1String("Children")) {
+            while (reader.readNextStartElement()) {
+                if (reader.name() != QLatin1String("TreeItem")) {
+                    reader.skipCurrentElement();
+                    continue;
+                }
+
+                // Construct and init the child:
+                QXmlStreamAttributes item_attributes = reader.attributes();
+                InstanceFactoryInfo instanceFactoryInfo;
+                instanceFactoryInfo.importXmlStream(item_attributes,exportVersion());
+                if (!instanceFactoryInfo.isValid()) {
+                    result = IExportable::Incomplete;
+                    LOG_TASK_WARNING(QString(QObject::tr("Found invalid factory data for child on tree node: %1")).arg(observer->observerName()),exportTask());
+                    reader.skipCurrentElement();
+                    continue;
+                }
+                LOG_TASK_TRACE(QString(QObject::tr("Importing subject type \"%1\" in factory \"%2\"...")).arg(instanceFactoryInfo.d_instance_tag).arg(instanceFactoryInfo.d_factory_tag),exportTask());
+
+                IFactoryProvider* ifactory = OBJECT_MANAGER->referenceIFactoryProvider(instanceFactoryInfo.d_factory_tag);
+                if (!ifactory) {
+                    LOG_TASK_WARNING(QString(QObject::tr("Factory with name %1 does not exist in the object manager. This item will be skipped and the import will be incomplete.")).arg(instanceFactoryInfo.d_factory_tag),exportTask());
+                    result = IExportable::Incomplete;
+                    reader.skipCurrentElement();
+                    continue;
+                }
+                QObject* obj = ifactory->createInstance(instanceFactoryInfo);
+                if (!obj) {
+                    LOG_TASK_WARNING(QString(QObject::tr("Factory tag %1 does not exist in factory %2. This item will be skipped and the import will be incomplete.")).arg(instanceFactoryInfo.d_instance_tag).arg(instanceFactoryInfo.d_factory_tag),exportTask());
+                    result = IExportable::Incomplete;
+                    reader.skipCurrentElement();
+                    continue;
+                }
+
+                obj->setObjectName(instanceFactoryInfo.d_instance_name);
+                internal_import_list << obj;
+                IExportable* iface = qobject_cast<IExportable*> (obj);
+                if (!iface) {
+                    LOG_TASK_ERROR(QString(QObject::tr("Found invalid exportable interface on reconstructed object in tree node: %1")).arg(observer->observerName()),exportTask());
+                    observer->endProcessingCycle();
+                    return IExportable::Failed;
+                }
+
+                // Attach first before doing import on object:
+                Observer::ObjectOwnership ownership = Observer::ObserverScopeOwnership;
+                if (item_attributes.hasAttribute("Ownership"))
+                    ownership = Observer::stringToObjectOwnership(item_attributes.value("Ownership").toString());
+                QString error_msg;
+                if (observer->attachSubject(iface->objectBase(),ownership,&error_msg)) {
+                    import_list << obj;
+                } else {
+                    LOG_TASK_WARNING(QString(QObject::tr("Failed to attach reconstructed object \"%1\" to tree node: %2. Import will be incomplete.")).arg(observer->observerName()).arg(error_msg),exportTask());
+                    delete obj;
+                    result = IExportable::Incomplete;
+                    reader.skipCurrentElement();
+                    continue;
+                }
+
+                // Now that we created the item, init its data and children:
+                iface->setExportVersion(exportVersion());
+                iface->setApplicationExportVersion(applicationExportVersion());
+                iface->setExportTask(exportTask());
+
+                // The category can appear anywhere in the item's element:
+                QtilitiesCategory category;
+                category.setExportVersion(exportVersion());
+                category.setExportTask(exportTask());
+                IExportable::ExportResultFlags category_result = IExportable::Complete;
+                bool has_category = false;
+
+                // Check if it is an observer: if so we must use internal_import_list, not import_list:
+                Observer* obs = qobject_cast<Observer*> (iface->objectBase());
+                IExportable::ExportResultFlags intermediate_result;
+                if (obs) {
+                    IExportableObserver* export_iface_obs = qobject_cast<IExportableObserver*> (obs->objectBase());
+                    Q_ASSERT(export_iface_obs);
+                    intermediate_result = export_iface_obs->importXmlStreamExt(reader,internal_import_list,&category);
+                    has_category = category.isValid();
+                } else {
+                    // Items are small compared to the tree, thus each item is read into its own document which is released again after the item was imported.
+                    // This allows items which does not implement XML streaming, and items which write attributes, to find their data regardless of where the category is:
+                    QDomDocument item_doc;
+                    QDomElement item_node = IExportable::readXmlStreamElement(reader,&item_doc);
+                    item_doc.appendChild(item_node);
+
+                    QDomElement category_node = item_node.firstChildElement("Category");
+                    if (!category_node.isNull()) {
+                        category_result = category.importXml(&item_doc,&category_node,import_list);
+                        has_category = true;
+                    }
+                    intermediate_result = iface->importXml(&item_doc,&item_node,import_list);
+                }
+                category.clearExportTask();
+
+                if (has_category) {
+                    if (category_result == IExportable::Incomplete) {
+                        LOG_TASK_WARNING(QString(QObject::tr("Failed to import category completely for object in tree node: %1. Item \"%2\" will not have its category set.")).arg(observer->observerName()).arg(iface->objectBase()->objectName()),exportTask());
+                        result = IExportable::Incomplete;
+                    } else if (category_result & IExportable::FailedResult) {
+                        LOG_TASK_ERROR(QString(QObject::tr("Failed to import category for object in tree node: %1. Item \"%2\" will not have its category set.")).arg(observer->observerName()).arg(iface->objectBase()->objectName()),exportTask());
+                        result = category_result;
+                    }
+
+                    MultiContextProperty category_property(qti_prop_CATEGORY_MAP);
+                    category_property.setValue(qVariantFromValue(category),observer->observerID());
+                    if (!ObjectManager::setMultiContextProperty(iface->objectBase(),category_property)) {
+                        LOG_TASK_WARNING(QString(QObject::tr("Failed to set category on object \"%1\" to tree node: %2. Import will be incomplete.")).arg(observer->observerName()).arg(iface->objectBase()->objectName()),exportTask());
+                        result = IExportable::Incomplete;
+                    }
+                }
+
+                if (intermediate_result == IExportable::Incomplete) {
+                    LOG_TASK_WARNING(QString(QObject::tr("Failed to reconstruct object completely in tree node: %1. Item \"%2\" will be incomplete.")).arg(observer->observerName()).arg(iface->objectBase()->objectName()),exportTask());
+                    result = IExportable::Incomplete;
+                } else if (intermediate_result & IExportable::FailedResult) {
+                    LOG_TASK_ERROR(QString(QObject::tr("Failed to import object in tree node: %1. Item \"%2\" will not be imported.")).arg(observer->observerName()).arg(iface->objectBase()->objectName()),exportTask());
+                    result = intermediate_result;
+
+                    // A failed observer might not have read its complete element, thus reading cannot continue:
+                    if (obs) {
+                        iface->clearExportTask();
+                        observer->endProcessingCycle();
+                        return result;
+                    }
+                }
+
+                // Check if it is active:
+                if (item_attributes.value("Activity") == QLatin1String("Active"))
+                    active_subjects << iface->objectBase();
+
+                // Get VisitorID if needed:
+                if (export_flags & ExportVisitorIDs) {
+                    if (item_attributes.hasAttribute("VisitorID")) {
+                        SharedProperty visitor_id_prop(qti_prop_VISITOR_ID,item_attributes.value("VisitorID").toString().toInt());
+                        ObjectManager::setSharedProperty(iface->objectBase(),visitor_id_prop);
+                    }
+                }
+
+                iface->clearExportTask();
+            }
+        } else if (item_category && reader.name() == QLatin1String("Category")) {
+            // The category of this observer in its parent observer:
+            item_category->setExportVersion(exportVersion());
+            item_category->importXmlStream(reader,import_list);
+        } else {
+            reader.skipCurrentElement();
+        }
+    }
+
+    observer->endProcessingCycle();
+
+    if (reader.hasError()) {
+        LOG_TASK_ERROR(QString(QObject::tr("Failed to read XML for tree node \"%1\": %2")).arg(observer->observerName()).arg(reader.errorString()),exportTask());
+        return IExportable::Failed;
+    }
+
+    // If active_subjects has items in it we must set them active:
+    if (active_subjects.count() > 0) {
+        for (int i = 0; i < subject_filters.count(); ++i) {
+            ActivityPolicyFilter* activity_filter = qobject_cast<ActivityPolicyFilter*> (subject_filters.at(i));
+            if (activity_filter) {
+                activity_filter->setActiveSubjects(active_subjects,true);
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
 bool Qtilities::Core::ObserverData::constructRelationships(QList<QPointer<QObject> >& objects, ObserverRelationalTable* table) const {
     if (!table)
         return false;
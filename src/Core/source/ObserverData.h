@@ -23,7 +23,12 @@
 #include <QSharedData>
 #include <QObject>
 #include <QMutex>
+#include <QReadWriteLock>
 #include <QHash>
+#include <QSet>
+#include <QPointer>
+
+class QTimer;
 
 namespace Qtilities {
     namespace Core {
@@ -32,6 +37,64 @@ namespace Qtilities {
         using namespace Qtilities::Core::Interfaces;
         using namespace Qtilities::Core::Constants;
 
+        /*!
+          \struct PropertyDispatchEntry
+          \brief The PropertyDispatchEntry struct describes how an observer handles changes to a dynamic property on its subjects.
+
+          Observers build a table of entries for all the properties which are reserved or monitored in their context when subject filters are
+          installed or uninstalled. The observer's event filter uses this table to handle property changes using a single lookup.
+
+          <i>This struct was added in %Qtilities v1.5.</i>
+          */
+        struct PropertyDispatchEntry {
+            PropertyDispatchEntry() : reserved(false),
+                monitored(false),
+                refreshes_data(false),
+                refreshes_layout(false) {}
+
+            //! Indicates if the property is reserved, thus changes to it are always filtered.
+            bool                            reserved;
+            //! Indicates if the property is monitored by the observer or by any of its subject filters.
+            bool                            monitored;
+            //! Indicates if views must be notified that data changed when the property changes.
+            bool                            refreshes_data;
+            //! Indicates if views might need to be notified that the layout changed when the property changes.
+            bool                            refreshes_layout;
+            //! The subject filters monitoring the property, in the order in which they were installed.
+            QList<AbstractSubjectFilter*>   filters;
+        };
+
+        /*!
+          \struct DeferredObjectSet
+          \brief The DeferredObjectSet struct is an ordered set of objects in the pending change set of an observer with deferred change notifications.
+
+          Membership checks and removals are constant time lookups, thus recording bulk attachments and detachments stays linear. Removed items are
+          left in the ordered list as null items and are skipped by objects().
+
+          <i>This struct was added in %Qtilities v1.5.</i>
+          */
+        struct DeferredObjectSet {
+            //! Indicates if \p obj is in the set. Null objects are never in the set.
+            bool contains(const QObject* obj) const;
+            //! Appends \p obj when it is not in the set yet. Null objects are always appended when \p allow_null is true.
+            void append(QObject* obj, bool allow_null = false);
+            //! Appends all objects in \p objects which are not in the set yet.
+            void append(const QList<QPointer<QObject> >& objects);
+            //! Removes \p obj from the set. Returns true when it was in the set.
+            bool remove(const QObject* obj);
+            //! Returns the objects in the set in the order in which they were appended, including null objects appended using \p allow_null.
+            QList<QPointer<QObject> > objects() const;
+            //! Clears the set.
+            void clear();
+
+            //! The objects in the order in which they were appended.
+            QList<QPointer<QObject> >       items;
+            //! Indicates for each item if it was removed.
+            QList<bool>                     removed;
+            //! The position of each object in items.
+            QHash<const QObject*,int>       index;
+        };
+
         /*!
           \class ObserverData
           \brief The ObserverData class contains data which is shared by different references of the same observer.
@@ -64,6 +127,10 @@ namespace Qtilities {
                 access_mode(0),
                 display_hints(0),
                 factory_data(InstanceFactoryInfo(qti_def_FACTORY_QTILITIES,qti_def_FACTORY_TAG_OBSERVER,QString())),
+                concurrent_reads_enabled(false),
+                tree_generation(0),
+                tree_cache_generation(-1),
+                tree_cache_set_valid(false),
                 start_processing_cycle_count(0),
                 process_cycle_active(false),
                 is_modified(false),
@@ -71,7 +138,15 @@ namespace Qtilities {
                 object_deletion_policy(0),
                 number_of_subjects_start_of_proc_cycle(0),
                 broadcast_modification_state_changes(true),
-                modification_state_start_of_proc_cycle(false)
+                modification_state_start_of_proc_cycle(false),
+                deferred_notifications_enabled(false),
+                deferred_notification_latency(0),
+                deferred_notification_timer(0),
+                deferred_notifications_pending(false),
+                deferred_layout_changed(false),
+                deferred_modification_state_changed(false),
+                deferred_modification_state_forced(false),
+                deferred_modification_state_start(false)
             {
                 subject_list.setObjectName(observer_name);
             }
@@ -88,6 +163,18 @@ namespace Qtilities {
                 categories(other.categories),
                 display_hints(other.display_hints),
                 factory_data(other.factory_data),
+                subject_pointer_index(other.subject_pointer_index),
+                subject_id_index(other.subject_id_index),
+                subject_name_index(other.subject_name_index),
+                subject_name_index_ci(other.subject_name_index_ci),
+                subject_indexed_names(other.subject_indexed_names),
+                subject_untracked_names(other.subject_untracked_names),
+                concurrent_reads_enabled(other.concurrent_reads_enabled),
+                subject_snapshot(other.subjectSnapshot()),
+                property_dispatch_table(other.property_dispatch_table),
+                tree_generation(0),
+                tree_cache_generation(-1),
+                tree_cache_set_valid(false),
                 start_processing_cycle_count(other.start_processing_cycle_count),
                 process_cycle_active(other.process_cycle_active),
                 is_modified(other.is_modified),
@@ -95,7 +182,15 @@ namespace Qtilities {
                 object_deletion_policy(other.object_deletion_policy),
                 number_of_subjects_start_of_proc_cycle(0),
                 broadcast_modification_state_changes(true),
-                modification_state_start_of_proc_cycle(false) {}
+                modification_state_start_of_proc_cycle(false),
+                deferred_notifications_enabled(false),
+                deferred_notification_latency(0),
+                deferred_notification_timer(0),
+                deferred_notifications_pending(false),
+                deferred_layout_changed(false),
+                deferred_modification_state_changed(false),
+                deferred_modification_state_forced(false),
+                deferred_modification_state_start(false) {}
 
             // --------------------------------
             // IObjectBase Implementation
@@ -120,6 +215,8 @@ namespace Qtilities {
             IExportable::ExportResultFlags importBinary(QDataStream& stream, QList<QPointer<QObject> >& import_list);
             IExportable::ExportResultFlags exportXml(QDomDocument* doc, QDomElement* object_node) const;
             IExportable::ExportResultFlags importXml(QDomDocument* doc, QDomElement* object_node, QList<QPointer<QObject> >& import_list);
+            IExportable::ExportResultFlags exportXmlStream(QXmlStreamWriter& writer) const;
+            IExportable::ExportResultFlags importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list);
 
             // --------------------------------
             // Extended Access Call Functions From Observer
@@ -128,6 +225,83 @@ namespace Qtilities {
             IExportable::ExportResultFlags exportBinaryExt(QDataStream& stream, ExportItemFlags export_flags) const;
             //! Extended XML export function.
             IExportable::ExportResultFlags exportXmlExt(QDomDocument* doc, QDomElement* object_node, ExportItemFlags export_flags) const;
+            //! Extended XML stream export function.
+            /*!
+              When \p export_flags contains ExportRelationalData, the observer is exported using exportXmlExt() to a temporary QDomDocument which is written to \p writer.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            IExportable::ExportResultFlags exportXmlStreamExt(QXmlStreamWriter& writer, ExportItemFlags export_flags) const;
+            //! Extended XML stream import function.
+            /*!
+              \param item_category When valid, the \p Category element found in the element of the observer is imported into it. This element is present
+              when the observer is a subject in another observer, in which case it contains the category of the observer in its parent.
+
+              When the element was exported with ExportRelationalData, it is read into a temporary QDomDocument and imported using importXml().
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            IExportable::ExportResultFlags importXmlStreamExt(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list, QtilitiesCategory* item_category = 0);
+            //! Returns the number of exportable objects in the tree underneath \p obs when the complete tree can be exported concurrently, otherwise -1.
+            /*!
+              A tree can be exported concurrently when all exportable objects in it support concurrent exports and none of them are observed in more than one
+              context, thus exporting the tree does not touch objects which are exported at the same time in another tree.
+
+              \param tree_sizes When not 0, the sizes of the trees underneath \p obs and all observers in its tree are added to this hash, using
+              the same rules. This visits the complete tree once, thus binary exports compute it once for the observer at the top of the export.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            static int concurrentExportTreeSize(const Observer* obs, QHash<const Observer*,int>* tree_sizes = 0);
+
+            // --------------------------------
+            // Subject Lookup Index
+            // --------------------------------
+            //! Adds a subject which was appended to subject_list to the lookup index.
+            /*!
+              \param obj The subject.
+              \param subject_id The subject ID of the object in this context, -1 when the observer does not assign subject IDs (the global object pool).
+              \param name The name under which the subject must be indexed.
+              \param name_tracked Indicates if the observer will be notified when the name of the subject changes. When false, name lookups fall back to checking the subject directly.
+              */
+            void indexSubject(QObject* obj, int subject_id, const QString& name, bool name_tracked);
+            //! Removes a subject which was removed from subject_list from the lookup index.
+            void unindexSubject(QObject* obj);
+            //! Updates the name under which a subject is indexed. Does nothing when the subject is not indexed.
+            void reindexSubjectName(QObject* obj, const QString& new_name);
+
+            // --------------------------------
+            // Concurrent Read Snapshot
+            // --------------------------------
+            //! Publishes the current contents of subject_list as the snapshot returned by subjectSnapshot().
+            /*!
+              Must be called from the thread in which the observer lives, after subject_list was changed.
+              */
+            void publishSubjectSnapshot();
+            //! Returns the last published snapshot of subject_list. This function is thread safe.
+            QList<QObject*> subjectSnapshot() const;
+
+            // --------------------------------
+            // Deferred Change Notifications
+            // --------------------------------
+            //! Adds an attached subject to the pending change set.
+            /*!
+              A subject which was detached earlier in the same change set is recorded as changed instead.
+              */
+            void recordDeferredAddition(QObject* obj);
+            //! Adds a detached subject to the pending change set. Pass 0 for subjects which were deleted.
+            /*!
+              A subject which was attached earlier in the same change set is dropped from the change set instead.
+              */
+            void recordDeferredRemoval(QObject* obj);
+            //! Adds an object of which the data changed to the pending change set.
+            void recordDeferredDataChange(QObject* obj);
+            //! Clears the pending change set.
+            void clearDeferredNotifications();
+
+        private:
+            //! Removes the name index entries for obj indexed under name.
+            void removeIndexedName(QObject* obj, const QString& name);
 
             // --------------------------------
             // Export Implementations For Different Qtilities Versions
@@ -137,6 +311,8 @@ namespace Qtilities {
             IExportable::ExportResultFlags importBinaryExt_1_0(QDataStream& stream, QList<QPointer<QObject> >& import_list);
             IExportable::ExportResultFlags exportXmlExt_1_0(QDomDocument* doc, QDomElement* object_node, ExportItemFlags export_flags) const;
             IExportable::ExportResultFlags importXmlExt_1_0(QDomDocument* doc, QDomElement* object_node, QList<QPointer<QObject> >& import_list);
+            IExportable::ExportResultFlags exportXmlStreamExt_1_0(QXmlStreamWriter& writer, ExportItemFlags export_flags) const;
+            IExportable::ExportResultFlags importXmlStreamExt_1_0(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list, QtilitiesCategory* item_category);
 
             //! Construct relationships between a list of objects with the relational data being passed to the function as a RelationalObserverTable.
             bool constructRelationships(QList<QPointer<QObject> >& objects, ObserverRelationalTable* table) const;
@@ -172,6 +348,44 @@ namespace Qtilities {
             QList<QtilitiesCategory>            categories;
             ObserverHints*                      display_hints;
             InstanceFactoryInfo                 factory_data;
+            //! Maps all subjects in subject_list to their subject IDs in this context.
+            /*!
+              The lookup index is kept in sync with subject_list in order to make contains(), subjectReference() and subjectID() constant time operations.
+              */
+            QHash<const QObject*,int>           subject_pointer_index;
+            //! Maps subject IDs in this context to the subjects.
+            QHash<int,QObject*>                 subject_id_index;
+            //! Maps subject names to the subjects with that name, in the order in which they were indexed.
+            QHash<QString,QList<QObject*> >     subject_name_index;
+            //! Maps case folded subject names to the subjects with that name, in the order in which they were indexed.
+            QHash<QString,QList<QObject*> >     subject_name_index_ci;
+            //! The names under which subjects are currently indexed.
+            QHash<const QObject*,QString>       subject_indexed_names;
+            //! Subjects for which the observer cannot track name changes, for example subjects living in a different thread.
+            QSet<const QObject*>                subject_untracked_names;
+            //! Indicates if the observer publishes snapshots of its subject list for readers in other threads.
+            bool                                concurrent_reads_enabled;
+            //! The last published snapshot of subject_list. Only access it through publishSubjectSnapshot() and subjectSnapshot().
+            QList<QObject*>                     subject_snapshot;
+            //! Protects subject_snapshot. Only the swap of the implicitly shared list is done while holding the lock.
+            mutable QReadWriteLock              subject_snapshot_lock;
+            //! Maps the names of all reserved and monitored properties in this context to the way in which changes to them are handled.
+            /*!
+              Rebuilt every time a subject filter is installed or uninstalled.
+              */
+            QHash<QByteArray,PropertyDispatchEntry> property_dispatch_table;
+            //! The structural generation of the tree underneath the observer. Changes every time subjects are attached to or detached from the observer, or any observer in the tree underneath it.
+            int                                 tree_generation;
+            //! The tree_generation for which the tree cache was built, -1 when it was never built.
+            int                                 tree_cache_generation;
+            //! The flattened tree underneath the observer in the order in which Observer::treeChildren() returns it.
+            QList<QObject*>                     tree_cache;
+            //! The set of objects in tree_cache. Only valid when tree_cache_set_valid is true.
+            QSet<const QObject*>                tree_cache_set;
+            //! Indicates if tree_cache_set was built for the current tree_cache.
+            bool                                tree_cache_set_valid;
+            //! Counts of objects in tree_cache which inherit specific base classes.
+            QHash<QString,int>                  tree_cache_counts;
             int                                 start_processing_cycle_count;
             bool                                process_cycle_active;
             bool                                is_modified;
@@ -188,6 +402,33 @@ namespace Qtilities {
             bool                                broadcast_modification_state_changes;
             //! Used during processing cycles to store the modification state of the observer when a processing cycle is started. When different when the processing cycle is stopped, only then will it emit that the modification state changed.
             bool                                modification_state_start_of_proc_cycle;
+            //! Indicates if change notifications are deferred and coalesced, see Observer::setDeferredNotificationsEnabled().
+            /*!
+              Not copied by the copy constructor, copies of an observer emit their change notifications immediately.
+              */
+            bool                                deferred_notifications_enabled;
+            //! The time in milliseconds for which change notifications are collected before they are emitted.
+            int                                 deferred_notification_latency;
+            //! Single shot timer which flushes the pending change set. Created by Observer::setDeferredNotificationsEnabled().
+            QTimer*                             deferred_notification_timer;
+            //! Indicates if a change set is waiting to be flushed.
+            bool                                deferred_notifications_pending;
+            //! Subjects attached since the last flush.
+            DeferredObjectSet                   deferred_added;
+            //! Subjects detached since the last flush. Contains null items for subjects which were deleted.
+            DeferredObjectSet                   deferred_removed;
+            //! Objects of which the data changed since the last flush.
+            DeferredObjectSet                   deferred_changed;
+            //! The new selection which will be passed to layoutChanged() when the change set is flushed.
+            DeferredObjectSet                   deferred_layout_selection;
+            //! Indicates if layoutChanged() must be emitted when the change set is flushed.
+            bool                                deferred_layout_changed;
+            //! Indicates if listeners must be notified about the modification state when the change set is flushed.
+            bool                                deferred_modification_state_changed;
+            //! Indicates if modificationStateChanged() must be emitted when the change set is flushed, even when the modification state did not change.
+            bool                                deferred_modification_state_forced;
+            //! The modification state of the observer before the first change in the pending change set.
+            bool                                deferred_modification_state_start;
         };
 
         Q_DECLARE_OPERATORS_FOR_FLAGS(ObserverData::ExportItemFlags)
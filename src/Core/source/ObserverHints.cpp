@@ -12,6 +12,8 @@
 #include "ObserverHints.h"
 
 #include <QDomElement>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 struct Qtilities::Core::ObserverHintsPrivateData {
     ObserverHintsPrivateData() : observer_selection_context(ObserverHints::SelectionUseParentContext),
@@ -647,6 +649,7 @@ Qtilities::Core::Interfaces::IExportable::ExportModeFlags Qtilities::Core::Obser
     IExportable::ExportModeFlags flags = 0;
     flags |= IExportable::Binary;
     flags |= IExportable::XML;
+    flags |= IExportable::XMLStream;
     return flags;
 }
 
@@ -925,6 +928,154 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Obs
     return IExportable::Complete;
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::ObserverHints::exportXmlStream(QXmlStreamWriter& writer) const {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    // Export hints:
+    if (d->action_hints != ActionNoHints)
+        writer.writeAttribute("ActionHints",actionHintsToString(d->action_hints));
+    if (d->activity_control != NoActivityControlHint)
+        writer.writeAttribute("ActivityControl",activityControlToString(d->activity_control));
+    if (d->activity_display != NoActivityDisplayHint)
+        writer.writeAttribute("ActivityDisplay",activityDisplayToString(d->activity_display));
+    if (d->display_flags != NoDisplayFlagsHint)
+        writer.writeAttribute("DisplayFlags",displayFlagsToString(d->display_flags));
+    if (d->drag_drop_flags != NoDragDrop)
+        writer.writeAttribute("DragDropFlags",dragDropFlagsToString(d->drag_drop_flags));
+    if (d->hierarhical_display != NoHierarchicalDisplayHint)
+        writer.writeAttribute("HierarchicalDisplay",hierarchicalDisplayToString(d->hierarhical_display));
+    if (d->item_view_column_hint != SelectableItems)
+        writer.writeAttribute("ItemSelectionControl",itemSelectionControlToString(d->item_selection_control));
+    if (d->item_view_column_hint != ColumnNoHints)
+        writer.writeAttribute("ItemViewColumnFlags",itemViewColumnFlagsToString(d->item_view_column_hint));
+    if (d->naming_control != NoNamingControlHint)
+        writer.writeAttribute("NamingControl",namingControlToString(d->naming_control));
+    if (d->observer_selection_context != SelectionUseParentContext)
+        writer.writeAttribute("ObserverSelectionContext",observerSelectionContextToString(d->observer_selection_context));
+    if (d->modification_state_display != NoModificationStateDisplayHint)
+        writer.writeAttribute("ModificationStateDisplay",modificationStateDisplayToString(d->modification_state_display));
+
+    // -----------------------------------
+    // Start of specific to Qtilities::Qtilities_1_1:
+    // -----------------------------------
+    if (exportVersion() == Qtilities::Qtilities_1_1) {
+        if (d->category_editing_flags != CategoriesReadOnly)
+            writer.writeAttribute("CategoryEditingFlags",categoryEditingFlagsToString(d->category_editing_flags));
+    }
+    // -----------------------------------
+    // End of specific to Qtilities::Qtilities_1_1:
+    // -----------------------------------
+    // Start of specific to Qtilities::Qtilities_1_2:
+    // -----------------------------------
+    if (exportVersion() == Qtilities::Qtilities_1_2) {
+        if (d->root_index_display_hint != RootIndexHide)
+            writer.writeAttribute("RootIndexDisplayHint",rootIndexDisplayHintToString(d->root_index_display_hint));
+    }
+    // -----------------------------------
+    // End of specific to Qtilities::Qtilities_1_2:
+    // -----------------------------------
+
+    // Export category related stuff only if it is neccesarry:
+    if (d->displayed_categories.count() > 0) {
+        writer.writeStartElement("CategoryFilter");
+        if (d->category_filter_enabled)
+            writer.writeAttribute("FilterEnabled","True");
+        else
+            writer.writeAttribute("FilterEnabled","False");
+        if (d->has_inversed_category_display)
+            writer.writeAttribute("FilterInversed","True");
+        else
+            writer.writeAttribute("FilterInversed","False");
+        writer.writeAttribute("CategoryCount",QString::number(d->displayed_categories.count()));
+
+        for (int i = 0; i < d->displayed_categories.count(); ++i) {
+            writer.writeStartElement("Category_" + QString::number(i));
+            d->displayed_categories.at(i).exportXmlStream(writer);
+            writer.writeEndElement();
+        }
+        writer.writeEndElement();
+    }
+    return IExportable::Complete;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::ObserverHints::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesImportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    // Hints:
+    QXmlStreamAttributes attributes = reader.attributes();
+    if (attributes.hasAttribute("ActionHints"))
+        d->action_hints = stringToActionHints(attributes.value("ActionHints").toString());
+    if (attributes.hasAttribute("ActivityControl"))
+        d->activity_control = stringToActivityControl(attributes.value("ActivityControl").toString());
+    if (attributes.hasAttribute("ActivityDisplay"))
+        d->activity_display = stringToActivityDisplay(attributes.value("ActivityDisplay").toString());
+    if (attributes.hasAttribute("DisplayFlags"))
+        d->display_flags = stringToDisplayFlags(attributes.value("DisplayFlags").toString());
+    if (attributes.hasAttribute("DragDropFlags"))
+        d->drag_drop_flags = stringToDragDropFlags(attributes.value("DragDropFlags").toString());
+    if (attributes.hasAttribute("HierarchicalDisplay"))
+        d->hierarhical_display = stringToHierarchicalDisplay(attributes.value("HierarchicalDisplay").toString());
+    if (attributes.hasAttribute("ItemSelectionControl"))
+        d->item_selection_control = stringToItemSelectionControl(attributes.value("ItemSelectionControl").toString());
+    if (attributes.hasAttribute("ItemViewColumnFlags"))
+        d->item_view_column_hint = stringToItemViewColumnFlags(attributes.value("ItemViewColumnFlags").toString());
+    if (attributes.hasAttribute("NamingControl"))
+        d->naming_control = stringToNamingControl(attributes.value("NamingControl").toString());
+    if (attributes.hasAttribute("ObserverSelectionContext"))
+        d->observer_selection_context = stringToObserverSelectionContext(attributes.value("ObserverSelectionContext").toString());
+    if (attributes.hasAttribute("ModificationStateDisplay"))
+        d->modification_state_display = stringToModificationStateDisplay(attributes.value("ModificationStateDisplay").toString());
+
+    // -----------------------------------
+    // Start of specific to Qtilities v1.1:
+    // -----------------------------------
+    if (attributes.hasAttribute("CategoryEditingFlags"))
+        d->category_editing_flags = stringToCategoryEditingFlags(attributes.value("CategoryEditingFlags").toString());
+    // -----------------------------------
+    // End of specific to Qtilities v1.1:
+    // -----------------------------------
+    // Start of specific to Qtilities v1.2:
+    // -----------------------------------
+    if (attributes.hasAttribute("RootIndexDisplayHint"))
+        d->root_index_display_hint = stringToRootIndexDisplayHint(attributes.value("RootIndexDisplayHint").toString());
+    // -----------------------------------
+    // End of specific to Qtilities v1.2:
+    // -----------------------------------
+
+    // Category stuff:
+    while (reader.readNextStartElement()) {
+        if (reader.name() == QLatin1String("CategoryFilter")) {
+            if (reader.attributes().value("FilterEnabled") == QLatin1String("True"))
+                d->category_filter_enabled = true;
+            else
+                d->category_filter_enabled = false;
+            if (reader.attributes().value("FilterInversed") == QLatin1String("True"))
+                d->has_inversed_category_display = true;
+            else
+                d->has_inversed_category_display = false;
+
+            while (reader.readNextStartElement()) {
+                if (reader.name().toString().startsWith("Category_")) {
+                    QtilitiesCategory new_category;
+                    new_category.importXmlStream(reader,import_list);
+                    if (new_category.isValid())
+                        d->displayed_categories << new_category;
+                } else {
+                    reader.skipCurrentElement();
+                }
+            }
+        } else {
+            reader.skipCurrentElement();
+        }
+    }
+
+    return IExportable::Complete;
+}
+
 QDataStream & operator<< (QDataStream& stream, const Qtilities::Core::ObserverHints& stream_obj) {
     stream_obj.exportBinary(stream);
     return stream;
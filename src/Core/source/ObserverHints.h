@@ -473,6 +473,8 @@ category_filter_enabled(false),
             IExportable::ExportResultFlags importBinary(QDataStream& stream, QList<QPointer<QObject> >& import_list);
             IExportable::ExportResultFlags exportXml(QDomDocument* doc, QDomElement* object_node) const;
             IExportable::ExportResultFlags importXml(QDomDocument* doc, QDomElement* object_node, QList<QPointer<QObject> >& import_list);
+            IExportable::ExportResultFlags exportXmlStream(QXmlStreamWriter& writer) const;
+            IExportable::ExportResultFlags importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list);
 
             // --------------------------------
             // IModificationNotifier Implementation
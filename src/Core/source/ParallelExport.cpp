@@ -0,0 +1,225 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#include "ParallelExport.h"
+#include "Task.h"
+
+#include <QThreadPool>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include <QVector>
+
+namespace {
+    // The number of parallel exports which are busy in all threads.
+    QAtomicInt active_parallel_exports;
+}
+
+struct Qtilities::Core::ParallelExportPrivateData {
+    ParallelExportPrivateData() : stream_version(QDataStream::Qt_4_7),
+        task(0),
+        thread_pool(0),
+        data_ptr(0),
+        results_ptr(0),
+        reported_parts(0) {}
+
+    int                                         stream_version;
+    ITask*                                      task;
+    QThreadPool*                                thread_pool;
+    QList<AbstractExportPart*>                  parts;
+    QVector<QByteArray>                         data;
+    QVector<IExportable::ExportResultFlags>     results;
+    // Parts are exported into these, which avoids detaching the vectors from different threads:
+    QByteArray*                                 data_ptr;
+    IExportable::ExportResultFlags*             results_ptr;
+    // The indices of the thread safe parts, taken by threads in order:
+    QVector<int>                                thread_safe_parts;
+    QAtomicInt                                  next_part;
+    QAtomicInt                                  completed_parts;
+    QAtomicInt                                  cancelled;
+    QSemaphore                                  finished_workers;
+    int                                         reported_parts;
+
+    // Set by ParallelExportTaskMonitor, thus workers never access the task:
+    bool isCancelled() {
+        return cancelled.fetchAndAddOrdered(0) != 0;
+    }
+
+    void exportPart(int index, ITask* part_task) {
+        QByteArray buffer;
+        {
+            QDataStream stream(&buffer,QIODevice::WriteOnly);
+            stream.setVersion(stream_version);
+            results_ptr[index] = parts.at(index)->exportPart(stream,part_task);
+        }
+        parts.at(index)->finishPart(&buffer);
+        data_ptr[index] = buffer;
+        completed_parts.fetchAndAddOrdered(1);
+    }
+
+    // Exports thread safe parts until all of them were taken by this or other threads:
+    void exportThreadSafeParts(bool report_progress) {
+        int next = next_part.fetchAndAddOrdered(1);
+        while (next < thread_safe_parts.count()) {
+            if (isCancelled())
+                return;
+
+            exportPart(thread_safe_parts.at(next),0);
+            if (report_progress)
+                reportProgress();
+            next = next_part.fetchAndAddOrdered(1);
+        }
+    }
+
+    // Only called from the thread calling exportParts():
+    void reportProgress() {
+        int completed = completed_parts.fetchAndAddOrdered(0);
+        if (completed <= reported_parts)
+            return;
+
+        Task* task_ref = task ? qobject_cast<Task*> (task->objectBase()) : 0;
+        if (task_ref && task_ref->state() == ITask::TaskBusy)
+            task_ref->addCompletedSubTasks(completed - reported_parts);
+        reported_parts = completed;
+    }
+};
+
+namespace {
+    class ParallelExportWorker : public QRunnable {
+    public:
+        ParallelExportWorker(Qtilities::Core::ParallelExportPrivateData* state) : QRunnable(), d_state(state) {}
+        void run() {
+            d_state->exportThreadSafeParts(false);
+            d_state->finished_workers.release();
+        }
+
+    private:
+        Qtilities::Core::ParallelExportPrivateData* d_state;
+    };
+}
+
+Qtilities::Core::ParallelExportTaskMonitor::ParallelExportTaskMonitor(ITask* task, QAtomicInt* cancelled) : QObject(), d_cancelled(cancelled) {
+    if (!task)
+        return;
+
+    // A direct connection sets the flag as soon as the state changes, in the thread changing it:
+    connect(task->objectBase(),SIGNAL(stateChanged(ITask::TaskState,ITask::TaskState)),SLOT(handle_taskStateChanged(ITask::TaskState)),Qt::DirectConnection);
+    handle_taskStateChanged(task->state());
+}
+
+void Qtilities::Core::ParallelExportTaskMonitor::handle_taskStateChanged(ITask::TaskState new_state) {
+    if (new_state == ITask::TaskStopped || new_state == ITask::TaskCompleted)
+        d_cancelled->fetchAndStoreOrdered(1);
+}
+
+Qtilities::Core::ParallelExport::ParallelExport(int stream_version, ITask* task, QThreadPool* thread_pool) {
+    d = new ParallelExportPrivateData;
+    d->stream_version = stream_version;
+    d->task = task;
+    d->thread_pool = thread_pool;
+}
+
+Qtilities::Core::ParallelExport::~ParallelExport() {
+    qDeleteAll(d->parts);
+    delete d;
+}
+
+void Qtilities::Core::ParallelExport::addPart(AbstractExportPart* part) {
+    if (part)
+        d->parts << part;
+}
+
+int Qtilities::Core::ParallelExport::partCount() const {
+    return d->parts.count();
+}
+
+Qtilities::Core::AbstractExportPart* Qtilities::Core::ParallelExport::part(int index) const {
+    if (index < 0 || index >= d->parts.count())
+        return 0;
+    return d->parts.at(index);
+}
+
+bool Qtilities::Core::ParallelExport::exportParts() {
+    QThreadPool* thread_pool = d->thread_pool;
+    if (!thread_pool)
+        thread_pool = QThreadPool::globalInstance();
+
+    d->data.fill(QByteArray(),d->parts.count());
+    d->results.fill(IExportable::Failed,d->parts.count());
+    d->data_ptr = d->data.data();
+    d->results_ptr = d->results.data();
+    d->thread_safe_parts.clear();
+    d->next_part.fetchAndStoreOrdered(0);
+    d->completed_parts.fetchAndStoreOrdered(0);
+    d->cancelled.fetchAndStoreOrdered(0);
+    d->reported_parts = 0;
+    ParallelExportTaskMonitor task_monitor(d->task,&d->cancelled);
+
+    QList<int> calling_thread_parts;
+    for (int i = 0; i < d->parts.count(); ++i) {
+        if (d->parts.at(i)->isThreadSafe())
+            d->thread_safe_parts << i;
+        else
+            calling_thread_parts << i;
+    }
+
+    active_parallel_exports.ref();
+
+    // Only use idle threads. If the pool is busy, the calling thread does the work. When the calling
+    // thread has parts of its own to export, it only joins the other threads when it is done with them:
+    int thread_count = qMax(1,thread_pool->maxThreadCount());
+    int worker_count = qMin(thread_count,d->thread_safe_parts.count());
+    if (calling_thread_parts.isEmpty())
+        --worker_count;
+    int started_workers = 0;
+    for (int i = 0; i < worker_count; ++i) {
+        ParallelExportWorker* worker = new ParallelExportWorker(d);
+        if (!thread_pool->tryStart(worker)) {
+            delete worker;
+            break;
+        }
+        ++started_workers;
+    }
+
+    for (int i = 0; i < calling_thread_parts.count(); ++i) {
+        if (d->isCancelled())
+            break;
+        d->exportPart(calling_thread_parts.at(i),d->task);
+        d->reportProgress();
+    }
+    d->exportThreadSafeParts(true);
+
+    int finished_workers = 0;
+    while (finished_workers < started_workers) {
+        if (d->finished_workers.tryAcquire(1,100))
+            ++finished_workers;
+        d->reportProgress();
+    }
+
+    active_parallel_exports.deref();
+    return !d->cancelled.fetchAndAddOrdered(0);
+}
+
+QByteArray Qtilities::Core::ParallelExport::partData(int index) const {
+    if (index < 0 || index >= d->data.count())
+        return QByteArray();
+    return d->data.at(index);
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::ParallelExport::partResult(int index) const {
+    if (index < 0 || index >= d->results.count())
+        return IExportable::Failed;
+    return d->results.at(index);
+}
+
+bool Qtilities::Core::ParallelExport::isBusy() {
+    return active_parallel_exports.fetchAndAddOrdered(0) > 0;
+}
@@ -0,0 +1,156 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#ifndef PARALLEL_EXPORT_H
+#define PARALLEL_EXPORT_H
+
+#include "QtilitiesCore_global.h"
+#include "IExportable.h"
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QDataStream>
+
+class QThreadPool;
+
+namespace Qtilities {
+    namespace Core {
+        using namespace Qtilities::Core::Interfaces;
+
+        /*!
+          \class AbstractExportPart
+          \brief The AbstractExportPart class is the base class of independent parts of a binary export which are exported by ParallelExport.
+
+          <i>This class was added in %Qtilities v1.5.</i>
+          */
+        class QTILIITES_CORE_SHARED_EXPORT AbstractExportPart
+        {
+        public:
+            AbstractExportPart() {}
+            virtual ~AbstractExportPart() {}
+
+            //! Indicates if this part can be exported from a thread in the thread pool. Parts which are not thread safe are exported in the calling thread.
+            virtual bool isThreadSafe() const = 0;
+            //! Exports the part to \p stream.
+            /*!
+              \param task The task to which information about the export must be logged. Only parts which are not thread safe get a task, since
+              the logging functions of tasks can only be used from the calling thread. For thread safe parts this is always 0.
+              */
+            virtual IExportable::ExportResultFlags exportPart(QDataStream& stream, ITask* task) = 0;
+            //! Called in the same thread as exportPart() after the part was exported, for example to compress \p data.
+            virtual void finishPart(QByteArray* data) { Q_UNUSED(data) }
+        };
+
+        /*!
+          \class ParallelExportTaskMonitor
+          \brief The ParallelExportTaskMonitor class sets the cancellation flag of work done in parallel when its task is stopped or completed.
+
+          The flag is set from the thread in which the state of the task changes, thus threads doing the work never access the task itself.
+
+          You should not need to use this class directly, ParallelExport::exportParts() and Observer::visitTree() use it internally.
+
+          <i>This class was added in %Qtilities v1.5.</i>
+          */
+        class QTILIITES_CORE_SHARED_EXPORT ParallelExportTaskMonitor : public QObject
+        {
+            Q_OBJECT
+
+        public:
+            //! Monitors \p task, setting \p cancelled when it is stopped or completed. Also sets \p cancelled when this is already the case.
+            ParallelExportTaskMonitor(ITask* task, QAtomicInt* cancelled);
+
+        private slots:
+            void handle_taskStateChanged(ITask::TaskState new_state);
+
+        private:
+            QAtomicInt* d_cancelled;
+        };
+
+        /*!
+        \struct ParallelExportPrivateData
+        \brief The ParallelExportPrivateData struct stores private data used by the ParallelExport class.
+          */
+        struct ParallelExportPrivateData;
+
+        /*!
+          \class ParallelExport
+          \brief The ParallelExport class exports independent parts of a binary export into separate buffers in parallel.
+
+          Parts are added using addPart() and exported by exportParts(). Every part is exported into its own buffer using a QDataStream
+          with the stream version passed to the constructor, thus the buffers can be written to the final stream in the order in which
+          the parts were added using QDataStream::writeRawData(). This gives exactly the same output as exporting the parts directly to the
+          final stream one after the other.
+
+          Thread safe parts are exported on a thread pool. Threads take the next part as soon as they are done with a part, and the calling
+          thread exports parts as well. Parts which are not thread safe are exported in the calling thread, in the order in which they were added.
+
+\code
+ParallelExport parallel_export(stream.version(),exportTask());
+for (int i = 0; i < items.count(); ++i)
+    parallel_export.addPart(new MyExportPart(items.at(i)));
+
+if (!parallel_export.exportParts())
+    return IExportable::Failed;
+
+for (int i = 0; i < parallel_export.partCount(); ++i)
+    stream.writeRawData(parallel_export.partData(i).constData(),parallel_export.partData(i).size());
+\endcode
+
+          When a task is specified, one sub task is completed on it for every exported part and the export is cancelled as soon as the task
+          is stopped or completed. Progress is reported from the calling thread only.
+
+          <i>This class was added in %Qtilities v1.5.</i>
+          */
+        class QTILIITES_CORE_SHARED_EXPORT ParallelExport
+        {
+        public:
+            //! Constructs a parallel export.
+            /*!
+              \param stream_version The QDataStream version used for the buffers of all parts.
+              \param task The task used to report progress and to cancel the export. The task must be started before calling exportParts().
+              \param thread_pool The thread pool to use. When 0, QThreadPool::globalInstance() is used. Only idle threads in the pool are used,
+              thus exports can be nested in parts which are themselves exported on the pool.
+              */
+            ParallelExport(int stream_version, ITask* task = 0, QThreadPool* thread_pool = 0);
+            //! Destroys the parallel export and all of its parts.
+            ~ParallelExport();
+
+            //! Adds a part to the export. The parallel export takes ownership of \p part.
+            void addPart(AbstractExportPart* part);
+            //! Returns the number of parts in the export.
+            int partCount() const;
+            //! Returns the part at \p index.
+            AbstractExportPart* part(int index) const;
+
+            //! Exports all parts.
+            /*!
+              \returns True when all parts were exported, false when the export was cancelled. The results of the individual parts are available through partResult().
+              */
+            bool exportParts();
+            //! Returns the buffer to which the part at \p index was exported.
+            QByteArray partData(int index) const;
+            //! Returns the result of the export of the part at \p index. Parts which were not exported because the export was cancelled are IExportable::Failed.
+            IExportable::ExportResultFlags partResult(int index) const;
+
+            //! Indicates if a parallel export is busy in any thread.
+            /*!
+              Exports which process events while they run must not do so while this is true, since events could change objects which are being exported in other threads.
+              */
+            static bool isBusy();
+
+        private:
+            ParallelExportPrivateData* d;
+        };
+    }
+}
+
+#endif // PARALLEL_EXPORT_H
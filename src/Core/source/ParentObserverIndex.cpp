@@ -0,0 +1,137 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#include "ParentObserverIndex.h"
+#include "Observer.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QVarLengthArray>
+
+namespace {
+    // Most objects are observed by only a few observers, thus the parents of an object are stored inline.
+    typedef QVarLengthArray<Qtilities::Core::Observer*,4> ParentObserverList;
+}
+
+struct Qtilities::Core::ParentObserverIndexPrivateData {
+    QHash<const QObject*,ParentObserverList>    parents;
+    mutable QReadWriteLock                      lock;
+};
+
+Qtilities::Core::ParentObserverIndex* Qtilities::Core::ParentObserverIndex::m_Instance = 0;
+
+Qtilities::Core::ParentObserverIndex* Qtilities::Core::ParentObserverIndex::instance() {
+    static QMutex mutex;
+    if (!m_Instance)
+    {
+        mutex.lock();
+
+        if (!m_Instance)
+            m_Instance = new ParentObserverIndex;
+
+        mutex.unlock();
+    }
+
+    return m_Instance;
+}
+
+Qtilities::Core::ParentObserverIndex::ParentObserverIndex() : QObject() {
+    d = new ParentObserverIndexPrivateData;
+}
+
+Qtilities::Core::ParentObserverIndex::~ParentObserverIndex() {
+    delete d;
+}
+
+int Qtilities::Core::ParentObserverIndex::parentCount(const QObject* obj) const {
+    QReadLocker locker(&d->lock);
+    QHash<const QObject*,ParentObserverList>::const_iterator itr = d->parents.constFind(obj);
+    if (itr == d->parents.constEnd())
+        return 0;
+    return itr.value().count();
+}
+
+QList<Qtilities::Core::Observer*> Qtilities::Core::ParentObserverIndex::parents(const QObject* obj) const {
+    QList<Observer*> parents;
+    QReadLocker locker(&d->lock);
+    QHash<const QObject*,ParentObserverList>::const_iterator itr = d->parents.constFind(obj);
+    if (itr != d->parents.constEnd()) {
+        const ParentObserverList& list = itr.value();
+        for (int i = 0; i < list.count(); ++i)
+            parents << list.at(i);
+    }
+    return parents;
+}
+
+void Qtilities::Core::ParentObserverIndex::addParent(const QObject* obj, Observer* observer) {
+    if (!obj || !observer)
+        return;
+
+    QWriteLocker locker(&d->lock);
+    QHash<const QObject*,ParentObserverList>::iterator itr = d->parents.find(obj);
+    if (itr == d->parents.end()) {
+        itr = d->parents.insert(obj,ParentObserverList());
+        // Don't rely on observers to remove the entry of a deleted object:
+        connect(obj,SIGNAL(destroyed(QObject*)),SLOT(handle_objectDestroyed(QObject*)),Qt::DirectConnection);
+    }
+
+    ParentObserverList& list = itr.value();
+    for (int i = 0; i < list.count(); ++i) {
+        if (list.at(i) == observer)
+            return;
+    }
+
+    // Observer IDs are handed out in increasing order, thus new parents are normally appended at the end:
+    int observer_id = observer->observerID();
+    list.append(observer);
+    int i = list.count() - 1;
+    while (i > 0 && list.at(i-1)->observerID() > observer_id) {
+        list[i] = list.at(i-1);
+        --i;
+    }
+    list[i] = observer;
+}
+
+void Qtilities::Core::ParentObserverIndex::removeParent(const QObject* obj, Observer* observer) {
+    if (!obj || !observer)
+        return;
+
+    QWriteLocker locker(&d->lock);
+    QHash<const QObject*,ParentObserverList>::iterator itr = d->parents.find(obj);
+    if (itr == d->parents.end())
+        return;
+
+    ParentObserverList& list = itr.value();
+    for (int i = 0; i < list.count(); ++i) {
+        if (list.at(i) == observer) {
+            for (int j = i; j < list.count() - 1; ++j)
+                list[j] = list.at(j+1);
+            list.resize(list.count() - 1);
+            break;
+        }
+    }
+    if (list.isEmpty()) {
+        d->parents.erase(itr);
+        disconnect(obj,SIGNAL(destroyed(QObject*)),this,SLOT(handle_objectDestroyed(QObject*)));
+    }
+}
+
+int Qtilities::Core::ParentObserverIndex::count() const {
+    QReadLocker locker(&d->lock);
+    return d->parents.count();
+}
+
+void Qtilities::Core::ParentObserverIndex::handle_objectDestroyed(QObject* obj) {
+    // Don't use sender() here, it is not valid for direct connections made from other threads.
+    QWriteLocker locker(&d->lock);
+    d->parents.remove(obj);
+}
@@ -0,0 +1,78 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#ifndef PARENT_OBSERVER_INDEX_H
+#define PARENT_OBSERVER_INDEX_H
+
+#include "QtilitiesCore_global.h"
+
+#include <QObject>
+#include <QList>
+
+namespace Qtilities {
+    namespace Core {
+        class Observer;
+
+        /*!
+        \struct ParentObserverIndexPrivateData
+        \brief Structure used by ParentObserverIndex to store private data.
+          */
+        struct ParentObserverIndexPrivateData;
+
+        /*!
+          \class ParentObserverIndex
+          \brief The ParentObserverIndex class is the reverse index of the observers observing each object.
+
+          The index mirrors the contexts of the qti_prop_OBSERVER_MAP properties on observed objects. The parents of each object are
+          sorted on their observer IDs, which is the order in which the contexts of the property are stored.
+
+          Observers update the index when objects enter or leave their context. Entries of objects which are destroyed are dropped by the
+          index itself, thus objects which are deleted in ways which bypass their observers, for example using QObject::deleteLater(), never
+          leave entries behind which could be picked up by new objects created at the same address.
+
+          You should not need to use this class directly, ObjectManager::parentObserverCount() and ObjectManager::parentObservers() use it internally.
+
+          The index is thread safe.
+
+          <i>This class was added in %Qtilities v1.5.</i>
+          */
+        class QTILIITES_CORE_SHARED_EXPORT ParentObserverIndex : public QObject
+        {
+            Q_OBJECT
+
+        public:
+            static ParentObserverIndex* instance();
+            ~ParentObserverIndex();
+
+            //! Returns the number of observers observing \p obj.
+            int parentCount(const QObject* obj) const;
+            //! Returns the observers observing \p obj, sorted on their observer IDs.
+            QList<Observer*> parents(const QObject* obj) const;
+            //! Adds \p observer to the parents of \p obj.
+            void addParent(const QObject* obj, Observer* observer);
+            //! Removes \p observer from the parents of \p obj.
+            void removeParent(const QObject* obj, Observer* observer);
+            //! Returns the number of objects which have entries in the index.
+            int count() const;
+
+        private slots:
+            void handle_objectDestroyed(QObject* obj);
+
+        private:
+            ParentObserverIndex();
+
+            static ParentObserverIndex* m_Instance;
+            ParentObserverIndexPrivateData* d;
+        };
+    }
+}
+
+#endif // PARENT_OBSERVER_INDEX_H
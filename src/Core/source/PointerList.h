@@ -97,6 +97,10 @@ test_list: Delete object test2 during destruction of test_list. Deleting it will
             void deleteAll();
             int count() const;
             void removeOne(QObject* obj);
+            //! Removes all the objects in \p objects from the list in a single pass over the list.
+            void removeObjects(const QList<QObject*>& objects);
+            //! Reserves space for \p size objects in the list.
+            void reserve(int size);
             QObject* at(int i) const;
             QMutableListIterator<QObject*> iterator();
             QList<QObject*> toQList() const;
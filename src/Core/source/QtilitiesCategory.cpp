@@ -14,6 +14,8 @@
 #include <Logger.h>
 
 #include <QDomElement>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 // -----------------------------------------
 // CategoryLevel
@@ -22,6 +24,7 @@ Qtilities::Core::IExportable::ExportModeFlags Qtilities::Core::CategoryLevel::su
     IExportable::ExportModeFlags flags = 0;
     flags |= IExportable::Binary;
     flags |= IExportable::XML;
+    flags |= IExportable::XMLStream;
     return flags;
 }
 
@@ -72,6 +75,33 @@ Qtilities::Core::IExportable::ExportResultFlags Qtilities::Core::CategoryLevel::
     return IExportable::Failed;
 }
 
+Qtilities::Core::IExportable::ExportResultFlags Qtilities::Core::CategoryLevel::exportXmlStream(QXmlStreamWriter& writer) const {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    writer.writeAttribute("Name",d_name);
+    return IExportable::Complete;
+}
+
+Qtilities::Core::IExportable::ExportResultFlags Qtilities::Core::CategoryLevel::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    Q_UNUSED(import_list)
+
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesImportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    bool has_name = reader.attributes().hasAttribute("Name");
+    if (has_name)
+        d_name = reader.attributes().value("Name").toString();
+    reader.skipCurrentElement();
+
+    if (has_name)
+        return IExportable::Complete;
+    else
+        return IExportable::Failed;
+}
+
 // -----------------------------------------
 // QtilitiesCategory
 // -----------------------------------------
@@ -175,6 +205,7 @@ Qtilities::Core::Interfaces::IExportable::ExportModeFlags Qtilities::Core::Qtili
     IExportable::ExportModeFlags flags = 0;
     flags |= IExportable::Binary;
     flags |= IExportable::XML;
+    flags |= IExportable::XMLStream;
     return flags;
 }
 
@@ -279,6 +310,57 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Qti
         return IExportable::Failed;
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::QtilitiesCategory::exportXmlStream(QXmlStreamWriter& writer) const {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    writer.writeAttribute("AccessMode",QString::number(d_access_mode));
+    writer.writeAttribute("Depth",QString::number(d_category_levels.count()));
+    bool all_successful = true;
+    for (int i = 0; i < d_category_levels.count(); ++i) {
+        writer.writeStartElement("CategoryLevel_" + QString::number(i));
+        if (d_category_levels.at(i).exportXmlStream(writer) != IExportable::Complete)
+            all_successful = false;
+        writer.writeEndElement();
+    }
+
+    if (all_successful)
+        return IExportable::Complete;
+    else
+        return IExportable::Failed;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::QtilitiesCategory::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesImportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    int depth_readback = 0;
+
+    QXmlStreamAttributes attributes = reader.attributes();
+    if (attributes.hasAttribute("AccessMode"))
+        d_access_mode = attributes.value("AccessMode").toString().toInt();
+    if (attributes.hasAttribute("Depth"))
+        depth_readback = attributes.value("Depth").toString().toInt();
+
+    while (reader.readNextStartElement()) {
+        if (reader.name().toString().startsWith("CategoryLevel")) {
+            CategoryLevel category_level;
+            category_level.setExportVersion(exportVersion());
+            category_level.importXmlStream(reader,import_list);
+            addLevel(category_level);
+        } else {
+            reader.skipCurrentElement();
+        }
+    }
+
+    if (categoryDepth() == depth_readback)
+        return IExportable::Complete;
+    else
+        return IExportable::Failed;
+}
+
 QDataStream & operator<< (QDataStream& stream, const Qtilities::Core::CategoryLevel& stream_obj) {
     stream_obj.exportBinary(stream);
     return stream;
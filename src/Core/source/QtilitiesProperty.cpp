@@ -17,6 +17,8 @@
 #include <Logger>
 
 #include <QDomDocument>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 using namespace Qtilities::Core::Properties;
 
@@ -222,6 +224,7 @@ Qtilities::Core::Interfaces::IExportable::ExportModeFlags Qtilities::Core::Qtili
     IExportable::ExportModeFlags flags = 0;
     flags |= IExportable::Binary;
     flags |= IExportable::XML;
+    flags |= IExportable::XMLStream;
     return flags;
 }
 
@@ -338,6 +341,64 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Qti
     return IExportable::Complete;
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::QtilitiesProperty::exportXmlStream(QXmlStreamWriter& writer) const {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    if (!name.isEmpty())
+        writer.writeAttribute("Name",name);
+
+    writer.writeAttribute("Reserved",is_reserved ? "1" : "0");
+    writer.writeAttribute("ReadOnly",read_only ? "1" : "0");
+    writer.writeAttribute("Removable",is_removable ? "1" : "0");
+    writer.writeAttribute("Notifications",supports_change_notifications ? "1" : "0");
+
+    return IExportable::Complete;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::QtilitiesProperty::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    Q_UNUSED(import_list)
+
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesImportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    importXmlStreamAttributes(reader.attributes());
+    reader.skipCurrentElement();
+
+    return IExportable::Complete;
+}
+
+void Qtilities::Core::QtilitiesProperty::importXmlStreamAttributes(const QXmlStreamAttributes& attributes) {
+    name = attributes.value("Name").toString();
+
+    if (attributes.hasAttribute("Reserved")) {
+        if (attributes.value("Reserved") == QLatin1String("1"))
+            is_reserved = true;
+        if (attributes.value("Reserved") == QLatin1String("0"))
+            is_reserved = false;
+    }
+    if (attributes.hasAttribute("ReadOnly")) {
+        if (attributes.value("ReadOnly") == QLatin1String("1"))
+            read_only = true;
+        if (attributes.value("ReadOnly") == QLatin1String("0"))
+            read_only = false;
+    }
+    if (attributes.hasAttribute("Removable")) {
+        if (attributes.value("Removable") == QLatin1String("1"))
+            is_removable = true;
+        if (attributes.value("Removable") == QLatin1String("0"))
+            is_removable = false;
+    }
+    if (attributes.hasAttribute("Notifications")) {
+        if (attributes.value("Notifications") == QLatin1String("1"))
+            supports_change_notifications = true;
+        if (attributes.value("Notifications") == QLatin1String("0"))
+            supports_change_notifications = false;
+    }
+}
+
 QVariant Qtilities::Core::QtilitiesProperty::constructVariant(const QString& type_string, const QString& value_string) {
     QVariant::Type type = QVariant::nameToType(type_string.toUtf8().constData());
     return QtilitiesProperty::constructVariant(type,value_string);
@@ -504,6 +565,7 @@ Qtilities::Core::Interfaces::IExportable::ExportModeFlags Qtilities::Core::Multi
     IExportable::ExportModeFlags flags = 0;
     flags |= IExportable::Binary;
     flags |= IExportable::XML;
+    flags |= IExportable::XMLStream;
     return flags;
 }
 
@@ -608,6 +670,66 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Mul
     return result;
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::MultiContextProperty::exportXmlStream(QXmlStreamWriter& writer) const {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    QMap<quint32,QVariant>::const_iterator itr;
+    for (itr = context_map.constBegin(); itr != context_map.constEnd(); ++itr) {
+        if (!isExportableVariant(itr.value())) {
+            LOG_DEBUG("Failed to export MultiContextProperty. It contains a QVariant which cannot be converted to a QString(). Type name: " + QString(itr.value().typeName()));
+            return IExportable::Incomplete;
+        }
+    }
+
+    IExportable::ExportResultFlags result = QtilitiesProperty::exportXmlStream(writer);
+    if (result == IExportable::Failed)
+        return result;
+
+    writer.writeAttribute("Count",QString::number(context_map.count()));
+    int i = 0;
+    for (itr = context_map.constBegin(); itr != context_map.constEnd(); ++itr) {
+        writer.writeStartElement("Context_" + QString::number(i++));
+        writer.writeAttribute("ID",QString::number(itr.key()));
+        writer.writeAttribute("Type",itr.value().typeName());
+        if (itr.value().type() == QVariant::StringList)
+            writer.writeAttribute("Value",itr.value().toStringList().join(","));
+        else
+            writer.writeAttribute("Value",itr.value().toString());
+        writer.writeEndElement();
+    }
+
+    return result;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::MultiContextProperty::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    Q_UNUSED(import_list)
+
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesImportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    context_map.clear();
+
+    IExportable::ExportResultFlags result = IExportable::Complete;
+    importXmlStreamAttributes(reader.attributes());
+
+    while (reader.readNextStartElement()) {
+        if (reader.name().toString().startsWith("Context_")) {
+            QXmlStreamAttributes attributes = reader.attributes();
+            if (attributes.hasAttribute("Type") && attributes.hasAttribute("Value")) {
+                int observer_id = attributes.value("ID").toString().toInt();
+                context_map[observer_id] = constructVariant(attributes.value("Type").toString(),attributes.value("Value").toString());
+            } else
+                result = IExportable::Incomplete;
+        }
+        reader.skipCurrentElement();
+    }
+
+    return result;
+}
+
 // ------------------------------------------
 // SharedProperty
 // ------------------------------------------
@@ -683,6 +805,7 @@ Qtilities::Core::Interfaces::IExportable::ExportModeFlags Qtilities::Core::Share
     IExportable::ExportModeFlags flags = 0;
     flags |= IExportable::Binary;
     flags |= IExportable::XML;
+    flags |= IExportable::XMLStream;
     return flags;
 }
 
@@ -763,6 +886,49 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Sha
     return result;
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::SharedProperty::exportXmlStream(QXmlStreamWriter& writer) const {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    if (!isExportableVariant(property_value)) {
+        LOG_DEBUG("Failed to export SharedProperty. It contains a QVariant which cannot be converted to a QString(). Type name: " + QString(property_value.typeName()));
+        return IExportable::Incomplete;
+    }
+
+    IExportable::ExportResultFlags result = QtilitiesProperty::exportXmlStream(writer);
+    if (result == IExportable::Failed)
+        return result;
+
+    writer.writeAttribute("Type",property_value.typeName());
+    if (property_value.type() == QVariant::StringList)
+        writer.writeAttribute("Value",property_value.toStringList().join(","));
+    else
+        writer.writeAttribute("Value",property_value.toString());
+
+    return result;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::SharedProperty::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    Q_UNUSED(import_list)
+
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesImportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    IExportable::ExportResultFlags result = IExportable::Complete;
+    QXmlStreamAttributes attributes = reader.attributes();
+    importXmlStreamAttributes(attributes);
+
+    if (attributes.hasAttribute("Type") && attributes.hasAttribute("Value"))
+        property_value = constructVariant(attributes.value("Type").toString(),attributes.value("Value").toString());
+    else
+        result = IExportable::Incomplete;
+    reader.skipCurrentElement();
+
+    return result;
+}
+
 QDataStream & operator<< (QDataStream& stream, const Qtilities::Core::MultiContextProperty& stream_obj) {
     stream_obj.exportBinary(stream);
     return stream;
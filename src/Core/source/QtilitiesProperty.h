@@ -21,6 +21,8 @@
 #include "Qtilities.h"
 #include "IExportable.h"
 
+class QXmlStreamAttributes;
+
 namespace Qtilities {
     namespace Core {
             using namespace Qtilities::Core::Interfaces;
@@ -127,6 +129,8 @@ namespace Qtilities {
                 virtual IExportable::ExportResultFlags importBinary(QDataStream& stream, QList<QPointer<QObject> >& import_list);
                 virtual IExportable::ExportResultFlags exportXml(QDomDocument* doc, QDomElement* object_node) const;
                 virtual IExportable::ExportResultFlags importXml(QDomDocument* doc, QDomElement* object_node, QList<QPointer<QObject> >& import_list);
+                virtual IExportable::ExportResultFlags exportXmlStream(QXmlStreamWriter& writer) const;
+                virtual IExportable::ExportResultFlags importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list);
 
                 //! Converts a QString type_string and QString value_string to a matching QVariant.
                 static QVariant constructVariant(const QString& type_string, const QString& value_string);
@@ -136,6 +140,14 @@ namespace Qtilities {
                 static bool isExportableVariant(QVariant variant);
 
             protected:
+                //! Reads the attributes written by exportXmlStream() on the element at which an XML stream is positioned.
+                /*!
+                  Subclasses use this function to read the base class attributes, after which they read their own attributes and child elements.
+
+                  <i>This function was added in %Qtilities v1.5.</i>
+                  */
+                void importXmlStreamAttributes(const QXmlStreamAttributes& attributes);
+
                 QString                 name;
                 bool                    is_reserved;
                 bool                    read_only;
@@ -268,6 +280,8 @@ if (prop.isValid() && prop.canConvert<MultiContextProperty>()) {
               This function will add a set of attributes directly to the object_node passed to it.
               */
             virtual IExportable::ExportResultFlags importXml(QDomDocument* doc, QDomElement* object_node, QList<QPointer<QObject> >& import_list);
+            virtual IExportable::ExportResultFlags exportXmlStream(QXmlStreamWriter& writer) const;
+            virtual IExportable::ExportResultFlags importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list);
 
         protected:
             QMap<quint32,QVariant>  context_map;
@@ -369,6 +383,8 @@ if (prop.isValid() && prop.canConvert<SharedProperty>()) {
               This function will add a set of attributes directly to the object_node passed to it.
               */
             virtual IExportable::ExportResultFlags importXml(QDomDocument* doc, QDomElement* object_node, QList<QPointer<QObject> >& import_list);
+            virtual IExportable::ExportResultFlags exportXmlStream(QXmlStreamWriter& writer) const;
+            virtual IExportable::ExportResultFlags importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list);
 
         private:
             QVariant property_value;
@@ -19,6 +19,8 @@
 #include <QVariant>
 #include <QDomElement>
 #include <QDomDocument>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 using namespace Qtilities::Core::Constants;
 
@@ -219,6 +221,7 @@ Qtilities::Core::Interfaces::IExportable::ExportModeFlags Qtilities::Core::Subje
     IExportable::ExportModeFlags flags = 0;
     flags |= IExportable::Binary;
     flags |= IExportable::XML;
+    flags |= IExportable::XMLStream;
     return flags;
 }
 
@@ -358,6 +361,83 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::Sub
         return IExportable::Failed;
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::SubjectTypeFilter::exportXmlStream(QXmlStreamWriter& writer) const {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    if (d->inversed_filtering)
+        writer.writeAttribute("InversedFiltering","True");
+    if (!d->known_objects_group_name.isEmpty())
+        writer.writeAttribute("GroupName",d->known_objects_group_name);
+    writer.writeAttribute("TypeCount",QString::number(d->known_subject_types.count()));
+
+    // Categories:
+    if (d->known_subject_types.count() > 0) {
+        writer.writeStartElement("KnownTypes");
+        for (int i = 0; i < d->known_subject_types.count(); ++i) {
+            writer.writeStartElement("Type_" + QString::number(i));
+            writer.writeAttribute("MetaType",d->known_subject_types.at(i).d_meta_type);
+            writer.writeAttribute("Name",d->known_subject_types.at(i).d_name);
+            writer.writeEndElement();
+        }
+        writer.writeEndElement();
+    }
+
+    return IExportable::Complete;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::Core::SubjectTypeFilter::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    Q_UNUSED(import_list)
+
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesImportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    QXmlStreamAttributes attributes = reader.attributes();
+    if (attributes.hasAttribute("InversedFiltering")) {
+        if (attributes.value("InversedFiltering") == QLatin1String("True"))
+            d->inversed_filtering = true;
+        else
+            d->inversed_filtering = false;
+    }
+    if (attributes.hasAttribute("GroupName"))
+        d->known_objects_group_name = attributes.value("GroupName").toString();
+
+    int count_readback = 0;
+    if (attributes.hasAttribute("TypeCount"))
+        count_readback = attributes.value("TypeCount").toString().toInt();
+
+    // Known types stuff. The remainder of the element is always read, also when invalid types are found:
+    bool valid = true;
+    while (reader.readNextStartElement()) {
+        if (reader.name() == QLatin1String("KnownTypes")) {
+            while (reader.readNextStartElement()) {
+                if (reader.name().toString().startsWith("Type")) {
+                    QString meta_type = reader.attributes().value("MetaType").toString();
+                    QString name = reader.attributes().value("Name").toString();
+                    if (meta_type.isEmpty() || name.isEmpty()) {
+                        if (valid)
+                            LOG_ERROR(tr("Invalid subject type filter parameters detected. This filter will not be included in the parsed tree."));
+                        valid = false;
+                    } else if (valid) {
+                        SubjectTypeInfo new_type(meta_type, name);
+                        d->known_subject_types << new_type;
+                    }
+                }
+                reader.skipCurrentElement();
+            }
+        } else {
+            reader.skipCurrentElement();
+        }
+    }
+
+    if (valid && d->known_subject_types.count() == count_readback)
+        return IExportable::Complete;
+    else
+        return IExportable::Failed;
+}
+
 bool Qtilities::Core::SubjectTypeFilter::isModified() const {
     return d->is_modified;
 }
@@ -84,6 +84,7 @@ subject_type_filter->enableInverseFiltering(true);
             // AbstractSubjectFilter Implementation
             // --------------------------------
             AbstractSubjectFilter::EvaluationResult evaluateAttachment(QObject* obj, QString* rejectMsg = 0, bool silent = false) const;
+            bool supportsBatchOperations() const { return true; }
             QString filterName() const { return qti_def_FACTORY_TAG_SUBJECT_TYPE_FILTER; }
         protected:
             bool handleMonitoredPropertyChange(QObject* obj, const char* property_name, QDynamicPropertyChangeEvent* propertyChangeEvent);
@@ -104,6 +105,8 @@ subject_type_filter->enableInverseFiltering(true);
             IExportable::ExportResultFlags importBinary(QDataStream& stream, QList<QPointer<QObject> >& import_list);
             IExportable::ExportResultFlags exportXml(QDomDocument* doc, QDomElement* object_node) const;
             IExportable::ExportResultFlags importXml(QDomDocument* doc, QDomElement* object_node, QList<QPointer<QObject> >& import_list);
+            IExportable::ExportResultFlags exportXmlStream(QXmlStreamWriter& writer) const;
+            IExportable::ExportResultFlags importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list);
 
             // --------------------------------
             // IModificationNotifier Implementation
@@ -21,6 +21,7 @@
 #include "Observer.h"
 #include "QtilitiesCore_global.h"
 #include "SubjectIterator.h"
+#include "TreeTraversal.h"
 
 namespace Qtilities {
     namespace Core {
@@ -101,14 +102,11 @@ rootTop->attachSubject(rootNodeA);
 rootTop->attachSubject(rootNodeB);
 \endcode
 
-        When TreeIterator iterates through this tree two things can happen:
-        - When you iterate forward in the tree it will remember the path it has taken to get to any point and you don't have to worry about it. TreeIterator will be able
-          to iterate through the tree regardless of any multiple parents that it might find on its way.
-        - When iterating backwards through the tree, the iterator will always iterate through the tree from front to back to get to the last value which you want to start
-          with. Thus, the path information will also be stored for you and TreeIterator will be able to iterate through the tree regardless of any multiple parents that
-          it might find on its way.
+        TreeIterator keeps the path it has taken to get to the current item, thus it is able to iterate through the tree regardless of any multiple parents
+        that it might find on its way, in both directions. Iterating through a tree does not change the items in the tree in any way. TreeIterator is
+        built on TreeTraversal, which also provides post-order and breadth first traversals.
 
-        \sa SubjectIterator, ConstSubjectIterator
+        \sa SubjectIterator, ConstSubjectIterator, TreeTraversal
 
         <i>This class was added in %Qtilities v1.0.</i>
         */
@@ -118,305 +116,73 @@ rootTop->attachSubject(rootNodeB);
             /*!
              * \brief TreeIterator Constructs a new iterator
              * \param top_node The top node of the tree on which the iterator should operate.
+             * \param iterator_id Not used since %Qtilities v1.5, iterators do not set properties on the items in the tree anymore.
              */
             TreeIterator(const Observer* top_node = 0,
                          int iterator_id = -1) :
-                  d_top_node(top_node)
+                  d_traversal(top_node,TreeTraversal::PreOrder)
             {
-                d_current = top_node;
-                if (iterator_id == -1)
-                    d_iterator_id = OBJECT_MANAGER->getNewIteratorID();
-                else
-                    d_iterator_id = iterator_id;
+                Q_UNUSED(iterator_id)
             }
 
             QObject* first()
             {
-                d_current = d_top_node;
-                return const_cast<QObject*> (d_current);
+                return d_traversal.first();
             }
 
+            //! Moves to the last item in the tree. Only the items on the path to the last item are visited.
             QObject* last()
             {
-                d_current = d_top_node->treeChildren("QObject",-1,d_iterator_id).last();
-                return const_cast<QObject*> (d_current);
+                return d_traversal.last();
             }
 
             QObject* current() const
             {
-                return const_cast<QObject*> (d_current);
+                return d_traversal.current();
             }
 
+            //! Moves the iterator to the first occurrence of \p current in the tree. When \p current is not in the tree, the iterator is not moved.
             void setCurrent(const QObject* current)
             {
-                d_current = current;
+                d_traversal.setCurrent(current);
             }
 
             QObject* next()
             {
-                //qDebug() << "Starting next(): from current" << d_current << ", previous parent" << findParentPrevious(d_current);
-                Observer* obs = qobject_cast<Observer*> (const_cast<QObject*> (d_current));
-                if (obs) {
-                    if (obs->subjectCount() > 0) {
-                        d_current = obs->subjectAt(0);
-
-                        // Check if any subjects under this observer has multiple parents. If so, we need to set the qti_prop_TREE_ITERATOR_SOURCE_OBS on all
-                        // subjects in this context since SubjectIterator needs it on all subjects. TreeIterator only needs it on the first and last subject.
-                        bool add_prop = false;
-                        for (int i = 0; i < obs->subjectCount(); i++) {
-                            if (Observer::parentCount(obs->subjectAt(i)) > 1) {
-                                add_prop = true;
-                                continue;
-                            }
-                        }
-
-                        if (add_prop) {
-                            for (int i = 0; i < obs->subjectCount(); i++) {
-                                MultiContextProperty existing_prop = ObjectManager::getMultiContextProperty(obs->subjectAt(i),qti_prop_TREE_ITERATOR_SOURCE_OBS);
-                                if (existing_prop.isValid()) {
-                                    existing_prop.setValue(obs->observerID(),d_iterator_id);
-                                    ObjectManager::setMultiContextProperty(obs->subjectAt(i),existing_prop);
-                                } else {
-                                    MultiContextProperty prop(qti_prop_TREE_ITERATOR_SOURCE_OBS);
-                                    prop.setValue(obs->observerID(),d_iterator_id);
-                                    ObjectManager::setMultiContextProperty(obs->subjectAt(i),prop);
-                                }
-                            }
-                        }
-
-                        return const_cast<QObject*> (d_current);
-                    } else {
-                        if (d_current == d_top_node)
-                            return 0;
-                        else {
-                            SubjectIterator<QObject> sibling_itr(obs,
-                                                                 SubjectIterator<QObject>::IterateSiblings,
-                                                                 findParentPreviousObserver(obs),
-                                                                 d_iterator_id);
-                            if (sibling_itr.hasNext()) {
-                                d_current = sibling_itr.next();
-                                return const_cast<QObject*> (d_current);
-                            } else {
-                                const QObject* obj = findParentNext(d_current);
-                                if (obj) {
-                                    d_current = obj;
-                                    return const_cast<QObject*> (d_current);
-                                } else
-                                    return 0;
-                            }
-                        }
-                    }
-                } else {
-                    SubjectIterator<QObject> sibling_itr(d_current,
-                                                         findParentPreviousObserver(d_current),
-                                                         d_iterator_id);
-                    if (sibling_itr.hasNext()) {
-                        d_current = sibling_itr.next();
-                        return const_cast<QObject*> (d_current);
-                    } else {
-                        const QObject* obj = findParentNext(d_current);
-                        //qDebug() << "LAST SIBLING, FINDING NEXT PARENT" << obj;
-                        if (obj) {
-                            d_current = obj;
-                            return const_cast<QObject*> (d_current);
-                        } else
-                            return 0;
-                    }
-                }
+                return d_traversal.next();
             }
 
             QObject* previous()
             {
-                if (d_current == d_top_node)
-                    return 0;
-
-                Observer* obs = qobject_cast<Observer*> (const_cast<QObject*> (d_current));
-                if (obs) {
-                    SubjectIterator<Observer> sibling_itr(obs,
-                                                          SubjectIterator<Observer>::IterateSiblings,
-                                                          findParentPreviousObserver(obs),
-                                                          d_iterator_id);
-                    if (sibling_itr.hasPrevious()) {
-                        Observer* previous_obs = sibling_itr.previous();
-
-                        // If previous observer has children, take the last child, otherwise take previous observer.
-                        QList<QObject*> previous_obs_children = previous_obs->treeChildren("QObject",-1,d_iterator_id);
-                        if (previous_obs_children.count() > 0) {
-                            d_current = previous_obs_children.last();
-
-                            // Check if any subjects under this observer has multiple parents. If so, we need to set the qti_prop_TREE_ITERATOR_SOURCE_OBS on all
-                            // subjects in this context since SubjectIterator needs it on all subjects. TreeIterator only needs it on the first and last subject.
-                            bool add_prop = false;
-                            for (int i = 0; i < previous_obs->subjectCount(); i++) {
-                                if (Observer::parentCount(previous_obs->subjectAt(i)) > 1) {
-                                    add_prop = true;
-                                    continue;
-                                }
-                            }
-                            if (add_prop) {
-                                for (int i = 0; i < previous_obs->subjectCount(); i++) {
-                                    MultiContextProperty existing_prop = ObjectManager::getMultiContextProperty(previous_obs->subjectAt(i),qti_prop_TREE_ITERATOR_SOURCE_OBS);
-                                    if (existing_prop.isValid()) {
-                                        existing_prop.setValue(previous_obs->observerID(),d_iterator_id);
-                                        ObjectManager::setMultiContextProperty(previous_obs->subjectAt(i),existing_prop);
-                                    } else {
-                                        MultiContextProperty prop(qti_prop_TREE_ITERATOR_SOURCE_OBS);
-                                        prop.setValue(previous_obs->observerID(),d_iterator_id);
-                                        ObjectManager::setMultiContextProperty(previous_obs->subjectAt(i),prop);
-                                    }
-                                }
-                            }
-
-                            return const_cast<QObject*> (d_current);
-                        } else {
-                            d_current = previous_obs;
-                            return const_cast<QObject*> (d_current);
-                        }
-                    } else {
-                        const QObject* obj = findParentPrevious(d_current);
-                        if (obj) {
-                            d_current = obj;
-                            return const_cast<QObject*> (d_current);
-                        } else
-                            return 0;
-                    }
-                } else {
-                    SubjectIterator<QObject> sibling_itr(d_current,
-                                                         findParentPreviousObserver(d_current),
-                                                         d_iterator_id);
-                    if (sibling_itr.hasPrevious()) {
-                        d_current = sibling_itr.previous();
-                        return const_cast<QObject*> (d_current);
-                    } else {
-                        const QObject* obj = findParentPrevious(d_current);
-                        if (obj) {
-                            d_current = obj;
-                            return const_cast<QObject*> (d_current);
-                        } else
-                            return 0;
-                    }
-                }
+                return d_traversal.previous();
             }
 
-            Observer* topNode() const {
-                return const_cast<Observer*> (d_top_node);
+            bool hasNext()
+            {
+                return d_traversal.hasNext();
             }
 
-        protected:
-            //! Finds the next parent of an object and cast it to an observer.
-            const Observer* findParentNextObserver(const QObject* obj) {
-                const QObject* parent_obj = findParentNext(obj);
-                if (parent_obj)
-                    return qobject_cast<const Observer*> (parent_obj);
-                else
-                    return 0;
+            bool hasPrevious()
+            {
+                return d_traversal.hasPrevious();
             }
 
-            //! Finds the previous parent of an object and cast it to an observer.
-            const Observer* findParentPreviousObserver(const QObject* obj) {
-                const QObject* parent_obj = findParentPrevious(obj);
-                if (parent_obj)
-                    return qobject_cast<const Observer*> (parent_obj);
-                else
-                    return 0;
+            Observer* topNode() const {
+                return d_traversal.topNode();
             }
 
-            //! Finds the next parent of an object.
-            const QObject* findParentNext(const QObject* obj) {
-                if (!obj)
-                    return 0;
-
-                QList<Observer*> parents = Observer::parentReferences(obj);
-                if (parents.count() == 1) {
-                    if (parents.front() == d_top_node)
-                        return 0;
-                    else {
-                        SubjectIterator<QObject> parent_itr(parents.front(),
-                                                            SubjectIterator<QObject>::IterateSiblings,
-                                                            findParentPreviousObserver(parents.front()),
-                                                            d_iterator_id);
-                        if (parent_itr.hasNext()) {
-                            return parent_itr.next();
-                        } else {
-                            return findParentNext(parents.front());
-                        }
-                    }
-                } else if (parents.count() > 1) {
-                    // In here we set the observer ID of obs on the last and the first subjects in the observer context.
-                    MultiContextProperty prop = ObjectManager::getMultiContextProperty(obj,qti_prop_TREE_ITERATOR_SOURCE_OBS);
-//                    QObject* non_const_obj = const_cast<QObject*> (obj);
-//                    non_const_obj->setProperty(qti_prop_TREE_ITERATOR_SOURCE_OBS,QVariant());
-                    if (prop.isValid() && prop.hasContext(d_iterator_id)) {
-                        int obs_id = prop.value(d_iterator_id).toInt();
-                        Observer* parent_obs = OBJECT_MANAGER->observerReference(obs_id);
-                        if (parent_obs) {
-                            if (parent_obs == d_top_node)
-                                return 0;
-
-                            SubjectIterator<QObject> parent_itr(parent_obs,
-                                                                SubjectIterator<QObject>::IterateSiblings,
-                                                                findParentPreviousObserver(parent_obs),
-                                                                d_iterator_id);
-                            if (parent_itr.hasNext()) {
-                                return parent_itr.next();
-                            } else {
-                                //qDebug() << "Finding next parent, done with level of" << parent_obs->objectName() << ", navigating level up";
-                                return findParentNext(parent_obs);
-                            }
-                        }
-                    }
-
-                    QString warning_string;
-                    warning_string.append(Q_FUNC_INFO);
-                    warning_string.append("- A subject was found with multiple parents during tree iteratrion. In such cases, you must specify the parent observer in which context you are iterating. Please see the SubjectIterator documentation for more information.");
-                    QStringList parents_string;
-                    foreach (Observer* obs, parents)
-                        parents_string << QString("\"" + obs->observerName() + "\"");
-                    warning_string.append("\nDetails: object name = \"" + obj->objectName() + "\" parents = " + parents_string.join(","));
-
-                    qWarning() << warning_string;
-                    LOG_FATAL(warning_string);
-                    Q_ASSERT(0);
-                }
-                return 0;
-            }
-            //! Finds the previous parent of an object.
-            const QObject* findParentPrevious(const QObject* obj) {
-                QList<Observer*> parents = Observer::parentReferences(obj);
-                if (parents.count() == 1)
-                    return parents.front();
-                else if (parents.count() > 1) {
-                    // In here we set the observer ID of obs on the last and the first subjects in the observer context.
-                    MultiContextProperty prop = ObjectManager::getMultiContextProperty(obj,qti_prop_TREE_ITERATOR_SOURCE_OBS);
-//                    QObject* non_const_obj = const_cast<QObject*> (obj);
-//                    non_const_obj->setProperty(qti_prop_TREE_ITERATOR_SOURCE_OBS,QVariant());
-                    if (prop.isValid() && prop.hasContext(d_iterator_id)) {
-                        int obs_id = prop.value(d_iterator_id).toInt();
-                        Observer* parent_obs = OBJECT_MANAGER->observerReference(obs_id);
-                        if (parent_obs)
-                            return parent_obs;
-                    }
-
-                    QString warning_string;
-                    warning_string.append(Q_FUNC_INFO);
-                    warning_string.append("- A subject was found with multiple parents during tree iteratrion. In such cases, you must specify the parent observer in which context you are iterating. Please see the SubjectIterator documentation for more information.");
-                    QStringList parents_string;
-                    foreach (Observer* obs, parents)
-                        parents_string << QString("\"" + obs->observerName() + "\"");
-                    warning_string.append("\nDetails: object name = \"" + obj->objectName() + "\" parents = " + parents_string.join(","));
-
-                    qWarning() << warning_string;
-                    LOG_FATAL(warning_string);
-                    Q_ASSERT(0);
-                }
-                return 0;
+            //! Returns the observer in which context the current item was reached, 0 when the current item is the top node.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            Observer* currentParent() const {
+                return d_traversal.currentParent();
             }
 
         private:
-            const QObject* d_current;
-            const Observer* const d_top_node;
-            int d_iterator_id;
+            TreeTraversal d_traversal;
         };
     }
 }
+
 #endif // TREE_ITERATOR_H
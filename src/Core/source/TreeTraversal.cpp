@@ -0,0 +1,335 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#include "TreeTraversal.h"
+#include "Observer.h"
+
+Qtilities::Core::TreeTraversal::TreeTraversal(const Observer* top_node, TraversalOrder order) :
+    d_top_node(top_node),
+    d_order(order),
+    d_level_index(0)
+{
+    first();
+}
+
+Qtilities::Core::Observer* Qtilities::Core::TreeTraversal::topNode() const {
+    return const_cast<Observer*> (d_top_node);
+}
+
+Qtilities::Core::TreeTraversal::TraversalOrder Qtilities::Core::TreeTraversal::order() const {
+    return d_order;
+}
+
+QObject* Qtilities::Core::TreeTraversal::first() {
+    d_path.clear();
+    d_levels.clear();
+    d_level_index = 0;
+
+    if (d_order == BreadthFirst) {
+        QList<LevelItem> top_level;
+        top_level << LevelItem(0,const_cast<Observer*> (d_top_node));
+        d_levels << top_level;
+    } else if (d_order == PostOrder) {
+        descendFirst();
+    }
+
+    return current();
+}
+
+QObject* Qtilities::Core::TreeTraversal::last() {
+    d_path.clear();
+    d_levels.clear();
+    d_level_index = 0;
+
+    if (d_order == BreadthFirst) {
+        QList<LevelItem> level;
+        level << LevelItem(0,const_cast<Observer*> (d_top_node));
+        while (!level.isEmpty()) {
+            d_levels << level;
+            level = nextLevel(level);
+        }
+        d_level_index = d_levels.last().count() - 1;
+    } else if (d_order == PreOrder) {
+        descendLast();
+    }
+    // In PostOrder traversals the top node is the last item.
+
+    return current();
+}
+
+QObject* Qtilities::Core::TreeTraversal::current() const {
+    if (d_order == BreadthFirst) {
+        if (d_levels.isEmpty())
+            return 0;
+        return d_levels.last().at(d_level_index).object;
+    }
+
+    if (d_path.isEmpty())
+        return const_cast<Observer*> (d_top_node);
+
+    const PathFrame& frame = d_path.last();
+    // The observer might have changed underneath the traversal:
+    if (frame.index >= frame.observer->subjectCount())
+        return 0;
+    return frame.observer->subjectAt(frame.index);
+}
+
+QObject* Qtilities::Core::TreeTraversal::next() {
+    if (!d_top_node)
+        return 0;
+
+    bool moved = false;
+    if (d_order == PreOrder)
+        moved = nextPreOrder();
+    else if (d_order == PostOrder)
+        moved = nextPostOrder();
+    else
+        moved = nextBreadthFirst();
+
+    if (moved)
+        return current();
+    else
+        return 0;
+}
+
+QObject* Qtilities::Core::TreeTraversal::previous() {
+    if (!d_top_node)
+        return 0;
+
+    bool moved = false;
+    if (d_order == PreOrder)
+        moved = previousPreOrder();
+    else if (d_order == PostOrder)
+        moved = previousPostOrder();
+    else
+        moved = previousBreadthFirst();
+
+    if (moved)
+        return current();
+    else
+        return 0;
+}
+
+bool Qtilities::Core::TreeTraversal::hasNext() const {
+    // The path is small, thus peeking on a copy is cheap:
+    TreeTraversal peek(*this);
+    return peek.next() != 0;
+}
+
+bool Qtilities::Core::TreeTraversal::hasPrevious() const {
+    TreeTraversal peek(*this);
+    return peek.previous() != 0;
+}
+
+bool Qtilities::Core::TreeTraversal::setCurrent(const QObject* obj) {
+    if (!obj)
+        return false;
+    if (obj == current())
+        return true;
+
+    TreeTraversal search(d_top_node,d_order);
+    QObject* search_obj = search.current();
+    while (search_obj) {
+        if (search_obj == obj) {
+            *this = search;
+            return true;
+        }
+        search_obj = search.next();
+    }
+
+    return false;
+}
+
+Qtilities::Core::Observer* Qtilities::Core::TreeTraversal::currentParent() const {
+    if (d_order == BreadthFirst) {
+        if (d_levels.isEmpty())
+            return 0;
+        return const_cast<Observer*> (d_levels.last().at(d_level_index).parent);
+    }
+
+    if (d_path.isEmpty())
+        return 0;
+    return const_cast<Observer*> (d_path.last().observer);
+}
+
+int Qtilities::Core::TreeTraversal::depth() const {
+    if (d_order == BreadthFirst)
+        return d_levels.count() - 1;
+    return d_path.count();
+}
+
+QList<QObject*> Qtilities::Core::TreeTraversal::collect(const Observer* top_node, TraversalOrder order, bool include_top_node, const QString& base_class_name, int limit) {
+    QList<QObject*> items;
+    if (!top_node)
+        return items;
+
+    QByteArray base_class_name_bytes = base_class_name.toUtf8();
+    int count = 0;
+
+    TreeTraversal traversal(top_node,order);
+    QObject* obj = traversal.current();
+    while (obj) {
+        if (include_top_node || traversal.depth() > 0) {
+            if (base_class_name.isEmpty() || obj->inherits(base_class_name_bytes.constData())) {
+                items << obj;
+                if (limit != -1) {
+                    ++count;
+                    if (count > limit)
+                        break;
+                }
+            }
+        }
+        obj = traversal.next();
+    }
+
+    return items;
+}
+
+void Qtilities::Core::TreeTraversal::descendFirst() {
+    const Observer* obs = currentObserverWithSubjects();
+    while (obs) {
+        d_path.append(PathFrame(obs,0));
+        obs = currentObserverWithSubjects();
+    }
+}
+
+void Qtilities::Core::TreeTraversal::descendLast() {
+    const Observer* obs = currentObserverWithSubjects();
+    while (obs) {
+        d_path.append(PathFrame(obs,obs->subjectCount() - 1));
+        obs = currentObserverWithSubjects();
+    }
+}
+
+const Qtilities::Core::Observer* Qtilities::Core::TreeTraversal::currentObserverWithSubjects() const {
+    const Observer* obs = qobject_cast<const Observer*> (current());
+    if (obs && obs->subjectCount() > 0)
+        return obs;
+    return 0;
+}
+
+QList<Qtilities::Core::TreeTraversal::LevelItem> Qtilities::Core::TreeTraversal::nextLevel(const QList<LevelItem>& level) {
+    QList<LevelItem> next_level;
+    for (int i = 0; i < level.count(); ++i) {
+        const Observer* obs = qobject_cast<const Observer*> (level.at(i).object);
+        if (!obs)
+            continue;
+        QList<QObject*> subjects = obs->subjectReferences();
+        for (int s = 0; s < subjects.count(); ++s)
+            next_level << LevelItem(obs,subjects.at(s));
+    }
+    return next_level;
+}
+
+bool Qtilities::Core::TreeTraversal::nextPreOrder() {
+    // Observers with subjects continue with their first subject:
+    const Observer* obs = currentObserverWithSubjects();
+    if (obs) {
+        d_path.append(PathFrame(obs,0));
+        return true;
+    }
+
+    // Otherwise continue with the next sibling of the closest item on the path which has one:
+    for (int i = d_path.count() - 1; i >= 0; --i) {
+        if (d_path.at(i).index + 1 < d_path.at(i).observer->subjectCount()) {
+            d_path.resize(i + 1);
+            ++d_path[i].index;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Qtilities::Core::TreeTraversal::previousPreOrder() {
+    if (d_path.isEmpty())
+        return false;
+
+    PathFrame& frame = d_path.last();
+    if (frame.index > 0) {
+        // The previous item is the last item in the tree underneath the previous sibling:
+        --frame.index;
+        descendLast();
+    } else {
+        // The previous item is the parent:
+        d_path.pop_back();
+    }
+    return true;
+}
+
+bool Qtilities::Core::TreeTraversal::nextPostOrder() {
+    if (d_path.isEmpty())
+        return false;
+
+    PathFrame& frame = d_path.last();
+    if (frame.index + 1 < frame.observer->subjectCount()) {
+        // The next item is the first item in the tree underneath the next sibling:
+        ++frame.index;
+        descendFirst();
+    } else {
+        // The next item is the parent:
+        d_path.pop_back();
+    }
+    return true;
+}
+
+bool Qtilities::Core::TreeTraversal::previousPostOrder() {
+    // Observers with subjects are preceded by their last subject:
+    const Observer* obs = currentObserverWithSubjects();
+    if (obs) {
+        d_path.append(PathFrame(obs,obs->subjectCount() - 1));
+        return true;
+    }
+
+    // Otherwise by the previous sibling of the closest item on the path which has one:
+    for (int i = d_path.count() - 1; i >= 0; --i) {
+        if (d_path.at(i).index > 0) {
+            d_path.resize(i + 1);
+            --d_path[i].index;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Qtilities::Core::TreeTraversal::nextBreadthFirst() {
+    if (d_levels.isEmpty())
+        return false;
+
+    if (d_level_index + 1 < d_levels.last().count()) {
+        ++d_level_index;
+        return true;
+    }
+
+    QList<LevelItem> next_level = nextLevel(d_levels.last());
+    if (next_level.isEmpty())
+        return false;
+
+    d_levels << next_level;
+    d_level_index = 0;
+    return true;
+}
+
+bool Qtilities::Core::TreeTraversal::previousBreadthFirst() {
+    if (d_levels.isEmpty())
+        return false;
+
+    if (d_level_index > 0) {
+        --d_level_index;
+        return true;
+    }
+
+    if (d_levels.count() == 1)
+        return false;
+
+    d_levels.removeLast();
+    d_level_index = d_levels.last().count() - 1;
+    return true;
+}
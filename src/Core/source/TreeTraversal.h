@@ -0,0 +1,163 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#ifndef TREE_TRAVERSAL_H
+#define TREE_TRAVERSAL_H
+
+#include "QtilitiesCore_global.h"
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+namespace Qtilities {
+    namespace Core {
+        class Observer;
+
+        /*!
+          \class TreeTraversal
+          \brief The TreeTraversal class walks through the tree underneath an observer without changing any objects in the tree.
+
+          TreeTraversal keeps the path from the top node of the tree to the current item in an explicit stack. Since the path is known at
+          all times, items which are attached to more than one observer are handled without having to store anything on the items themselves,
+          thus traversing a tree does not set properties on the items visited and does not cause property change events in the observers
+          of the tree.
+
+          Three traversal orders are supported:
+          - PreOrder: Each observer is visited before the items underneath it. This is the order used by TreeIterator and Observer::treeChildren().
+          - PostOrder: Each observer is visited after the items underneath it.
+          - BreadthFirst: All items at one depth in the tree are visited before the items at the next depth.
+
+          All orders can be traversed forward using next() and in reverse using previous(). The top node is part of the traversal: it is the first
+          item in PreOrder and BreadthFirst traversals and the last item in PostOrder traversals. For PreOrder and PostOrder traversals, only the
+          path to the current item is stored and last() only visits the items on the path to the last item.
+
+\code
+TreeTraversal traversal(rootNode,TreeTraversal::PostOrder);
+QObject* obj = traversal.current();
+while (obj) {
+    qDebug() << obj->objectName();
+    obj = traversal.next();
+}
+\endcode
+
+          \note TreeTraversal does not guard against changes to the tree while it is traversed. When the tree changes, call first() or last() to
+          start over.
+
+          <i>This class was added in %Qtilities v1.5.</i>
+          */
+        class QTILIITES_CORE_SHARED_EXPORT TreeTraversal
+        {
+        public:
+            //! The possible orders in which a tree can be traversed.
+            enum TraversalOrder {
+                PreOrder        = 0, /*!< Observers are visited before the items underneath them. */
+                PostOrder       = 1, /*!< Observers are visited after the items underneath them. */
+                BreadthFirst    = 2  /*!< Items are visited level by level. */
+            };
+
+            //! Constructs a traversal of the tree underneath \p top_node which is positioned on the first item in the specified order.
+            TreeTraversal(const Observer* top_node = 0, TraversalOrder order = PreOrder);
+
+            //! Returns the top node of the tree.
+            Observer* topNode() const;
+            //! Returns the order in which the tree is traversed.
+            TraversalOrder order() const;
+
+            //! Moves to the first item in the traversal and returns it.
+            QObject* first();
+            //! Moves to the last item in the traversal and returns it.
+            QObject* last();
+            //! Returns the current item.
+            QObject* current() const;
+            //! Moves to the next item in the traversal and returns it.
+            /*!
+              \returns The next item, or 0 when the current item is the last item in the traversal. The traversal stays on the current item in that case.
+              */
+            QObject* next();
+            //! Moves to the previous item in the traversal and returns it.
+            /*!
+              \returns The previous item, or 0 when the current item is the first item in the traversal. The traversal stays on the current item in that case.
+              */
+            QObject* previous();
+            //! Indicates if a next item exists. Does not move the traversal.
+            bool hasNext() const;
+            //! Indicates if a previous item exists. Does not move the traversal.
+            bool hasPrevious() const;
+            //! Moves the traversal to the first occurrence of \p obj in the traversal.
+            /*!
+              \returns True when \p obj was found, false otherwise. The traversal stays on the current item when \p obj was not found.
+              */
+            bool setCurrent(const QObject* obj);
+
+            //! Returns the observer in which context the current item was reached, 0 when the current item is the top node.
+            Observer* currentParent() const;
+            //! Returns the depth of the current item, where the top node has a depth of 0.
+            int depth() const;
+
+            //! Returns all items in the tree underneath \p top_node in the specified order.
+            /*!
+              \param top_node The top node of the tree.
+              \param order The order in which the items must be returned.
+              \param include_top_node Indicates if \p top_node must be part of the list.
+              \param base_class_name When specified, only items which inherit this base class are returned.
+              \param limit When not -1, the list stops growing once it holds more than \p limit items.
+              */
+            static QList<QObject*> collect(const Observer* top_node,
+                                           TraversalOrder order = PreOrder,
+                                           bool include_top_node = false,
+                                           const QString& base_class_name = QString(),
+                                           int limit = -1);
+
+        private:
+            // A step on the path from the top node to the current item: the current item in the context of observer is the subject at index.
+            struct PathFrame {
+                PathFrame(const Observer* frame_observer = 0, int frame_index = 0) : observer(frame_observer), index(frame_index) {}
+                const Observer* observer;
+                int             index;
+            };
+            // An item in a level of a breadth first traversal, with the observer in which context it was reached.
+            struct LevelItem {
+                LevelItem(const Observer* item_parent = 0, QObject* item_object = 0) : parent(item_parent), object(item_object) {}
+                const Observer* parent;
+                QObject*        object;
+            };
+
+            //! Moves down to the first item underneath the current item, as long as the current item is an observer with subjects.
+            void descendFirst();
+            //! Moves down to the last item underneath the current item, as long as the current item is an observer with subjects.
+            void descendLast();
+            //! Returns the current item as an observer with subjects, 0 otherwise.
+            const Observer* currentObserverWithSubjects() const;
+            //! Builds the next level of a breadth first traversal from the items in level.
+            static QList<LevelItem> nextLevel(const QList<LevelItem>& level);
+
+            bool nextPreOrder();
+            bool previousPreOrder();
+            bool nextPostOrder();
+            bool previousPostOrder();
+            bool nextBreadthFirst();
+            bool previousBreadthFirst();
+
+            const Observer*             d_top_node;
+            TraversalOrder              d_order;
+            //! The path to the current item. Used by PreOrder and PostOrder traversals.
+            QVector<PathFrame>          d_path;
+            //! The levels up to the current level. Used by BreadthFirst traversals.
+            QList<QList<LevelItem> >    d_levels;
+            //! The index of the current item in the current level. Used by BreadthFirst traversals.
+            int                         d_level_index;
+        };
+    }
+}
+
+#endif // TREE_TRAVERSAL_H
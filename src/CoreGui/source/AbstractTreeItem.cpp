@@ -14,6 +14,8 @@
 #include "NamingPolicyFilter.h"
 
 #include <QDomElement>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 using namespace Qtilities::Core;
 
@@ -262,6 +264,28 @@ IExportable::ExportResultFlags Qtilities::CoreGui::AbstractTreeItem::loadFormatt
     return IExportable::Complete;
 }
 
+IExportable::ExportResultFlags Qtilities::CoreGui::AbstractTreeItem::saveFormattingToXmlStream(QXmlStreamWriter& writer, Qtilities::ExportVersion version) const {
+    // The formatting is small, thus it is constructed using the DOM export:
+    QDomDocument doc;
+    QDomElement object_node = doc.createElement("Object");
+    doc.appendChild(object_node);
+
+    IExportable::ExportResultFlags result = saveFormattingToXML(&doc,&object_node,version);
+    for (QDomElement formatting_data = object_node.firstChildElement(); !formatting_data.isNull(); formatting_data = formatting_data.nextSiblingElement())
+        IExportable::writeXmlStreamElement(writer,formatting_data);
+
+    return result;
+}
+
+IExportable::ExportResultFlags Qtilities::CoreGui::AbstractTreeItem::loadFormattingFromXmlStream(QXmlStreamReader& reader, Qtilities::ExportVersion version) {
+    QDomDocument doc;
+    QDomElement object_node = doc.createElement("Object");
+    doc.appendChild(object_node);
+    object_node.appendChild(IExportable::readXmlStreamElement(reader,&doc));
+
+    return loadFormattingFromXML(&doc,&object_node,version);
+}
+
 bool Qtilities::CoreGui::AbstractTreeItem::setCategory(const QtilitiesCategory& category, TreeNode* tree_node) {
     if (!category.isValid() || !tree_node)
         return false;
@@ -86,6 +86,18 @@ namespace Qtilities {
               */
             IExportable::ExportResultFlags saveFormattingToXML(QDomDocument* doc, QDomElement* object_node, Qtilities::ExportVersion version) const;
             IExportable::ExportResultFlags loadFormattingFromXML(QDomDocument* doc, QDomElement* object_node, Qtilities::ExportVersion version);
+            //! Writes the formatting of the tree item as a child element of the element which is currently open on \p writer.
+            /*!
+              The same information as saveFormattingToXML() is exported.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            IExportable::ExportResultFlags saveFormattingToXmlStream(QXmlStreamWriter& writer, Qtilities::ExportVersion version) const;
+            //! Loads the formatting of the tree item from the \p Formatting element at which \p reader is positioned.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            IExportable::ExportResultFlags loadFormattingFromXmlStream(QXmlStreamReader& reader, Qtilities::ExportVersion version);
 
         public:
             // -------------------------------
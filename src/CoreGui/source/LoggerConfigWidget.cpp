@@ -139,7 +139,7 @@ void Qtilities::CoreGui::LoggerConfigWidget::handle_NewLoggerEngineRequest() {
 
     if (ok && !new_item_selection.isEmpty() && !engine_name.isEmpty()) {
         // Handle new widget
-        if (new_item_selection == QString(qti_def_FACTORY_TAG_FILE_LOGGER_ENGINE)) {
+        if (new_item_selection == QString(qti_def_FACTORY_TAG_FILE_LOGGER_ENGINE) || new_item_selection == QString(qti_def_FACTORY_TAG_ROLLING_FILE_LOGGER_ENGINE)) {
             // Prompt the correct file extensions and select the formatting engine according to the user's selection.
             QString file_ext = "";
             for (int i = 0; i < Log->availableFormattingEnginesInFactory().count(); ++i) {
@@ -152,7 +152,26 @@ void Qtilities::CoreGui::LoggerConfigWidget::handle_NewLoggerEngineRequest() {
 
             QString fileName = QFileDialog::getSaveFileName(this,tr("Select Output File"),QtilitiesApplication::applicationSessionPath(),file_ext);
             if (!fileName.isEmpty()) {
-                Log->newFileEngine(engine_name,fileName,QString());
+                if (new_item_selection == QString(qti_def_FACTORY_TAG_FILE_LOGGER_ENGINE)) {
+                    Log->newFileEngine(engine_name,fileName,QString());
+                } else {
+                    RollingFileLoggerEngine* rolling_engine = qobject_cast<RollingFileLoggerEngine*> (Log->newLoggerEngine(qti_def_FACTORY_TAG_ROLLING_FILE_LOGGER_ENGINE));
+                    if (rolling_engine) {
+                        rolling_engine->setName(engine_name);
+                        rolling_engine->setFileName(fileName);
+                        Log->attachLoggerEngine(rolling_engine);
+                    }
+                }
+            }
+        } else if (new_item_selection == QString(qti_def_FACTORY_TAG_BINARY_LOGGER_ENGINE)) {
+            QString fileName = QFileDialog::getSaveFileName(this,tr("Select Output File"),QtilitiesApplication::applicationSessionPath(),tr("Binary Log (*%1)").arg(qti_def_SUFFIX_BINARY_LOG));
+            if (!fileName.isEmpty()) {
+                BinaryLoggerEngine* binary_engine = qobject_cast<BinaryLoggerEngine*> (Log->newLoggerEngine(qti_def_FACTORY_TAG_BINARY_LOGGER_ENGINE));
+                if (binary_engine) {
+                    binary_engine->setName(engine_name);
+                    binary_engine->setFileName(fileName);
+                    Log->attachLoggerEngine(binary_engine);
+                }
             }
         }
     }
@@ -30,6 +30,8 @@
 #include <QRegExpValidator>
 #include <QCoreApplication>
 #include <QDomDocument>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 using namespace Qtilities::CoreGui::Constants;
 using namespace Qtilities::Core::Properties;
@@ -650,6 +652,7 @@ Qtilities::Core::Interfaces::IExportable::ExportModeFlags Qtilities::CoreGui::Na
     IExportable::ExportModeFlags flags = 0;
     flags |= IExportable::Binary;
     flags |= IExportable::XML;
+    flags |= IExportable::XMLStream;
     return flags;
 }
 
@@ -712,7 +715,7 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::CoreGui::
     if (version_check_result != IExportable::VersionSupported)
         return version_check_result;
 
-    if (object_node->hasAttribute("NewSubjectActivityPolicy"))
+    if (object_node->hasAttribute("UniquenessPolicy"))
         d->uniqueness_policy = stringToUniquenessPolicy(object_node->attribute("UniquenessPolicy"));
     if (object_node->hasAttribute("ValidityResolutionPolicy"))
         d->validity_resolution_policy = stringToResolutionPolicy(object_node->attribute("ValidityResolutionPolicy"));
@@ -727,6 +730,42 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::CoreGui::
     return IExportable::Complete;
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::CoreGui::NamingPolicyFilter::exportXmlStream(QXmlStreamWriter& writer) const {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    writer.writeAttribute("UniquenessPolicy",uniquenessPolicyToString(d->uniqueness_policy));
+    writer.writeAttribute("ValidityResolutionPolicy",resolutionPolicyToString(d->validity_resolution_policy));
+    writer.writeAttribute("UniquenessResolutionPolicy",resolutionPolicyToString(d->uniqueness_resolution_policy));
+    writer.writeAttribute("ProcessingCycleValidationCheckFlags",validationCheckFlagsToString(d->processing_cycle_validation_check_flags));
+    writer.writeAttribute("ValidationCheckFlags",validationCheckFlagsToString(d->validation_check_flags));
+    return IExportable::Complete;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::CoreGui::NamingPolicyFilter::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    Q_UNUSED(import_list)
+
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesImportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    QXmlStreamAttributes attributes = reader.attributes();
+    if (attributes.hasAttribute("UniquenessPolicy"))
+        d->uniqueness_policy = stringToUniquenessPolicy(attributes.value("UniquenessPolicy").toString());
+    if (attributes.hasAttribute("ValidityResolutionPolicy"))
+        d->validity_resolution_policy = stringToResolutionPolicy(attributes.value("ValidityResolutionPolicy").toString());
+    if (attributes.hasAttribute("UniquenessResolutionPolicy"))
+        d->uniqueness_resolution_policy = stringToResolutionPolicy(attributes.value("UniquenessResolutionPolicy").toString());
+    if (attributes.hasAttribute("ProcessingCycleValidationCheckFlags"))
+        d->processing_cycle_validation_check_flags = stringToValidationCheckFlags(attributes.value("ProcessingCycleValidationCheckFlags").toString());
+    if (attributes.hasAttribute("ValidationCheckFlags"))
+        d->validation_check_flags = stringToValidationCheckFlags(attributes.value("ValidationCheckFlags").toString());
+    reader.skipCurrentElement();
+
+    return IExportable::Complete;
+}
+
 void Qtilities::CoreGui::NamingPolicyFilter::setConflictingObject(QObject* obj) {
     d->conflicting_object = obj;
 }
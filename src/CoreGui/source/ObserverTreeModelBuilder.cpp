@@ -268,9 +268,11 @@ void Qtilities::CoreGui::ObserverTreeModelBuilder::buildRecursive(ObserverTreeIt
                     }
                 }
             } else {
-                int count = observer->subjectCount();
+                // Get a consistent view of the subjects, the observer might be changed while the tree is built:
+                QList<QObject*> subjects = observer->subjectSnapshot();
+                int count = subjects.count();
                 for (int i = 0; i < count; ++i) {
-                    QObject* obj_at = observer->subjectAt(i);
+                    QObject* obj_at = subjects.at(i);
                     Observer* obs = qobject_cast<Observer*> (obj_at);
                     QVector<QVariant> column_data;
                     column_data << QVariant(observer->subjectNameInContext(obj_at));
@@ -14,6 +14,8 @@
 #include "QtilitiesCoreConstants.h"
 
 #include <QDomElement>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 #include <QApplication>
 
 using namespace Qtilities::CoreGui::Constants;
@@ -44,6 +46,7 @@ Qtilities::Core::InstanceFactoryInfo Qtilities::CoreGui::TreeFileItem::instanceF
 Qtilities::Core::Interfaces::IExportable::ExportModeFlags Qtilities::CoreGui::TreeFileItem::supportedFormats() const {
     IExportable::ExportModeFlags flags = 0;
     flags |= IExportable::XML;
+    flags |= IExportable::XMLStream;
     return flags;
 }
 
@@ -106,6 +109,63 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::CoreGui::
     return result;
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::CoreGui::TreeFileItem::exportXmlStream(QXmlStreamWriter& writer) const {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    // 1.1 Formatting:
+    IExportable::ExportResultFlags result = saveFormattingToXmlStream(writer,exportVersion());
+
+    // 1.2 File Information:
+    writer.writeStartElement("FileInfo");
+    writer.writeAttribute("Path",filePath());
+    writer.writeAttribute("RelativeToPath",relativeToPath());
+    writer.writeAttribute("PathDisplay",QString::number((int) pathDisplay()));
+    writer.writeEndElement();
+    return result;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::CoreGui::TreeFileItem::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    Q_UNUSED(import_list)
+
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesImportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    IExportable::ExportResultFlags result = IExportable::Incomplete;
+    IExportable::ExportResultFlags formatting_result = IExportable::Complete;
+
+    while (reader.readNextStartElement()) {
+        if (reader.name() == QLatin1String("FileInfo")) {
+            // Restore the file path/name:
+            QXmlStreamAttributes attributes = reader.attributes();
+            if (attributes.hasAttribute("Path")) {
+                setFileForce(attributes.value("Path").toString());
+                result = IExportable::Complete;
+            }
+            if (attributes.hasAttribute("RelativeToPath")) {
+                setRelativeToPath(attributes.value("RelativeToPath").toString());
+                result = IExportable::Complete;
+            }
+            if (attributes.hasAttribute("PathDisplay")) {
+                setPathDisplay((PathDisplay) attributes.value("PathDisplay").toString().toInt());
+                result = IExportable::Complete;
+            }
+            reader.skipCurrentElement();
+        } else if (reader.name() == QLatin1String("Formatting")) {
+            formatting_result = loadFormattingFromXmlStream(reader,exportVersion());
+        } else {
+            reader.skipCurrentElement();
+        }
+    }
+
+    if (formatting_result != IExportable::Complete)
+        result = formatting_result;
+
+    return result;
+}
+
 void Qtilities::CoreGui::TreeFileItem::setFactoryData(InstanceFactoryInfo instanceFactoryInfo) {
     treeFileItemBase->instanceFactoryInfo = instanceFactoryInfo;
 }
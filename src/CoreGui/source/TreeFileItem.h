@@ -186,6 +186,8 @@ namespace Qtilities {
             InstanceFactoryInfo instanceFactoryInfo() const;
             virtual IExportable::ExportResultFlags exportXml(QDomDocument* doc, QDomElement* object_node) const;
             virtual IExportable::ExportResultFlags importXml(QDomDocument* doc, QDomElement* object_node, QList<QPointer<QObject> >& import_list);
+            virtual IExportable::ExportResultFlags exportXmlStream(QXmlStreamWriter& writer) const;
+            virtual IExportable::ExportResultFlags importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list);
 
         signals:
             //! Signal which is emitted when the file path of this tree file item changes.
@@ -20,6 +20,7 @@ using namespace Qtilities::Core::Constants;
 using namespace Qtilities::Core;
 
 #include <QDomElement>
+#include <QXmlStreamReader>
 
 namespace Qtilities {
     namespace CoreGui {
@@ -49,6 +50,7 @@ Qtilities::Core::Interfaces::IExportable::ExportModeFlags Qtilities::CoreGui::Tr
     IExportable::ExportModeFlags flags = 0;
     flags |= IExportable::Binary;
     flags |= IExportable::XML;
+    flags |= IExportable::XMLStream;
     return flags;
 }
 
@@ -94,3 +96,30 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::CoreGui::
     return loadFormattingFromXML(doc,object_node,exportVersion());
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::CoreGui::TreeItem::exportXmlStream(QXmlStreamWriter& writer) const {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    IExportable::ExportResultFlags result = saveFormattingToXmlStream(writer,exportVersion());
+    return result;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::CoreGui::TreeItem::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    Q_UNUSED(import_list)
+
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesImportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    IExportable::ExportResultFlags result = IExportable::Complete;
+    while (reader.readNextStartElement()) {
+        if (reader.name() == QLatin1String("Formatting"))
+            result = loadFormattingFromXmlStream(reader,exportVersion());
+        else
+            reader.skipCurrentElement();
+    }
+
+    return result;
+}
+
@@ -41,9 +41,13 @@ HEADERS += source/Logging_global.h \
     source/Logger.h \
     source/LoggerEngines.h \
     source/LoggerFactory.h \
-    source/ILoggerExportable.h
+    source/ILoggerExportable.h \
+    source/LogRecord.h \
+    source/BinaryLogReader.h
 
 SOURCES += source/AbstractLoggerEngine.cpp \
     source/Logger.cpp \
     source/LoggerEngines.cpp \
-    source/FormattingEngines.cpp
+    source/FormattingEngines.cpp \
+    source/LogRecord.cpp \
+    source/BinaryLogReader.cpp
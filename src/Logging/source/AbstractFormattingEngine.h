@@ -17,6 +17,7 @@
 #include <QVariant>
 
 #include "Logger.h"
+#include "LogRecord.h"
 #include "Logging_global.h"
 
 namespace Qtilities {
@@ -132,6 +133,19 @@ if (rich_text_engine) {
             virtual QString finalizeString() const = 0;
             //! Function which is called to format the message.
             virtual QString formatMessage(Logger::MessageType message_type, const QList<QVariant>& messages) const = 0;
+            //! Function which is called to format a record logged through the logger.
+            /*!
+              Logger engines do not call this function directly, they use LogRecord::formattedMessage() which calls this function
+              once for each formatting engine and shares the result between all engines using the same formatting engine.
+
+              The default implementation formats the message and parameters of the record using formatMessage(). Formatting engines
+              which include the time at which a message was logged should reimplement this function and use LogRecord::timestamp().
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            virtual QString formatRecord(const LogRecord& record) const {
+                return formatMessage(record.messageType(),record.messages());
+            }
             //! Function which provides a name for this formatting engine.
             virtual QString name() const = 0;
             //! Function which provides a file extension which will be used if the logger engine is a File logger engine.
@@ -162,6 +176,7 @@ if (rich_text_engine) {
                     return false;
 
                 color_formatting_hints.append(color_formatting_hint);
+                compileColorFormattingHints();
                 return true;
             }
             //! Returns all color formatting hint rules specified for this engine.
@@ -179,6 +194,7 @@ if (rich_text_engine) {
               */
             void clearColorFormattingHints() {
                 color_formatting_hints.clear();
+                compileColorFormattingHints();
             }
             //! Removes a specific color formatting hint.
             /*!
@@ -186,49 +202,159 @@ if (rich_text_engine) {
               */
             void removeColorFormattingHint(CustomFormattingHint custom_formatting_hint) {
                 color_formatting_hints.removeOne(custom_formatting_hint);
+                compileColorFormattingHints();
             }
             //! Checks a color formatting hint against a log message to see if they match.
             /*!
               This function will check the message type and the message contents against all color
               formatting hints specified. When a match if found, the color that must be used is returned.
 
+              The hints are compiled when they change: each message type has a list of the hints which apply to it, and the literal text at
+              the start of each expression is compared before the expression itself is matched. Thus messages which can't match a hint are
+              rejected without running its regular expression.
+
               \returns The color that must be used to format the message if a match was found. If not match was found and empty string is returned.
 
               <i>This function was added in %Qtilities v1.1.</i>
               */
             QString matchColorFormattingHint(const QString& message, Logger::MessageTypeFlags message_type_flags) const {
-                for (int i = 0; i < color_formatting_hints.count(); i++) {
-                    CustomFormattingHint hint = color_formatting_hints.at(i);
-                    if (hint.d_message_type_flags & message_type_flags) {
-                        if (hint.d_regexp.exactMatch(message))
-                            return hint.d_hint;
+                const int flags = (int) message_type_flags;
+                if (flags != 0 && (flags & (flags - 1)) == 0) {
+                    // A single message type, only the hints which apply to it are checked:
+                    int bit = 0;
+                    while (!(flags & (1 << bit)))
+                        ++bit;
+                    const QList<int>& candidates = compiled_hints_by_type[bit];
+                    for (int i = 0; i < candidates.count(); ++i) {
+                        const CompiledFormattingHint& compiled_hint = compiled_hints.at(candidates.at(i));
+                        if (matchesCompiledHint(compiled_hint,message))
+                            return compiled_hint.hint;
                     }
+                    return QString();
                 }
 
-                return "";
+                for (int i = 0; i < compiled_hints.count(); ++i) {
+                    const CompiledFormattingHint& compiled_hint = compiled_hints.at(i);
+                    if ((compiled_hint.message_type_flags & message_type_flags) && matchesCompiledHint(compiled_hint,message))
+                        return compiled_hint.hint;
+                }
+                return QString();
             }
             //! Function that does the same as QTextDocument::escape(). Since the Logging module does not depend on QtGui, we cannot use that function directly.
             static QString escape(const QString& plain) {
-                // This code is exactly the same as the code found in QTextDocument::escape()
                 QString rich;
                 rich.reserve(int(plain.length() * 1.1));
+                appendEscaped(rich,plain);
+                return rich;
+            }
+            //! Appends the escaped version of \p plain to \p rich, which allows formatting engines to build a message in a single buffer.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            static void appendEscaped(QString& rich, const QString& plain) {
+                // This code is exactly the same as the code found in QTextDocument::escape()
+                const QChar* characters = plain.constData();
                 for (int i = 0; i < plain.length(); ++i) {
-                    if (plain.at(i) == QLatin1Char('<'))
+                    if (characters[i] == QLatin1Char('<'))
                         rich += QLatin1String("&lt;");
-                    else if (plain.at(i) == QLatin1Char('>'))
+                    else if (characters[i] == QLatin1Char('>'))
                         rich += QLatin1String("&gt;");
-                    else if (plain.at(i) == QLatin1Char('&'))
+                    else if (characters[i] == QLatin1Char('&'))
                         rich += QLatin1String("&amp;");
-                    else if (plain.at(i) == QLatin1Char('"'))
+                    else if (characters[i] == QLatin1Char('"'))
                         rich += QLatin1String("&quot;");
                     else
-                        rich += plain.at(i);
+                        rich += characters[i];
                 }
-                return rich;
             }
 
         protected:
+            //! Prepares color_formatting_hints for matchColorFormattingHint().
+            /*!
+              Called by the functions which change the hints. Formatting engines which change color_formatting_hints directly must call this function afterwards.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            void compileColorFormattingHints() {
+                compiled_hints.clear();
+                for (int bit = 0; bit < 8; ++bit)
+                    compiled_hints_by_type[bit].clear();
+
+                for (int i = 0; i < color_formatting_hints.count(); ++i) {
+                    const CustomFormattingHint& hint = color_formatting_hints.at(i);
+                    CompiledFormattingHint compiled_hint;
+                    compiled_hint.regexp = hint.d_regexp;
+                    compiled_hint.hint = hint.d_hint;
+                    compiled_hint.message_type_flags = hint.d_message_type_flags;
+                    compiled_hint.case_sensitivity = hint.d_regexp.caseSensitivity();
+                    compiled_hint.is_fixed_string = (hint.d_regexp.patternSyntax() == QRegExp::FixedString);
+                    compiled_hint.literal_prefix = literalPrefix(hint.d_regexp);
+                    compiled_hints << compiled_hint;
+
+                    for (int bit = 0; bit < 8; ++bit) {
+                        if ((int) hint.d_message_type_flags & (1 << bit))
+                            compiled_hints_by_type[bit] << i;
+                    }
+                }
+            }
+
             QList<CustomFormattingHint> color_formatting_hints;
+
+        private:
+            // A color formatting hint prepared by compileColorFormattingHints().
+            struct CompiledFormattingHint {
+                QRegExp                     regexp;
+                QString                     hint;
+                Logger::MessageTypeFlags    message_type_flags;
+                Qt::CaseSensitivity         case_sensitivity;
+                bool                        is_fixed_string;
+                //! Text which all messages matching the expression start with, the complete text for fixed strings.
+                QString                     literal_prefix;
+            };
+
+            static bool matchesCompiledHint(const CompiledFormattingHint& compiled_hint, const QString& message) {
+                if (compiled_hint.is_fixed_string)
+                    return message.compare(compiled_hint.literal_prefix,compiled_hint.case_sensitivity) == 0;
+                if (!message.startsWith(compiled_hint.literal_prefix,compiled_hint.case_sensitivity))
+                    return false;
+
+                // QRegExp stores the results of the last match, thus a copy is used since messages can be formatted in any thread:
+                QRegExp regexp(compiled_hint.regexp);
+                return regexp.exactMatch(message);
+            }
+
+            // Returns the literal text at the start of a pattern, which every exact match of the pattern must start with.
+            static QString literalPrefix(const QRegExp& regexp) {
+                const QString pattern = regexp.pattern();
+                const QRegExp::PatternSyntax syntax = regexp.patternSyntax();
+                if (syntax == QRegExp::FixedString)
+                    return pattern;
+
+                const bool is_wildcard = (syntax == QRegExp::Wildcard || syntax == QRegExp::WildcardUnix);
+                if (!is_wildcard && syntax != QRegExp::RegExp && syntax != QRegExp::RegExp2)
+                    return QString();
+                // The alternatives of an expression can start with different text:
+                if (!is_wildcard && pattern.contains(QLatin1Char('|')))
+                    return QString();
+
+                const QString special_characters = is_wildcard ? QString("*?[\\") : QString("\\^$.[]|()?*+{}");
+                int length = 0;
+                while (length < pattern.length() && !special_characters.contains(pattern.at(length)))
+                    ++length;
+
+                QString prefix = pattern.left(length);
+                // A quantifier makes the last literal character optional:
+                if (!is_wildcard && length < pattern.length() && !prefix.isEmpty()) {
+                    const QChar next = pattern.at(length);
+                    if (next == QLatin1Char('?') || next == QLatin1Char('*') || next == QLatin1Char('{'))
+                        prefix.chop(1);
+                }
+                return prefix;
+            }
+
+            QList<CompiledFormattingHint> compiled_hints;
+            //! Indexes into compiled_hints of the hints which apply to each message type, indexed by the bit of the message type.
+            QList<int> compiled_hints_by_type[8];
         };
     }
 }
@@ -41,15 +41,26 @@ void Qtilities::Logging::AbstractLoggerEngine::setActive(bool is_active) {
         return;
 
     abstractLoggerEngineData->is_enabled = is_active;
+    Log->refreshLoggerEngineRoutes();
 }
 
 void Qtilities::Logging::AbstractLoggerEngine::setName(const QString& name) {
     setObjectName(name);
     abstractLoggerEngineData->engine_name = name;
+    Log->refreshLoggerEngineRoutes();
+}
+
+void Qtilities::Logging::AbstractLoggerEngine::setMessageContexts(Logger::MessageContextFlags message_contexts) {
+    if (message_contexts == abstractLoggerEngineData->message_contexts)
+        return;
+
+    abstractLoggerEngineData->message_contexts = message_contexts;
+    Log->refreshLoggerEngineRoutes();
 }
 
 void Qtilities::Logging::AbstractLoggerEngine::setEnabledMessageTypes(Logger::MessageTypeFlags message_types) {
     abstractLoggerEngineData->enabled_message_types = message_types;
+    Log->refreshLoggerEngineRoutes();
 }
 
 Qtilities::Logging::Logger::MessageTypeFlags Qtilities::Logging::AbstractLoggerEngine::getEnabledMessageTypes() const {
@@ -64,6 +75,7 @@ void Qtilities::Logging::AbstractLoggerEngine::enableAllMessageTypes() {
     abstractLoggerEngineData->enabled_message_types |= Logger::Fatal;
     abstractLoggerEngineData->enabled_message_types |= Logger::Debug;
     abstractLoggerEngineData->enabled_message_types |= Logger::Trace;
+    Log->refreshLoggerEngineRoutes();
 }
 
 void Qtilities::Logging::AbstractLoggerEngine::installFormattingEngine(AbstractFormattingEngine* engine) {
@@ -93,22 +105,32 @@ QString Qtilities::Logging::AbstractLoggerEngine::formattingEngineName() {
 }
 
 void Qtilities::Logging::AbstractLoggerEngine::newMessages(const QString& engine_name, Logger::MessageType message_type, Logger::MessageContextFlags message_context, const QList<QVariant>& messages) {
-    if ((!engine_name.isEmpty()) && (engine_name != name()))
+    newLogRecord(LogRecord(message_type,messages,message_context,engine_name));
+}
+
+void Qtilities::Logging::AbstractLoggerEngine::newLogRecord(const LogRecord& record) {
+    // Check if there is a formatting engine present
+    if (!abstractLoggerEngineData->formatting_engine)
         return;
 
+    if (acceptsRecord(record))
+        logMessage(record.formattedMessage(abstractLoggerEngineData->formatting_engine),record.messageType());
+}
+
+bool Qtilities::Logging::AbstractLoggerEngine::acceptsRecord(const LogRecord& record) const {
+    if ((!record.engineName().isEmpty()) && (record.engineName() != name()))
+        return false;
+
     // Check the message context:
-    if (!(abstractLoggerEngineData->message_contexts & message_context))
-        return;
+    if (!(abstractLoggerEngineData->message_contexts & record.messageContext()))
+        return false;
 
     // Check if active
-    if (abstractLoggerEngineData->is_enabled) {
-        // Check if there is a formatting engine present
-        if (abstractLoggerEngineData->formatting_engine) {
-            //Check if this message type is allowed
-            if (abstractLoggerEngineData->enabled_message_types & message_type)
-                logMessage(abstractLoggerEngineData->formatting_engine->formatMessage(message_type,messages),message_type);
-        }
-    }
+    if (!abstractLoggerEngineData->is_enabled)
+        return false;
+
+    //Check if this message type is allowed
+    return abstractLoggerEngineData->enabled_message_types & record.messageType();
 }
 
 bool Qtilities::Logging::AbstractLoggerEngine::removable() const {
@@ -66,9 +66,9 @@ namespace Qtilities {
             bool isInitialized() const;
             //! Function which receives a formatted string which needs to be logged.
             /*!
-              Messages arrives at logger engines through the newMessages() slot which will format the messages and validate if they must be logged.
+              Messages arrives at logger engines through the newLogRecord() slot which will format the messages and validate if they must be logged.
               If so, this function will be called with a formatted message. If you wish to handle the message formatting manually, you can reimplement the
-              newMessages() function.
+              newLogRecord() function.
               */
             virtual void logMessage(const QString& message, Logger::MessageType message_type = Logger::Info) = 0;
             //! Clears the log currently hold by the logger engine.
@@ -76,6 +76,14 @@ namespace Qtilities {
               \note This is not supported by all logger engines. See the class documentation of the logger engine you are interested in to see if it is supported.
               */
             virtual void clearLog() {}
+            //! Indicates if logMessage() and newLogRecord() can be called from any thread, while the engine lives in another thread.
+            /*!
+              The logger delivers fatal messages logged from other threads to thread safe engines on the logging thread before the logging function
+              returns, see \ref logger_threads. Other engines receive them through their event loop. By default engines are not thread safe.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            virtual bool isThreadSafe() const { return false; }
 
             //! Indicates if the engine is active.
             bool isActive() const;
@@ -115,15 +123,39 @@ namespace Qtilities {
             //! Returns the logging contexts for which this engine accepts messages.
             inline Logger::MessageContextFlags messageContexts() const { return abstractLoggerEngineData->message_contexts; }
             //! Sets the logging contexts for which this engine accepts messages.
-            void setMessageContexts(Logger::MessageContextFlags message_contexts) { abstractLoggerEngineData->message_contexts = message_contexts; }
+            void setMessageContexts(Logger::MessageContextFlags message_contexts);
 
         public slots:
             //! Function which is called to finalize the logger engine.
             virtual void finalize() = 0;
-            //! Slot which is connected to the newMessage() signal of the Logger class.
+            //! Logs a message which was not logged through the Logger class.
+            /*!
+              Creates a record for the message and passes it to newLogRecord().
+              */
             virtual void newMessages(const QString& engine_name, Logger::MessageType message_type, Logger::MessageContextFlags message_context, const QList<QVariant>& messages);
+            //! Slot which receives the records logged through the Logger class.
+            /*!
+              The logger only calls this slot with records targeted at this engine or with records of a type and context that this engine accepts,
+              see \ref logger_engine_routing.
+
+              Validates if the record must be logged by this engine, and if so calls logMessage() with the record formatted by the installed
+              formatting engine. The record is formatted using LogRecord::formattedMessage(), thus engines using the same formatting engine share
+              the formatted message.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            virtual void newLogRecord(const LogRecord& record);
 
         protected:
+            //! Indicates if a record must be logged by this engine.
+            /*!
+              Checks the target engine, message context and type of \p record against the settings of this engine, and if the engine is active.
+              Engines which reimplement newLogRecord() can use this function to do the same validation as the default implementation.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            bool acceptsRecord(const LogRecord& record) const;
+
             AbstractLoggerEngineData* abstractLoggerEngineData;
         };
     }
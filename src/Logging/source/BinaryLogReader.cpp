@@ -0,0 +1,506 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#include "BinaryLogReader.h"
+#include "AbstractFormattingEngine.h"
+#include "LoggingConstants.h"
+
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QTextStream>
+#include <QVector>
+#include <QtEndian>
+
+using namespace Qtilities::Logging::Constants;
+
+namespace Qtilities {
+    namespace Logging {
+        // A range of records in the file, summarized by an index block or by scanning the records after the last index block.
+        struct BinaryLogBlock {
+            BinaryLogBlock() : first_offset(-1),
+                end_offset(-1),
+                count(0),
+                message_types(0),
+                min_timestamp(0),
+                max_timestamp(0) {}
+
+            qint64  first_offset;
+            qint64  end_offset;
+            quint32 count;
+            quint32 message_types;
+            qint64  min_timestamp;
+            qint64  max_timestamp;
+        };
+
+        // Receives the entries matched by BinaryLogReader::visitRecords().
+        struct BinaryLogEntrySink {
+            virtual ~BinaryLogEntrySink() {}
+            // Return false to stop visiting records.
+            virtual bool accept(const BinaryLogEntry& entry) = 0;
+        };
+    }
+}
+
+struct Qtilities::Logging::BinaryLogReaderPrivateData {
+    BinaryLogReaderPrivateData() : data(0),
+        data_size(0),
+        header_size(0),
+        creation_time(0),
+        is_complete(false),
+        scan_offset(0),
+        entry_count(0),
+        watcher(0) {}
+
+    QString                 file_name;
+    QFile                   file;
+    uchar*                  data;
+    qint64                  data_size;
+    qint64                  header_size;
+    qint64                  creation_time;
+    bool                    is_complete;
+    //! The blocks which were summarized by index blocks.
+    QVector<BinaryLogBlock> blocks;
+    //! The records after the last index block.
+    BinaryLogBlock          tail;
+    //! The offset up to which the file was scanned.
+    qint64                  scan_offset;
+    quint64                 entry_count;
+    QFileSystemWatcher*     watcher;
+};
+
+namespace {
+    using namespace Qtilities::Logging;
+
+    template <typename T>
+    inline T readValue(const uchar* data, qint64 offset) {
+        return qFromLittleEndian<T>(data + offset);
+    }
+
+    // Offsets of the fields in a record body:
+    const int record_timestamp_offset       = 0;
+    const int record_sequence_offset        = 8;
+    const int record_thread_offset          = 16;
+    const int record_type_offset            = 24;
+    const int record_context_offset         = 28;
+    const int record_engine_name_offset     = 32;
+    // The size of the fixed part of an index block body:
+    const int index_body_size               = 56;
+
+    // Collects entries into a list.
+    struct BinaryLogEntryListSink : public BinaryLogEntrySink {
+        BinaryLogEntryListSink(int entry_limit) : limit(entry_limit) {}
+        bool accept(const BinaryLogEntry& entry) {
+            entries.append(entry);
+            return limit < 0 || entries.count() < limit;
+        }
+
+        int                     limit;
+        QList<BinaryLogEntry>   entries;
+    };
+
+    // Writes entries formatted by a formatting engine to a text stream.
+    struct BinaryLogEntryFormattingSink : public BinaryLogEntrySink {
+        BinaryLogEntryFormattingSink(QTextStream* text_stream, const AbstractFormattingEngine* engine) : stream(text_stream), formatting_engine(engine) {}
+        bool accept(const BinaryLogEntry& entry) {
+            *stream << formatting_engine->formatRecord(entry.toLogRecord()) << "\n";
+            return stream->status() == QTextStream::Ok;
+        }
+
+        QTextStream*                    stream;
+        const AbstractFormattingEngine* formatting_engine;
+    };
+}
+
+Qtilities::Logging::LogRecord Qtilities::Logging::BinaryLogEntry::toLogRecord() const {
+    QList<QVariant> record_messages;
+    for (int i = 0; i < messages.count(); ++i)
+        record_messages << messages.at(i);
+    return LogRecord(message_type,record_messages,message_context,engine_name,timestamp);
+}
+
+Qtilities::Logging::BinaryLogReader::BinaryLogReader(const QString& file_name, QObject* parent) : QObject(parent) {
+    d = new BinaryLogReaderPrivateData;
+    d->file_name = file_name;
+}
+
+Qtilities::Logging::BinaryLogReader::~BinaryLogReader() {
+    close();
+    delete d;
+}
+
+void Qtilities::Logging::BinaryLogReader::setFileName(const QString& file_name) {
+    if (d->file_name == file_name)
+        return;
+
+    bool following = isFollowing();
+    close();
+    d->file_name = file_name;
+    if (following)
+        setFollowing(true);
+}
+
+QString Qtilities::Logging::BinaryLogReader::fileName() const {
+    return d->file_name;
+}
+
+bool Qtilities::Logging::BinaryLogReader::open() {
+    close();
+
+    d->file.setFileName(d->file_name);
+    if (!d->file.open(QIODevice::ReadOnly)) {
+        LOG_ERROR(QString(tr("Failed to open binary log file: %1")).arg(d->file_name));
+        return false;
+    }
+
+    if (!mapFile() || d->data_size < qti_def_BINARY_LOG_HEADER_SIZE) {
+        LOG_ERROR(QString(tr("Failed to map binary log file: %1")).arg(d->file_name));
+        close();
+        return false;
+    }
+
+    if (readValue<quint32>(d->data,0) != qti_def_BINARY_LOG_MAGIC || readValue<quint16>(d->data,4) > qti_def_BINARY_LOG_VERSION) {
+        LOG_ERROR(QString(tr("The file is not a supported binary log file: %1")).arg(d->file_name));
+        close();
+        return false;
+    }
+
+    d->header_size = readValue<quint16>(d->data,6);
+    d->creation_time = readValue<qint64>(d->data,8);
+    if (d->header_size < qti_def_BINARY_LOG_HEADER_SIZE || d->header_size > d->data_size) {
+        LOG_ERROR(QString(tr("The file is not a supported binary log file: %1")).arg(d->file_name));
+        close();
+        return false;
+    }
+
+    // When the file was finalized, the footer leads to all index blocks. Otherwise the records are scanned:
+    const qint64 footer_size = qti_def_BINARY_LOG_BLOCK_HEADER_SIZE + sizeof(qint64);
+    qint64 footer_offset = d->data_size - footer_size;
+    bool has_footer = false;
+    if (footer_offset >= d->header_size) {
+        if (readValue<quint32>(d->data,footer_offset) == qti_def_BINARY_LOG_BLOCK_FOOTER && readValue<quint32>(d->data,footer_offset + 4) == sizeof(qint64))
+            has_footer = readIndexChain(footer_offset);
+    }
+
+    if (!has_footer) {
+        d->scan_offset = d->header_size;
+        scanBlocks();
+    }
+
+    return true;
+}
+
+void Qtilities::Logging::BinaryLogReader::close() {
+    if (d->data) {
+        d->file.unmap(d->data);
+        d->data = 0;
+    }
+    d->file.close();
+    d->data_size = 0;
+    d->header_size = 0;
+    d->creation_time = 0;
+    d->is_complete = false;
+    d->blocks.clear();
+    d->tail = BinaryLogBlock();
+    d->scan_offset = 0;
+    d->entry_count = 0;
+
+    if (d->watcher) {
+        delete d->watcher;
+        d->watcher = 0;
+    }
+}
+
+bool Qtilities::Logging::BinaryLogReader::isOpen() const {
+    return d->data != 0;
+}
+
+bool Qtilities::Logging::BinaryLogReader::isComplete() const {
+    return d->is_complete;
+}
+
+QDateTime Qtilities::Logging::BinaryLogReader::creationTime() const {
+    if (!d->data)
+        return QDateTime();
+    return QDateTime::fromMSecsSinceEpoch(d->creation_time);
+}
+
+quint64 Qtilities::Logging::BinaryLogReader::entryCount() const {
+    return d->entry_count;
+}
+
+QList<Qtilities::Logging::BinaryLogEntry> Qtilities::Logging::BinaryLogReader::entries(const QDateTime& from, const QDateTime& to, Logger::MessageTypeFlags message_types, int limit) const {
+    BinaryLogEntryListSink sink(limit);
+    if (limit != 0)
+        visitRecords(from,to,message_types,&sink);
+    return sink.entries;
+}
+
+quint64 Qtilities::Logging::BinaryLogReader::countEntries(const QDateTime& from, const QDateTime& to, Logger::MessageTypeFlags message_types) const {
+    return visitRecords(from,to,message_types,0);
+}
+
+bool Qtilities::Logging::BinaryLogReader::convert(QIODevice* device, AbstractFormattingEngine* formatting_engine, const QDateTime& from, const QDateTime& to, Logger::MessageTypeFlags message_types) const {
+    if (!device || !formatting_engine || !d->data)
+        return false;
+    if (!device->isWritable())
+        return false;
+
+    QTextStream out(device);
+    out << formatting_engine->initializeString() << "\n";
+
+    BinaryLogEntryFormattingSink sink(&out,formatting_engine);
+    visitRecords(from,to,message_types,&sink);
+
+    out << formatting_engine->finalizeString() << "\n";
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
+
+void Qtilities::Logging::BinaryLogReader::setFollowing(bool following) {
+    if (following == isFollowing())
+        return;
+
+    if (following) {
+        d->watcher = new QFileSystemWatcher(this);
+        d->watcher->addPath(d->file_name);
+        connect(d->watcher,SIGNAL(fileChanged(QString)),SLOT(handle_fileChanged(QString)));
+    } else {
+        delete d->watcher;
+        d->watcher = 0;
+    }
+}
+
+bool Qtilities::Logging::BinaryLogReader::isFollowing() const {
+    return d->watcher != 0;
+}
+
+int Qtilities::Logging::BinaryLogReader::refresh() {
+    if (!d->data || d->is_complete)
+        return 0;
+
+    if (d->file.size() == d->data_size)
+        return 0;
+
+    if (d->file.size() < d->data_size) {
+        // The file was cleared or restarted by the engine, read it again:
+        bool following = isFollowing();
+        if (!open())
+            return 0;
+        if (following)
+            setFollowing(true);
+        if (d->entry_count > 0)
+            emit entriesAppended(entries());
+        return (int) d->entry_count;
+    }
+
+    if (!mapFile())
+        return 0;
+
+    QList<BinaryLogEntry> appended_entries;
+    scanBlocks(&appended_entries);
+    if (!appended_entries.isEmpty())
+        emit entriesAppended(appended_entries);
+    return appended_entries.count();
+}
+
+void Qtilities::Logging::BinaryLogReader::handle_fileChanged(const QString& path) {
+    Q_UNUSED(path)
+    refresh();
+}
+
+bool Qtilities::Logging::BinaryLogReader::mapFile() {
+    if (d->data) {
+        d->file.unmap(d->data);
+        d->data = 0;
+    }
+
+    d->data_size = d->file.size();
+    if (d->data_size <= 0)
+        return false;
+
+    d->data = d->file.map(0,d->data_size);
+    if (!d->data)
+        d->data_size = 0;
+    return d->data != 0;
+}
+
+void Qtilities::Logging::BinaryLogReader::scanBlocks(QList<BinaryLogEntry>* appended_entries) {
+    qint64 offset = d->scan_offset;
+    while (offset + qti_def_BINARY_LOG_BLOCK_HEADER_SIZE <= d->data_size) {
+        quint32 kind = readValue<quint32>(d->data,offset);
+        quint32 length = readValue<quint32>(d->data,offset + 4);
+        qint64 body_offset = offset + qti_def_BINARY_LOG_BLOCK_HEADER_SIZE;
+        // Stop at blocks which are still being written:
+        if (body_offset + length > d->data_size)
+            break;
+
+        if (kind == qti_def_BINARY_LOG_BLOCK_RECORD && length >= (quint32) record_engine_name_offset) {
+            qint64 timestamp = readValue<qint64>(d->data,body_offset + record_timestamp_offset);
+            if (d->tail.count == 0) {
+                d->tail.first_offset = offset;
+                d->tail.min_timestamp = timestamp;
+                d->tail.max_timestamp = timestamp;
+            } else {
+                d->tail.min_timestamp = qMin(d->tail.min_timestamp,timestamp);
+                d->tail.max_timestamp = qMax(d->tail.max_timestamp,timestamp);
+            }
+            ++d->tail.count;
+            d->tail.message_types |= readValue<quint32>(d->data,body_offset + record_type_offset);
+            d->tail.end_offset = body_offset + length;
+            ++d->entry_count;
+
+            if (appended_entries) {
+                BinaryLogEntry entry;
+                if (decodeRecord(body_offset,length,&entry))
+                    appended_entries->append(entry);
+            }
+        } else if (kind == qti_def_BINARY_LOG_BLOCK_INDEX && length >= (quint32) index_body_size) {
+            // The index block summarizes the records scanned since the previous index block:
+            BinaryLogBlock block;
+            block.count = readValue<quint32>(d->data,body_offset);
+            block.message_types = readValue<quint32>(d->data,body_offset + 4);
+            block.min_timestamp = readValue<qint64>(d->data,body_offset + 8);
+            block.max_timestamp = readValue<qint64>(d->data,body_offset + 16);
+            block.first_offset = readValue<qint64>(d->data,body_offset + 24);
+            block.end_offset = offset;
+            d->blocks.append(block);
+            d->tail = BinaryLogBlock();
+        } else if (kind == qti_def_BINARY_LOG_BLOCK_FOOTER) {
+            d->is_complete = true;
+        }
+
+        offset = body_offset + length;
+    }
+    d->scan_offset = offset;
+}
+
+bool Qtilities::Logging::BinaryLogReader::readIndexChain(qint64 footer_offset) {
+    QVector<BinaryLogBlock> blocks;
+    quint64 entry_count = 0;
+
+    qint64 index_offset = readValue<qint64>(d->data,footer_offset + qti_def_BINARY_LOG_BLOCK_HEADER_SIZE);
+    qint64 limit = footer_offset;
+    while (index_offset >= 0) {
+        // Index blocks are chained backwards, thus each offset must be before the previous one:
+        if (index_offset < d->header_size || index_offset + qti_def_BINARY_LOG_BLOCK_HEADER_SIZE + index_body_size > limit)
+            return false;
+        if (readValue<quint32>(d->data,index_offset) != qti_def_BINARY_LOG_BLOCK_INDEX)
+            return false;
+
+        qint64 body_offset = index_offset + qti_def_BINARY_LOG_BLOCK_HEADER_SIZE;
+        BinaryLogBlock block;
+        block.count = readValue<quint32>(d->data,body_offset);
+        block.message_types = readValue<quint32>(d->data,body_offset + 4);
+        block.min_timestamp = readValue<qint64>(d->data,body_offset + 8);
+        block.max_timestamp = readValue<qint64>(d->data,body_offset + 16);
+        block.first_offset = readValue<qint64>(d->data,body_offset + 24);
+        block.end_offset = index_offset;
+        if (block.first_offset < d->header_size || block.first_offset > index_offset)
+            return false;
+
+        blocks.prepend(block);
+        entry_count += block.count;
+        limit = index_offset;
+        index_offset = readValue<qint64>(d->data,body_offset + 32);
+    }
+
+    d->blocks = blocks;
+    d->tail = BinaryLogBlock();
+    d->entry_count = entry_count;
+    d->scan_offset = d->data_size;
+    d->is_complete = true;
+    return true;
+}
+
+bool Qtilities::Logging::BinaryLogReader::decodeRecord(qint64 offset, quint32 length, BinaryLogEntry* entry) const {
+    if (length < (quint32) record_engine_name_offset + 2)
+        return false;
+
+    const qint64 end = offset + length;
+    entry->timestamp = QDateTime::fromMSecsSinceEpoch(readValue<qint64>(d->data,offset + record_timestamp_offset));
+    entry->sequence = readValue<quint64>(d->data,offset + record_sequence_offset);
+    entry->thread_id = readValue<quint64>(d->data,offset + record_thread_offset);
+    entry->message_type = (Logger::MessageType) readValue<quint32>(d->data,offset + record_type_offset);
+    entry->message_context = Logger::MessageContextFlags((int) readValue<quint32>(d->data,offset + record_context_offset));
+
+    qint64 position = offset + record_engine_name_offset;
+    quint16 engine_name_length = readValue<quint16>(d->data,position);
+    position += 2;
+    if (position + engine_name_length + 2 > end)
+        return false;
+    entry->engine_name = QString::fromUtf8((const char*) d->data + position,engine_name_length);
+    position += engine_name_length;
+
+    quint16 message_count = readValue<quint16>(d->data,position);
+    position += 2;
+    entry->messages.clear();
+    for (int i = 0; i < message_count; ++i) {
+        if (position + 4 > end)
+            return false;
+        quint32 message_length = readValue<quint32>(d->data,position);
+        position += 4;
+        if (position + message_length > end)
+            return false;
+        entry->messages << QString::fromUtf8((const char*) d->data + position,message_length);
+        position += message_length;
+    }
+
+    return true;
+}
+
+quint64 Qtilities::Logging::BinaryLogReader::visitRecords(const QDateTime& from, const QDateTime& to, Logger::MessageTypeFlags message_types, BinaryLogEntrySink* sink) const {
+    if (!d->data)
+        return 0;
+
+    const qint64 from_msecs = from.isValid() ? from.toMSecsSinceEpoch() : Q_INT64_C(-0x7FFFFFFFFFFFFFFF);
+    const qint64 to_msecs = to.isValid() ? to.toMSecsSinceEpoch() : Q_INT64_C(0x7FFFFFFFFFFFFFFF);
+    const quint32 types = (quint32) (int) message_types;
+
+    QVector<BinaryLogBlock> blocks = d->blocks;
+    if (d->tail.count > 0)
+        blocks.append(d->tail);
+
+    quint64 visited = 0;
+    for (int i = 0; i < blocks.count(); ++i) {
+        const BinaryLogBlock& block = blocks.at(i);
+        // Skip blocks without matching records:
+        if (block.max_timestamp < from_msecs || block.min_timestamp > to_msecs || !(block.message_types & types))
+            continue;
+
+        qint64 offset = block.first_offset;
+        while (offset + qti_def_BINARY_LOG_BLOCK_HEADER_SIZE <= block.end_offset) {
+            quint32 kind = readValue<quint32>(d->data,offset);
+            quint32 length = readValue<quint32>(d->data,offset + 4);
+            qint64 body_offset = offset + qti_def_BINARY_LOG_BLOCK_HEADER_SIZE;
+            if (body_offset + length > block.end_offset)
+                break;
+
+            if (kind == qti_def_BINARY_LOG_BLOCK_RECORD && length >= (quint32) record_engine_name_offset) {
+                qint64 timestamp = readValue<qint64>(d->data,body_offset + record_timestamp_offset);
+                quint32 type = readValue<quint32>(d->data,body_offset + record_type_offset);
+                if (timestamp >= from_msecs && timestamp <= to_msecs && (type & types)) {
+                    ++visited;
+                    if (sink) {
+                        BinaryLogEntry entry;
+                        if (decodeRecord(body_offset,length,&entry)) {
+                            if (!sink->accept(entry))
+                                return visited;
+                        }
+                    }
+                }
+            }
+
+            offset = body_offset + length;
+        }
+    }
+
+    return visited;
+}
@@ -0,0 +1,226 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#ifndef BINARY_LOG_READER_H
+#define BINARY_LOG_READER_H
+
+#include "Logging_global.h"
+#include "Logger.h"
+#include "LogRecord.h"
+
+#include <QObject>
+#include <QDateTime>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+class QIODevice;
+
+namespace Qtilities {
+    namespace Logging {
+        class AbstractFormattingEngine;
+
+        /*!
+          \struct BinaryLogEntry
+          \brief The BinaryLogEntry structure holds a single record read from a binary log file.
+
+          <i>This struct was added in %Qtilities v1.5.</i>
+         */
+        struct LOGGING_SHARED_EXPORT BinaryLogEntry {
+        public:
+            BinaryLogEntry() : sequence(0),
+                thread_id(0),
+                message_type(Logger::None),
+                message_context(0) {}
+
+            //! Returns a LogRecord with the information in this entry, which can be formatted by formatting engines.
+            LogRecord toLogRecord() const;
+
+            //! The time at which the message was logged.
+            QDateTime                       timestamp;
+            //! The sequence number of the record in its log file.
+            quint64                         sequence;
+            //! The ID of the thread which logged the message.
+            quint64                         thread_id;
+            //! The type of the message.
+            Logger::MessageType             message_type;
+            //! The context in which the message was logged.
+            Logger::MessageContextFlags     message_context;
+            //! The name of the engine the message was targeted at, empty when the message was targeted at all engines.
+            QString                         engine_name;
+            //! The message, followed by any additional parameters which were passed to the logger.
+            QStringList                     messages;
+        };
+
+        /*!
+        \struct BinaryLogReaderPrivateData
+        \brief The BinaryLogReader class uses this struct to store its private data.
+          */
+        struct BinaryLogReaderPrivateData;
+        struct BinaryLogEntrySink;
+
+        /*!
+        \class BinaryLogReader
+        \brief The BinaryLogReader class reads binary log files written by BinaryLoggerEngine.
+
+        The reader memory maps the log file, thus only the parts of the file which are accessed are read from disk. The index blocks in the file
+        are used to skip records which can't match a query: each index block holds the time range and the message types of the records before it.
+
+\code
+BinaryLogReader reader("session.qlog");
+if (reader.open()) {
+    // All errors and warnings logged during the last hour:
+    QList<BinaryLogEntry> entries = reader.entries(QDateTime::currentDateTime().addSecs(-3600),QDateTime(),Logger::Error | Logger::Warning);
+
+    // Convert the complete log to HTML:
+    QFile html_file("session.html");
+    if (html_file.open(QIODevice::WriteOnly | QIODevice::Text))
+        reader.convert(&html_file,Log->formattingEngineReference(qti_def_FORMATTING_ENGINE_HTML));
+}
+\endcode
+
+        Log files which are still being written can be followed using setFollowing(). The reader then watches the file and emits entriesAppended()
+        for records which are added to the file. refresh() can also be called directly to pick up new records.
+
+        \section binary_log_reader_format File Format
+
+        All values are stored in little endian byte order. The file starts with a header of Constants::qti_def_BINARY_LOG_HEADER_SIZE bytes:
+        - quint32: Constants::qti_def_BINARY_LOG_MAGIC
+        - quint16: The format version, Constants::qti_def_BINARY_LOG_VERSION
+        - quint16: The size of the header
+        - qint64: The time at which the file was created, in milliseconds since the epoch
+        - quint32: The index interval of the engine which wrote the file
+        - quint32: Reserved
+
+        The header is followed by blocks. Each block starts with a quint32 block kind and a quint32 length of the block body which follows. The following
+        blocks are written:
+        - Constants::qti_def_BINARY_LOG_BLOCK_RECORD: A log record with its timestamp (qint64, milliseconds since the epoch), sequence number (quint64),
+          thread ID (quint64), message type (quint32), message context (quint32), target engine name (quint16 length followed by UTF-8 text) and
+          messages (quint16 count, followed by each message as a quint32 length and UTF-8 text).
+        - Constants::qti_def_BINARY_LOG_BLOCK_INDEX: Summarizes the records since the previous index block with their count (quint32), the message types
+          they contain (quint32), their earliest and latest timestamps (qint64 each), the offset of the first record (qint64), the offset of the previous
+          index block or -1 (qint64), the sequence number of the first record (quint64) and a reserved quint64.
+        - Constants::qti_def_BINARY_LOG_BLOCK_FOOTER: Written when the engine is finalized, holds the offset of the last index block (qint64).
+
+        Unknown block kinds are skipped by the reader, thus new kinds of blocks can be added to the format later.
+
+        \note Memory mapping a large file requires enough address space, thus 64 bit builds are recommended when reading very large log files.
+
+        <i>This class was added in %Qtilities v1.5.</i>
+          */
+        class LOGGING_SHARED_EXPORT BinaryLogReader : public QObject
+        {
+            Q_OBJECT
+
+        public:
+            BinaryLogReader(const QString& file_name = QString(), QObject* parent = 0);
+            ~BinaryLogReader();
+
+            //! Sets the file name of the log file to read. Closes the current file.
+            void setFileName(const QString& file_name);
+            //! Returns the file name of the log file.
+            QString fileName() const;
+
+            //! Opens and memory maps the log file.
+            /*!
+              \returns True when the file could be mapped and it is a valid binary log file, false otherwise.
+              */
+            bool open();
+            //! Unmaps and closes the log file.
+            void close();
+            //! Indicates if the log file is open.
+            bool isOpen() const;
+            //! Indicates if the file was finalized by the engine which wrote it, thus no more records will be added to it.
+            bool isComplete() const;
+            //! Returns the time at which the log file was created.
+            QDateTime creationTime() const;
+
+            //! Returns the number of records in the log file.
+            quint64 entryCount() const;
+            //! Returns the entries in a time range which has one of the given message types.
+            /*!
+              \param from The earliest timestamp to include. When invalid, there is no lower limit.
+              \param to The latest timestamp to include. When invalid, there is no upper limit.
+              \param message_types The message types to include.
+              \param limit The maximum number of entries to return, or -1 for no limit.
+              \returns The entries in the order in which they were logged.
+              */
+            QList<BinaryLogEntry> entries(const QDateTime& from = QDateTime(),
+                                          const QDateTime& to = QDateTime(),
+                                          Logger::MessageTypeFlags message_types = Logger::AllLogLevels,
+                                          int limit = -1) const;
+            //! Returns the number of entries in a time range which has one of the given message types.
+            /*!
+              Does the same as entries(), without decoding the messages of the matching entries.
+              */
+            quint64 countEntries(const QDateTime& from = QDateTime(),
+                                 const QDateTime& to = QDateTime(),
+                                 Logger::MessageTypeFlags message_types = Logger::AllLogLevels) const;
+            //! Converts entries of the log file into a text format.
+            /*!
+              Writes the initialization string of \p formatting_engine, each matching entry formatted by \p formatting_engine on its own line and
+              the finalization string of \p formatting_engine to \p device.
+
+              \param device The device to write to, which must be open for writing.
+              \param formatting_engine The formatting engine to use.
+              \param from The earliest timestamp to include. When invalid, there is no lower limit.
+              \param to The latest timestamp to include. When invalid, there is no upper limit.
+              \param message_types The message types to include.
+              \returns True when successfull, false otherwise.
+              */
+            bool convert(QIODevice* device,
+                         AbstractFormattingEngine* formatting_engine,
+                         const QDateTime& from = QDateTime(),
+                         const QDateTime& to = QDateTime(),
+                         Logger::MessageTypeFlags message_types = Logger::AllLogLevels) const;
+
+            //! Enables or disables following of the log file.
+            /*!
+              When following, the reader watches the log file and calls refresh() when it changes.
+              */
+            void setFollowing(bool following);
+            //! Indicates if the log file is followed.
+            bool isFollowing() const;
+
+        public slots:
+            //! Picks up records which were added to the log file since it was opened or refreshed.
+            /*!
+              \returns The number of records which were added. When records were added, entriesAppended() is emitted.
+              */
+            int refresh();
+
+        signals:
+            //! Emitted by refresh() with the entries which were added to the log file.
+            void entriesAppended(const QList<Qtilities::Logging::BinaryLogEntry>& entries);
+
+        private slots:
+            void handle_fileChanged(const QString& path);
+
+        private:
+            //! Maps the file, or remaps it when its size changed.
+            bool mapFile();
+            //! Scans blocks from the current scan position up to the end of the mapped data.
+            void scanBlocks(QList<BinaryLogEntry>* appended_entries = 0);
+            //! Reads the index blocks using the footer of a complete file.
+            bool readIndexChain(qint64 footer_offset);
+            //! Decodes the record at offset, which must be the start of a record body.
+            bool decodeRecord(qint64 offset, quint32 length, BinaryLogEntry* entry) const;
+            //! Visits matching records and returns the number of records visited. Matching records are decoded and passed to sink when it is not null.
+            quint64 visitRecords(const QDateTime& from, const QDateTime& to, Logger::MessageTypeFlags message_types, BinaryLogEntrySink* sink) const;
+
+            BinaryLogReaderPrivateData* d;
+        };
+    }
+}
+
+Q_DECLARE_METATYPE(Qtilities::Logging::BinaryLogEntry)
+
+#endif // BINARY_LOG_READER_H
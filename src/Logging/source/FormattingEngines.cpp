@@ -11,6 +11,36 @@
 
 #include "FormattingEngines.h"
 
+namespace {
+    using namespace Qtilities::Logging;
+
+    // The default colors of message types in FormattingEngine_Rich_Text.
+    const char* richTextColor(Logger::MessageType message_type) {
+        switch (message_type) {
+        case Logger::Info:      return "black";
+        case Logger::Warning:   return "orange";
+        case Logger::Error:     return "red";
+        case Logger::Fatal:     return "purple";
+        case Logger::Debug:     return "grey";
+        case Logger::Trace:     return "lightgrey";
+        default:                return "";
+        }
+    }
+
+    // The colors of message types in FormattingEngine_HTML, or 0 for types which are not logged.
+    const char* htmlColor(Logger::MessageType message_type) {
+        switch (message_type) {
+        case Logger::Trace:     return "grey";
+        case Logger::Debug:     return "grey";
+        case Logger::Warning:   return "orange";
+        case Logger::Info:      return "black";
+        case Logger::Error:     return "red";
+        case Logger::Fatal:     return "red";
+        default:                return 0;
+        }
+    }
+}
+
 // -----------------------------------
 // Default Formatting Engine
 // -----------------------------------
@@ -19,7 +49,14 @@ QString Qtilities::Logging::FormattingEngine_Default::initializeString() const {
 }
 
 QString Qtilities::Logging::FormattingEngine_Default::formatMessage(Logger::MessageType message_type, const QList<QVariant>& messages) const {
-    QString message = QTime::currentTime().toString();
+    return formatRecord(LogRecord(message_type,messages));
+}
+
+QString Qtilities::Logging::FormattingEngine_Default::formatRecord(const LogRecord& record) const {
+    Logger::MessageType message_type = record.messageType();
+    QList<QVariant> messages = record.messages();
+
+    QString message = record.timestamp().time().toString();
     if (message_type == Logger::Debug)
         message.append(QString(" [%1] ").arg("Debug",-8,QChar(' ')));
     else if (message_type == Logger::Trace)
@@ -53,77 +90,52 @@ QString Qtilities::Logging::FormattingEngine_Default::finalizeString() const {
  }
 
 QString Qtilities::Logging::FormattingEngine_Rich_Text::formatMessage(Logger::MessageType message_type, const QList<QVariant>& messages) const {
-    QString message;
-
-    message.append(QTime::currentTime().toString());
-    message.append(QString(" [%1] ").arg(Log->logLevelToString(message_type),-8,QChar(QChar::Nbsp)));
-
-    // Since we convert it to rich text, < and > characters must be converted.
-    QString formatted_string = AbstractFormattingEngine::escape(messages.front().toString());
-    message.append(formatted_string);
-    for (int i = 1; i < messages.count(); ++i) {
-        QString formatted_string = AbstractFormattingEngine::escape(messages.at(i).toString());
-        message.append("<br>            %1").arg(formatted_string);
-    }
-    message.append("</font>");
+    return formatRecord(LogRecord(message_type,messages));
+}
 
-    QString custom_color_hint;
+QString Qtilities::Logging::FormattingEngine_Rich_Text::formatRecord(const LogRecord& record) const {
+    Logger::MessageType message_type = record.messageType();
+    QList<QVariant> messages = record.messages();
+    QString first_message;
     if (messages.count() > 0)
-        custom_color_hint = matchColorFormattingHint(messages.front().toString(),message_type);
-
-    // Start with the correct font:
-    switch (message_type) {
-    case Logger::Info:
-        if (custom_color_hint.isEmpty())
-            message.prepend("<font color='black'>");
-        else
-            message.prepend(QString("<font color='%1'>").arg(custom_color_hint));
-        break;
-
-    case Logger::Warning:
-        if (custom_color_hint.isEmpty())
-            message.prepend("<font color='orange'>");
-        else
-            message.prepend(QString("<font color='%1'>").arg(custom_color_hint));
-        break;
-
-    case Logger::Error:
-        if (custom_color_hint.isEmpty())
-            message.prepend("<font color='red'>");
-        else
-            message.prepend(QString("<font color='%1'>").arg(custom_color_hint));
-        break;
-
-    case Logger::Fatal:
-        if (custom_color_hint.isEmpty())
-            message.prepend("<font color='purple'>");
-        else
-            message.prepend(QString("<font color='%1'>").arg(custom_color_hint));
-        break;
-
-    case Logger::Debug:
-        if (custom_color_hint.isEmpty())
-            message.prepend("<font color='grey'>");
-        else
-            message.prepend(QString("<font color='%1'>").arg(custom_color_hint));
-        break;
-
-    case Logger::Trace:
-        if (custom_color_hint.isEmpty())
-            message.prepend("<font color='lightgrey'>");
-        else
-            message.prepend(QString("<font color='%1'>").arg(custom_color_hint));
-        break;
-
-    default:
-        break;
-    }
+        first_message = messages.front().toString();
 
     // If the message matches a custom color regexp we use that color, otherwise
     // we use the color of the message.
+    QString color = matchColorFormattingHint(first_message,message_type);
+    if (color.isEmpty())
+        color = QLatin1String(richTextColor(message_type));
+
+    // The message is built in a single buffer, sized for the markup and the escaped messages:
+    QString message;
+    int capacity = 64 + color.length() + int(first_message.length() * 1.1);
+    for (int i = 1; i < messages.count(); ++i)
+        capacity += 16 + int(messages.at(i).toString().length() * 1.1);
+    message.reserve(capacity);
+
+    if (!color.isEmpty()) {
+        message += QLatin1String("<font color='");
+        message += color;
+        message += QLatin1String("'>");
+    }
+    message += record.timestamp().time().toString();
+    message += QLatin1String(" [");
+    QString level = Log->logLevelToString(message_type);
+    message += level;
+    for (int i = level.length(); i < 8; ++i)
+        message += QChar(QChar::Nbsp);
+    message += QLatin1String("] ");
+
+    // Since we convert it to rich text, < and > characters must be converted.
+    AbstractFormattingEngine::appendEscaped(message,first_message);
+    for (int i = 1; i < messages.count(); ++i) {
+        message += QLatin1String("<br>            ");
+        AbstractFormattingEngine::appendEscaped(message,messages.at(i).toString());
+    }
+    message += QLatin1String("</font>");
 
     if (message_type == Logger::Fatal)
-        message.append("</b>");
+        message += QLatin1String("</b>");
 
     return message;
 }
@@ -170,42 +182,32 @@ QString Qtilities::Logging::FormattingEngine_HTML::initializeString() const {
 }
 
 QString Qtilities::Logging::FormattingEngine_HTML::formatMessage(Logger::MessageType message_type, const QList<QVariant>& messages) const {
+    return formatRecord(LogRecord(message_type,messages));
+}
+
+QString Qtilities::Logging::FormattingEngine_HTML::formatRecord(const LogRecord& record) const {
+    Logger::MessageType message_type = record.messageType();
+    QList<QVariant> messages = record.messages();
     if (messages.count() == 0)
         return "";
 
-    QString formatted_string = AbstractFormattingEngine::escape(messages.front().toString());
-    QString message;
-    switch (message_type) {
-        case Logger::Trace:
-            message = QString("<td>%1</td><td><font color='grey'>%2</font></td>").arg(QTime::currentTime().toString()).arg(formatted_string);
-            break;
-        case Logger::Debug:
-            message = QString("<td>%1</td><td><font color='grey'>%2</font></td>").arg(QTime::currentTime().toString()).arg(formatted_string);
-            break;
-        case Logger::Warning:
-            message = QString("<td>%1</td><td><font color='orange'>%2</font></td>").arg(QTime::currentTime().toString()).arg(formatted_string);
-            break;
-        case Logger::Info:
-            message = QString("<td>%1</td><td><font color='black'>%2</font></td>").arg(QTime::currentTime().toString()).arg(formatted_string);
-            break;
-        case Logger::Error:
-            message = QString("<td>%1</td><td><font color='red'>%2</font></td>").arg(QTime::currentTime().toString()).arg(formatted_string);
-            break;
-        case Logger::Fatal:
-            message = QString("<td>%1</td><td><font color='red'>%2</font></td>").arg(QTime::currentTime().toString()).arg(formatted_string);
-            break;
-        case Logger::None:
-            return QString();
-        case Logger::AllLogLevels:
-            return QString();
-        }
+    const char* color = htmlColor(message_type);
+    if (!color)
+        return QString();
 
-    /*for (int i = 1; i < messages.count(); ++i) {
-        message.append(QString("%1").arg(messages.at(i).toString()));
-    }*/
+    QString formatted_string = messages.front().toString();
+    QString time_string = record.timestamp().time().toString();
 
-    message.prepend("<tr><font size=\"5\" face=\"verdana\">");
-    message.append("</font></tr>");
+    // The message is built in a single buffer, sized for the markup and the escaped message:
+    QString message;
+    message.reserve(112 + time_string.length() + int(formatted_string.length() * 1.1));
+    message += QLatin1String("<tr><font size=\"5\" face=\"verdana\"><td>");
+    message += time_string;
+    message += QLatin1String("</td><td><font color='");
+    message += QLatin1String(color);
+    message += QLatin1String("'>");
+    AbstractFormattingEngine::appendEscaped(message,formatted_string);
+    message += QLatin1String("</font></td></font></tr>");
     return message;
 }
 
@@ -49,6 +49,7 @@ namespace Qtilities {
             QString initializeString() const;
             QString finalizeString() const;
             QString formatMessage(Logger::MessageType message_type, const QList<QVariant>& messages) const;
+            QString formatRecord(const LogRecord& record) const;
             QString fileExtension() const { return QString("log"); }
             QString name() const { return qti_def_FORMATTING_ENGINE_DEFAULT; }
             QString endOfLineChar() const { return QString("\n"); }
@@ -84,6 +85,7 @@ namespace Qtilities {
             QString initializeString() const;
             QString finalizeString() const;
             QString formatMessage(Logger::MessageType message_type, const QList<QVariant>& messages) const;
+            QString formatRecord(const LogRecord& record) const;
             QString fileExtension() const { return QString(); }
             QString name() const { return qti_def_FORMATTING_ENGINE_RICH_TEXT; }
             QString endOfLineChar() const { return QString("<br>"); }
@@ -148,6 +150,7 @@ namespace Qtilities {
             QString initializeString() const;
             QString finalizeString() const;
             QString formatMessage(Logger::MessageType message_type, const QList<QVariant>& messages) const;
+            QString formatRecord(const LogRecord& record) const;
             QString fileExtension() const { return QString("html"); }
             QString name() const { return qti_def_FORMATTING_ENGINE_HTML; }
             QString endOfLineChar() const { return QString("<br>"); }
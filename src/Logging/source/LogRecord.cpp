@@ -0,0 +1,138 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#include "LogRecord.h"
+#include "AbstractFormattingEngine.h"
+
+#include <QMutex>
+#include <QPair>
+#include <QSharedData>
+#include <QThread>
+#include <QVarLengthArray>
+
+struct Qtilities::Logging::LogRecordData : public QSharedData {
+    LogRecordData() : thread_id(0),
+        message_type(Logger::None),
+        message_context(0) {}
+
+    QDateTime                       timestamp;
+    quint64                         thread_id;
+    Logger::MessageType             message_type;
+    Logger::MessageContextFlags     message_context;
+    QString                         engine_name;
+    QList<QVariant>                 messages;
+
+    // Only a few formatting engines are used at any time, thus a linear search is used.
+    mutable QMutex                  formatted_lock;
+    mutable QVarLengthArray<QPair<const AbstractFormattingEngine*,QString>,4> formatted_messages;
+};
+
+Qtilities::Logging::LogRecord::LogRecord() {
+
+}
+
+Qtilities::Logging::LogRecord::LogRecord(Logger::MessageType message_type, const QList<QVariant>& messages, Logger::MessageContextFlags message_context, const QString& engine_name, const QDateTime& timestamp) {
+    d = new LogRecordData;
+    d->timestamp = timestamp.isValid() ? timestamp : QDateTime::currentDateTime();
+    d->thread_id = (quint64) (quintptr) QThread::currentThreadId();
+    d->message_type = message_type;
+    d->message_context = message_context;
+    d->engine_name = engine_name;
+    d->messages = messages;
+}
+
+Qtilities::Logging::LogRecord::LogRecord(const LogRecord& ref) : d(ref.d) {
+
+}
+
+Qtilities::Logging::LogRecord& Qtilities::Logging::LogRecord::operator=(const LogRecord& ref) {
+    if (this==&ref) return *this;
+
+    d = ref.d;
+    return *this;
+}
+
+Qtilities::Logging::LogRecord::~LogRecord() {
+
+}
+
+bool Qtilities::Logging::LogRecord::isValid() const {
+    return d;
+}
+
+QDateTime Qtilities::Logging::LogRecord::timestamp() const {
+    if (!d)
+        return QDateTime();
+    return d->timestamp;
+}
+
+quint64 Qtilities::Logging::LogRecord::threadId() const {
+    if (!d)
+        return 0;
+    return d->thread_id;
+}
+
+Qtilities::Logging::Logger::MessageType Qtilities::Logging::LogRecord::messageType() const {
+    if (!d)
+        return Logger::None;
+    return d->message_type;
+}
+
+Qtilities::Logging::Logger::MessageContextFlags Qtilities::Logging::LogRecord::messageContext() const {
+    if (!d)
+        return 0;
+    return d->message_context;
+}
+
+QString Qtilities::Logging::LogRecord::engineName() const {
+    if (!d)
+        return QString();
+    return d->engine_name;
+}
+
+QList<QVariant> Qtilities::Logging::LogRecord::messages() const {
+    if (!d)
+        return QList<QVariant>();
+    return d->messages;
+}
+
+QString Qtilities::Logging::LogRecord::formattedMessage(const AbstractFormattingEngine* formatting_engine) const {
+    if (!d || !formatting_engine)
+        return QString();
+
+    {
+        QMutexLocker locker(&d->formatted_lock);
+        for (int i = 0; i < d->formatted_messages.count(); ++i) {
+            if (d->formatted_messages.at(i).first == formatting_engine)
+                return d->formatted_messages.at(i).second;
+        }
+    }
+
+    // Format outside of the lock, formatting engines can be slow. When another thread formatted the record
+    // in the meantime, its result is used.
+    QString formatted_message = formatting_engine->formatRecord(*this);
+
+    QMutexLocker locker(&d->formatted_lock);
+    for (int i = 0; i < d->formatted_messages.count(); ++i) {
+        if (d->formatted_messages.at(i).first == formatting_engine)
+            return d->formatted_messages.at(i).second;
+    }
+    d->formatted_messages.append(qMakePair(formatting_engine,formatted_message));
+    return formatted_message;
+}
+
+int Qtilities::Logging::LogRecord::formattedMessageCount() const {
+    if (!d)
+        return 0;
+
+    QMutexLocker locker(&d->formatted_lock);
+    return d->formatted_messages.count();
+}
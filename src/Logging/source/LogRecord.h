@@ -0,0 +1,106 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#ifndef LOG_RECORD_H
+#define LOG_RECORD_H
+
+#include "Logging_global.h"
+#include "Logger.h"
+
+#include <QDateTime>
+#include <QExplicitlySharedDataPointer>
+#include <QList>
+#include <QString>
+#include <QVariant>
+
+namespace Qtilities {
+    namespace Logging {
+        class AbstractFormattingEngine;
+
+        /*!
+        \struct LogRecordData
+        \brief The LogRecord class uses this struct to store its private data.
+          */
+        struct LogRecordData;
+
+        /*!
+        \class LogRecord
+        \brief The LogRecord class holds a single message logged through the Logger.
+
+        The logger creates one record for each message that it logs and sends it to all attached logger engines through
+        Logger::newLogRecord(). A record captures everything about the message at the time it was logged: its timestamp, the thread
+        which logged it, its type, context, the engine it is targeted at and its contents. Records are implicitly shared and can't be changed after they
+        were created, thus copying a record is cheap and records can be sent to engines living in other threads.
+
+        Engines format records using formattedMessage(), which remembers the result of each formatting engine used on the record.
+        When a number of engines share the same formatting engine, the message is therefore only formatted once.
+
+        <i>This class was added in %Qtilities v1.5.</i>
+          */
+        class LOGGING_SHARED_EXPORT LogRecord
+        {
+        public:
+            //! Constructs an invalid record.
+            LogRecord();
+            //! Constructs a record.
+            /*!
+              \param message_type The type of the message.
+              \param messages The message, followed by any additional parameters which were passed to the logger.
+              \param message_context The context in which the message was logged.
+              \param engine_name The name of the engine the message is targeted at, empty when the message is targeted at all engines.
+              \param timestamp The time at which the message was logged. When invalid, the current date and time is used.
+
+              The record stores the ID of the thread calling this constructor as its threadId().
+              */
+            LogRecord(Logger::MessageType message_type,
+                      const QList<QVariant>& messages,
+                      Logger::MessageContextFlags message_context = Logger::SystemWideMessages,
+                      const QString& engine_name = QString(),
+                      const QDateTime& timestamp = QDateTime());
+            LogRecord(const LogRecord& ref);
+            LogRecord& operator=(const LogRecord& ref);
+            ~LogRecord();
+
+            //! Indicates if this is a valid record.
+            bool isValid() const;
+            //! The time at which the message was logged.
+            QDateTime timestamp() const;
+            //! The ID of the thread which created the record, see QThread::currentThreadId().
+            quint64 threadId() const;
+            //! The type of the message.
+            Logger::MessageType messageType() const;
+            //! The context in which the message was logged.
+            Logger::MessageContextFlags messageContext() const;
+            //! The name of the engine the message is targeted at, empty when the message is targeted at all engines.
+            QString engineName() const;
+            //! The message, followed by any additional parameters which were passed to the logger.
+            QList<QVariant> messages() const;
+
+            //! Returns the record formatted by the given formatting engine.
+            /*!
+              The first call for a formatting engine calls AbstractFormattingEngine::formatRecord(), the result is stored in the record and
+              returned by later calls for the same formatting engine. This function can be called from any thread.
+
+              \returns The formatted message, or an empty string when \p formatting_engine is null or the record is invalid.
+              */
+            QString formattedMessage(const AbstractFormattingEngine* formatting_engine) const;
+            //! Returns the number of formatting engines which formatted this record so far.
+            int formattedMessageCount() const;
+
+        private:
+            QExplicitlySharedDataPointer<LogRecordData> d;
+        };
+    }
+}
+
+Q_DECLARE_METATYPE(Qtilities::Logging::LogRecord)
+
+#endif // LOG_RECORD_H
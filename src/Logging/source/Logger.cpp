@@ -16,14 +16,140 @@
 #include "FormattingEngines.h"
 #include "LoggerEngines.h"
 #include "LoggingConstants.h"
+#include "LogRecord.h"
 
 #include <Qtilities.h>
 
 #include <QtDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMetaObject>
 #include <QMutex>
+#include <QReadWriteLock>
+#include <QThread>
+#include <QThreadStorage>
+
+#include <stdio.h>
+#include <stdlib.h>
 
 using namespace Qtilities::Logging::Constants;
 
+namespace Qtilities {
+    namespace Logging {
+        /*!
+          The records logged by one thread which is not the thread of the logger.
+
+          The records are kept in a single producer, single consumer ring, thus the thread owning the buffer appends records without locking
+          and the thread draining the buffers in Logger::flush() takes them without locking. When the ring is full, records are appended to
+          an overflow list protected by a mutex until the ring was drained, which keeps the records in the order in which they were logged.
+          */
+        class LoggerThreadBuffer {
+        public:
+            LoggerThreadBuffer() : head(0),
+                tail(0),
+                has_overflow(0),
+                is_finished(0) {}
+
+            //! Appends a record, must only be called by the thread owning the buffer.
+            void append(const LogRecord& record) {
+                if (!has_overflow.fetchAndAddAcquire(0)) {
+                    int current_head = head.fetchAndAddAcquire(0);
+                    int next_head = (current_head + 1) & (ring_size - 1);
+                    if (next_head != tail.fetchAndAddAcquire(0)) {
+                        ring[current_head] = record;
+                        head.fetchAndStoreRelease(next_head);
+                        return;
+                    }
+                }
+
+                QMutexLocker locker(&overflow_lock);
+                overflow << record;
+                has_overflow.fetchAndStoreRelease(1);
+            }
+
+            //! Takes all records in the buffer, must only be called by the thread draining the buffers.
+            void takeRecords(QList<LogRecord>* records) {
+                takeFromRing(records);
+                if (has_overflow.fetchAndAddAcquire(0)) {
+                    // While there is an overflow the owning thread does not add records to the ring, thus the ring only holds records
+                    // which were logged before the records in the overflow list:
+                    QMutexLocker locker(&overflow_lock);
+                    takeFromRing(records);
+                    *records += overflow;
+                    overflow.clear();
+                    has_overflow.fetchAndStoreRelease(0);
+                }
+            }
+
+            //! Indicates that the owning thread finished, the buffer is deleted once it was drained.
+            void setFinished() {
+                is_finished.fetchAndStoreRelease(1);
+            }
+            bool isFinished() {
+                return is_finished.fetchAndAddAcquire(0);
+            }
+
+        private:
+            void takeFromRing(QList<LogRecord>* records) {
+                int current_tail = tail.fetchAndAddAcquire(0);
+                int current_head = head.fetchAndAddAcquire(0);
+                while (current_tail != current_head) {
+                    records->append(ring[current_tail]);
+                    ring[current_tail] = LogRecord();
+                    current_tail = (current_tail + 1) & (ring_size - 1);
+                }
+                tail.fetchAndStoreRelease(current_tail);
+            }
+
+            // Must be a power of 2:
+            enum { ring_size = 1024 };
+            LogRecord   ring[ring_size];
+            QAtomicInt  head;
+            QAtomicInt  tail;
+            QAtomicInt  has_overflow;
+            QMutex      overflow_lock;
+            QList<LogRecord> overflow;
+            QAtomicInt  is_finished;
+        };
+
+        //! A token bucket used by the rate limit of the logger, see Logger::setRateLimit().
+        struct LoggerRateLimitBucket {
+            LoggerRateLimitBucket() : tokens(0),
+                last_refill(0),
+                suppressed(0),
+                message_context(0) {}
+
+            // Returns the report of the messages suppressed since the previous report when there are any, and resets their count:
+            LogRecord takeReport() {
+                if (suppressed == 0)
+                    return LogRecord();
+
+                QList<QVariant> messages;
+                messages << QString("%1 messages were suppressed by the rate limit.").arg(suppressed);
+                suppressed = 0;
+                return LogRecord(Logger::Warning,messages,message_context,engine_name);
+            }
+
+            double                          tokens;
+            qint64                          last_refill;
+            int                             suppressed;
+            // The context and target engine of the suppressed messages, used by the report of the suppressed messages:
+            Logger::MessageContextFlags     message_context;
+            QString                         engine_name;
+        };
+
+        // Owned by the thread local storage of the logger, marks the buffer of a thread as finished when the thread ends.
+        struct LoggerThreadBufferReference {
+            LoggerThreadBufferReference(LoggerThreadBuffer* thread_buffer) : buffer(thread_buffer) {}
+            ~LoggerThreadBufferReference() {
+                buffer->setFinished();
+            }
+
+            LoggerThreadBuffer* buffer;
+        };
+    }
+}
+
 struct Qtilities::Logging::LoggerPrivateData {
     LoggerFactory<AbstractLoggerEngine>         logger_engine_factory;
     QList<QPointer<AbstractLoggerEngine> >      logger_engines;
@@ -36,9 +162,68 @@ struct Qtilities::Logging::LoggerPrivateData {
     QPointer<AbstractFormattingEngine>          priority_formatting_engine;
     QString                                     session_path;
     bool                                        settings_enabled;
+
+    // The routing table used to dispatch records, rebuilt by refreshLoggerEngineRoutes():
+    QReadWriteLock                              routes_lock;
+    //! Attached engines by name, used for engine specific messages.
+    QHash<QString,AbstractLoggerEngine*>        engine_routes;
+    //! Active engines accepting system wide messages, indexed by the bit of the message type.
+    QList<AbstractLoggerEngine*>                system_wide_routes[8];
+    //! Active engines accepting priority messages, indexed by the bit of the message type.
+    QList<AbstractLoggerEngine*>                priority_routes[8];
+
+    // Records logged from other threads than the thread of the logger, see Logger::flush():
+    QThreadStorage<LoggerThreadBufferReference*> thread_buffer_references;
+    QMutex                                      thread_buffers_lock;
+    QList<LoggerThreadBuffer*>                  thread_buffers;
+    QMutex                                      drain_lock;
+    QAtomicInt                                  drain_scheduled;
+
+    // The suppression stage, see Logger::processLogRecord():
+    QMutex                                      suppression_lock;
+    bool                                        suppress_duplicates;
+    LogRecord                                   last_record;
+    int                                         last_record_repeats;
+    int                                         rate_limit;
+    int                                         rate_limit_burst;
+    Logger::RateLimitKeys                       rate_limit_keys;
+    QHash<QString,LoggerRateLimitBucket>        rate_limit_buckets;
+    QElapsedTimer                               rate_limit_timer;
+    quint64                                     duplicate_count;
+    quint64                                     rate_limited_count;
 };
 
+namespace {
+    // Returns the index of the routes for a message type in LoggerPrivateData.
+    inline int messageTypeRouteIndex(Qtilities::Logging::Logger::MessageType message_type) {
+        int index = 0;
+        while (index < 7 && !(message_type & (1 << index)))
+            ++index;
+        return index;
+    }
+
+    // Tracks if the current thread is busy handling a Qt message in installLoggerMessageHandler().
+    QThreadStorage<int*> message_handler_depth;
+
+    struct MessageHandlerGuard {
+        MessageHandlerGuard() {
+            if (!message_handler_depth.hasLocalData())
+                message_handler_depth.setLocalData(new int(0));
+            ++(*message_handler_depth.localData());
+        }
+        ~MessageHandlerGuard() {
+            --(*message_handler_depth.localData());
+        }
+        //! Indicates that the message was raised while handling another message, for example by a logger engine.
+        bool isReentrant() const {
+            return *message_handler_depth.localData() > 1;
+        }
+    };
+}
+
 Qtilities::Logging::Logger* Qtilities::Logging::Logger::m_Instance = 0;
+QAtomicInt Qtilities::Logging::Logger::logged_message_types(0);
+QAtomicInt Qtilities::Logging::Logger::logged_priority_message_types(0);
 
 Qtilities::Logging::Logger* Qtilities::Logging::Logger::instance() {
     static QMutex mutex;
@@ -65,9 +250,21 @@ Qtilities::Logging::Logger::Logger(QObject* parent) : QObject(parent) {
     d->priority_formatting_engine = 0;
     d->session_path = QCoreApplication::applicationDirPath() + qti_def_PATH_SESSION;
     d->settings_enabled = true;
+    d->suppress_duplicates = false;
+    d->last_record_repeats = 0;
+    d->rate_limit = 0;
+    d->rate_limit_burst = 0;
+    d->rate_limit_keys = RateLimitPerMessageType;
+    d->duplicate_count = 0;
+    d->rate_limited_count = 0;
+
+    qRegisterMetaType<Qtilities::Logging::LogRecord>("Qtilities::Logging::LogRecord");
+    qRegisterMetaType<Qtilities::Logging::LogRecord>("LogRecord");
+    refreshLoggerEngineRoutes();
 }
 
 Qtilities::Logging::Logger::~Logger() {
+    flush();
     clear();
     delete d;
 }
@@ -89,6 +286,8 @@ void Qtilities::Logging::Logger::initialize(const QString& configuration_file_na
 
     // Register the logger enigines that comes as part of the Qtilities Logging Framework
     d->logger_engine_factory.registerFactoryInterface(qti_def_FACTORY_TAG_FILE_LOGGER_ENGINE, &FileLoggerEngine::factory);
+    d->logger_engine_factory.registerFactoryInterface(qti_def_FACTORY_TAG_ROLLING_FILE_LOGGER_ENGINE, &RollingFileLoggerEngine::factory);
+    d->logger_engine_factory.registerFactoryInterface(qti_def_FACTORY_TAG_BINARY_LOGGER_ENGINE, &BinaryLoggerEngine::factory);
 
     //qDebug() << tr("> Number of formatting engines available: ") << d->formatting_engines.count();
     //qDebug() << tr("> Number of logger engine factories available: ") << d->logger_engine_factory.tags().count();
@@ -115,6 +314,8 @@ void Qtilities::Logging::Logger::initialize(const QString& configuration_file_na
 }
 
 void Qtilities::Logging::Logger::finalize(const QString &configuration_file_name) {
+    flush();
+
     if (d->remember_session_config) {
         saveSessionConfig(configuration_file_name);
     }
@@ -135,6 +336,7 @@ void Qtilities::Logging::Logger::clear() {
 
     }
     d->logger_engines.clear();
+    refreshLoggerEngineRoutes();
     //qDebug() << tr("Qtilities Logging Framework, clearing finished successfully...");
 }
 
@@ -148,7 +350,7 @@ void Qtilities::Logging::Logger::logMessage(const QString& engine_name, MessageT
     if (message_type == AllLogLevels || message_type == None)
         return;
 
-    if (message_type > d->global_log_level)
+    if (!isMessageTypeLogged(message_type))
         return;
 
     QList<QVariant> message_contents;
@@ -185,7 +387,27 @@ void Qtilities::Logging::Logger::logMessage(const QString& engine_name, MessageT
     else
         context |= EngineSpecificMessages;
 
-    emit newMessage(engine_name,message_type,context,message_contents);
+    postLogRecord(LogRecord(message_type,message_contents,context,engine_name));
+}
+
+void Qtilities::Logging::Logger::logSingleMessage(const QString& engine_name, MessageType message_type, const QVariant& message) {
+    if (message_type == AllLogLevels || message_type == None)
+        return;
+
+    if (!isMessageTypeLogged(message_type))
+        return;
+
+    QList<QVariant> message_contents;
+    message_contents.push_back(message);
+
+    // Create the correct message context:
+    MessageContextFlags context = 0;
+    if (engine_name.isEmpty())
+        context |= SystemWideMessages;
+    else
+        context |= EngineSpecificMessages;
+
+    postLogRecord(LogRecord(message_type,message_contents,context,engine_name));
 }
 
 void Qtilities::Logging::Logger::logPriorityMessage(const QString& engine_name, MessageType message_type, const QVariant& message, const QVariant &msg1, const QVariant &msg2, const QVariant &msg3, const QVariant &msg4, const QVariant &msg5, const QVariant &msg6, const QVariant &msg7, const QVariant &msg8 , const QVariant &msg9) {
@@ -198,7 +420,7 @@ void Qtilities::Logging::Logger::logPriorityMessage(const QString& engine_name,
     if (message_type == AllLogLevels || message_type == None)
         return;
 
-    if (message_type > d->global_log_level)
+    if (!isPriorityMessageTypeLogged(message_type))
         return;
 
     QList<QVariant> message_contents;
@@ -217,15 +439,201 @@ void Qtilities::Logging::Logger::logPriorityMessage(const QString& engine_name,
     MessageContextFlags context = 0;
     context |= PriorityMessages;
 
-    emit newMessage(engine_name,message_type,context,message_contents);
+    postLogRecord(LogRecord(message_type,message_contents,context,engine_name));
+}
+
+void Qtilities::Logging::Logger::flush() {
+    drainScheduledRecords();
+
+    // Report suppressed messages, otherwise they are only reported once a message passes the same suppression again:
+    QList<LogRecord> reports;
+    {
+        QMutexLocker locker(&d->suppression_lock);
+        takeSuppressionReports(&reports);
+        d->last_record = LogRecord();
+    }
+    for (int i = 0; i < reports.count(); ++i)
+        deliverLogRecord(reports.at(i),false);
+}
+
+void Qtilities::Logging::Logger::drainScheduledRecords() {
+    d->drain_scheduled.fetchAndStoreOrdered(0);
+    drainThreadBuffers(false);
+}
+
+void Qtilities::Logging::Logger::postLogRecord(const LogRecord& record) {
+    if (record.messageType() == Fatal) {
+        // Fatal messages are typically followed by abort(), thus the records logged before it and the fatal record itself are
+        // delivered to the engines before returning:
+        drainThreadBuffers(true);
+        processLogRecord(record,true);
+    } else if (QThread::currentThread() == thread()) {
+        processLogRecord(record,false);
+    } else {
+        if (!d->thread_buffer_references.hasLocalData()) {
+            LoggerThreadBuffer* buffer = new LoggerThreadBuffer;
+            {
+                QMutexLocker locker(&d->thread_buffers_lock);
+                d->thread_buffers << buffer;
+            }
+            d->thread_buffer_references.setLocalData(new LoggerThreadBufferReference(buffer));
+        }
+        d->thread_buffer_references.localData()->buffer->append(record);
+
+        // Only schedule a drain when none is pending, thus a burst of records is drained in one batch:
+        if (d->drain_scheduled.testAndSetOrdered(0,1))
+            QMetaObject::invokeMethod(this,"drainScheduledRecords",Qt::QueuedConnection);
+    }
+}
+
+void Qtilities::Logging::Logger::processLogRecord(const LogRecord& record, bool direct_delivery) {
+    QList<LogRecord> reports;
+    bool deliver = passesSuppression(record,&reports);
+
+    for (int i = 0; i < reports.count(); ++i)
+        deliverLogRecord(reports.at(i),direct_delivery);
+    if (deliver)
+        deliverLogRecord(record,direct_delivery);
+}
+
+bool Qtilities::Logging::Logger::passesSuppression(const LogRecord& record, QList<LogRecord>* reports) {
+    QMutexLocker locker(&d->suppression_lock);
+    if (!d->suppress_duplicates && d->rate_limit == 0)
+        return true;
+
+    bool is_fatal = (record.messageType() == Fatal);
+    if (d->suppress_duplicates) {
+        if (!is_fatal && d->last_record.isValid()
+                && record.messageType() == d->last_record.messageType()
+                && record.messageContext() == d->last_record.messageContext()
+                && record.engineName() == d->last_record.engineName()
+                && record.messages() == d->last_record.messages()) {
+            ++d->last_record_repeats;
+            ++d->duplicate_count;
+            return false;
+        }
+
+        LogRecord repeat_report = takeRepeatReport();
+        if (repeat_report.isValid())
+            reports->append(repeat_report);
+        d->last_record = record;
+    }
+
+    if (d->rate_limit > 0 && !is_fatal) {
+        QString key;
+        if (d->rate_limit_keys & RateLimitPerMessageType)
+            key += QString::number((int) record.messageType());
+        key += QLatin1Char('|');
+        if (d->rate_limit_keys & RateLimitPerTargetEngine)
+            key += record.engineName();
+        key += QLatin1Char('|');
+        if (d->rate_limit_keys & RateLimitPerThread)
+            key += QString::number(record.threadId());
+
+        int burst = d->rate_limit_burst > 0 ? d->rate_limit_burst : d->rate_limit;
+        qint64 now = d->rate_limit_timer.elapsed();
+        QHash<QString,LoggerRateLimitBucket>::iterator bucket = d->rate_limit_buckets.find(key);
+        if (bucket == d->rate_limit_buckets.end()) {
+            bucket = d->rate_limit_buckets.insert(key,LoggerRateLimitBucket());
+            bucket.value().tokens = burst;
+        } else {
+            bucket.value().tokens = qMin((double) burst,bucket.value().tokens + (now - bucket.value().last_refill) * d->rate_limit / 1000.0);
+        }
+        bucket.value().last_refill = now;
+
+        if (bucket.value().tokens < 1.0) {
+            ++bucket.value().suppressed;
+            bucket.value().message_context = record.messageContext();
+            bucket.value().engine_name = record.engineName();
+            ++d->rate_limited_count;
+            return false;
+        }
+        bucket.value().tokens -= 1.0;
+
+        LogRecord rate_limit_report = bucket.value().takeReport();
+        if (rate_limit_report.isValid())
+            reports->append(rate_limit_report);
+    }
+
+    return true;
+}
+
+void Qtilities::Logging::Logger::takeSuppressionReports(QList<LogRecord>* reports) {
+    LogRecord repeat_report = takeRepeatReport();
+    if (repeat_report.isValid())
+        reports->append(repeat_report);
+
+    QHash<QString,LoggerRateLimitBucket>::iterator bucket;
+    for (bucket = d->rate_limit_buckets.begin(); bucket != d->rate_limit_buckets.end(); ++bucket) {
+        LogRecord rate_limit_report = bucket.value().takeReport();
+        if (rate_limit_report.isValid())
+            reports->append(rate_limit_report);
+    }
+}
+
+Qtilities::Logging::LogRecord Qtilities::Logging::Logger::takeRepeatReport() {
+    if (d->last_record_repeats == 0)
+        return LogRecord();
+
+    QList<QVariant> messages;
+    if (d->last_record_repeats == 1)
+        messages << QString("Last message repeated 1 time.");
+    else
+        messages << QString("Last message repeated %1 times.").arg(d->last_record_repeats);
+    d->last_record_repeats = 0;
+    return LogRecord(d->last_record.messageType(),messages,d->last_record.messageContext(),d->last_record.engineName());
+}
+
+void Qtilities::Logging::Logger::deliverLogRecord(const LogRecord& record, bool direct_delivery) {
+    dispatchLogRecord(record,direct_delivery);
+    emit newMessage(record.engineName(),record.messageType(),record.messageContext(),record.messages());
+    emit newLogRecord(record);
+
+    if (record.messageContext() & PriorityMessages) {
+        // The priority formatting engine is typically also used by logger engines, thus the record is shared with them:
+        QString formatted_message;
+        if (d->priority_formatting_engine)
+            formatted_message = record.formattedMessage(d->priority_formatting_engine);
+        else if (!record.messages().isEmpty())
+            formatted_message = record.messages().front().toString();
+
+        emit newPriorityMessage(record.messageType(),formatted_message);
+    }
+}
 
-    QString formatted_message;
-    if (d->priority_formatting_engine) {
-        formatted_message = d->priority_formatting_engine->formatMessage(message_type,message_contents);
+void Qtilities::Logging::Logger::drainThreadBuffers(bool direct_delivery) {
+    // There is a single consumer. A fatal message does not wait long for a drain in progress, the drain might be the one logging the fatal message.
+    if (direct_delivery) {
+        if (!d->drain_lock.tryLock(100))
+            return;
     } else
-        formatted_message = message.toString();
+        d->drain_lock.lock();
 
-    emit newPriorityMessage(message_type,formatted_message);
+    QList<LoggerThreadBuffer*> buffers;
+    {
+        QMutexLocker locker(&d->thread_buffers_lock);
+        buffers = d->thread_buffers;
+    }
+
+    QList<LogRecord> records;
+    for (int i = 0; i < buffers.count(); ++i) {
+        LoggerThreadBuffer* buffer = buffers.at(i);
+        // Check if the thread finished before draining, records are appended before the thread finishes:
+        bool is_finished = buffer->isFinished();
+
+        buffer->takeRecords(&records);
+        for (int r = 0; r < records.count(); ++r)
+            processLogRecord(records.at(r),direct_delivery);
+        records.clear();
+
+        if (is_finished) {
+            QMutexLocker locker(&d->thread_buffers_lock);
+            d->thread_buffers.removeOne(buffer);
+            delete buffer;
+        }
+    }
+
+    d->drain_lock.unlock();
 }
 
 bool Qtilities::Logging::Logger::setPriorityFormattingEngine(const QString& name) {
@@ -344,7 +752,7 @@ bool Qtilities::Logging::Logger::attachLoggerEngine(AbstractLoggerEngine* new_lo
     if (new_logger_engine) {
         new_logger_engine->setObjectName(new_logger_engine->name());
         d->logger_engines << new_logger_engine;
-        connect(this,SIGNAL(newMessage(QString,Logger::MessageType,Logger::MessageContextFlags,QList<QVariant>)),new_logger_engine,SLOT(newMessages(QString,Logger::MessageType,Logger::MessageContextFlags,QList<QVariant>)));
+        refreshLoggerEngineRoutes();
     }
 
     emit loggerEngineCountChanged(new_logger_engine, EngineAdded);
@@ -354,6 +762,7 @@ bool Qtilities::Logging::Logger::attachLoggerEngine(AbstractLoggerEngine* new_lo
 bool Qtilities::Logging::Logger::detachLoggerEngine(AbstractLoggerEngine* logger_engine, bool delete_engine) {
     if (logger_engine) {
         if (d->logger_engines.removeOne(logger_engine)) {
+            refreshLoggerEngineRoutes();
             emit loggerEngineCountChanged(logger_engine, EngineRemoved);
             if (delete_engine)
                 delete logger_engine;
@@ -467,6 +876,7 @@ void Qtilities::Logging::Logger::deleteAllLoggerEngines() {
             delete d->logger_engines.at(0);
     }
     d->logger_engines.clear();
+    refreshLoggerEngineRoutes();
 }
 
 void Qtilities::Logging::Logger::disableAllLoggerEngines() {
@@ -556,6 +966,7 @@ void Qtilities::Logging::Logger::setGlobalLogLevel(Logger::MessageType new_log_l
         return;
 
     d->global_log_level = new_log_level;
+    refreshLoggerEngineRoutes();
 
     writeSettings();
     LOG_INFO("Global log level changed to " + logLevelToString(new_log_level));
@@ -565,6 +976,79 @@ Qtilities::Logging::Logger::MessageType Qtilities::Logging::Logger::globalLogLev
     return d->global_log_level;
 }
 
+void Qtilities::Logging::Logger::refreshLoggerEngineRoutes() {
+    // All message types up to the global log level are logged:
+    int level_types = 0;
+    const MessageType message_types[] = { Info, Warning, Error, Fatal, Debug, Trace };
+    for (unsigned int i = 0; i < sizeof(message_types) / sizeof(message_types[0]); ++i) {
+        if (message_types[i] <= d->global_log_level)
+            level_types |= message_types[i];
+    }
+
+    // In release mode we should not log debug and trace messages.
+    #ifdef QT_NO_DEBUG
+        level_types &= ~(Debug | Trace);
+    #endif
+
+    int engine_types = 0;
+    QWriteLocker locker(&d->routes_lock);
+    d->engine_routes.clear();
+    for (int i = 0; i < 8; ++i) {
+        d->system_wide_routes[i].clear();
+        d->priority_routes[i].clear();
+    }
+
+    for (int i = 0; i < d->logger_engines.count(); ++i) {
+        AbstractLoggerEngine* engine = d->logger_engines.at(i);
+        if (!engine)
+            continue;
+
+        // Engine specific messages are validated by the engine itself:
+        d->engine_routes[engine->name()] = engine;
+        if (!engine->isActive())
+            continue;
+
+        int enabled_types = (int) engine->getEnabledMessageTypes();
+        engine_types |= enabled_types;
+        for (int bit = 0; bit < 8; ++bit) {
+            if (!(enabled_types & (1 << bit)))
+                continue;
+            if (engine->messageContexts() & SystemWideMessages)
+                d->system_wide_routes[bit] << engine;
+            if (engine->messageContexts() & PriorityMessages)
+                d->priority_routes[bit] << engine;
+        }
+    }
+
+    logged_priority_message_types.fetchAndStoreOrdered(level_types);
+    logged_message_types.fetchAndStoreOrdered(level_types & engine_types);
+}
+
+void Qtilities::Logging::Logger::dispatchLogRecord(const LogRecord& record, bool direct_delivery) {
+    QList<AbstractLoggerEngine*> engines;
+    {
+        QReadLocker locker(&d->routes_lock);
+        if (!record.engineName().isEmpty()) {
+            AbstractLoggerEngine* engine = d->engine_routes.value(record.engineName());
+            if (engine)
+                engines << engine;
+        } else if (record.messageContext() & PriorityMessages) {
+            engines = d->priority_routes[messageTypeRouteIndex(record.messageType())];
+        } else {
+            engines = d->system_wide_routes[messageTypeRouteIndex(record.messageType())];
+        }
+    }
+
+    // Engines living in other threads receive the record through their event loop, unless it must be delivered directly and the engine is thread safe:
+    for (int i = 0; i < engines.count(); ++i) {
+        AbstractLoggerEngine* engine = engines.at(i);
+        if (engine->thread() == QThread::currentThread() || (direct_delivery && engine->isThreadSafe()))
+            engine->newLogRecord(record);
+        else
+            QMetaObject::invokeMethod(engine,"newLogRecord",Qt::QueuedConnection,Q_ARG(LogRecord,record));
+    }
+}
+
 void Qtilities::Logging::Logger::writeSettings() const {
     if (!d->settings_enabled)
         return;
@@ -592,6 +1076,7 @@ void Qtilities::Logging::Logger::readSettings() {
     settings.beginGroup("General");
     QVariant log_level =  settings.value("global_log_level", Fatal);
     d->global_log_level = (MessageType) log_level.toInt();
+    refreshLoggerEngineRoutes();
     if (settings.value("is_qt_message_handler", false).toBool())
         installAsQtMessageHandler(false);
     settings.endGroup();
@@ -666,9 +1151,14 @@ void Qtilities::Logging::Logger::setIsQtMessageHandler(bool toggle) {
 #if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
 void Qtilities::Logging::installLoggerMessageHandler(QtMsgType type, const char *msg)
 {
-    static QMutex msgMutex;
-    if (!msgMutex.tryLock())
+    // The logger is thread safe, thus only messages raised while this thread is busy logging a message are not passed to it again:
+    MessageHandlerGuard guard;
+    if (guard.isReentrant()) {
+        fprintf(stderr,"%s\n",msg);
+        if (type == QtFatalMsg)
+            abort();
         return;
+    }
 
     switch (type)
     {
@@ -683,18 +1173,20 @@ void Qtilities::Logging::installLoggerMessageHandler(QtMsgType type, const char
         break;
     case QtFatalMsg:
         Log->logMessage(QString(),Logger::Fatal, msg);
-        msgMutex.unlock();
         abort();
     }
-
-    msgMutex.unlock();
 }
 #else
 void Qtilities::Logging::installLoggerMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
 {
-    static QMutex msgMutex;
-    if (!msgMutex.tryLock())
+    // The logger is thread safe, thus only messages raised while this thread is busy logging a message are not passed to it again:
+    MessageHandlerGuard guard;
+    if (guard.isReentrant()) {
+        fprintf(stderr,"%s\n",qPrintable(msg));
+        if (type == QtFatalMsg)
+            abort();
         return;
+    }
 
     QString detailed_msg = QString("%1 (%2:%3. %4)").arg(msg).arg(context.file).arg(context.line).arg(context.function);
     switch (type)
@@ -710,11 +1202,8 @@ void Qtilities::Logging::installLoggerMessageHandler(QtMsgType type, const QMess
         break;
     case QtFatalMsg:
         Log->logMessage(QString(),Logger::Fatal, detailed_msg);
-        msgMutex.unlock();
         abort();
     }
-
-    msgMutex.unlock();
 }
 #endif
 
@@ -791,6 +1280,67 @@ bool Qtilities::Logging::Logger::consoleEngineActive() const {
         return false;
 }
 
+void Qtilities::Logging::Logger::setDuplicateSuppressionEnabled(bool is_enabled) {
+    QList<LogRecord> reports;
+    {
+        QMutexLocker locker(&d->suppression_lock);
+        if (d->suppress_duplicates == is_enabled)
+            return;
+        takeSuppressionReports(&reports);
+        d->last_record = LogRecord();
+        d->suppress_duplicates = is_enabled;
+    }
+    for (int i = 0; i < reports.count(); ++i)
+        deliverLogRecord(reports.at(i),false);
+}
+
+bool Qtilities::Logging::Logger::duplicateSuppressionEnabled() const {
+    QMutexLocker locker(&d->suppression_lock);
+    return d->suppress_duplicates;
+}
+
+void Qtilities::Logging::Logger::setRateLimit(int messages_per_second, int burst, RateLimitKeys keys) {
+    // The buckets are replaced, thus the messages they suppressed are reported first:
+    QList<LogRecord> reports;
+    {
+        QMutexLocker locker(&d->suppression_lock);
+        takeSuppressionReports(&reports);
+        d->rate_limit = qMax(0,messages_per_second);
+        d->rate_limit_burst = qMax(0,burst);
+        d->rate_limit_keys = keys;
+        d->rate_limit_buckets.clear();
+        if (d->rate_limit > 0)
+            d->rate_limit_timer.start();
+    }
+    for (int i = 0; i < reports.count(); ++i)
+        deliverLogRecord(reports.at(i),false);
+}
+
+int Qtilities::Logging::Logger::rateLimit() const {
+    QMutexLocker locker(&d->suppression_lock);
+    return d->rate_limit;
+}
+
+int Qtilities::Logging::Logger::rateLimitBurst() const {
+    QMutexLocker locker(&d->suppression_lock);
+    return d->rate_limit_burst;
+}
+
+Qtilities::Logging::Logger::RateLimitKeys Qtilities::Logging::Logger::rateLimitKeys() const {
+    QMutexLocker locker(&d->suppression_lock);
+    return d->rate_limit_keys;
+}
+
+quint64 Qtilities::Logging::Logger::duplicateMessageCount() const {
+    QMutexLocker locker(&d->suppression_lock);
+    return d->duplicate_count;
+}
+
+quint64 Qtilities::Logging::Logger::rateLimitedMessageCount() const {
+    QMutexLocker locker(&d->suppression_lock);
+    return d->rate_limited_count;
+}
+
 void Qtilities::Logging::Logger::setLoggerSessionConfigPath(const QString path) {
     d->session_path = path;
 }
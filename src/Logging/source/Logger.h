@@ -23,6 +23,7 @@ namespace Qtilities {
     namespace Logging {
         class AbstractFormattingEngine;
         class AbstractLoggerEngine;
+        class LogRecord;
 
         /*!
         \struct LoggerPrivateData
@@ -35,6 +36,46 @@ namespace Qtilities {
         \brief The Logger class provides thread safe logging functionality to any Qt application.
 
         See the \ref page_logging article for more information on how to use the logger.
+
+        \section logger_engine_routing Logger Engine Routing
+
+        The logger keeps a routing table of its attached engines, thus a message only reaches the engines which can accept it:
+        - Engine specific messages, for example messages logged using LOG_INFO_E, are passed to the engine with the target name only.
+        - System wide and priority messages are passed to the active engines which accept the context and type of the message.
+
+        The table is rebuilt when engines are attached or detached, and when the name, activity, message contexts or enabled message types of
+        an attached engine change. Engines living in a different thread than the thread logging a message receive the message through their event loop.
+
+        \section logger_threads Logging From Multiple Threads
+
+        Messages can be logged from any thread. Messages logged in the thread of the logger, normally the main thread, are delivered to the logger
+        engines immediately. Messages logged in other threads are appended to a buffer owned by the logging thread without locking, and the logger
+        thread delivers the buffered messages of all threads in batches from its event loop. This means that:
+        - Messages logged by the same thread reach the logger engines in the order in which they were logged. Messages logged by different threads
+          can be interleaved in any order, LogRecord::timestamp() and LogRecord::threadId() can be used to tell them apart.
+        - Messages logged from other threads are delivered once the logger thread processes events, or when flush() is called.
+        - Fatal messages, including qFatal() messages when the logger is installed as the Qt message handler, are delivered before the logging
+          function returns to the engines which are thread safe, see AbstractLoggerEngine::isThreadSafe(). The messages buffered before it are delivered
+          first, thus they are not lost when the application aborts. Engines which are not thread safe, for example engines showing messages in widgets,
+          receive fatal messages logged from other threads through their event loop.
+
+        Qt messages raised by a thread while it is busy logging a message, for example a warning raised inside a logger engine, are written to
+        stderr instead of being logged again.
+
+        \section logger_suppression Message Suppression
+
+        A runaway loop logging the same message, for example a Qt warning captured through installAsQtMessageHandler(), can flood all logger
+        engines. Before records are delivered to the engines, and thus before they are formatted, the logger can suppress them in two ways:
+        - Identical consecutive messages are collapsed into a single "Last message repeated N times." message, see setDuplicateSuppressionEnabled().
+        - Messages are rate limited using token buckets per message type, target engine and/or logging thread, see setRateLimit().
+
+        Both are disabled by default. The number of suppressed messages are available through duplicateMessageCount() and rateLimitedMessageCount().
+
+\code
+// Collapse repeated messages and deliver at most 50 messages per second of each type, with bursts of up to 200 messages:
+Log->setDuplicateSuppressionEnabled(true);
+Log->setRateLimit(50,200,Logger::RateLimitPerMessageType);
+\endcode
           */
         class LOGGING_SHARED_EXPORT Logger : public QObject
         {
@@ -66,6 +107,16 @@ namespace Qtilities {
               Note that this does not include the Qt Message Logger or Console Logging engines.
               */
             void clear();
+            //! Delivers the records which were logged from other threads and are still waiting in their thread buffers.
+            /*!
+              Records logged from other threads than the thread of the logger are delivered to the logger engines in batches by the event
+              loop of the logger thread, see \ref logger_threads. This function delivers them immediately. It also delivers the reports of
+              messages which are suppressed but not reported yet, see \ref logger_suppression. It is called by finalize() and when the logger
+              is destroyed, and it can be called from any thread.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            void flush();
 
         public:
             //! The possible message contexts used by the logger.
@@ -90,6 +141,18 @@ namespace Qtilities {
             };
             Q_ENUMS(EngineChangeIndication)
 
+            //! The properties of a message which select the rate limit bucket it is counted in, see setRateLimit().
+            /*!
+              <i>This enum was added in %Qtilities v1.5.</i>
+              */
+            enum RateLimitKey {
+                RateLimitPerMessageType     = 1, /*!< Each message type has its own bucket. */
+                RateLimitPerTargetEngine    = 2, /*!< Each target engine has its own bucket, system wide messages share a bucket. */
+                RateLimitPerThread          = 4  /*!< Each thread logging messages has its own bucket. */
+            };
+            Q_DECLARE_FLAGS(RateLimitKeys, RateLimitKey)
+            Q_FLAGS(RateLimitKeys)
+
             //! The possible message types supported by the logger.
             /*!
               \sa setGlobalLogLevel(), globalLogLevel()
@@ -159,6 +222,53 @@ namespace Qtilities {
                       const QVariant& msg8 = QVariant(), const QVariant& msg9 = QVariant());
                       */
 
+        public:
+            //! Function to log a message without additional parameters.
+            /*!
+              Does the same as logMessage() when no additional parameters are passed, without building the list of additional parameters.
+              This function is used by the log macros, for example LOG_INFO.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            void logSingleMessage(const QString& engine_name, MessageType message_type, const QVariant& message);
+            //! Indicates if a message of the given type, logged through logMessage(), will reach at least one logger engine.
+            /*!
+              This function is the check used by the log macros before they evaluate their message argument, thus the construction of
+              messages which will not be logged costs nothing. It takes the global log level, the build mode of the Logging module (debug and
+              trace messages are not logged in release mode builds) and the enabled message types of all active logger engines into account.
+
+              Since the result is cached in an atomic integer, this function does not need the logger instance and it can be called from any thread.
+
+              \note Messages are only sent through the newMessage() signal when this function returns true for their type.
+
+              \sa isPriorityMessageTypeLogged(), setGlobalLogLevel()
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            static inline bool isMessageTypeLogged(MessageType message_type) {
+                #if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+                return ((int) logged_message_types) & message_type;
+                #else
+                return logged_message_types.load() & message_type;
+                #endif
+            }
+            //! Indicates if a message of the given type, logged through logPriorityMessage(), will be logged.
+            /*!
+              Priority messages are emitted through newPriorityMessage() regardless of the attached logger engines, thus only the
+              global log level and the build mode of the Logging module are taken into account.
+
+              \sa isMessageTypeLogged()
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            static inline bool isPriorityMessageTypeLogged(MessageType message_type) {
+                #if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+                return ((int) logged_priority_message_types) & message_type;
+                #else
+                return logged_priority_message_types.load() & message_type;
+                #endif
+            }
+
         public:
             // -----------------------------------------
             // Functions related to formatting engines
@@ -379,9 +489,83 @@ namespace Qtilities {
               */
             bool loggerSettingsEnabled() const;
 
+            // ----------------------------------
+            // Message suppression
+            // ----------------------------------
+            //! Enables or disables the collapsing of identical consecutive messages.
+            /*!
+              When enabled, a message which is identical to the previous message (the same type, context, target engine and contents) is not
+              delivered to the logger engines. When a different message is logged, when flush() is called or when duplicate suppression is disabled,
+              a single message stating how many times the previous message was repeated is delivered instead. Fatal messages are never collapsed.
+
+              Disabled by default. See \ref logger_suppression.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            void setDuplicateSuppressionEnabled(bool is_enabled);
+            //! Indicates if identical consecutive messages are collapsed.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            bool duplicateSuppressionEnabled() const;
+            //! Limits the rate at which messages are delivered to the logger engines.
+            /*!
+              Messages are counted in token buckets selected by \p keys. Each bucket holds up to \p burst messages and refills at \p messages_per_second
+              messages per second. Messages logged while their bucket is empty are dropped, and the next message which is delivered from the same
+              bucket is preceded by a warning stating how many messages were dropped. When no message is delivered from the bucket anymore, the
+              warning is delivered when flush() or setRateLimit() is called. Fatal messages are never dropped.
+
+              \param messages_per_second The rate at which buckets refill. When 0, rate limiting is disabled, which is the default.
+              \param burst The number of messages which can be delivered at once. When 0, \p messages_per_second is used.
+              \param keys The properties of messages which select their bucket.
+
+              See \ref logger_suppression.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            void setRateLimit(int messages_per_second, int burst = 0, RateLimitKeys keys = RateLimitPerMessageType);
+            //! Returns the rate at which rate limit buckets refill, 0 when rate limiting is disabled.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            int rateLimit() const;
+            //! Returns the number of messages which can be delivered at once from each rate limit bucket.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            int rateLimitBurst() const;
+            //! Returns the properties of messages which select their rate limit bucket.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            RateLimitKeys rateLimitKeys() const;
+            //! Returns the number of messages which were collapsed because they were identical to the previous message.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            quint64 duplicateMessageCount() const;
+            //! Returns the number of messages which were dropped by the rate limit.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            quint64 rateLimitedMessageCount() const;
+
         signals:
-            //! Signal which is emitted when a new message was logged. The logger connects all logger engines to this signal.
+            //! Signal which is emitted when a new message was logged.
+            /*!
+              This signal is emitted for backwards compatibility, logger engines receive messages through AbstractLoggerEngine::newLogRecord().
+              */
             void newMessage(const QString& engine_name, Logger::MessageType message_type, Logger::MessageContextFlags message_context, const QList<QVariant>& message_contents);
+            //! Signal which is emitted when a new message was logged.
+            /*!
+              One record is created for each message, thus all engines share the same record and the formatted messages stored in it.
+
+              Attached logger engines are not connected to this signal. The logger passes each record directly to the engines which can accept it,
+              see \ref logger_engine_routing.
+
+              <i>This signal was added in %Qtilities v1.5.</i>
+              */
+            void newLogRecord(const LogRecord& record);
             //! Signal which is emitted when a new priority message was logged.
             /*!
               \sa logPriorityMessage();
@@ -390,9 +574,47 @@ namespace Qtilities {
             //! Indicates that the number of logger engines changed.
             void loggerEngineCountChanged(AbstractLoggerEngine* engine, Logger::EngineChangeIndication change_indication);
 
+        private:
+            //! Rebuilds the routing table of the logger and updates the message types returned by isMessageTypeLogged() and isPriorityMessageTypeLogged().
+            /*!
+              Must be called whenever the global log level or the engines, their names, activity, message contexts or enabled message types change.
+              */
+            void refreshLoggerEngineRoutes();
+            //! Passes a record to the logger engines in the routing table which can accept it.
+            /*!
+              \param direct_delivery When true, engines living in other threads are called directly instead of through their event loop.
+              */
+            void dispatchLogRecord(const LogRecord& record, bool direct_delivery = false);
+            //! Delivers a new record, or appends it to the buffer of the calling thread when it is not the thread of the logger.
+            void postLogRecord(const LogRecord& record);
+            //! Passes a record through the suppression stage, and delivers it with any suppression reports due before it.
+            void processLogRecord(const LogRecord& record, bool direct_delivery);
+            //! Dispatches a record and emits the signals of the logger for it.
+            void deliverLogRecord(const LogRecord& record, bool direct_delivery);
+            //! Checks a record against the duplicate suppression and rate limits.
+            /*!
+              \param reports Receives the records reporting earlier suppressions which must be delivered before \p record.
+              \returns True when the record must be delivered, false when it was suppressed.
+              */
+            bool passesSuppression(const LogRecord& record, QList<LogRecord>* reports);
+            //! Returns the report for the repeats of the previous message when there are any, and resets the repeat count. Must be called with the suppression lock held.
+            LogRecord takeRepeatReport();
+            //! Appends the reports of all messages which are suppressed but not reported yet to \p reports. Must be called with the suppression lock held.
+            void takeSuppressionReports(QList<LogRecord>* reports);
+            //! Takes the records from all thread buffers and processes them. Only one thread drains the buffers at any time.
+            void drainThreadBuffers(bool direct_delivery);
+
+        private slots:
+            //! Drains the thread buffers when the drain scheduled by postLogRecord() is processed by the event loop of the logger thread.
+            void drainScheduledRecords();
+
         private:
             static Logger* m_Instance;
+            static QAtomicInt logged_message_types;
+            static QAtomicInt logged_priority_message_types;
             LoggerPrivateData* d;
+
+            friend class AbstractLoggerEngine;
         };
 
         #if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
@@ -402,11 +624,15 @@ namespace Qtilities {
         #endif
         Q_DECLARE_OPERATORS_FOR_FLAGS(Logger::MessageTypeFlags)
         Q_DECLARE_OPERATORS_FOR_FLAGS(Logger::MessageContextFlags)
+        Q_DECLARE_OPERATORS_FOR_FLAGS(Logger::RateLimitKeys)
      }
 }
 
 Q_DECLARE_METATYPE(Qtilities::Logging::Logger::MessageType)
 
+// LogRecord depends on the Logger class, it is included here so that the signals of the logger can use it:
+#include "LogRecord.h"
+
 // -----------------------------------
 // Macro Definitions
 // -----------------------------------
@@ -434,24 +660,26 @@ Q_DECLARE_METATYPE(Qtilities::Logging::Logger::MessageType)
 // -----------------------------------
 // Basic Logging Macros
 // -----------------------------------
+// The logging macros check Qtilities::Logging::Logger::isMessageTypeLogged() before they evaluate their message
+// argument, thus messages which will not be logged are never constructed.
 //! Logs a trace message to all active engines.
 /*!
     \note Trace messages are not part of release mode builds.
   */
-#define LOG_TRACE(Msg) Log->logMessage(QString(),Qtilities::Logging::Logger::Trace, Msg)
+#define LOG_TRACE(Msg) (Qtilities::Logging::Logger::isMessageTypeLogged(Qtilities::Logging::Logger::Trace) ? Log->logSingleMessage(QString(),Qtilities::Logging::Logger::Trace, Msg) : (void) 0)
 //! Logs a debug message to all active engines.
 /*!
     \note Debug messages are not part of release mode builds.
   */
-#define LOG_DEBUG(Msg) Log->logMessage(QString(),Qtilities::Logging::Logger::Debug, Msg)
+#define LOG_DEBUG(Msg) (Qtilities::Logging::Logger::isMessageTypeLogged(Qtilities::Logging::Logger::Debug) ? Log->logSingleMessage(QString(),Qtilities::Logging::Logger::Debug, Msg) : (void) 0)
 //! Logs an error message to all active engines.
-#define LOG_ERROR(Msg) Log->logMessage(QString(),Qtilities::Logging::Logger::Error, Msg)
+#define LOG_ERROR(Msg) (Qtilities::Logging::Logger::isMessageTypeLogged(Qtilities::Logging::Logger::Error) ? Log->logSingleMessage(QString(),Qtilities::Logging::Logger::Error, Msg) : (void) 0)
 //! Logs a warning message to all active engines.
-#define LOG_WARNING(Msg) Log->logMessage(QString(),Qtilities::Logging::Logger::Warning, Msg)
+#define LOG_WARNING(Msg) (Qtilities::Logging::Logger::isMessageTypeLogged(Qtilities::Logging::Logger::Warning) ? Log->logSingleMessage(QString(),Qtilities::Logging::Logger::Warning, Msg) : (void) 0)
 //! Logs a fatal message to all active engines.
-#define LOG_FATAL(Msg) Log->logMessage(QString(),Qtilities::Logging::Logger::Fatal, Msg)
+#define LOG_FATAL(Msg) (Qtilities::Logging::Logger::isMessageTypeLogged(Qtilities::Logging::Logger::Fatal) ? Log->logSingleMessage(QString(),Qtilities::Logging::Logger::Fatal, Msg) : (void) 0)
 //! Logs an information message to all active engines.
-#define LOG_INFO(Msg) Log->logMessage(QString(),Qtilities::Logging::Logger::Info, Msg)
+#define LOG_INFO(Msg) (Qtilities::Logging::Logger::isMessageTypeLogged(Qtilities::Logging::Logger::Info) ? Log->logSingleMessage(QString(),Qtilities::Logging::Logger::Info, Msg) : (void) 0)
 
 // -----------------------------------
 // Priority Logging Macros
@@ -460,36 +688,36 @@ Q_DECLARE_METATYPE(Qtilities::Logging::Logger::MessageType)
 /*!
     \note Trace messages are not part of release mode builds.
   */
-#define LOG_TRACE_P(Msg) Log->logPriorityMessage(QString(),Qtilities::Logging::Logger::Trace, Msg)
+#define LOG_TRACE_P(Msg) (Qtilities::Logging::Logger::isPriorityMessageTypeLogged(Qtilities::Logging::Logger::Trace) ? Log->logPriorityMessage(QString(),Qtilities::Logging::Logger::Trace, Msg) : (void) 0)
 //! Logs a priority debug message to all active engines.
 /*!
     \note Debug messages are not part of release mode builds.
   */
-#define LOG_DEBUG_P(Msg) Log->logPriorityMessage(QString(),Qtilities::Logging::Logger::Debug, Msg)
+#define LOG_DEBUG_P(Msg) (Qtilities::Logging::Logger::isPriorityMessageTypeLogged(Qtilities::Logging::Logger::Debug) ? Log->logPriorityMessage(QString(),Qtilities::Logging::Logger::Debug, Msg) : (void) 0)
 //! Logs a priority error message to all active engines.
-#define LOG_ERROR_P(Msg) Log->logPriorityMessage(QString(),Qtilities::Logging::Logger::Error, Msg)
+#define LOG_ERROR_P(Msg) (Qtilities::Logging::Logger::isPriorityMessageTypeLogged(Qtilities::Logging::Logger::Error) ? Log->logPriorityMessage(QString(),Qtilities::Logging::Logger::Error, Msg) : (void) 0)
 //! Logs a priority warning message to all active engines.
-#define LOG_WARNING_P(Msg) Log->logPriorityMessage(QString(),Qtilities::Logging::Logger::Warning, Msg)
+#define LOG_WARNING_P(Msg) (Qtilities::Logging::Logger::isPriorityMessageTypeLogged(Qtilities::Logging::Logger::Warning) ? Log->logPriorityMessage(QString(),Qtilities::Logging::Logger::Warning, Msg) : (void) 0)
 //! Logs a priority fatal message to all active engines.
-#define LOG_FATAL_P(Msg) Log->logPriorityMessage(QString(),Qtilities::Logging::Logger::Fatal, Msg)
+#define LOG_FATAL_P(Msg) (Qtilities::Logging::Logger::isPriorityMessageTypeLogged(Qtilities::Logging::Logger::Fatal) ? Log->logPriorityMessage(QString(),Qtilities::Logging::Logger::Fatal, Msg) : (void) 0)
 //! Logs a priority information message to all active engines.
-#define LOG_INFO_P(Msg) Log->logPriorityMessage(QString(),Qtilities::Logging::Logger::Info, Msg)
+#define LOG_INFO_P(Msg) (Qtilities::Logging::Logger::isPriorityMessageTypeLogged(Qtilities::Logging::Logger::Info) ? Log->logPriorityMessage(QString(),Qtilities::Logging::Logger::Info, Msg) : (void) 0)
 
 // -----------------------------------
 // Engine Specific Logging
 // -----------------------------------
 //! Logs a trace message to the engine specified. Note that the engine must be active for the message to be logger.
-#define LOG_TRACE_E(Engine_Name, Msg) Log->logMessage(Engine_Name,Qtilities::Logging::Logger::Trace, Msg)
+#define LOG_TRACE_E(Engine_Name, Msg) (Qtilities::Logging::Logger::isMessageTypeLogged(Qtilities::Logging::Logger::Trace) ? Log->logSingleMessage(Engine_Name,Qtilities::Logging::Logger::Trace, Msg) : (void) 0)
 //! Logs a debug message to the engine specified. Note that the engine must be active for the message to be logger.
-#define LOG_DEBUG_E(Engine_Name, Msg) Log->logMessage(Engine_Name,Qtilities::Logging::Logger::Debug, Msg)
+#define LOG_DEBUG_E(Engine_Name, Msg) (Qtilities::Logging::Logger::isMessageTypeLogged(Qtilities::Logging::Logger::Debug) ? Log->logSingleMessage(Engine_Name,Qtilities::Logging::Logger::Debug, Msg) : (void) 0)
 //! Logs an error message to the engine specified. Note that the engine must be active for the message to be logger.
-#define LOG_ERROR_E(Engine_Name, Msg) Log->logMessage(Engine_Name,Qtilities::Logging::Logger::Error, Msg)
+#define LOG_ERROR_E(Engine_Name, Msg) (Qtilities::Logging::Logger::isMessageTypeLogged(Qtilities::Logging::Logger::Error) ? Log->logSingleMessage(Engine_Name,Qtilities::Logging::Logger::Error, Msg) : (void) 0)
 //! Logs a warning message to the engine specified. Note that the engine must be active for the message to be logger.
-#define LOG_WARNING_E(Engine_Name, Msg) Log->logMessage(Engine_Name,Qtilities::Logging::Logger::Warning, Msg)
+#define LOG_WARNING_E(Engine_Name, Msg) (Qtilities::Logging::Logger::isMessageTypeLogged(Qtilities::Logging::Logger::Warning) ? Log->logSingleMessage(Engine_Name,Qtilities::Logging::Logger::Warning, Msg) : (void) 0)
 //! Logs a fatal message to the engine specified. Note that the engine must be active for the message to be logger.
-#define LOG_FATAL_E(Engine_Name, Msg) Log->logMessage(Engine_Name,Qtilities::Logging::Logger::Fatal, Msg)
+#define LOG_FATAL_E(Engine_Name, Msg) (Qtilities::Logging::Logger::isMessageTypeLogged(Qtilities::Logging::Logger::Fatal) ? Log->logSingleMessage(Engine_Name,Qtilities::Logging::Logger::Fatal, Msg) : (void) 0)
 //! Logs an info message to the engine specified. Note that the engine must be active for the message to be logger.
-#define LOG_INFO_E(Engine_Name, Msg) Log->logMessage(Engine_Name,Qtilities::Logging::Logger::Info, Msg)
+#define LOG_INFO_E(Engine_Name, Msg) (Qtilities::Logging::Logger::isMessageTypeLogged(Qtilities::Logging::Logger::Info) ? Log->logSingleMessage(Engine_Name,Qtilities::Logging::Logger::Info, Msg) : (void) 0)
 
 // -----------------------------------
 // Function Specific Logging
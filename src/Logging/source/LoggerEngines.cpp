@@ -17,6 +17,13 @@
 #include <QList>
 #include <QString>
 #include <QMutex>
+#include <QReadWriteLock>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <QWaitCondition>
+#include <QtEndian>
 
 #include <stdio.h>
 
@@ -30,12 +37,382 @@ using namespace Qtilities::Logging::Interfaces;
 namespace Qtilities {
     namespace Logging {
         LoggerFactoryItem<AbstractLoggerEngine, FileLoggerEngine> FileLoggerEngine::factory;
+
+        // Settings used by a FileLoggerEngineWriter to roll its file over, used by RollingFileLoggerEngine.
+        struct FileLoggerEngineRolling {
+            FileLoggerEngineRolling() : enabled(false),
+                maximum_file_size(0),
+                roll_interval(0),
+                generations(0),
+                compress(false) {}
+
+            bool    enabled;
+            qint64  maximum_file_size;
+            int     roll_interval;
+            int     generations;
+            bool    compress;
+            //! Written at the start of each file.
+            QString initialize_string;
+            //! Written at the end of each file.
+            QString finalize_string;
+        };
+
+        // Compresses a rolled log file using qCompress(), replacing it with a file with the qti_def_SUFFIX_COMPRESSED_LOG suffix.
+        class RolledFileCompressor : public QRunnable
+        {
+        public:
+            RolledFileCompressor(const QString& rolled_file_name) : file_name(rolled_file_name) {}
+
+            void run() {
+                QFile rolled_file(file_name);
+                if (!rolled_file.open(QIODevice::ReadOnly))
+                    return;
+                QByteArray compressed = qCompress(rolled_file.readAll());
+                rolled_file.close();
+
+                // Write to a temporary file first, thus an interrupted compression never leaves a truncated file behind:
+                QString compressed_name = file_name + qti_def_SUFFIX_COMPRESSED_LOG;
+                QFile compressed_file(compressed_name + ".tmp");
+                if (!compressed_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+                    return;
+                bool written = compressed_file.write(compressed) == compressed.size();
+                compressed_file.close();
+                if (!written) {
+                    compressed_file.remove();
+                    return;
+                }
+
+                QFile::remove(compressed_name);
+                if (compressed_file.rename(compressed_name))
+                    rolled_file.remove();
+            }
+
+        private:
+            QString file_name;
+        };
+
+        // The writer thread of a FileLoggerEngine with asynchronous writing enabled. Messages are queued in a bounded
+        // ring buffer by any number of logging threads, and written in batches by the writer thread which keeps the file open.
+        class FileLoggerEngineWriter : public QThread
+        {
+        public:
+            FileLoggerEngineWriter(const QString& writer_file_name, int capacity, int writer_batch_size, int writer_flush_interval, FileLoggerEngine::BackPressurePolicy writer_policy,
+                                   const FileLoggerEngineRolling& writer_rolling = FileLoggerEngineRolling()) :
+                file_name(writer_file_name),
+                rolling(writer_rolling),
+                ring(qMax(capacity,1)),
+                head(0),
+                count(0),
+                batch_size(qBound(1,writer_batch_size,qMax(capacity,1))),
+                flush_interval(qMax(writer_flush_interval,1)),
+                policy(writer_policy),
+                queued_sequence(0),
+                written_sequence(0),
+                dropped(0),
+                roll_count(0),
+                open_succeeded(false),
+                open_completed(false),
+                flush_requested(false),
+                clear_requested(false),
+                clear_succeeded(false),
+                stopping(false) {}
+            ~FileLoggerEngineWriter() {
+                stop();
+            }
+
+            // Starts the thread and waits until it opened the file.
+            bool startWriting() {
+                start();
+                QMutexLocker locker(&mutex);
+                while (!open_completed)
+                    written.wait(&mutex);
+                return open_succeeded;
+            }
+
+            // Writes everything queued so far, then stops the thread.
+            void stop() {
+                {
+                    QMutexLocker locker(&mutex);
+                    stopping = true;
+                    not_empty.wakeOne();
+                    not_full.wakeAll();
+                }
+                wait();
+            }
+
+            void enqueue(const QString& message, Logger::MessageType message_type) {
+                QMutexLocker locker(&mutex);
+                if (stopping)
+                    return;
+
+                const int capacity = ring.count();
+                while (count == capacity) {
+                    if (policy == FileLoggerEngine::DropOldestWhenFull) {
+                        head = (head + 1) % capacity;
+                        --count;
+                        ++dropped;
+                    } else if (policy == FileLoggerEngine::DropTraceWhenFull && (message_type == Logger::Trace || message_type == Logger::Debug)) {
+                        ++dropped;
+                        return;
+                    } else {
+                        not_full.wait(&mutex);
+                        if (stopping)
+                            return;
+                    }
+                }
+
+                ring[(head + count) % capacity] = message;
+                ++count;
+                ++queued_sequence;
+
+                // The writer waits without a timeout while the queue is empty, and with the flush interval as timeout otherwise:
+                if (count == 1 || count == batch_size)
+                    not_empty.wakeOne();
+            }
+
+            void flush() {
+                QMutexLocker locker(&mutex);
+                const quint64 target = queued_sequence;
+                while (written_sequence < target && isRunning()) {
+                    flush_requested = true;
+                    not_empty.wakeOne();
+                    written.wait(&mutex,100);
+                }
+            }
+
+            // Discards everything queued so far and lets the writer thread truncate the file. The writer stays alive, thus
+            // logging threads which are enqueueing concurrently never see it disappear.
+            bool clear() {
+                QMutexLocker locker(&mutex);
+                if (stopping || !isRunning())
+                    return false;
+
+                for (int i = 0; i < count; ++i)
+                    ring[(head + i) % ring.count()] = QString();
+                head = 0;
+                count = 0;
+                clear_requested = true;
+                not_full.wakeAll();
+                not_empty.wakeOne();
+                while (clear_requested && isRunning())
+                    written.wait(&mutex,100);
+                return clear_succeeded;
+            }
+
+            void setBackPressurePolicy(FileLoggerEngine::BackPressurePolicy new_policy) {
+                QMutexLocker locker(&mutex);
+                policy = new_policy;
+                not_full.wakeAll();
+            }
+
+            int droppedCount() const {
+                QMutexLocker locker(&mutex);
+                return dropped;
+            }
+
+            int rollCount() const {
+                QMutexLocker locker(&mutex);
+                return roll_count;
+            }
+
+        protected:
+            void run() {
+                QFile file(file_name);
+                bool opened = false;
+                if (rolling.enabled) {
+                    // The file of a previous session becomes the first generation:
+                    if (QFileInfo(file_name).size() > 0)
+                        rotateGenerations();
+                    opened = file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text);
+                } else
+                    opened = file.open(QIODevice::Append | QIODevice::Text);
+                QTextStream out(&file);
+                if (opened && rolling.enabled) {
+                    out << rolling.initialize_string << "\n";
+                    out.flush();
+                }
+                QDateTime segment_start = QDateTime::currentDateTime();
+
+                QMutexLocker locker(&mutex);
+                open_succeeded = opened;
+                open_completed = true;
+                written.wakeAll();
+
+                QVector<QString> batch;
+                batch.reserve(batch_size);
+                forever {
+                    if (count == 0 && !stopping && !flush_requested && !clear_requested)
+                        not_empty.wait(&mutex);
+                    // Give the batch time to fill up:
+                    if (count > 0 && count < batch_size && !stopping && !flush_requested && !clear_requested)
+                        not_empty.wait(&mutex,flush_interval);
+
+                    // Messages queued after the clear request belong in the truncated file, thus the file is truncated first:
+                    if (clear_requested) {
+                        locker.unlock();
+                        opened = truncate(file,out);
+                        segment_start = QDateTime::currentDateTime();
+                        locker.relock();
+                        clear_succeeded = opened;
+                        clear_requested = false;
+                        written.wakeAll();
+                    }
+
+                    const int capacity = ring.count();
+                    while (count > 0) {
+                        batch.append(ring.at(head));
+                        ring[head] = QString();
+                        head = (head + 1) % capacity;
+                        --count;
+                    }
+                    // Messages dropped from the queue are also done, thus everything queued up to now is accounted for:
+                    const quint64 batch_sequence = queued_sequence;
+                    flush_requested = false;
+                    not_full.wakeAll();
+
+                    if (!batch.isEmpty()) {
+                        locker.unlock();
+                        if (opened && rolling.enabled && rollDue(file,segment_start)) {
+                            opened = roll(file,out);
+                            segment_start = QDateTime::currentDateTime();
+                            locker.relock();
+                            ++roll_count;
+                            locker.unlock();
+                        }
+                        if (opened) {
+                            for (int i = 0; i < batch.count(); ++i)
+                                out << batch.at(i) << "\n";
+                            out.flush();
+                        }
+                        batch.clear();
+                        locker.relock();
+                    }
+
+                    written_sequence = batch_sequence;
+                    written.wakeAll();
+
+                    if (stopping && count == 0)
+                        break;
+                }
+                locker.unlock();
+
+                if (opened) {
+                    if (rolling.enabled) {
+                        out << rolling.finalize_string << "\n";
+                        out.flush();
+                    }
+                    file.close();
+                }
+                compression_pool.waitForDone();
+            }
+
+        private:
+            QString generationFileName(int generation) const {
+                return QString("%1.%2").arg(file_name).arg(generation);
+            }
+
+            bool rollDue(const QFile& file, const QDateTime& segment_start) const {
+                if (rolling.maximum_file_size > 0 && file.size() >= rolling.maximum_file_size)
+                    return true;
+                if (rolling.roll_interval > 0 && segment_start.secsTo(QDateTime::currentDateTime()) >= rolling.roll_interval)
+                    return true;
+                return false;
+            }
+
+            // Closes the current file, moves it to the first generation and starts a new file.
+            bool roll(QFile& file, QTextStream& out) {
+                out << rolling.finalize_string << "\n";
+                out.flush();
+                file.close();
+
+                rotateGenerations();
+
+                if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+                    return false;
+                out << rolling.initialize_string << "\n";
+                out.flush();
+                return true;
+            }
+
+            // Closes the current file and reopens it empty. A rolling file starts a new segment, without rolling the cleared messages over.
+            bool truncate(QFile& file, QTextStream& out) {
+                out.flush();
+                file.close();
+
+                const QIODevice::OpenMode mode = rolling.enabled ? (QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text) : (QIODevice::WriteOnly | QIODevice::Truncate);
+                if (!file.open(mode))
+                    return false;
+                if (rolling.enabled) {
+                    out << rolling.initialize_string << "\n";
+                    out.flush();
+                } else {
+                    // Later messages are appended, as when the file was opened by run():
+                    file.close();
+                    if (!file.open(QIODevice::Append | QIODevice::Text))
+                        return false;
+                }
+                return true;
+            }
+
+            // Shifts all generations up by one, removing the oldest generation, and moves the current file to the first generation.
+            void rotateGenerations() {
+                // A compression which is still busy with the first generation must finish before the generations are renamed:
+                compression_pool.waitForDone();
+
+                if (rolling.generations <= 0) {
+                    QFile::remove(file_name);
+                    return;
+                }
+
+                const QString compressed_suffix = qti_def_SUFFIX_COMPRESSED_LOG;
+                QFile::remove(generationFileName(rolling.generations));
+                QFile::remove(generationFileName(rolling.generations) + compressed_suffix);
+                for (int generation = rolling.generations - 1; generation >= 1; --generation) {
+                    QFile::rename(generationFileName(generation),generationFileName(generation + 1));
+                    QFile::rename(generationFileName(generation) + compressed_suffix,generationFileName(generation + 1) + compressed_suffix);
+                }
+
+                if (QFile::rename(file_name,generationFileName(1)) && rolling.compress)
+                    compression_pool.start(new RolledFileCompressor(generationFileName(1)));
+            }
+
+            QString                                 file_name;
+            FileLoggerEngineRolling                 rolling;
+            QThreadPool                             compression_pool;
+            mutable QMutex                          mutex;
+            QWaitCondition                          not_empty;
+            QWaitCondition                          not_full;
+            QWaitCondition                          written;
+            QVector<QString>                        ring;
+            int                                     head;
+            int                                     count;
+            int                                     batch_size;
+            int                                     flush_interval;
+            FileLoggerEngine::BackPressurePolicy    policy;
+            quint64                                 queued_sequence;
+            quint64                                 written_sequence;
+            int                                     dropped;
+            int                                     roll_count;
+            bool                                    open_succeeded;
+            bool                                    open_completed;
+            bool                                    flush_requested;
+            bool                                    clear_requested;
+            bool                                    clear_succeeded;
+            bool                                    stopping;
+        };
     }
 }
 
 Qtilities::Logging::FileLoggerEngine::FileLoggerEngine() : AbstractLoggerEngine()
 {
     file_name = QString();
+    asynchronous_writing = false;
+    queue_capacity = 8192;
+    batch_size = 256;
+    flush_interval = 200;
+    back_pressure_policy = BlockWhenFull;
+    dropped_messages = 0;
+    writer = 0;
     abstractLoggerEngineData->formatting_engine = 0;
     setName(QObject::tr("File Logger Engine"));
 }
@@ -81,12 +458,40 @@ bool Qtilities::Logging::FileLoggerEngine::initialize() {
     out << abstractLoggerEngineData->formatting_engine->initializeString() << "\n";
     file.close();
 
-    abstractLoggerEngineData->is_initialized = true;
+    bool writer_failed = false;
+    {
+        QWriteLocker locker(&writer_lock);
+        dropped_messages = 0;
+        if (asynchronous_writing && !writer) {
+            writer = new FileLoggerEngineWriter(file_name,queue_capacity,batch_size,flush_interval,back_pressure_policy);
+            if (!writer->startWriting()) {
+                delete writer;
+                writer = 0;
+                writer_failed = true;
+            }
+        }
+        abstractLoggerEngineData->is_initialized = true;
+    }
+
+    // Logged outside of the lock, since the message can be delivered to this engine:
+    if (writer_failed)
+        LOG_WARNING(QString(tr("File logger engine (%1) could not start its writer thread, messages will be written synchronously to: %2")).arg(objectName()).arg(file_name));
     return true;
 }
 
 void Qtilities::Logging::FileLoggerEngine::finalize() {
+    // Threads logging messages hold a read lock while they use the writer, thus it is only deleted once they are done
+    // with it. Messages logged afterwards are ignored since the engine is not initialized anymore:
+    QWriteLocker locker(&writer_lock);
     if (abstractLoggerEngineData->is_initialized) {
+        abstractLoggerEngineData->is_initialized = false;
+        if (writer) {
+            writer->stop();
+            dropped_messages += writer->droppedCount();
+            delete writer;
+            writer = 0;
+        }
+
         QFile file(file_name);
         if (!file.exists())
             return;
@@ -118,20 +523,40 @@ QString Qtilities::Logging::FileLoggerEngine::status() const {
 }
 
 void Qtilities::Logging::FileLoggerEngine::clearLog() {
+    // The writer keeps the file open, thus it truncates the file itself. It lives as long as the engine is initialized
+    // since logging threads might be enqueueing messages into it at any time:
+    if (writer) {
+        if (!writer->clear())
+            qWarning() << tr("Failed to clear file logger engine:") << file_name;
+        return;
+    }
+
     QFile file(file_name);
     if (!file.open(QIODevice::WriteOnly)) {
         qWarning() << tr("Failed to clear file logger engine:") << file_name;
-        return;
+    } else {
+        file.close();
     }
-    file.close();
 }
 
-void Qtilities::Logging::FileLoggerEngine::logMessage(const QString& message, Logger::MessageType message_type) {
-    Q_UNUSED(message_type)
+bool Qtilities::Logging::FileLoggerEngine::isThreadSafe() const {
+    // Without a writer, every message opens and appends to the file on the calling thread:
+    QReadLocker locker(&writer_lock);
+    return writer != 0;
+}
 
+void Qtilities::Logging::FileLoggerEngine::logMessage(const QString& message, Logger::MessageType message_type) {
+    QReadLocker locker(&writer_lock);
     if (!abstractLoggerEngineData->is_initialized)
         return;
 
+    if (writer) {
+        writer->enqueue(message,message_type);
+        if (message_type == Logger::Fatal)
+            writer->flush();
+        return;
+    }
+
     QFile file(file_name);
     if (!file.open(QIODevice::Append | QIODevice::Text))
         return;
@@ -141,7 +566,6 @@ void Qtilities::Logging::FileLoggerEngine::logMessage(const QString& message, Lo
     file.close();
 }
 
-
 Qtilities::Logging::Interfaces::ILoggerExportable::ExportModeFlags Qtilities::Logging::FileLoggerEngine::supportedFormats() const {
     ILoggerExportable::ExportModeFlags flags = 0;
     flags |= ILoggerExportable::Binary;
@@ -167,6 +591,594 @@ QString Qtilities::Logging::FileLoggerEngine::getFileName() {
     return file_name;
 }
 
+void Qtilities::Logging::FileLoggerEngine::setAsynchronousWritingEnabled(bool enabled) {
+    if (!abstractLoggerEngineData->is_initialized)
+        asynchronous_writing = enabled;
+}
+
+bool Qtilities::Logging::FileLoggerEngine::asynchronousWritingEnabled() const {
+    return asynchronous_writing;
+}
+
+void Qtilities::Logging::FileLoggerEngine::setQueueCapacity(int capacity) {
+    if (!abstractLoggerEngineData->is_initialized && capacity > 0)
+        queue_capacity = capacity;
+}
+
+int Qtilities::Logging::FileLoggerEngine::queueCapacity() const {
+    return queue_capacity;
+}
+
+void Qtilities::Logging::FileLoggerEngine::setBatchSize(int new_batch_size) {
+    if (!abstractLoggerEngineData->is_initialized && new_batch_size > 0)
+        batch_size = new_batch_size;
+}
+
+int Qtilities::Logging::FileLoggerEngine::batchSize() const {
+    return batch_size;
+}
+
+void Qtilities::Logging::FileLoggerEngine::setFlushInterval(int msec) {
+    if (!abstractLoggerEngineData->is_initialized && msec > 0)
+        flush_interval = msec;
+}
+
+int Qtilities::Logging::FileLoggerEngine::flushInterval() const {
+    return flush_interval;
+}
+
+void Qtilities::Logging::FileLoggerEngine::setBackPressurePolicy(BackPressurePolicy policy) {
+    back_pressure_policy = policy;
+    if (writer)
+        writer->setBackPressurePolicy(policy);
+}
+
+Qtilities::Logging::FileLoggerEngine::BackPressurePolicy Qtilities::Logging::FileLoggerEngine::backPressurePolicy() const {
+    return back_pressure_policy;
+}
+
+int Qtilities::Logging::FileLoggerEngine::droppedMessageCount() const {
+    if (writer)
+        return dropped_messages + writer->droppedCount();
+    return dropped_messages;
+}
+
+void Qtilities::Logging::FileLoggerEngine::flush() {
+    if (writer)
+        writer->flush();
+}
+
+// ------------------------------------
+// RollingFileLoggerEngine implementation
+// ------------------------------------
+namespace Qtilities {
+    namespace Logging {
+        LoggerFactoryItem<AbstractLoggerEngine, RollingFileLoggerEngine> RollingFileLoggerEngine::factory;
+    }
+}
+
+struct Qtilities::Logging::RollingFileLoggerEngineData {
+    RollingFileLoggerEngineData() : maximum_file_size(10 * 1024 * 1024),
+        roll_interval(0),
+        generations(5),
+        compress(true),
+        roll_count(0),
+        writer(0) {}
+
+    QString                 file_name;
+    qint64                  maximum_file_size;
+    int                     roll_interval;
+    int                     generations;
+    bool                    compress;
+    //! The number of rolls done by writers which were stopped.
+    int                     roll_count;
+    FileLoggerEngineWriter* writer;
+    // Protects writer and the initialization state against finalize() while other threads log messages:
+    QReadWriteLock          writer_lock;
+};
+
+Qtilities::Logging::RollingFileLoggerEngine::RollingFileLoggerEngine() : AbstractLoggerEngine()
+{
+    d = new RollingFileLoggerEngineData;
+    abstractLoggerEngineData->formatting_engine = 0;
+    setName(QObject::tr("Rolling File Logger Engine"));
+}
+
+Qtilities::Logging::RollingFileLoggerEngine::~RollingFileLoggerEngine()
+{
+    finalize();
+    delete d;
+}
+
+bool Qtilities::Logging::RollingFileLoggerEngine::initialize() {
+    if (d->file_name.isEmpty()) {
+        LOG_ERROR(QString(tr("Failed to initialize rolling file logger engine (%1): File name is empty...").arg(objectName())));
+        return false;
+    }
+
+    if (!abstractLoggerEngineData->formatting_engine) {
+        // Attempt to get the formatting engine with the specified file format.
+        QFileInfo fi(d->file_name);
+        QString extension = fi.fileName().split(".").last();
+        AbstractFormattingEngine* formatting_engine_inst = Log->formattingEngineReferenceFromExtension(extension);
+        if (!formatting_engine_inst) {
+            // We assign a default formatting engine:
+            abstractLoggerEngineData->formatting_engine = Log->formattingEngineReference(qti_def_FORMATTING_ENGINE_DEFAULT);
+            LOG_INFO(QString(tr("Assigning default formatting engine to rolling file logger engine (%1).").arg(objectName())));
+        } else {
+            abstractLoggerEngineData->formatting_engine = formatting_engine_inst;
+        }
+    }
+
+    QFileInfo fi(d->file_name);
+    QDir dir(fi.path());
+    if (!dir.exists()) {
+        dir.mkpath(fi.path());
+    }
+
+    bool started;
+    {
+        QWriteLocker locker(&d->writer_lock);
+        started = d->writer || startWriter();
+        if (started)
+            abstractLoggerEngineData->is_initialized = true;
+    }
+
+    // Logged outside of the lock, since the message can be delivered to this engine:
+    if (!started) {
+        LOG_ERROR(QString(tr("Failed to initialize rolling file logger engine (%1): Can't open the specified file (%2) for writing...")).arg(objectName()).arg(d->file_name));
+        return false;
+    }
+    return true;
+}
+
+void Qtilities::Logging::RollingFileLoggerEngine::finalize() {
+    // Threads logging messages hold a read lock while they use the writer, thus it is only deleted once they are done with it:
+    QWriteLocker locker(&d->writer_lock);
+    if (abstractLoggerEngineData->is_initialized) {
+        abstractLoggerEngineData->is_initialized = false;
+        stopWriter();
+    }
+}
+
+QString Qtilities::Logging::RollingFileLoggerEngine::description() const {
+    return QObject::tr("Writes log messages to a file which is rolled over when it becomes too large or too old.");
+}
+
+QString Qtilities::Logging::RollingFileLoggerEngine::status() const {
+    if (abstractLoggerEngineData->is_initialized) {
+        if (abstractLoggerEngineData->is_enabled)
+            return QString(QObject::tr("Logging in progress to output file: %1 (rolled over %2 times)")).arg(d->file_name).arg(rollCount());
+        else
+            return QObject::tr("Ready but inactive.");
+    } else {
+        return QObject::tr("Not initialized.");
+    }
+}
+
+void Qtilities::Logging::RollingFileLoggerEngine::clearLog() {
+    // The writer keeps the file open, thus it truncates the file itself instead of being restarted underneath logging threads:
+    if (!d->writer)
+        return;
+
+    if (!d->writer->clear())
+        qWarning() << tr("Failed to clear rolling file logger engine:") << d->file_name;
+}
+
+bool Qtilities::Logging::RollingFileLoggerEngine::isThreadSafe() const {
+    QReadLocker locker(&d->writer_lock);
+    return d->writer != 0;
+}
+
+void Qtilities::Logging::RollingFileLoggerEngine::logMessage(const QString& message, Logger::MessageType message_type) {
+    QReadLocker locker(&d->writer_lock);
+    if (!abstractLoggerEngineData->is_initialized || !d->writer)
+        return;
+
+    d->writer->enqueue(message,message_type);
+    if (message_type == Logger::Fatal)
+        d->writer->flush();
+}
+
+Qtilities::Logging::Interfaces::ILoggerExportable::ExportModeFlags Qtilities::Logging::RollingFileLoggerEngine::supportedFormats() const {
+    ILoggerExportable::ExportModeFlags flags = 0;
+    flags |= ILoggerExportable::Binary;
+    return flags;
+}
+
+bool Qtilities::Logging::RollingFileLoggerEngine::exportBinary(QDataStream& stream) const {
+    stream << d->file_name;
+    stream << d->maximum_file_size;
+    stream << (qint32) d->roll_interval;
+    stream << (qint32) d->generations;
+    stream << d->compress;
+    return stream.status() == QDataStream::Ok;
+}
+
+bool Qtilities::Logging::RollingFileLoggerEngine::importBinary(QDataStream& stream) {
+    qint32 roll_interval;
+    qint32 generations;
+    stream >> d->file_name;
+    stream >> d->maximum_file_size;
+    stream >> roll_interval;
+    stream >> generations;
+    stream >> d->compress;
+    d->roll_interval = roll_interval;
+    d->generations = generations;
+    return stream.status() == QDataStream::Ok;
+}
+
+void Qtilities::Logging::RollingFileLoggerEngine::setFileName(const QString& fileName) {
+    if (!abstractLoggerEngineData->is_initialized)
+        d->file_name = fileName;
+}
+
+QString Qtilities::Logging::RollingFileLoggerEngine::getFileName() {
+    return d->file_name;
+}
+
+void Qtilities::Logging::RollingFileLoggerEngine::setMaximumFileSize(qint64 bytes) {
+    if (!abstractLoggerEngineData->is_initialized && bytes >= 0)
+        d->maximum_file_size = bytes;
+}
+
+qint64 Qtilities::Logging::RollingFileLoggerEngine::maximumFileSize() const {
+    return d->maximum_file_size;
+}
+
+void Qtilities::Logging::RollingFileLoggerEngine::setRollInterval(int seconds) {
+    if (!abstractLoggerEngineData->is_initialized && seconds >= 0)
+        d->roll_interval = seconds;
+}
+
+int Qtilities::Logging::RollingFileLoggerEngine::rollInterval() const {
+    return d->roll_interval;
+}
+
+void Qtilities::Logging::RollingFileLoggerEngine::setGenerations(int generations) {
+    if (!abstractLoggerEngineData->is_initialized && generations >= 0)
+        d->generations = generations;
+}
+
+int Qtilities::Logging::RollingFileLoggerEngine::generations() const {
+    return d->generations;
+}
+
+void Qtilities::Logging::RollingFileLoggerEngine::setCompressionEnabled(bool enabled) {
+    if (!abstractLoggerEngineData->is_initialized)
+        d->compress = enabled;
+}
+
+bool Qtilities::Logging::RollingFileLoggerEngine::compressionEnabled() const {
+    return d->compress;
+}
+
+int Qtilities::Logging::RollingFileLoggerEngine::rollCount() const {
+    if (d->writer)
+        return d->roll_count + d->writer->rollCount();
+    return d->roll_count;
+}
+
+void Qtilities::Logging::RollingFileLoggerEngine::flush() {
+    if (d->writer)
+        d->writer->flush();
+}
+
+bool Qtilities::Logging::RollingFileLoggerEngine::startWriter() {
+    FileLoggerEngineRolling rolling;
+    rolling.enabled = true;
+    rolling.maximum_file_size = d->maximum_file_size;
+    rolling.roll_interval = d->roll_interval;
+    rolling.generations = d->generations;
+    rolling.compress = d->compress;
+    if (abstractLoggerEngineData->formatting_engine) {
+        rolling.initialize_string = abstractLoggerEngineData->formatting_engine->initializeString();
+        rolling.finalize_string = abstractLoggerEngineData->formatting_engine->finalizeString();
+    }
+
+    d->writer = new FileLoggerEngineWriter(d->file_name,8192,256,200,FileLoggerEngine::BlockWhenFull,rolling);
+    if (!d->writer->startWriting()) {
+        delete d->writer;
+        d->writer = 0;
+        return false;
+    }
+    return true;
+}
+
+void Qtilities::Logging::RollingFileLoggerEngine::stopWriter() {
+    if (!d->writer)
+        return;
+
+    d->writer->stop();
+    d->roll_count += d->writer->rollCount();
+    delete d->writer;
+    d->writer = 0;
+}
+
+// ------------------------------------
+// BinaryLoggerEngine implementation
+// ------------------------------------
+namespace Qtilities {
+    namespace Logging {
+        LoggerFactoryItem<AbstractLoggerEngine, BinaryLoggerEngine> BinaryLoggerEngine::factory;
+    }
+}
+
+struct Qtilities::Logging::BinaryLoggerEngineData {
+    BinaryLoggerEngineData() : index_interval(1024),
+        sequence(0),
+        block_count(0),
+        block_types(0),
+        block_min_timestamp(0),
+        block_max_timestamp(0),
+        block_first_offset(-1),
+        block_first_sequence(0),
+        previous_index_offset(-1) {}
+
+    QString     file_name;
+    int         index_interval;
+    QFile       file;
+    QMutex      lock;
+    quint64     sequence;
+
+    // Summary of the records written since the previous index block:
+    quint32     block_count;
+    quint32     block_types;
+    qint64      block_min_timestamp;
+    qint64      block_max_timestamp;
+    qint64      block_first_offset;
+    quint64     block_first_sequence;
+    qint64      previous_index_offset;
+};
+
+namespace {
+    // All values in binary log files are stored in little endian byte order.
+    template <typename T>
+    void appendValue(QByteArray& buffer, T value) {
+        uchar bytes[sizeof(T)];
+        qToLittleEndian<T>(value,bytes);
+        buffer.append((const char*) bytes,sizeof(T));
+    }
+
+    void appendBlockHeader(QByteArray& buffer, quint32 kind, quint32 body_length) {
+        appendValue<quint32>(buffer,kind);
+        appendValue<quint32>(buffer,body_length);
+    }
+
+    // Writes a complete block to the file and hands it to the operating system, thus readers following the file see it immediately
+    // and it survives a crash of the application.
+    bool writeBlock(QFile& file, const QByteArray& block) {
+        return file.write(block) == block.size() && file.flush();
+    }
+}
+
+Qtilities::Logging::BinaryLoggerEngine::BinaryLoggerEngine() : AbstractLoggerEngine()
+{
+    d = new BinaryLoggerEngineData;
+    abstractLoggerEngineData->formatting_engine = 0;
+    setName(QObject::tr("Binary Logger Engine"));
+}
+
+Qtilities::Logging::BinaryLoggerEngine::~BinaryLoggerEngine()
+{
+    finalize();
+    delete d;
+}
+
+bool Qtilities::Logging::BinaryLoggerEngine::initialize() {
+    if (d->file_name.isEmpty()) {
+        LOG_ERROR(QString(tr("Failed to initialize binary logger engine (%1): File name is empty...").arg(objectName())));
+        return false;
+    }
+
+    QFileInfo fi(d->file_name);
+    QDir dir(fi.path());
+    if (!dir.exists()) {
+        dir.mkpath(fi.path());
+    }
+
+    QMutexLocker locker(&d->lock);
+    d->file.setFileName(d->file_name);
+    if (!d->file.open(QIODevice::WriteOnly | QIODevice::Truncate) || !startFile()) {
+        d->file.close();
+        locker.unlock();
+        LOG_ERROR(QString(tr("Failed to initialize binary logger engine (%1): Can't open the specified file (%2) for writing...")).arg(objectName()).arg(d->file_name));
+        return false;
+    }
+
+    abstractLoggerEngineData->is_initialized = true;
+    return true;
+}
+
+void Qtilities::Logging::BinaryLoggerEngine::finalize() {
+    QMutexLocker locker(&d->lock);
+    if (!d->file.isOpen())
+        return;
+
+    if (d->block_count > 0)
+        writeIndexBlock();
+
+    // The footer points to the last index block, which allows readers to find all index blocks without reading the records:
+    if (d->previous_index_offset >= 0) {
+        QByteArray footer;
+        appendBlockHeader(footer,qti_def_BINARY_LOG_BLOCK_FOOTER,sizeof(qint64));
+        appendValue<qint64>(footer,d->previous_index_offset);
+        writeBlock(d->file,footer);
+    }
+    d->file.close();
+}
+
+QString Qtilities::Logging::BinaryLoggerEngine::description() const {
+    return QObject::tr("Writes log messages to a binary log file.");
+}
+
+QString Qtilities::Logging::BinaryLoggerEngine::status() const {
+    if (abstractLoggerEngineData->is_initialized) {
+        if (abstractLoggerEngineData->is_enabled)
+            return QString(QObject::tr("Logging in progress to binary output file: %1")).arg(d->file_name);
+        else
+            return QObject::tr("Ready but inactive.");
+    } else {
+        return QObject::tr("Not initialized.");
+    }
+}
+
+void Qtilities::Logging::BinaryLoggerEngine::clearLog() {
+    QMutexLocker locker(&d->lock);
+    if (!d->file.isOpen())
+        return;
+
+    if (!d->file.resize(0) || !d->file.seek(0) || !startFile())
+        qWarning() << tr("Failed to clear binary logger engine:") << d->file_name;
+}
+
+void Qtilities::Logging::BinaryLoggerEngine::logMessage(const QString& message, Logger::MessageType message_type) {
+    QList<QVariant> messages;
+    messages << message;
+
+    QMutexLocker locker(&d->lock);
+    if (!d->file.isOpen())
+        return;
+    writeRecord(QDateTime::currentDateTime(),(quint64) (quintptr) QThread::currentThreadId(),message_type,Logger::SystemWideMessages,name(),messages);
+}
+
+void Qtilities::Logging::BinaryLoggerEngine::newLogRecord(const LogRecord& record) {
+    if (!acceptsRecord(record))
+        return;
+
+    QMutexLocker locker(&d->lock);
+    if (!d->file.isOpen())
+        return;
+    writeRecord(record.timestamp(),record.threadId(),record.messageType(),record.messageContext(),record.engineName(),record.messages());
+}
+
+bool Qtilities::Logging::BinaryLoggerEngine::startFile() {
+    d->sequence = 0;
+    d->block_count = 0;
+    d->block_types = 0;
+    d->block_first_offset = -1;
+    d->previous_index_offset = -1;
+
+    QByteArray header;
+    appendValue<quint32>(header,qti_def_BINARY_LOG_MAGIC);
+    appendValue<quint16>(header,qti_def_BINARY_LOG_VERSION);
+    appendValue<quint16>(header,qti_def_BINARY_LOG_HEADER_SIZE);
+    appendValue<qint64>(header,QDateTime::currentDateTime().toMSecsSinceEpoch());
+    appendValue<quint32>(header,(quint32) d->index_interval);
+    appendValue<quint32>(header,0);
+    Q_ASSERT(header.size() == qti_def_BINARY_LOG_HEADER_SIZE);
+
+    return d->file.write(header) == header.size() && d->file.flush();
+}
+
+void Qtilities::Logging::BinaryLoggerEngine::writeRecord(const QDateTime& timestamp, quint64 thread_id, Logger::MessageType message_type, Logger::MessageContextFlags message_context,
+                                                         const QString& engine_name, const QList<QVariant>& messages) {
+    qint64 msecs = timestamp.toMSecsSinceEpoch();
+    QByteArray engine_name_bytes = engine_name.toUtf8();
+
+    // The block header is written with a zero length, which is filled in once the body is complete:
+    QByteArray block;
+    appendBlockHeader(block,qti_def_BINARY_LOG_BLOCK_RECORD,0);
+    appendValue<qint64>(block,msecs);
+    appendValue<quint64>(block,d->sequence);
+    appendValue<quint64>(block,thread_id);
+    appendValue<quint32>(block,(quint32) message_type);
+    appendValue<quint32>(block,(quint32) message_context);
+    appendValue<quint16>(block,(quint16) qMin(engine_name_bytes.size(),0xFFFF));
+    block.append(engine_name_bytes.constData(),qMin(engine_name_bytes.size(),0xFFFF));
+    int message_count = qMin(messages.count(),0xFFFF);
+    appendValue<quint16>(block,(quint16) message_count);
+    for (int i = 0; i < message_count; ++i) {
+        QByteArray message_bytes = messages.at(i).toString().toUtf8();
+        appendValue<quint32>(block,(quint32) message_bytes.size());
+        block.append(message_bytes);
+    }
+    qToLittleEndian<quint32>((quint32) (block.size() - qti_def_BINARY_LOG_BLOCK_HEADER_SIZE),(uchar*) block.data() + 4);
+
+    if (d->block_count == 0) {
+        d->block_first_offset = d->file.pos();
+        d->block_first_sequence = d->sequence;
+        d->block_min_timestamp = msecs;
+        d->block_max_timestamp = msecs;
+    } else {
+        d->block_min_timestamp = qMin(d->block_min_timestamp,msecs);
+        d->block_max_timestamp = qMax(d->block_max_timestamp,msecs);
+    }
+    ++d->block_count;
+    d->block_types |= (quint32) message_type;
+    ++d->sequence;
+
+    // Each record is written as soon as it is logged, only the index blocks are periodic:
+    writeBlock(d->file,block);
+    if ((int) d->block_count >= d->index_interval)
+        writeIndexBlock();
+}
+
+void Qtilities::Logging::BinaryLoggerEngine::writeIndexBlock() {
+    qint64 index_offset = d->file.pos();
+
+    QByteArray block;
+    appendBlockHeader(block,qti_def_BINARY_LOG_BLOCK_INDEX,56);
+    appendValue<quint32>(block,d->block_count);
+    appendValue<quint32>(block,d->block_types);
+    appendValue<qint64>(block,d->block_min_timestamp);
+    appendValue<qint64>(block,d->block_max_timestamp);
+    appendValue<qint64>(block,d->block_first_offset);
+    appendValue<qint64>(block,d->previous_index_offset);
+    appendValue<quint64>(block,d->block_first_sequence);
+    appendValue<quint64>(block,0);
+    writeBlock(d->file,block);
+
+    d->previous_index_offset = index_offset;
+    d->block_count = 0;
+    d->block_types = 0;
+    d->block_first_offset = -1;
+}
+
+Qtilities::Logging::Interfaces::ILoggerExportable::ExportModeFlags Qtilities::Logging::BinaryLoggerEngine::supportedFormats() const {
+    ILoggerExportable::ExportModeFlags flags = 0;
+    flags |= ILoggerExportable::Binary;
+    return flags;
+}
+
+bool Qtilities::Logging::BinaryLoggerEngine::exportBinary(QDataStream& stream) const {
+    stream << d->file_name;
+    stream << (qint32) d->index_interval;
+    return true;
+}
+
+bool Qtilities::Logging::BinaryLoggerEngine::importBinary(QDataStream& stream) {
+    qint32 index_interval;
+    stream >> d->file_name;
+    stream >> index_interval;
+    if (index_interval > 0)
+        d->index_interval = index_interval;
+    return true;
+}
+
+void Qtilities::Logging::BinaryLoggerEngine::setFileName(const QString& fileName) {
+    if (!abstractLoggerEngineData->is_initialized)
+        d->file_name = fileName;
+}
+
+QString Qtilities::Logging::BinaryLoggerEngine::getFileName() {
+    return d->file_name;
+}
+
+void Qtilities::Logging::BinaryLoggerEngine::setIndexInterval(int record_count) {
+    if (!abstractLoggerEngineData->is_initialized && record_count > 0)
+        d->index_interval = record_count;
+}
+
+int Qtilities::Logging::BinaryLoggerEngine::indexInterval() const {
+    return d->index_interval;
+}
+
+quint64 Qtilities::Logging::BinaryLoggerEngine::recordCount() const {
+    QMutexLocker locker(&d->lock);
+    return d->sequence;
+}
+
 // ------------------------------------
 // QtMsgLoggerEngine implementation
 // ------------------------------------
@@ -20,6 +20,7 @@
 
 #include <QList>
 #include <QVariant>
+#include <QReadWriteLock>
 
 #define CONSOLE_RESET   "\033[0m"
 #define CONSOLE_BLACK   "\033[30m"      /* Black */
@@ -44,6 +45,10 @@ namespace Qtilities {
         using namespace Qtilities::Logging::Interfaces;
         using namespace Qtilities::Logging::Constants;
 
+        class FileLoggerEngineWriter;
+        struct RollingFileLoggerEngineData;
+        struct BinaryLoggerEngineData;
+
         // ------------------------------------
         // File Logger Engine
         // ------------------------------------
@@ -52,6 +57,27 @@ namespace Qtilities {
         \brief A logger engine which stores the logged messages in a file.
 
         A logger engine which stores the logged messages in a file.
+
+        \section file_logger_engine_asynchronous Asynchronous Writing
+
+        By default every message is written to the file on the thread which logged it, opening and closing the file for each message.
+        When a lot of messages are logged (for example when logging at Logger::Trace level) this becomes expensive. Asynchronous
+        writing can be enabled using setAsynchronousWritingEnabled() before the engine is initialized. In this mode messages are placed
+        in a bounded queue and a writer thread, which keeps the file open, writes them to the file in batches. A batch is written when
+        batchSize() messages are waiting, or when flushInterval() milliseconds passed since the first message in the batch was queued.
+
+        When the queue is full, the backPressurePolicy() determines what happens to new messages. Fatal messages are always written to
+        the file before logMessage() returns, and finalize() writes all queued messages before the finalization string is added. The
+        writer thread lives as long as the engine is initialized: clearLog() discards the queued messages and lets the writer thread
+        truncate the file, thus other threads can keep on logging while the log is cleared.
+
+\code
+FileLoggerEngine* file_engine = new FileLoggerEngine;
+file_engine->setFileName("trace.log");
+file_engine->setAsynchronousWritingEnabled(true);
+file_engine->setBackPressurePolicy(FileLoggerEngine::DropTraceWhenFull);
+Log->attachLoggerEngine(file_engine,true);
+\endcode
           */
         class LOGGING_SHARED_EXPORT FileLoggerEngine : public AbstractLoggerEngine, public ILoggerExportable
         {
@@ -63,6 +89,16 @@ namespace Qtilities {
             FileLoggerEngine();
             ~FileLoggerEngine();
 
+            //! Policies which determine what happens to new messages when the queue of an asynchronous engine is full.
+            /*!
+              <i>This enum was added in %Qtilities v1.5.</i>
+              */
+            enum BackPressurePolicy {
+                BlockWhenFull       = 0, /*!< The thread logging the message waits until the writer thread made space in the queue. */
+                DropOldestWhenFull  = 1, /*!< The oldest message in the queue is dropped to make space for the new message. */
+                DropTraceWhenFull   = 2  /*!< New Logger::Trace and Logger::Debug messages are dropped, other messages wait until space is available. */
+            };
+
             // --------------------------------
             // AbstractLoggerEngine Implementation
             // --------------------------------
@@ -71,6 +107,8 @@ namespace Qtilities {
             QString description() const;
             QString status() const;
             bool isFormattingEngineConstant() const { return true; }
+            //! The engine is thread safe while asynchronous writing is active, since messages are then only queued for the writer thread.
+            bool isThreadSafe() const;
             /*!
               Clearing of FileLoggerEngine was introduced in %Qtilities v1.1.
               */
@@ -94,6 +132,81 @@ namespace Qtilities {
             //! Gets the file name to which the logger is currently logging.
             QString getFileName();
 
+            //! Enables or disables asynchronous writing, see \ref file_logger_engine_asynchronous.
+            /*!
+              Its not possible to change the writing mode while the logger engine is in a initialized state.
+
+              Asynchronous writing is disabled by default.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            void setAsynchronousWritingEnabled(bool enabled);
+            //! Indicates if asynchronous writing is enabled.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            bool asynchronousWritingEnabled() const;
+            //! Sets the maximum number of messages which can wait in the queue of an asynchronous engine.
+            /*!
+              Its not possible to change the capacity while the logger engine is in a initialized state. The default capacity is 8192 messages.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            void setQueueCapacity(int capacity);
+            //! Returns the maximum number of messages which can wait in the queue of an asynchronous engine.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            int queueCapacity() const;
+            //! Sets the number of waiting messages which causes the writer thread to write a batch to the file.
+            /*!
+              Its not possible to change the batch size while the logger engine is in a initialized state. The default batch size is 256 messages.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            void setBatchSize(int batch_size);
+            //! Returns the number of waiting messages which causes the writer thread to write a batch to the file.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            int batchSize() const;
+            //! Sets the maximum time in milliseconds which messages wait in the queue before they are written, when the batch size is not reached.
+            /*!
+              Its not possible to change the flush interval while the logger engine is in a initialized state. The default interval is 200 milliseconds.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            void setFlushInterval(int msec);
+            //! Returns the maximum time in milliseconds which messages wait in the queue before they are written.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            int flushInterval() const;
+            //! Sets the policy which is used when the queue of an asynchronous engine is full.
+            /*!
+              The policy can be changed at any time. The default policy is BlockWhenFull.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            void setBackPressurePolicy(BackPressurePolicy policy);
+            //! Returns the policy which is used when the queue of an asynchronous engine is full.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            BackPressurePolicy backPressurePolicy() const;
+            //! Returns the number of messages which were dropped because the queue was full since the engine was initialized.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            int droppedMessageCount() const;
+            //! Writes all queued messages to the file and waits until they are written.
+            /*!
+              Does nothing when asynchronous writing is disabled, since messages are written immediately in that case.
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            void flush();
+
             // Make this class a factory item
             static LoggerFactoryItem<AbstractLoggerEngine, FileLoggerEngine> factory;
 
@@ -102,6 +215,227 @@ namespace Qtilities {
 
         private:
             QString file_name;
+            bool asynchronous_writing;
+            int queue_capacity;
+            int batch_size;
+            int flush_interval;
+            BackPressurePolicy back_pressure_policy;
+            int dropped_messages;
+            FileLoggerEngineWriter* writer;
+            // Protects writer and the initialization state against finalize() while other threads log messages:
+            mutable QReadWriteLock writer_lock;
+        };
+
+        // ------------------------------------
+        // Rolling File Logger Engine
+        // ------------------------------------
+        /*!
+        \class RollingFileLoggerEngine
+        \brief A logger engine which stores the logged messages in a file that is rolled over when it becomes too large or too old.
+
+        FileLoggerEngine appends to the same file for as long as the application runs, thus long running applications can fill up the disk.
+        The rolling file logger engine starts a new file when the current file reaches maximumFileSize() bytes, or when it was written to for
+        rollInterval() seconds. The file which was rolled over becomes the first generation, named by adding ".1" to fileName(), the previous
+        first generation becomes ".2" and so on. Only generations() generations are kept, older files are removed. When the engine is initialized
+        and the file of a previous session exists, that file becomes the first generation.
+
+        Messages are written by a writer thread in the same way as an asynchronous FileLoggerEngine, see \ref file_logger_engine_asynchronous.
+        Rolling over happens on the writer thread, thus threads logging messages are not blocked while files are renamed. Since the size is checked
+        before each batch of messages is written, files can become slightly larger than maximumFileSize().
+
+        When compressionEnabled() is true, rolled files are compressed on a background thread using qCompress(), replacing the generation's file
+        with a file with the Constants::qti_def_SUFFIX_COMPRESSED_LOG suffix. Use qUncompress() to restore the text of a compressed generation.
+
+\code
+RollingFileLoggerEngine* rolling_engine = new RollingFileLoggerEngine;
+rolling_engine->setName("Shop Floor Log");
+rolling_engine->setFileName("shop_floor.log");
+rolling_engine->setMaximumFileSize(5 * 1024 * 1024);
+rolling_engine->setRollInterval(24 * 60 * 60);
+rolling_engine->setGenerations(10);
+Log->attachLoggerEngine(rolling_engine,true);
+\endcode
+
+        The engine is available in the logger engine factory under Constants::qti_def_FACTORY_TAG_ROLLING_FILE_LOGGER_ENGINE, and its settings are
+        stored in the session configuration of the logger, see Logger::saveSessionConfig().
+
+        <i>This class was added in %Qtilities v1.5.</i>
+          */
+        class LOGGING_SHARED_EXPORT RollingFileLoggerEngine : public AbstractLoggerEngine, public ILoggerExportable
+        {
+            Q_OBJECT
+            Q_INTERFACES(Qtilities::Logging::Interfaces::ILoggerExportable)
+            Q_PROPERTY(QString FileName READ getFileName)
+
+        public:
+            RollingFileLoggerEngine();
+            ~RollingFileLoggerEngine();
+
+            // --------------------------------
+            // AbstractLoggerEngine Implementation
+            // --------------------------------
+            bool initialize();
+            void finalize();
+            QString description() const;
+            QString status() const;
+            bool isFormattingEngineConstant() const { return true; }
+            //! The engine is thread safe while it is initialized, since messages are then only queued for the writer thread.
+            bool isThreadSafe() const;
+            void clearLog();
+
+            // --------------------------------
+            // ILoggerExportable Implementation
+            // --------------------------------
+            ExportModeFlags supportedFormats() const;
+            bool exportBinary(QDataStream& stream) const;
+            bool importBinary(QDataStream& stream);
+            QString factoryTag() const { return qti_def_FACTORY_TAG_ROLLING_FILE_LOGGER_ENGINE; }
+            QString instanceName() const { return name(); }
+
+            //! Sets the file name to which this engine will write the log output.
+            /*!
+                Its not possible to change the file name while the logger engine is in a initialized state.
+                To change the file name: call finalize(), setFileName() and then call initialize() again.
+              */
+            void setFileName(const QString& fileName);
+            //! Gets the file name to which the logger is currently logging.
+            QString getFileName();
+            //! Sets the size in bytes at which the file is rolled over. When 0, the file is not rolled over because of its size.
+            /*!
+              Its not possible to change the size while the logger engine is in a initialized state. The default size is 10 MB.
+              */
+            void setMaximumFileSize(qint64 bytes);
+            //! Returns the size in bytes at which the file is rolled over.
+            qint64 maximumFileSize() const;
+            //! Sets the number of seconds after which the file is rolled over. When 0, the file is not rolled over because of its age.
+            /*!
+              Its not possible to change the interval while the logger engine is in a initialized state. The default interval is 0.
+              */
+            void setRollInterval(int seconds);
+            //! Returns the number of seconds after which the file is rolled over.
+            int rollInterval() const;
+            //! Sets the number of rolled files which are kept.
+            /*!
+              Its not possible to change the number of generations while the logger engine is in a initialized state. The default is 5 generations.
+              */
+            void setGenerations(int generations);
+            //! Returns the number of rolled files which are kept.
+            int generations() const;
+            //! Enables or disables compression of rolled files.
+            /*!
+              Its not possible to change compression while the logger engine is in a initialized state. Compression is enabled by default.
+              */
+            void setCompressionEnabled(bool enabled);
+            //! Indicates if rolled files are compressed.
+            bool compressionEnabled() const;
+            //! Returns the number of times the file was rolled over since the engine was initialized.
+            int rollCount() const;
+            //! Writes all queued messages to the file and waits until they are written.
+            void flush();
+
+            // Make this class a factory item
+            static LoggerFactoryItem<AbstractLoggerEngine, RollingFileLoggerEngine> factory;
+
+        public slots:
+            void logMessage(const QString& message, Logger::MessageType message_type);
+
+        private:
+            //! Creates and starts the writer thread.
+            bool startWriter();
+            //! Stops and deletes the writer thread.
+            void stopWriter();
+
+            RollingFileLoggerEngineData* d;
+        };
+
+        // ------------------------------------
+        // Binary Logger Engine
+        // ------------------------------------
+        /*!
+        \class BinaryLoggerEngine
+        \brief A logger engine which stores the logged messages in a compact binary file.
+
+        Text log files become very large when a lot of messages are logged, and finding messages in them means parsing all the text.
+        The binary logger engine stores each message as a length prefixed record which contains the time at which the message was
+        logged, its type, context, the thread that logged it, the engine it was targeted at, a sequence number and the message itself.
+        After every indexInterval() records an index block is written which summarizes the records before it. When the engine is finalized,
+        a footer which points to the last index block is added.
+
+        Binary log files are read using BinaryLogReader, which memory maps the file and uses the index blocks to filter records by time and
+        message type without reading all records. BinaryLogReader can also convert binary log files into any of the text formats provided
+        by formatting engines. The file format is described in the BinaryLogReader documentation.
+
+        Since records are stored unformatted, this engine does not use a formatting engine. Each record is handed to the operating system
+        as soon as it is logged, thus a BinaryLogReader following the file sees it immediately and records are not lost when the application
+        crashes. Only the index blocks are written periodically.
+
+        <i>This class was added in %Qtilities v1.5.</i>
+          */
+        class LOGGING_SHARED_EXPORT BinaryLoggerEngine : public AbstractLoggerEngine, public ILoggerExportable
+        {
+            Q_OBJECT
+            Q_INTERFACES(Qtilities::Logging::Interfaces::ILoggerExportable)
+            Q_PROPERTY(QString FileName READ getFileName)
+
+        public:
+            BinaryLoggerEngine();
+            ~BinaryLoggerEngine();
+
+            // --------------------------------
+            // AbstractLoggerEngine Implementation
+            // --------------------------------
+            bool initialize();
+            void finalize();
+            QString description() const;
+            QString status() const;
+            bool isFormattingEngineConstant() const { return true; }
+            bool isThreadSafe() const { return true; }
+            void clearLog();
+
+            // --------------------------------
+            // ILoggerExportable Implementation
+            // --------------------------------
+            ExportModeFlags supportedFormats() const;
+            bool exportBinary(QDataStream& stream) const;
+            bool importBinary(QDataStream& stream);
+            QString factoryTag() const { return qti_def_FACTORY_TAG_BINARY_LOGGER_ENGINE; }
+            QString instanceName() const { return name(); }
+
+            //! Sets the file name to which this engine will write the log output.
+            /*!
+                Its not possible to change the file name while the logger engine is in a initialized state.
+                To change the file name: call finalize(), setFileName() and then call initialize() again.
+              */
+            void setFileName(const QString& fileName);
+            //! Gets the file name to which the logger is currently logging.
+            QString getFileName();
+            //! Sets the number of records after which an index block is written.
+            /*!
+              Its not possible to change the interval while the logger engine is in a initialized state. The default interval is 1024 records.
+              */
+            void setIndexInterval(int record_count);
+            //! Returns the number of records after which an index block is written.
+            int indexInterval() const;
+            //! Returns the number of records written since the engine was initialized.
+            quint64 recordCount() const;
+
+            // Make this class a factory item
+            static LoggerFactoryItem<AbstractLoggerEngine, BinaryLoggerEngine> factory;
+
+        public slots:
+            void logMessage(const QString& message, Logger::MessageType message_type);
+            void newLogRecord(const LogRecord& record);
+
+        private:
+            //! Writes a record to the file. Must be called with the engine's lock held.
+            void writeRecord(const QDateTime& timestamp, quint64 thread_id, Logger::MessageType message_type, Logger::MessageContextFlags message_context,
+                             const QString& engine_name, const QList<QVariant>& messages);
+            //! Writes an index block for the records written since the previous index block. Must be called with the engine's lock held.
+            void writeIndexBlock();
+            //! Writes the file header and resets the record state. Must be called with the engine's lock held.
+            bool startFile();
+
+            BinaryLoggerEngineData* d;
         };
 
         // ------------------------------------
@@ -135,6 +469,7 @@ namespace Qtilities {
             QString status() const;
             bool removable() const { return false; }
             bool isFormattingEngineConstant() const { return true; }
+            bool isThreadSafe() const { return true; }
 
         public slots:
             void logMessage(const QString& message, Logger::MessageType message_type);
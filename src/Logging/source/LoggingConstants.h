@@ -12,6 +12,8 @@
 #ifndef LOGGINGCONSTANTS_H
 #define LOGGINGCONSTANTS_H
 
+#include <QtGlobal>
+
 //! Namespace containing all the modules which forms part of the library set.
 namespace Qtilities {
     //! Namespace containing all the classes which forms part of the Logging Module.
@@ -42,9 +44,30 @@ namespace Qtilities {
 
             // Default Factory Tags
             const char * const qti_def_FACTORY_TAG_FILE_LOGGER_ENGINE = "qti.def.FactoryTag.File";
+            const char * const qti_def_FACTORY_TAG_BINARY_LOGGER_ENGINE = "qti.def.FactoryTag.Binary";
+            const char * const qti_def_FACTORY_TAG_ROLLING_FILE_LOGGER_ENGINE = "qti.def.FactoryTag.RollingFile";
 
             // File Extensions
             const char * const qti_def_SUFFIX_LOGGER_CONFIG         = ".logconfig";
+            const char * const qti_def_SUFFIX_BINARY_LOG            = ".qlog";
+            //! The suffix added to log files compressed using qCompress(), see Qtilities::Logging::RollingFileLoggerEngine.
+            const char * const qti_def_SUFFIX_COMPRESSED_LOG        = ".qz";
+
+            // Binary Log Format, see Qtilities::Logging::BinaryLogReader
+            //! The magic number at the start of binary log files.
+            const quint32 qti_def_BINARY_LOG_MAGIC                  = 0x474C5451;
+            //! The version of the binary log format.
+            const quint16 qti_def_BINARY_LOG_VERSION                = 1;
+            //! The size of the file header of binary log files.
+            const int qti_def_BINARY_LOG_HEADER_SIZE                = 24;
+            //! The size of the header of each block in binary log files.
+            const int qti_def_BINARY_LOG_BLOCK_HEADER_SIZE          = 8;
+            //! Block kind of a log record in binary log files.
+            const quint32 qti_def_BINARY_LOG_BLOCK_RECORD           = 1;
+            //! Block kind of an index block in binary log files.
+            const quint32 qti_def_BINARY_LOG_BLOCK_INDEX            = 2;
+            //! Block kind of the footer of binary log files.
+            const quint32 qti_def_BINARY_LOG_BLOCK_FOOTER           = 3;
 
             // Default file paths (all subdirectories of the executable file)
             const char * const qti_def_PATH_SESSION                 = "Session";
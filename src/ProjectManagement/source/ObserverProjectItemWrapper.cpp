@@ -19,6 +19,8 @@
 
 #include <QApplication>
 #include <QDomNodeList>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 using namespace Qtilities::Core::Interfaces;
 using namespace Qtilities::Core;
@@ -84,9 +86,21 @@ Qtilities::Core::Interfaces::IExportable::ExportModeFlags Qtilities::ProjectMana
     IExportable::ExportModeFlags flags = 0;
     flags |= IExportable::Binary;
     flags |= IExportable::XML;
+    // Relational data is exported for the complete tree at once, thus streaming has no benefit:
+    if (!(d->export_flags & ObserverData::ExportRelationalData))
+        flags |= IExportable::XMLStream;
     return flags;
 }
 
+bool Qtilities::ProjectManagement::ObserverProjectItemWrapper::supportsConcurrentExport() const {
+    if (!d->observer)
+        return false;
+    // The relational table and the limited exports list used for visitor IDs visit the complete tree and set properties on the objects in it:
+    if (d->export_flags & (ObserverData::ExportRelationalData | ObserverData::ExportVisitorIDs))
+        return false;
+    return d->observer->supportsConcurrentExport();
+}
+
 Qtilities::Core::InstanceFactoryInfo Qtilities::ProjectManagement::ObserverProjectItemWrapper::instanceFactoryInfo() const {
     return InstanceFactoryInfo();
 }
@@ -177,6 +191,44 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::ProjectMa
     return IExportable::Incomplete;
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::ProjectManagement::ObserverProjectItemWrapper::exportXmlStream(QXmlStreamWriter& writer) const {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    if (d->observer) {
+        // Add a new node for this observer. We don't want it to add its factory data
+        // to the ProjectItem node.
+        writer.writeStartElement("ObserverProjectItemWrapper");
+        IExportable::ExportResultFlags result = d->observer->exportXmlStreamExt(writer,d->export_flags);
+        writer.writeEndElement();
+        return result;
+    } else
+        return IExportable::Incomplete;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::ProjectManagement::ObserverProjectItemWrapper::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesImportVersion(exportVersion(),exportTask());
+    if (version_check_result != IExportable::VersionSupported)
+        return version_check_result;
+
+    IExportable::ExportResultFlags result = IExportable::Incomplete;
+    bool imported = false;
+    while (reader.readNextStartElement()) {
+        if (d->observer && !imported && reader.name() == QLatin1String("ObserverProjectItemWrapper")) {
+            d->observer->setExportVersion(exportVersion());
+            result = d->observer->importXmlStream(reader,import_list);
+            imported = true;
+            if (result & IExportable::FailedResult)
+                return result;
+        } else {
+            reader.skipCurrentElement();
+        }
+    }
+
+    return result;
+}
+
 void Qtilities::ProjectManagement::ObserverProjectItemWrapper::setExportItemFlags(ObserverData::ExportItemFlags flags) {
     d->export_flags = flags;
 }
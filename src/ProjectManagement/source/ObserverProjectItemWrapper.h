@@ -65,8 +65,16 @@ OBJECT_MANAGER->registerObject(project_item,QtilitiesCategory("Core::Project Ite
             // --------------------------------
             // IExportable Implementation
             // --------------------------------
+            /*!
+              XML streaming is supported when the export item flags does not contain Qtilities::Core::ObserverData::ExportRelationalData.
+              */
             ExportModeFlags supportedFormats() const;
             InstanceFactoryInfo instanceFactoryInfo() const;
+            /*!
+              Concurrent exports are supported when the observer supports it and the export item flags does not contain Qtilities::Core::ObserverData::ExportRelationalData
+              or Qtilities::Core::ObserverData::ExportVisitorIDs.
+              */
+            virtual bool supportsConcurrentExport() const;
             virtual void setExportVersion(Qtilities::ExportVersion version);
             virtual void setExportTask(ITask* task);
             virtual void clearExportTask();
@@ -74,6 +82,8 @@ OBJECT_MANAGER->registerObject(project_item,QtilitiesCategory("Core::Project Ite
             virtual IExportable::ExportResultFlags importBinary(QDataStream& stream, QList<QPointer<QObject> >& import_list);
             virtual IExportable::ExportResultFlags exportXml(QDomDocument* doc, QDomElement* object_node) const;
             virtual IExportable::ExportResultFlags importXml(QDomDocument* doc, QDomElement* object_node, QList<QPointer<QObject> >& import_list);
+            virtual IExportable::ExportResultFlags exportXmlStream(QXmlStreamWriter& writer) const;
+            virtual IExportable::ExportResultFlags importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list);
 
             //! Sets the export item flags to be used for this project item.
             /*!
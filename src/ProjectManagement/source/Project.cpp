@@ -19,21 +19,57 @@
 #include <QtilitiesApplication>
 #include <FileUtils>
 
+#include <QFile>
 #include <QFileInfo>
+#include <QElapsedTimer>
 #include <QDomElement>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 #include <QApplication>
 #include <QCursor>
 #include <QMessageBox>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+#include <QSaveFile>
+#endif
 
 #include <FileLocker>
+#include <ParallelExport>
 
+#include <limits.h>
 #include <stdio.h>
 #include <time.h>
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 using namespace Qtilities::ProjectManagement::Constants;
 using namespace Qtilities;
 using namespace Qtilities::Core;
 
+struct Qtilities::ProjectManagement::ProjectContainerSection {
+    QString                 item_name;
+    qint64                  offset;
+    qint64                  length;
+    quint16                 checksum;
+    bool                    compressed;
+};
+
+struct Qtilities::ProjectManagement::ProjectContainerHeader {
+    ProjectContainerHeader(): export_version(Qtilities::Qtilities_Latest),
+    application_export_version(0),
+    sections_offset(-1),
+    appendix_position(-1) {}
+
+    Qtilities::ExportVersion        export_version;
+    quint32                         application_export_version;
+    QList<ProjectContainerSection>  sections;
+    qint64                          sections_offset;
+    // The position of the appendix from which the sections were read, -1 when they were read from the header:
+    qint64                          appendix_position;
+};
+
 struct Qtilities::ProjectManagement::ProjectPrivateData {
     ProjectPrivateData(): project_file(QString()),
     project_name(QString(QObject::tr("New Project"))) {}
@@ -42,6 +78,8 @@ struct Qtilities::ProjectManagement::ProjectPrivateData {
     QString                 project_file;
     QString                 project_name;
     QMutex                  modification_mutex;
+    QStringList             deferred_items;
+    QMap<QString,qint64>    item_save_times;
 
     FileLocker              file_locker;
 };
@@ -59,6 +97,7 @@ Qtilities::ProjectManagement::Project::~Project() {
 bool Qtilities::ProjectManagement::Project::newProject() {
     d->project_file = QString();
     d->project_name = QString(QObject::tr("New Project"));
+    d->deferred_items.clear();
     for (int i = 0; i < d->project_items.count(); ++i) {
         d->project_items.at(i)->newProjectItem();
     }
@@ -68,6 +107,159 @@ bool Qtilities::ProjectManagement::Project::newProject() {
 }
 
 quint32 MARKER_PROJECT_SECTION = 0xBABEFACE;
+quint32 MARKER_PROJECT_CONTAINER = 0xBABEC0DE;
+quint32 PROJECT_CONTAINER_VERSION = 1;
+quint32 MARKER_PROJECT_APPENDIX = 0xBABEADD5;
+// Sections smaller than this are not worth compressing:
+int PROJECT_CONTAINER_COMPRESSION_THRESHOLD = 1024;
+// Incrementally saved files are compacted when their sections take up more than this factor of the live sections:
+int PROJECT_CONTAINER_COMPACTION_FACTOR = 2;
+// An appendix ends with a trailer containing its position followed by MARKER_PROJECT_APPENDIX:
+qint64 PROJECT_CONTAINER_TRAILER_SIZE = sizeof(qint64) + sizeof(quint32);
+
+namespace {
+    // Exports a project item into the data of its container section, compressing the data when it is worth it.
+    class ProjectItemExportPart : public AbstractExportPart {
+    public:
+        ProjectItemExportPart(Qtilities::ProjectManagement::IProjectItem* item) : d_item(item), d_compressed(false), d_elapsed(0) {}
+
+        bool isThreadSafe() const { return d_item->supportsConcurrentExport(); }
+        IExportable::ExportResultFlags exportPart(QDataStream& stream, ITask* task) {
+            d_timer.start();
+            if (task)
+                d_item->setExportTask(task);
+            IExportable::ExportResultFlags result = d_item->exportBinary(stream);
+            if (task)
+                d_item->clearExportTask();
+            return result;
+        }
+        void finishPart(QByteArray* data) {
+            // Only keep the compressed section when compression actually saves space:
+            if (data->size() >= PROJECT_CONTAINER_COMPRESSION_THRESHOLD) {
+                QByteArray compressed_data = qCompress(*data);
+                if (compressed_data.size() < data->size()) {
+                    *data = compressed_data;
+                    d_compressed = true;
+                }
+            }
+            d_elapsed = d_timer.elapsed();
+        }
+
+        Qtilities::ProjectManagement::IProjectItem* item() const { return d_item; }
+        bool compressed() const { return d_compressed; }
+        qint64 elapsed() const { return d_elapsed; }
+
+    private:
+        Qtilities::ProjectManagement::IProjectItem* d_item;
+        QElapsedTimer d_timer;
+        bool d_compressed;
+        qint64 d_elapsed;
+    };
+
+    // Flushes the data written to file to the disk. Data which is only in the cache of the operating system is lost when the system crashes.
+    bool syncFileToDisk(QFile* file) {
+        if (!file->flush())
+            return false;
+        #ifdef Q_OS_WIN
+        return _commit(file->handle()) == 0;
+        #else
+        return fsync(file->handle()) == 0;
+        #endif
+    }
+
+    // Writes a project file next to the project file and renames it into place when it is committed, thus the project
+    // file on disk is always either the complete previous version or the complete new version of the project.
+    class ProjectSaveFile {
+    public:
+        #if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+        ProjectSaveFile(const QString& file_name) : d_file_name(file_name), d_file(file_name) {}
+        #else
+        ProjectSaveFile(const QString& file_name) : d_file_name(file_name), d_file(file_name + ".saving") {}
+        #endif
+
+        bool open() { return d_file.open(QIODevice::WriteOnly); }
+        QIODevice* device() { return &d_file; }
+        QString errorString() const { return d_file.errorString(); }
+
+        // Discards the new version, leaving the project file as it was:
+        void cancel() {
+            #if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+            d_file.cancelWriting();
+            #else
+            d_file.close();
+            d_file.remove();
+            #endif
+        }
+
+        // Syncs the new version to disk and renames it to the project file. When backup_file_name is not empty, the current
+        // project file is backed up to it first. The project file itself stays in place until the new version replaces it.
+        bool commit(const QString& backup_file_name, QString* errorMsg) {
+            bool backed_up = false;
+            if (!backup_file_name.isEmpty() && QFile::exists(d_file_name)) {
+                if (QFile::exists(backup_file_name) && !QFile::remove(backup_file_name)) {
+                    *errorMsg = QObject::tr("The previous backup could not be removed: ") + backup_file_name;
+                    cancel();
+                    return false;
+                }
+                // A hard link keeps the current version under the backup name once the new version replaces the project file,
+                // without copying it. Copy it where hard links are not supported:
+                #ifndef Q_OS_WIN
+                backed_up = (::link(QFile::encodeName(d_file_name).constData(),QFile::encodeName(backup_file_name).constData()) == 0);
+                #endif
+                if (!backed_up)
+                    backed_up = QFile::copy(d_file_name,backup_file_name);
+                if (!backed_up) {
+                    *errorMsg = QObject::tr("The project file could not be backed up: ") + backup_file_name;
+                    cancel();
+                    return false;
+                }
+            }
+
+            #if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+            // QSaveFile syncs the file to disk before renaming it:
+            bool committed = d_file.commit();
+            if (!committed)
+                *errorMsg = d_file.errorString();
+            #else
+            bool committed = syncFileToDisk(&d_file);
+            if (!committed)
+                *errorMsg = d_file.errorString();
+            d_file.close();
+            if (committed) {
+                #ifdef Q_OS_WIN
+                // QFile::rename() does not replace existing files:
+                if (QFile::exists(d_file_name))
+                    QFile::remove(d_file_name);
+                committed = QFile::rename(d_file.fileName(),d_file_name);
+                #else
+                committed = (::rename(QFile::encodeName(d_file.fileName()).constData(),QFile::encodeName(d_file_name).constData()) == 0);
+                #endif
+                if (!committed)
+                    *errorMsg = QObject::tr("The new version could not be renamed to the project file: ") + d_file.fileName();
+            }
+            if (!committed)
+                d_file.remove();
+            #endif
+
+            // A failed commit leaves the project file in place, except when replacing it failed halfway on platforms where
+            // it must be removed first. Restore the previous version from the backup in that case:
+            if (!committed && backed_up && !QFile::exists(d_file_name)) {
+                if (!QFile::copy(backup_file_name,d_file_name))
+                    *errorMsg += QObject::tr(" The previous version could not be restored from its backup: ") + backup_file_name;
+            }
+            return committed;
+        }
+
+    private:
+        QString d_file_name;
+        #if QT_VERSION >= QT_VERSION_CHECK(5, 1, 0)
+        QSaveFile d_file;
+        #else
+        QFile d_file;
+        #endif
+    };
+}
+
 
 bool Qtilities::ProjectManagement::Project::saveProject(const QString& file_name, ITask* task) {
     if (!PROJECT_MANAGER->projectSavingEnabled()) {
@@ -86,158 +278,174 @@ bool Qtilities::ProjectManagement::Project::saveProject(const QString& file_name
     }
 
     LOG_TASK_INFO(tr("Starting to save current project to file: ") + file_name,task);
+    d->item_save_times.clear();
 
-    if (file_name.endsWith(PROJECT_MANAGER->projectTypeSuffix(IExportable::XML))) {
-        QTemporaryFile file;
-        file.open();
-
-        // Create the QDomDocument:
-        QDomDocument doc("QtilitiesXMLProject");
-        QDomElement root = doc.createElement("QtilitiesXMLProject");
-        doc.appendChild(root);
-
+    // Only save modified project items when saving to the current binary project file:
+    if (PROJECT_MANAGER->incrementalProjectSaving() && !d->project_file.isEmpty() && QFileInfo(file_name) == QFileInfo(d->project_file)
+            && file_name.endsWith(PROJECT_MANAGER->projectTypeSuffix(IExportable::Binary))) {
         #ifdef QTILITIES_BENCHMARKING
         time_t start,end;
         time(&start);
         #endif
-        IExportable::setExportTask(task);
-        IExportable::ExportResultFlags success = exportXml(&doc,&root);
-        IExportable::clearExportTask();
+        bool saved = saveProjectIncremental(task);
         #ifdef QTILITIES_BENCHMARKING
         time(&end);
         double diff = difftime(end,start);
-        LOG_TASK_INFO("Project XML export completed in " + QString::number(diff) + " seconds.",task);
+        LOG_TASK_INFO("Project incremental binary export completed in " + QString::number(diff) + " seconds.",task);
         #endif
 
-        // Put the complete doc in a string and save it to the file:
-        QString docStr = doc.toString(2);
-        docStr.prepend("<!--Created by " + QApplication::applicationName() + " v" + QApplication::applicationVersion() + " on " + QDateTime::currentDateTime().toString() + "-->\n");
-        docStr.prepend("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
-        file.write(docStr.toUtf8());
-        file.close();
+        if (saved) {
+            setModificationState(false,IModificationNotifier::NotifyListeners | IModificationNotifier::NotifySubjects);
+            LOG_TASK_INFO_P(tr("Successfully saved modified project items to file: ") + d->project_file,task);
+            return true;
+        }
+        LOG_TASK_INFO(tr("The project could not be saved incrementally, the complete project will be saved."),task);
+        d->item_save_times.clear();
+    }
 
-        if (success != IExportable::Failed) {
-            // Copy the tmp file to the actual project file.
-            QString old_project_file = d->project_file;
-            d->project_file = file_name;
-            QFile current_file(d->project_file);
-            if (current_file.exists())  {
-                if (!current_file.remove()) {
-                    LOG_TASK_ERROR(tr("Failed to replace the current project file at path: ") + d->project_file,task);
-                    return false;
-                }
-            }
-            file.copy(d->project_file);
+    // Deferred project items must be loaded before they can be saved:
+    QStringList deferred_items = d->deferred_items;
+    for (int i = 0; i < deferred_items.count(); ++i) {
+        if (!loadProjectItem(deferred_items.at(i),task)) {
+            LOG_TASK_ERROR_P(tr("Failed to save current project to file: ") + file_name + tr(". Deferred project item \"") + deferred_items.at(i) + tr("\" could not be loaded."),task);
+            return false;
+        }
+    }
 
-            // Only if successfull, check if the new file is different to the old file and handle locks accordingly:
-            if (PROJECT_MANAGER->useProjectFileLocks()) {
-                // Unlock the old file:
-                if (d->file_locker.isFileLocked(old_project_file)) {
-                    QString errorMsg;
-                    if (!d->file_locker.unlockFile(old_project_file,&errorMsg))
-                        LOG_TASK_WARNING(errorMsg,task);
-                }
-            }
+    bool xml_file = file_name.endsWith(PROJECT_MANAGER->projectTypeSuffix(IExportable::XML));
+    if (!xml_file && !file_name.endsWith(PROJECT_MANAGER->projectTypeSuffix(IExportable::Binary))) {
+        LOG_TASK_ERROR_P(tr("Failed to save project. Unsupported project file suffix found on file: ") + file_name,task);
+        return false;
+    }
 
-            // We change the project name to the selected file name:
-            QFileInfo fi(d->project_file);
-            QString file_name_only = fi.baseName();
-            d->project_name = file_name_only;
+    // Lock the project file before it is written. The lock is held while the new version is renamed into place:
+    QString old_project_file = d->project_file;
+    bool new_lock = false;
+    if (PROJECT_MANAGER->useProjectFileLocks() && !d->file_locker.isFileLocked(file_name)) {
+        QString errorMsg;
+        if (d->file_locker.lockFile(file_name,&errorMsg))
+            new_lock = true;
+        else
+            LOG_TASK_WARNING(errorMsg,task);
+    }
 
-            // Add a lock on the project file.
-            if (PROJECT_MANAGER->useProjectFileLocks()) {
-                if (!d->file_locker.isFileLocked(file_name)) {
-                    QString errorMsg;
-                    if (!d->file_locker.lockFile(file_name,&errorMsg))
-                        LOG_TASK_WARNING(errorMsg,task);
-                }
-            }
+    ProjectSaveFile file(file_name);
+    if (!file.open()) {
+        LOG_TASK_ERROR_P(tr("Failed to save current project to file: ") + file_name + tr(". The file could not be opened for writing: ") + file.errorString(),task);
+        if (new_lock)
+            d->file_locker.unlockFile(file_name);
+        return false;
+    }
 
-            setModificationState(false,IModificationNotifier::NotifyListeners | IModificationNotifier::NotifySubjects);
-            if (success == IExportable::Complete)
-                LOG_TASK_INFO_P(tr("Successfully saved complete project to file: ") + d->project_file,task);
-            if (success == IExportable::Incomplete)
-                LOG_TASK_INFO_P(tr("Successfully saved incomplete project to file: ") + d->project_file,task);
+    #ifdef QTILITIES_BENCHMARKING
+    time_t start,end;
+    time(&start);
+    #endif
+    IExportable::ExportResultFlags success;
+    if (xml_file) {
+        if (supportedFormats() & IExportable::XMLStream) {
+            // Stream the project directly to the file, the complete document is never kept in memory:
+            QXmlStreamWriter writer(file.device());
+            writer.setAutoFormatting(true);
+            writer.setAutoFormattingIndent(2);
+            writer.writeStartDocument();
+            writer.writeComment("Created by " + QApplication::applicationName() + " v" + QApplication::applicationVersion() + " on " + QDateTime::currentDateTime().toString());
+            writer.writeDTD("<!DOCTYPE QtilitiesXMLProject>");
+            writer.writeStartElement("QtilitiesXMLProject");
+
+            IExportable::setExportTask(task);
+            success = exportXmlStream(writer);
+            IExportable::clearExportTask();
+
+            writer.writeEndElement();
+            writer.writeEndDocument();
+            if (writer.hasError()) {
+                LOG_TASK_ERROR(tr("Failed to write the project XML stream to file: ") + file_name,task);
+                success = IExportable::Failed;
+            }
         } else {
-            LOG_TASK_ERROR_P(tr("Failed to save current project to file: ") + d->project_file,task);
-            return false;
+            // Create the QDomDocument:
+            QDomDocument doc("QtilitiesXMLProject");
+            QDomElement root = doc.createElement("QtilitiesXMLProject");
+            doc.appendChild(root);
+
+            IExportable::setExportTask(task);
+            success = exportXml(&doc,&root);
+            IExportable::clearExportTask();
+
+            // Put the complete doc in a string and save it to the file:
+            QString docStr = doc.toString(2);
+            docStr.prepend("<!--Created by " + QApplication::applicationName() + " v" + QApplication::applicationVersion() + " on " + QDateTime::currentDateTime().toString() + "-->\n");
+            docStr.prepend("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+            file.device()->write(docStr.toUtf8());
         }
-
-        return true;
-    } else if (file_name.endsWith(PROJECT_MANAGER->projectTypeSuffix(IExportable::Binary))) {
-        QTemporaryFile file;
-        file.open();
-        QDataStream stream(&file);
+        #ifdef QTILITIES_BENCHMARKING
+        time(&end);
+        double diff = difftime(end,start);
+        LOG_TASK_INFO("Project XML export completed in " + QString::number(diff) + " seconds.",task);
+        #endif
+    } else {
+        QDataStream stream(file.device());
         if (exportVersion() == Qtilities::Qtilities_1_0 || exportVersion() == Qtilities::Qtilities_1_1 || exportVersion() == Qtilities::Qtilities_1_2)
             stream.setVersion(QDataStream::Qt_4_7);
 
-        #ifdef QTILITIES_BENCHMARKING
-        time_t start,end;
-        time(&start);
-        #endif
         IExportable::setExportTask(task);
-        IExportable::ExportResultFlags success = exportBinary(stream);
+        success = exportBinary(stream);
         IExportable::clearExportTask();
+        if (stream.status() != QDataStream::Ok) {
+            LOG_TASK_ERROR(tr("Failed to write the project binary stream to file: ") + file_name,task);
+            success = IExportable::Failed;
+        }
         #ifdef QTILITIES_BENCHMARKING
         time(&end);
         double diff = difftime(end,start);
         LOG_TASK_INFO("Project binary export completed in " + QString::number(diff) + " seconds.",task);
         #endif
+    }
 
-        file.close();
-
-        if (success != IExportable::Failed) {
-            // Copy the tmp file to the actual project file.
-            QString old_project_file = d->project_file;
-            d->project_file = file_name;
-            QFile current_file(d->project_file);
-            if (current_file.exists())  {
-                if (!current_file.remove()) {
-                    LOG_TASK_ERROR_P(tr("Failed to replace the current project file at path: ") + d->project_file,task);
-                    return false;
-                }
-            }
-            file.copy(d->project_file);
-
-            // Only if successfull, check if the new file is different to the old file and handle locks accordingly:
-            if (PROJECT_MANAGER->useProjectFileLocks()) {
-                // Unlock the old file:
-                if (d->file_locker.isFileLocked(old_project_file)) {
-                    QString errorMsg;
-                    if (!d->file_locker.unlockFile(old_project_file,&errorMsg))
-                        LOG_TASK_WARNING(errorMsg,task);
-                }
-            }
+    // Replace the project file with the new version, keeping the previous version as a backup when needed:
+    if (success != IExportable::Failed) {
+        QString backup_file_name;
+        if (PROJECT_MANAGER->projectFileBackups())
+            backup_file_name = file_name + ".bak";
+        QString errorMsg;
+        if (!file.commit(backup_file_name,&errorMsg)) {
+            LOG_TASK_ERROR(tr("Failed to replace the project file at path: ") + file_name + " (" + errorMsg + ")",task);
+            success = IExportable::Failed;
+        }
+    } else {
+        file.cancel();
+    }
 
-            // We change the project name to the selected file name
-            QFileInfo fi(d->project_file);
-            QString file_name_only = fi.baseName();
-            d->project_name = file_name_only;
+    if (success == IExportable::Failed) {
+        if (new_lock)
+            d->file_locker.unlockFile(file_name);
+        LOG_TASK_ERROR_P(tr("Failed to save current project to file: ") + file_name,task);
+        return false;
+    }
 
-            // Add a lock on the project file.
-            if (PROJECT_MANAGER->useProjectFileLocks()) {
-                if (!d->file_locker.isFileLocked(file_name)) {
-                    QString errorMsg;
-                    if (!d->file_locker.lockFile(file_name,&errorMsg))
-                        LOG_TASK_WARNING(errorMsg,task);
-                }
-            }
+    d->project_file = file_name;
 
-            setModificationState(false,IModificationNotifier::NotifyListeners | IModificationNotifier::NotifySubjects);
-            if (success == IExportable::Complete)
-                LOG_TASK_INFO_P(tr("Successfully saved complete project to file: ") + d->project_file,task);
-            if (success == IExportable::Incomplete)
-                LOG_TASK_INFO_P(tr("Successfully saved incomplete project to file: ") + d->project_file,task);
-        } else {
-            LOG_TASK_ERROR_P(tr("Failed to save current project to file: ") + d->project_file,task);
-            return false;
+    // Unlock the old file when the project was saved to a different file:
+    if (PROJECT_MANAGER->useProjectFileLocks() && !old_project_file.isEmpty() && QFileInfo(old_project_file) != QFileInfo(file_name)) {
+        if (d->file_locker.isFileLocked(old_project_file)) {
+            QString errorMsg;
+            if (!d->file_locker.unlockFile(old_project_file,&errorMsg))
+                LOG_TASK_WARNING(errorMsg,task);
         }
-        return true;
-    } else {
-        LOG_TASK_ERROR_P(tr("Failed to save project. Unsupported project file suffix found on file: ") + file_name,task);
     }
 
-    return false;
+    // We change the project name to the selected file name:
+    QFileInfo fi(d->project_file);
+    QString file_name_only = fi.baseName();
+    d->project_name = file_name_only;
+
+    setModificationState(false,IModificationNotifier::NotifyListeners | IModificationNotifier::NotifySubjects);
+    if (success == IExportable::Complete)
+        LOG_TASK_INFO_P(tr("Successfully saved complete project to file: ") + d->project_file,task);
+    if (success == IExportable::Incomplete)
+        LOG_TASK_INFO_P(tr("Successfully saved incomplete project to file: ") + d->project_file,task);
+    return true;
 }
 
 bool Qtilities::ProjectManagement::Project::loadProject(const QString& file_name, bool close_current_first, ITask* task) {
@@ -255,29 +463,49 @@ bool Qtilities::ProjectManagement::Project::loadProject(const QString& file_name
     file.open(QIODevice::ReadOnly);
 
     if (file_name.endsWith(PROJECT_MANAGER->projectTypeSuffix(IExportable::XML))) {
-        // Load the file into doc:
-        QDomDocument doc("QtilitiesXMLProject");
-        QString docStr = file.readAll();
-        file.close();
-        QString error_string;
-        int error_line;
-        int error_column;
-        if (!doc.setContent(docStr,&error_string,&error_line,&error_column)) {
-            LOG_TASK_ERROR_P(QString(tr("The tree input file could not be parsed by QDomDocument. Error on line %1 column %2: %3")).arg(error_line).arg(error_column).arg(error_string),task);
-            return false;
-        }
-        QDomElement root = doc.documentElement();
-
-        // Interpret the loaded doc:
         QList<QPointer<QObject> > import_list;
+        IExportable::ExportResultFlags success;
 
         #ifdef QTILITIES_BENCHMARKING
         time_t start,end;
         time(&start);
         #endif
-        setExportTask(task);
-        IExportable::ExportResultFlags success = importXml(&doc,&root,import_list);
-        clearExportTask();
+        if (supportedFormats() & IExportable::XMLStream) {
+            // Read the file as a stream, the complete document is never kept in memory:
+            QXmlStreamReader reader(&file);
+            if (!reader.readNextStartElement()) {
+                LOG_TASK_ERROR_P(QString(tr("The tree input file could not be parsed by QXmlStreamReader. Error on line %1 column %2: %3")).arg(reader.lineNumber()).arg(reader.columnNumber()).arg(reader.errorString()),task);
+                file.close();
+                return false;
+            }
+
+            setExportTask(task);
+            success = importXmlStream(reader,import_list);
+            clearExportTask();
+            if (reader.hasError()) {
+                LOG_TASK_ERROR_P(QString(tr("The tree input file could not be parsed by QXmlStreamReader. Error on line %1 column %2: %3")).arg(reader.lineNumber()).arg(reader.columnNumber()).arg(reader.errorString()),task);
+                success = IExportable::Failed;
+            }
+            file.close();
+        } else {
+            // Load the file into doc:
+            QDomDocument doc("QtilitiesXMLProject");
+            QString docStr = file.readAll();
+            file.close();
+            QString error_string;
+            int error_line;
+            int error_column;
+            if (!doc.setContent(docStr,&error_string,&error_line,&error_column)) {
+                LOG_TASK_ERROR_P(QString(tr("The tree input file could not be parsed by QDomDocument. Error on line %1 column %2: %3")).arg(error_line).arg(error_column).arg(error_string),task);
+                return false;
+            }
+            QDomElement root = doc.documentElement();
+
+            // Interpret the loaded doc:
+            setExportTask(task);
+            success = importXml(&doc,&root,import_list);
+            clearExportTask();
+        }
         #ifdef QTILITIES_BENCHMARKING
         time(&end);
         double diff = difftime(end,start);
@@ -410,6 +638,7 @@ bool Qtilities::ProjectManagement::Project::loadProject(const QString& file_name
 
 bool Qtilities::ProjectManagement::Project::closeProject(ITask *task) {
     LOG_TASK_INFO_P(tr("Closing project: ") + d->project_file,task);
+    d->deferred_items.clear();
     for (int i = 0; i < d->project_items.count(); ++i) {
         d->project_items.at(i)->closeProjectItem(task);
     }
@@ -483,9 +712,103 @@ Qtilities::ProjectManagement::IProjectItem* Qtilities::ProjectManagement::Projec
     if (index < 0 || index >= d->project_items.count())
         return 0;
 
+    if (d->deferred_items.contains(d->project_items.at(index)->projectItemName()))
+        loadProjectItem(d->project_items.at(index)->projectItemName());
+
     return d->project_items.at(index);
 }
 
+bool Qtilities::ProjectManagement::Project::loadProjectItem(const QString& item_name, ITask* task) {
+    IProjectItem* item = 0;
+    for (int i = 0; i < d->project_items.count(); ++i) {
+        if (d->project_items.at(i)->projectItemName() == item_name) {
+            item = d->project_items.at(i);
+            break;
+        }
+    }
+    if (!item) {
+        LOG_TASK_ERROR(QString(tr("Failed to load project item \"%1\". The project does not contain this item.")).arg(item_name),task);
+        return false;
+    }
+
+    if (!d->project_file.endsWith(PROJECT_MANAGER->projectTypeSuffix(IExportable::Binary))) {
+        LOG_TASK_ERROR(QString(tr("Failed to load project item \"%1\". Single project items can only be loaded from binary project files.")).arg(item_name),task);
+        return false;
+    }
+
+    QFile file(d->project_file);
+    if (!file.open(QIODevice::ReadOnly)) {
+        LOG_TASK_ERROR(QString(tr("Failed to load project item \"%1\". The project file could not be opened: %2")).arg(item_name).arg(d->project_file),task);
+        return false;
+    }
+    QDataStream stream(&file);
+    if (exportVersion() == Qtilities::Qtilities_1_0 || exportVersion() == Qtilities::Qtilities_1_1 || exportVersion() == Qtilities::Qtilities_1_2)
+        stream.setVersion(QDataStream::Qt_4_7);
+
+    quint32 marker;
+    stream >> marker;
+    if (marker != MARKER_PROJECT_CONTAINER) {
+        LOG_TASK_ERROR(QString(tr("Failed to load project item \"%1\". The project file was saved in a format without project item sections.")).arg(item_name),task);
+        return false;
+    }
+
+    setExportTask(task);
+    ProjectContainerHeader header;
+    IExportable::ExportResultFlags result = readContainerHeader(stream,&header);
+    int section_index = -1;
+    for (int i = 0; i < header.sections.count(); ++i) {
+        if (header.sections.at(i).item_name == item_name) {
+            section_index = i;
+            break;
+        }
+    }
+
+    if (result != IExportable::Failed && section_index == -1) {
+        LOG_TASK_ERROR(QString(tr("Failed to load project item \"%1\". The project file does not contain a section for this item.")).arg(item_name),task);
+        result = IExportable::Failed;
+    }
+
+    if (result != IExportable::Failed) {
+        // Only the section of this item is read from the file:
+        const ProjectContainerSection& section = header.sections.at(section_index);
+        QByteArray data;
+        if (file.seek(header.sections_offset + section.offset))
+            data = file.read(section.length);
+        if (data.size() != section.length) {
+            LOG_TASK_ERROR(QString(tr("Failed to load project item \"%1\". Its section in the project file is truncated.")).arg(item_name),task);
+            result = IExportable::Failed;
+        } else {
+            // Clear the item first, this allows items which are already loaded to be reloaded:
+            if (!d->deferred_items.contains(item_name))
+                item->newProjectItem();
+
+            QList<QPointer<QObject> > import_list;
+            result = importContainerSection(data,section,header,stream.version(),item,import_list);
+        }
+    }
+    clearExportTask();
+    file.close();
+
+    if (result == IExportable::Failed) {
+        LOG_TASK_ERROR(QString(tr("Failed to load project item \"%1\" from file: %2")).arg(item_name).arg(d->project_file),task);
+        return false;
+    }
+
+    d->deferred_items.removeAll(item_name);
+    item->setModificationState(false,IModificationNotifier::NotifySubjects);
+    setModificationState(isModified(),IModificationNotifier::NotifyListeners);
+    LOG_TASK_INFO(QString(tr("Successfully loaded project item \"%1\" from file: %2")).arg(item_name).arg(d->project_file),task);
+    return true;
+}
+
+QStringList Qtilities::ProjectManagement::Project::deferredProjectItemNames() const {
+    return d->deferred_items;
+}
+
+QMap<QString,qint64> Qtilities::ProjectManagement::Project::projectItemSaveTimes() const {
+    return d->item_save_times;
+}
+
 bool Qtilities::ProjectManagement::Project::isModified() const {
     for (int i = 0; i < d->project_items.count(); ++i) {
         if (d->project_items.at(i)->isModified())
@@ -515,6 +838,17 @@ Qtilities::Core::Interfaces::IExportable::ExportModeFlags Qtilities::ProjectMana
     flags |= IExportable::Binary;
     flags |= IExportable::XML;
 
+    // The project is streamed when all of its items can be streamed:
+    bool all_items_stream = true;
+    for (int i = 0; i < d->project_items.count(); ++i) {
+        if (!(d->project_items.at(i)->supportedFormats() & IExportable::XMLStream)) {
+            all_items_stream = false;
+            break;
+        }
+    }
+    if (all_items_stream)
+        flags |= IExportable::XMLStream;
+
     return flags;
 }
 
@@ -522,60 +856,160 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::ProjectMa
     // ---------------------------------------------------
     // Save file format information:
     // ---------------------------------------------------
-    stream << MARKER_PROJECT_SECTION;
+    stream << MARKER_PROJECT_CONTAINER;
+    stream << PROJECT_CONTAINER_VERSION;
     stream << (quint32) exportVersion();
     stream << CoreGui::QtilitiesApplication::qtilitiesVersionString();
     stream << (quint32) applicationExportVersion();
     stream << QApplication::applicationVersion();
     stream << MARKER_PROJECT_SECTION;
 
-    stream << (quint32) d->project_items.count();
-    QStringList item_names;
-    for (int i = 0; i < d->project_items.count(); ++i) {
-        item_names << d->project_items.at(i)->projectItemName();
-    }
-    stream << item_names;
-
     // ---------------------------------------------------
-    // Do the actual export:
+    // Export each project item into its own section:
     // ---------------------------------------------------
     LOG_DEBUG(QString(tr("This project contains %1 project item(s).")).arg(d->project_items.count()));
     IExportable::ExportResultFlags success = IExportable::Complete;
+    QList<IProjectItem*> items;
     for (int i = 0; i < d->project_items.count(); ++i) {
-        if (d->project_items.at(i)->supportedFormats() & IExportable::Binary) {
-            LOG_DEBUG(QString(tr("Saving item %1: %2.")).arg(i).arg(d->project_items.at(i)->projectItemName()));
-            d->project_items.at(i)->setExportTask(exportTask());
-            IExportable::ExportResultFlags item_result = d->project_items.at(i)->exportBinary(stream);
-            d->project_items.at(i)->clearExportTask();
-
-            if (item_result == IExportable::Failed) {
-                success = item_result;
-                break;
-            }
-            if (item_result == IExportable::Incomplete && success == IExportable::Complete)
-                success = item_result;
-        } else {
+        if (!(d->project_items.at(i)->supportedFormats() & IExportable::Binary)) {
             success = IExportable::Incomplete;
             LOG_WARNING(QString(tr("Could not save project item %1: %2. This project item does not support binary exporting.")).arg(i).arg(d->project_items.at(i)->projectItemName()));
+            continue;
         }
+
+        LOG_DEBUG(QString(tr("Saving item %1: %2.")).arg(i).arg(d->project_items.at(i)->projectItemName()));
+        items << d->project_items.at(i);
     }
 
+    QList<ProjectContainerSection> sections;
+    QList<QByteArray> section_data;
+    IExportable::ExportResultFlags items_result = exportContainerSections(items,stream.version(),&sections,&section_data);
+    if (items_result == IExportable::Failed || (items_result == IExportable::Incomplete && success == IExportable::Complete))
+        success = items_result;
+
+    qint64 offset = 0;
+    for (int i = 0; i < sections.count(); ++i) {
+        sections[i].offset = offset;
+        offset += section_data.at(i).size();
+    }
+
+    if (success == IExportable::Failed)
+        return success;
+
+    // ---------------------------------------------------
+    // Save the table of contents, followed by the sections:
+    // ---------------------------------------------------
+    writeContainerSections(stream,sections);
+    stream << MARKER_PROJECT_SECTION;
+
+    for (int i = 0; i < section_data.count(); ++i)
+        stream.writeRawData(section_data.at(i).constData(),section_data.at(i).size());
+
     stream << MARKER_PROJECT_SECTION;
     return success;
 }
 
 Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::ProjectManagement::Project::importBinary(QDataStream& stream, QList<QPointer<QObject> >& import_list) {
-
     // ---------------------------------------------------
     // Inspect file format:
     // ---------------------------------------------------
     quint32 marker;
     stream >> marker;
-    if (marker != MARKER_PROJECT_SECTION) {
+    if (marker == MARKER_PROJECT_SECTION) {
+        // Project files saved before the container format was introduced:
+        return importBinaryMonolithic(stream,import_list);
+    } else if (marker != MARKER_PROJECT_CONTAINER) {
         LOG_ERROR(QString(tr("Failed to load project from. Missing project marker at beginning of file.")));
         return IExportable::Failed;
     }
 
+    ProjectContainerHeader header;
+    IExportable::ExportResultFlags header_result = readContainerHeader(stream,&header);
+    if (header_result == IExportable::Failed)
+        return IExportable::Failed;
+
+    // Sections can only be deferred when they can be read again later from the project file:
+    QFile* file = qobject_cast<QFile*> (stream.device());
+    bool can_defer = file && !file->isSequential() && QFileInfo(file->fileName()) == QFileInfo(d->project_file);
+    QStringList lazy_items = PROJECT_MANAGER->lazyProjectItems();
+    d->deferred_items.clear();
+
+    // ---------------------------------------------------
+    // Do the actual import:
+    // ---------------------------------------------------
+    // Files which were saved incrementally must be read using their last table of contents, which
+    // requires random access. Sequential devices read the sections in the order they were saved.
+    bool random_access = stream.device() && !stream.device()->isSequential();
+    qint64 read_offset = 0;
+
+    LOG_DEBUG(QString(tr("This project contains %1 project item(s).")).arg(header.sections.count()));
+    // The project is incomplete when it was recovered from an interrupted incremental save:
+    IExportable::ExportResultFlags success = header_result;
+    for (int i = 0; i < header.sections.count(); ++i) {
+        const ProjectContainerSection& section = header.sections.at(i);
+        IProjectItem* item = 0;
+        for (int p = 0; p < d->project_items.count(); ++p) {
+            if (d->project_items.at(p)->projectItemName() == section.item_name) {
+                item = d->project_items.at(p);
+                break;
+            }
+        }
+
+        if (!item) {
+            LOG_WARNING(QString(tr("Input file contains a project item \"%1\" which does not exist in your application. Import will be incomplete.")).arg(section.item_name));
+            success = IExportable::Incomplete;
+            if (!random_access) {
+                stream.skipRawData((int) section.length);
+                read_offset += section.length;
+            }
+            continue;
+        }
+
+        if (can_defer && lazy_items.contains(section.item_name)) {
+            LOG_DEBUG(QString(tr("Deferring loading of item %1: %2.")).arg(i).arg(section.item_name));
+            d->deferred_items << section.item_name;
+            continue;
+        }
+
+        bool positioned = true;
+        if (random_access)
+            positioned = stream.device()->seek(header.sections_offset + section.offset);
+        else
+            positioned = (section.offset == read_offset);
+
+        QByteArray data((int) section.length,0);
+        if (!positioned || stream.readRawData(data.data(),(int) section.length) != section.length) {
+            LOG_ERROR(QString(tr("Failed to load project. The section of project item \"%1\" is truncated.")).arg(section.item_name));
+            success = IExportable::Failed;
+            break;
+        }
+
+        read_offset += section.length;
+
+        LOG_DEBUG(QString(tr("Loading item %1: %2.")).arg(i).arg(section.item_name));
+        IExportable::ExportResultFlags item_result = importContainerSection(data,section,header,stream.version(),item,import_list);
+        if (item_result == IExportable::Failed) {
+            success = item_result;
+            break;
+        }
+        if (item_result == IExportable::Incomplete && success == IExportable::Complete)
+            success = item_result;
+    }
+
+    if (success != IExportable::Failed && !random_access) {
+        stream >> marker;
+        if (marker != MARKER_PROJECT_SECTION)
+            success = IExportable::Failed;
+    }
+
+    return success;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::ProjectManagement::Project::importBinaryMonolithic(QDataStream& stream, QList<QPointer<QObject> >& import_list) {
+    // ---------------------------------------------------
+    // Inspect file format:
+    // ---------------------------------------------------
+    quint32 marker;
     stream >> marker;
     Qtilities::ExportVersion read_version = (Qtilities::ExportVersion) marker;
     LOG_INFO(QString(tr("Inspecting project file format: Qtilities export format version: %1")).arg(marker));
@@ -661,6 +1095,390 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::ProjectMa
     return success;
 }
 
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::ProjectManagement::Project::readContainerHeader(QDataStream& stream, ProjectContainerHeader* header) const {
+    quint32 container_version;
+    stream >> container_version;
+    if (container_version > PROJECT_CONTAINER_VERSION) {
+        LOG_ERROR(QString(tr("Unsupported project container version found: %1. The project file will not be parsed.")).arg(container_version));
+        return IExportable::Failed;
+    }
+
+    quint32 marker;
+    stream >> marker;
+    header->export_version = (Qtilities::ExportVersion) marker;
+    LOG_INFO(QString(tr("Inspecting project file format: Qtilities export format version: %1")).arg(marker));
+    QString qtilities_version;
+    stream >> qtilities_version;
+    LOG_INFO(QString(tr("Inspecting project file format: Qtilities version used to save the file: %1")).arg(qtilities_version));
+
+    stream >> header->application_export_version;
+    LOG_INFO(QString(tr("Inspecting project file format: Application export format version: %1")).arg(header->application_export_version));
+    QString application_version;
+    stream >> application_version;
+    LOG_INFO(QString(tr("Inspecting project file format: Application version used to save the file: %1")).arg(application_version));
+
+    stream >> marker;
+    if (marker != MARKER_PROJECT_SECTION) {
+        LOG_ERROR(QString(tr("Failed to load project. Missing project marker after the file format information.")));
+        return IExportable::Failed;
+    }
+
+    if (header->export_version < Qtilities::Qtilities_1_0 || header->export_version > Qtilities::Qtilities_Latest) {
+        LOG_ERROR(QString(tr("Unsupported project file found with export version: %1. The project file will not be parsed.")).arg(header->export_version));
+        return IExportable::Failed;
+    }
+
+    // ---------------------------------------------------
+    // Read the table of contents:
+    // ---------------------------------------------------
+    if (!readContainerSections(stream,&header->sections)) {
+        LOG_ERROR(QString(tr("Failed to load project. The table of contents of the project file is corrupt.")));
+        return IExportable::Failed;
+    }
+
+    stream >> marker;
+    if (marker != MARKER_PROJECT_SECTION) {
+        LOG_ERROR(QString(tr("Failed to load project. Missing project marker after the table of contents.")));
+        return IExportable::Failed;
+    }
+
+    QIODevice* device = stream.device();
+    header->sections_offset = device ? device->pos() : -1;
+    if (!device || device->isSequential())
+        return IExportable::Complete;
+
+    // ---------------------------------------------------
+    // Use the table of contents appended by the last incremental save, if any:
+    // ---------------------------------------------------
+    // A file which was never saved incrementally ends with MARKER_PROJECT_SECTION right after its sections:
+    qint64 sections_end = header->sections_offset;
+    for (int i = 0; i < header->sections.count(); ++i)
+        sections_end = qMax(sections_end,header->sections_offset + header->sections.at(i).offset + header->sections.at(i).length);
+    if (device->size() == sections_end + (qint64) sizeof(quint32)) {
+        device->seek(sections_end);
+        stream >> marker;
+        if (marker == MARKER_PROJECT_SECTION) {
+            stream.resetStatus();
+            device->seek(header->sections_offset);
+            return IExportable::Complete;
+        }
+    }
+
+    // Otherwise the file must end with the trailer of a valid appendix. When it does not, the last incremental save was
+    // interrupted and the file is read using the last appendix which was completely written, or the table of contents in
+    // the header when no such appendix exists.
+    IExportable::ExportResultFlags result = IExportable::Complete;
+    QList<ProjectContainerSection> appended_sections;
+    qint64 appendix_position = readContainerAppendix(stream,device->size() - PROJECT_CONTAINER_TRAILER_SIZE,header->sections_offset,&appended_sections);
+    if (appendix_position < 0) {
+        LOG_TASK_ERROR(QString(tr("The project file does not end with a valid table of contents, the last save to it was interrupted. Recovering the last completely saved version of the project.")),exportTask());
+        appendix_position = findContainerAppendix(stream,device->size(),header->sections_offset,&appended_sections);
+        result = IExportable::Incomplete;
+    }
+    if (appendix_position >= 0) {
+        header->sections = appended_sections;
+        header->appendix_position = appendix_position;
+    }
+
+    stream.resetStatus();
+    device->seek(header->sections_offset);
+    return result;
+}
+
+qint64 Qtilities::ProjectManagement::Project::readContainerAppendix(QDataStream& stream, qint64 trailer_position, qint64 sections_offset, QList<ProjectContainerSection>* sections) const {
+    // An appendix consists of MARKER_PROJECT_APPENDIX, the position of the previous appendix (-1 when there is none) and the
+    // table of contents, followed by the checksum of these and the trailer: the position of the appendix and MARKER_PROJECT_APPENDIX.
+    QIODevice* device = stream.device();
+    if (trailer_position < sections_offset + (qint64) sizeof(quint16) || !device->seek(trailer_position - (qint64) sizeof(quint16)))
+        return -1;
+
+    quint16 checksum;
+    qint64 appendix_position;
+    quint32 marker;
+    stream >> checksum;
+    stream >> appendix_position;
+    stream >> marker;
+    if (stream.status() != QDataStream::Ok || marker != MARKER_PROJECT_APPENDIX) {
+        stream.resetStatus();
+        return -1;
+    }
+    if (appendix_position < sections_offset || appendix_position > trailer_position - (qint64) sizeof(quint16) || !device->seek(appendix_position))
+        return -1;
+
+    qint64 appendix_size = trailer_position - (qint64) sizeof(quint16) - appendix_position;
+    QByteArray appendix = device->read(appendix_size);
+    if (appendix.size() != appendix_size || qChecksum(appendix.constData(),appendix.size()) != checksum)
+        return -1;
+
+    QDataStream appendix_stream(appendix);
+    appendix_stream.setVersion(stream.version());
+    qint64 previous_position;
+    appendix_stream >> marker;
+    appendix_stream >> previous_position;
+    if (marker != MARKER_PROJECT_APPENDIX || (previous_position != -1 && (previous_position < sections_offset || previous_position >= appendix_position)))
+        return -1;
+    QList<ProjectContainerSection> appended_sections;
+    if (!readContainerSections(appendix_stream,&appended_sections) || !appendix_stream.atEnd())
+        return -1;
+
+    // All sections must have been written before the appendix which lists them:
+    for (int i = 0; i < appended_sections.count(); ++i) {
+        if (sections_offset + appended_sections.at(i).offset + appended_sections.at(i).length > appendix_position)
+            return -1;
+    }
+
+    *sections = appended_sections;
+    return appendix_position;
+}
+
+qint64 Qtilities::ProjectManagement::Project::findContainerAppendix(QDataStream& stream, qint64 end, qint64 sections_offset, QList<ProjectContainerSection>* sections) const {
+    QByteArray marker_bytes;
+    QDataStream marker_stream(&marker_bytes,QIODevice::WriteOnly);
+    marker_stream.setByteOrder(stream.byteOrder());
+    marker_stream << MARKER_PROJECT_APPENDIX;
+
+    // Search backwards through the file in chunks which overlap, thus markers spanning two chunks are found as well:
+    QIODevice* device = stream.device();
+    const qint64 chunk_size = 64 * 1024;
+    qint64 chunk_end = end;
+    while (chunk_end > sections_offset) {
+        qint64 chunk_start = qMax(sections_offset,chunk_end - chunk_size);
+        if (!device->seek(chunk_start))
+            return -1;
+        QByteArray chunk = device->read(chunk_end - chunk_start);
+        int index = chunk.size();
+        while (index > 0 && (index = chunk.lastIndexOf(marker_bytes,index - 1)) >= 0) {
+            // The marker ends the trailer when it is preceded by the position of its appendix:
+            qint64 trailer_position = chunk_start + index - (qint64) sizeof(qint64);
+            if (trailer_position >= sections_offset) {
+                qint64 appendix_position = readContainerAppendix(stream,trailer_position,sections_offset,sections);
+                if (appendix_position >= 0)
+                    return appendix_position;
+            }
+        }
+        if (chunk_start == sections_offset)
+            break;
+        chunk_end = chunk_start + marker_bytes.size() - 1;
+    }
+    return -1;
+}
+
+bool Qtilities::ProjectManagement::Project::readContainerSections(QDataStream& stream, QList<ProjectContainerSection>* sections) const {
+    quint32 section_count;
+    stream >> section_count;
+    sections->clear();
+    for (quint32 i = 0; i < section_count; ++i) {
+        ProjectContainerSection section;
+        stream >> section.item_name;
+        stream >> section.offset;
+        stream >> section.length;
+        stream >> section.checksum;
+        stream >> section.compressed;
+        if (stream.status() != QDataStream::Ok || section.offset < 0 || section.length < 0 || section.length > INT_MAX)
+            return false;
+        *sections << section;
+    }
+    return true;
+}
+
+void Qtilities::ProjectManagement::Project::writeContainerSections(QDataStream& stream, const QList<ProjectContainerSection>& sections) const {
+    stream << (quint32) sections.count();
+    for (int i = 0; i < sections.count(); ++i) {
+        stream << sections.at(i).item_name;
+        stream << sections.at(i).offset;
+        stream << sections.at(i).length;
+        stream << sections.at(i).checksum;
+        stream << sections.at(i).compressed;
+    }
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::ProjectManagement::Project::exportContainerSections(const QList<IProjectItem*>& items, int stream_version, QList<ProjectContainerSection>* sections, QList<QByteArray>* data) const {
+    // Items which support concurrent exports are exported on the global thread pool while the rest are exported in this thread:
+    ParallelExport parallel_export(stream_version,exportTask());
+    for (int i = 0; i < items.count(); ++i)
+        parallel_export.addPart(new ProjectItemExportPart(items.at(i)));
+
+    if (!parallel_export.exportParts()) {
+        LOG_TASK_WARNING(tr("Saving of project items was cancelled."),exportTask());
+        return IExportable::Failed;
+    }
+
+    IExportable::ExportResultFlags result = IExportable::Complete;
+    for (int i = 0; i < parallel_export.partCount(); ++i) {
+        ProjectItemExportPart* part = static_cast<ProjectItemExportPart*> (parallel_export.part(i));
+        IExportable::ExportResultFlags part_result = parallel_export.partResult(i);
+        if (part_result == IExportable::Failed) {
+            LOG_TASK_ERROR(QString(tr("Failed to save project item: %1.")).arg(part->item()->projectItemName()),exportTask());
+            return IExportable::Failed;
+        }
+        if (part_result == IExportable::Incomplete)
+            result = IExportable::Incomplete;
+
+        ProjectContainerSection section;
+        QByteArray part_data = parallel_export.partData(i);
+        section.item_name = part->item()->projectItemName();
+        section.compressed = part->compressed();
+        section.offset = 0;
+        section.length = part_data.size();
+        section.checksum = qChecksum(part_data.constData(),part_data.size());
+
+        d->item_save_times[section.item_name] = part->elapsed();
+        *sections << section;
+        *data << part_data;
+    }
+
+    return result;
+}
+
+bool Qtilities::ProjectManagement::Project::saveProjectIncremental(ITask* task) {
+    QFile file(d->project_file);
+    if (!file.exists() || !file.open(QIODevice::ReadWrite))
+        return false;
+
+    QDataStream stream(&file);
+    if (exportVersion() == Qtilities::Qtilities_1_0 || exportVersion() == Qtilities::Qtilities_1_1 || exportVersion() == Qtilities::Qtilities_1_2)
+        stream.setVersion(QDataStream::Qt_4_7);
+
+    quint32 marker;
+    stream >> marker;
+    if (marker != MARKER_PROJECT_CONTAINER)
+        return false;
+
+    ProjectContainerHeader header;
+    IExportable::setExportTask(task);
+    IExportable::ExportResultFlags header_result = readContainerHeader(stream,&header);
+    IExportable::clearExportTask();
+    // Files which were recovered from an interrupted save are compacted by saving the complete project:
+    if (header_result != IExportable::Complete)
+        return false;
+
+    // Sections can only be reused when they were saved in the same format:
+    if (header.export_version != exportVersion() || header.application_export_version != applicationExportVersion())
+        return false;
+
+    // Compact the file by saving the complete project when most of it is taken up by replaced sections:
+    qint64 live_size = 0;
+    for (int i = 0; i < header.sections.count(); ++i)
+        live_size += header.sections.at(i).length;
+    qint64 sections_size = file.size() - header.sections_offset;
+    if (sections_size > PROJECT_CONTAINER_COMPACTION_FACTOR * live_size + PROJECT_CONTAINER_COMPRESSION_THRESHOLD) {
+        LOG_TASK_INFO(tr("Compacting project file: ") + d->project_file,task);
+        return false;
+    }
+
+    // Every project item must already have a section in the file:
+    QList<int> modified_items;
+    QList<int> modified_sections;
+    for (int i = 0; i < d->project_items.count(); ++i) {
+        int section_index = -1;
+        for (int s = 0; s < header.sections.count(); ++s) {
+            if (header.sections.at(s).item_name == d->project_items.at(i)->projectItemName()) {
+                section_index = s;
+                break;
+            }
+        }
+        if (section_index == -1 || !(d->project_items.at(i)->supportedFormats() & IExportable::Binary))
+            return false;
+
+        if (d->project_items.at(i)->isModified()) {
+            modified_items << i;
+            modified_sections << section_index;
+        }
+    }
+
+    if (modified_items.isEmpty()) {
+        LOG_TASK_INFO(tr("No project items were modified, nothing needs to be saved to file: ") + d->project_file,task);
+        return true;
+    }
+
+    // ---------------------------------------------------
+    // Append the sections of modified items, followed by a new table of contents:
+    // ---------------------------------------------------
+    // Appending to the project file in place is safe since nothing in front of original_size is changed, and the new sections
+    // only become visible through the appendix listing them. The sections are synced to disk before this appendix is written,
+    // thus the appendix never refers to data which is not on disk yet. When the save is interrupted the file does not end with
+    // a valid appendix, and readContainerHeader() falls back to the previous appendix, which the new appendix links to.
+    qint64 original_size = file.size();
+    file.seek(original_size);
+    qint64 offset = original_size - header.sections_offset;
+    bool success = true;
+    QList<IProjectItem*> items;
+    for (int i = 0; i < modified_items.count(); ++i) {
+        LOG_DEBUG(QString(tr("Saving modified item %1: %2.")).arg(modified_items.at(i)).arg(d->project_items.at(modified_items.at(i))->projectItemName()));
+        items << d->project_items.at(modified_items.at(i));
+    }
+
+    QList<ProjectContainerSection> sections;
+    QList<QByteArray> section_data;
+    IExportable::setExportTask(task);
+    if (exportContainerSections(items,stream.version(),&sections,&section_data) != IExportable::Complete)
+        success = false;
+    IExportable::clearExportTask();
+
+    for (int i = 0; success && i < sections.count(); ++i) {
+        sections[i].offset = offset;
+        offset += section_data.at(i).size();
+        header.sections[modified_sections.at(i)] = sections.at(i);
+        stream.writeRawData(section_data.at(i).constData(),section_data.at(i).size());
+    }
+
+    if (success)
+        success = (stream.status() == QDataStream::Ok) && syncFileToDisk(&file);
+
+    if (success) {
+        qint64 appendix_position = file.pos();
+        QByteArray appendix;
+        QDataStream appendix_stream(&appendix,QIODevice::WriteOnly);
+        appendix_stream.setVersion(stream.version());
+        appendix_stream << MARKER_PROJECT_APPENDIX;
+        appendix_stream << header.appendix_position;
+        writeContainerSections(appendix_stream,header.sections);
+
+        stream.writeRawData(appendix.constData(),appendix.size());
+        stream << qChecksum(appendix.constData(),appendix.size());
+        stream << appendix_position;
+        stream << MARKER_PROJECT_APPENDIX;
+        success = (stream.status() == QDataStream::Ok) && syncFileToDisk(&file);
+    }
+
+    if (!success) {
+        // Leave the file as it was before this save:
+        file.resize(original_size);
+        syncFileToDisk(&file);
+        return false;
+    }
+
+    LOG_TASK_INFO(QString(tr("Saved %1 of %2 project item(s) incrementally.")).arg(modified_items.count()).arg(d->project_items.count()),task);
+    return true;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::ProjectManagement::Project::importContainerSection(const QByteArray& data, const ProjectContainerSection& section, const ProjectContainerHeader& header, int stream_version, IProjectItem* item, QList<QPointer<QObject> >& import_list) {
+    if (qChecksum(data.constData(),data.size()) != section.checksum) {
+        LOG_ERROR(QString(tr("Failed to load project item \"%1\". The checksum of its section does not match.")).arg(section.item_name));
+        return IExportable::Failed;
+    }
+
+    QByteArray item_data = section.compressed ? qUncompress(data) : data;
+    if (section.compressed && item_data.isEmpty()) {
+        LOG_ERROR(QString(tr("Failed to load project item \"%1\". Its section could not be decompressed.")).arg(section.item_name));
+        return IExportable::Failed;
+    }
+
+    if (!(item->supportedFormats() & IExportable::Binary)) {
+        LOG_WARNING(QString(tr("Could not load project item %1. This project item does not support binary importing.")).arg(section.item_name));
+        return IExportable::Incomplete;
+    }
+
+    QDataStream section_stream(item_data);
+    section_stream.setVersion(stream_version);
+    item->setExportVersion(header.export_version);
+    item->setApplicationExportVersion(header.application_export_version);
+    item->setExportTask(exportTask());
+    IExportable::ExportResultFlags result = item->importBinary(section_stream,import_list);
+    item->clearExportTask();
+    return result;
+}
+
 Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::ProjectManagement::Project::exportXml(QDomDocument* doc, QDomElement* object_node) const {
     // ---------------------------------------------------
     // Save file format information:
@@ -680,9 +1498,12 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::ProjectMa
         QDomElement itemRoot = doc->createElement("ProjectItem_" + QString::number(i));
         itemRoot.setAttribute("Name",name);
         object_node->appendChild(itemRoot);
+        QElapsedTimer timer;
+        timer.start();
         d->project_items.at(i)->setExportTask(exportTask());
         IExportable::ExportResultFlags item_result = d->project_items.at(i)->exportXml(doc,&itemRoot);
         d->project_items.at(i)->clearExportTask();
+        d->item_save_times[name] = timer.elapsed();
         if (item_result == IExportable::Failed) {
             success = item_result;
             break;
@@ -796,3 +1617,132 @@ Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::ProjectMa
 
     return success;
 }
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::ProjectManagement::Project::exportXmlStream(QXmlStreamWriter& writer) const {
+    // ---------------------------------------------------
+    // Save file format information:
+    // ---------------------------------------------------
+    writer.writeAttribute("ExportVersion",QString::number(exportVersion()));
+    writer.writeAttribute("QtilitiesVersion",CoreGui::QtilitiesApplication::qtilitiesVersionString());
+    writer.writeAttribute("ApplicationExportVersion",QString::number(applicationExportVersion()));
+    writer.writeAttribute("ApplicationVersion",QApplication::applicationVersion());
+    writer.writeAttribute("ApplicationName",QApplication::applicationName());
+
+    // ---------------------------------------------------
+    // Do the actual export:
+    // ---------------------------------------------------
+    IExportable::ExportResultFlags success = IExportable::Complete;
+    for (int i = 0; i < d->project_items.count(); ++i) {
+        writer.writeStartElement("ProjectItem_" + QString::number(i));
+        writer.writeAttribute("Name",d->project_items.at(i)->projectItemName());
+        QElapsedTimer timer;
+        timer.start();
+        d->project_items.at(i)->setExportTask(exportTask());
+        IExportable::ExportResultFlags item_result = d->project_items.at(i)->exportXmlStream(writer);
+        d->project_items.at(i)->clearExportTask();
+        d->item_save_times[d->project_items.at(i)->projectItemName()] = timer.elapsed();
+        writer.writeEndElement();
+        if (item_result == IExportable::Failed) {
+            success = item_result;
+            break;
+        }
+        if (item_result == IExportable::Incomplete && success == IExportable::Complete)
+            success = item_result;
+    }
+
+    return success;
+}
+
+Qtilities::Core::Interfaces::IExportable::ExportResultFlags Qtilities::ProjectManagement::Project::importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list) {
+    // ---------------------------------------------------
+    // Inspect file format:
+    // ---------------------------------------------------
+    QXmlStreamAttributes attributes = reader.attributes();
+    Qtilities::ExportVersion read_version;
+    if (attributes.hasAttribute("ExportVersion")) {
+        read_version = (Qtilities::ExportVersion) attributes.value("ExportVersion").toString().toInt();
+        LOG_TASK_INFO(QString(tr("Inspecting project file format: Qtilities export format version: %1")).arg(read_version),exportTask());
+    } else {
+        LOG_TASK_ERROR(QString(tr("The export version of the input file could not be determined. This might indicate that the input file is in the wrong format. The project file will not be parsed.")),exportTask());
+        QApplication::restoreOverrideCursor();
+        return IExportable::Failed;
+    }
+    if (attributes.hasAttribute("QtilitiesVersion"))
+        LOG_TASK_INFO(QString(tr("Inspecting project file format: Qtilities version used to save the file: %1")).arg(attributes.value("QtilitiesVersion").toString()),exportTask());
+    quint32 application_read_version = 0;
+    if (attributes.hasAttribute("ApplicationExportVersion")) {
+        application_read_version = attributes.value("ApplicationExportVersion").toString().toInt();
+        LOG_TASK_INFO(QString(tr("Inspecting project file format: Application export format version: %1")).arg(application_read_version),exportTask());
+    } else {
+        LOG_TASK_ERROR(QString(tr("The application export version of the input file could not be determined. This might indicate that the input file is in the wrong format. The project file will not be parsed.")),exportTask());
+        QApplication::restoreOverrideCursor();
+        return IExportable::Failed;
+    }
+    if (attributes.hasAttribute("ApplicationVersion"))
+        LOG_TASK_INFO(QString(tr("Inspecting project file format: Application version used to save the file: %1")).arg(attributes.value("ApplicationVersion").toString()),exportTask());
+
+    // ---------------------------------------------------
+    // Check if input format is supported:
+    // ---------------------------------------------------
+    IExportable::ExportResultFlags version_check_result = IExportable::validateQtilitiesExportVersion(read_version,exportTask());
+    if (version_check_result != IExportable::VersionSupported) {
+        LOG_TASK_ERROR(QString(tr("Unsupported project file found with export version: %1. The project file will not be parsed.")).arg(read_version),exportTask());
+        return IExportable::Failed;
+    }
+
+    bool found_project_item = false;
+
+    // ---------------------------------------------------
+    // Do the actual import:
+    // ---------------------------------------------------
+    IExportable::ExportResultFlags success = IExportable::Complete;
+    while (reader.readNextStartElement()) {
+        if (!reader.name().toString().startsWith("ProjectItem_")) {
+            reader.skipCurrentElement();
+            continue;
+        }
+
+        found_project_item = true;
+        QString item_name = reader.attributes().value("Name").toString();
+        if (item_name.isEmpty()) {
+            LOG_TASK_WARNING(tr("Nameless project item found in input file. This item will be skipped."),exportTask());
+            reader.skipCurrentElement();
+            continue;
+        }
+        LOG_TASK_TRACE("Found project item in import file with name: " + item_name,exportTask());
+
+        // Now get the project item with name item_name:
+        IProjectItem* item_iface = 0;
+        for (int i = 0; i < d->project_items.count(); ++i) {
+            if (d->project_items.at(i)->projectItemName() == item_name) {
+                item_iface = d->project_items.at(i);
+                break;
+            }
+        }
+
+        if (!item_iface) {
+            LOG_TASK_WARNING(QString(tr("Input file contains a project item \"%1\" which does not exist in your application. Import will be incomplete.")).arg(item_name),exportTask());
+            if (success != IExportable::Failed)
+                success = IExportable::Incomplete;
+            reader.skipCurrentElement();
+            continue;
+        }
+
+        item_iface->setExportVersion(read_version);
+        item_iface->setApplicationExportVersion(application_read_version);
+        item_iface->setExportTask(exportTask());
+        success = item_iface->importXmlStream(reader,import_list);
+        item_iface->clearExportTask();
+
+        if (success & IExportable::FailedResult) {
+            LOG_TASK_ERROR(tr("Project item \"") + item_name + tr("\" failed during import."),exportTask());
+            success = IExportable::Incomplete;
+            break;
+        }
+    }
+
+    if (!found_project_item)
+        LOG_TASK_WARNING(tr("No project items found in project file."),exportTask());
+
+    return success;
+}
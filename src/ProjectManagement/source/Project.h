@@ -18,6 +18,7 @@
 #include <Logger>
 
 #include <QObject>
+#include <QMap>
 
 namespace Qtilities {
     namespace ProjectManagement {
@@ -28,6 +29,16 @@ namespace Qtilities {
           \brief The ProjectPrivateData class stores private data used by the Project class.
          */
         struct ProjectPrivateData;
+        /*!
+          \struct ProjectContainerSection
+          \brief The ProjectContainerSection struct describes the section of a single project item in a binary project file.
+         */
+        struct ProjectContainerSection;
+        /*!
+          \struct ProjectContainerHeader
+          \brief The ProjectContainerHeader struct stores the file format information and table of contents of a binary project file.
+         */
+        struct ProjectContainerHeader;
 
         /*!
           \class Project
@@ -35,6 +46,39 @@ namespace Qtilities {
 
           When creating a new project using the ProjectManager class it will create an instance of this class
           and set it as the current open project.
+
+          \section project_binary_container Binary Project Files
+
+          Binary project files start with a table of contents listing the name, offset, length, checksum and compression flag of each
+          project item, followed by one independently decodable section per project item. Sections are compressed using qCompress()
+          when this makes them smaller. Project items are matched to sections using their names, thus the order of the project items
+          does not need to match the order in which they were saved. Project files saved by earlier versions of %Qtilities, which do
+          not contain a table of contents, can still be loaded.
+
+          Loading of the project items listed in ProjectManager::lazyProjectItems() is deferred when a binary project file is opened.
+          A deferred item is loaded the first time it is accessed through projectItem(), when loadProjectItem() is called on it, or
+          before the project is saved. loadProjectItem() can also be used to reload a single item from the project file without
+          reloading the complete project.
+
+          When ProjectManager::incrementalProjectSaving() is enabled and the project is saved to its current binary project file,
+          only the sections of modified project items are appended to the file, followed by a new table of contents. Unmodified
+          and deferred project items are not saved again. The appended sections are synced to disk before the table of contents
+          which lists them is written, and each appended table of contents is protected by a checksum and refers to the previous one.
+          When an incremental save is interrupted, an error is logged when the file is loaded and the project is loaded from the last
+          table of contents which was written completely. The complete project is saved instead when the file was saved by a
+          different export version, when a project item does not have a section in the file yet, when the last incremental save was
+          interrupted, or when replaced sections take up most of the file, which compacts it. The time it took to save each project
+          item is available through projectItemSaveTimes().
+
+          \section project_saving Saving Project Files
+
+          Projects are written to a new file in the same directory as the project file, which is synced to disk and renamed to the
+          project file once the complete project was written. Thus the project file is never partially written, and a failed save leaves
+          the previous version in place. When ProjectManager::projectFileBackups() is enabled, the previous version is first backed up
+          to a \p .bak file using a hard link, or a copy where hard links are not supported. The project file is not moved out of the
+          way to do this, and when the new version can not be put in its place the previous version is restored from the backup if the
+          project file was lost. When project file locks are used, the project file is locked before it is written and stays locked while
+          the new version is renamed into place.
          */
         class PROJECT_MANAGEMENT_SHARED_EXPORT Project : public QObject, public IProject, public IExportable
         {
@@ -63,6 +107,36 @@ namespace Qtilities {
             int projectItemCount() const;
             IProjectItem* projectItem(int index);
 
+            // --------------------------------------------
+            // Project Implementation
+            // --------------------------------------------
+            //! Loads a single project item from its section in the current binary project file.
+            /*!
+              When the item was deferred it is loaded for the first time, otherwise the item is cleared using IProjectItem::newProjectItem()
+              and reloaded from the project file.
+
+              \returns True when the item was loaded successfully, false otherwise.
+
+              \sa deferredProjectItemNames(), ProjectManager::setLazyProjectItems()
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            bool loadProjectItem(const QString& item_name, ITask* task = 0);
+            //! Returns the names of the project items of which loading was deferred and which are not loaded yet.
+            /*!
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            QStringList deferredProjectItemNames() const;
+            //! Returns the time in milliseconds it took to save each project item during the last save, with project item names as keys.
+            /*!
+              Project items which were not saved, for example unmodified project items during an incremental save, are not included.
+
+              \sa ProjectManager::setIncrementalProjectSaving()
+
+              <i>This function was added in %Qtilities v1.5.</i>
+              */
+            QMap<QString,qint64> projectItemSaveTimes() const;
+
             // --------------------------------
             // IModificationNotifier Implementation
             // --------------------------------
@@ -81,6 +155,8 @@ namespace Qtilities {
             IExportable::ExportResultFlags importBinary(QDataStream& stream, QList<QPointer<QObject> >& import_list);
             IExportable::ExportResultFlags exportXml(QDomDocument* doc, QDomElement* object_node) const;
             IExportable::ExportResultFlags importXml(QDomDocument* doc, QDomElement* object_node, QList<QPointer<QObject> >& import_list);
+            IExportable::ExportResultFlags exportXmlStream(QXmlStreamWriter& writer) const;
+            IExportable::ExportResultFlags importXmlStream(QXmlStreamReader& reader, QList<QPointer<QObject> >& import_list);
 
             // --------------------------------
             // IObjectBase Implementation
@@ -89,6 +165,25 @@ namespace Qtilities {
             const QObject* objectBase() const { return this; }
 
         private:
+            //! Imports a binary project file saved before project item sections were introduced.
+            IExportable::ExportResultFlags importBinaryMonolithic(QDataStream& stream, QList<QPointer<QObject> >& import_list);
+            //! Reads the file format information and table of contents of a binary project file, following the container marker.
+            IExportable::ExportResultFlags readContainerHeader(QDataStream& stream, ProjectContainerHeader* header) const;
+            //! Reads the appendix of an incremental save of which the trailer starts at \p trailer_position. Returns the position of the appendix, or -1 when it is not valid.
+            qint64 readContainerAppendix(QDataStream& stream, qint64 trailer_position, qint64 sections_offset, QList<ProjectContainerSection>* sections) const;
+            //! Searches backwards from \p end for the last valid appendix of an incremental save. Returns the position of the appendix, or -1 when none was found.
+            qint64 findContainerAppendix(QDataStream& stream, qint64 end, qint64 sections_offset, QList<ProjectContainerSection>* sections) const;
+            //! Reads a table of contents of a binary project file.
+            bool readContainerSections(QDataStream& stream, QList<ProjectContainerSection>* sections) const;
+            //! Writes a table of contents of a binary project file.
+            void writeContainerSections(QDataStream& stream, const QList<ProjectContainerSection>& sections) const;
+            //! Exports each project item in \p items into its own, possibly compressed, section. Items which support concurrent exports are exported in parallel.
+            IExportable::ExportResultFlags exportContainerSections(const QList<IProjectItem*>& items, int stream_version, QList<ProjectContainerSection>* sections, QList<QByteArray>* data) const;
+            //! Appends the sections of modified project items to the current binary project file. Returns false when the complete project must be saved instead.
+            bool saveProjectIncremental(ITask* task);
+            //! Verifies, decompresses and imports the section of a single project item.
+            IExportable::ExportResultFlags importContainerSection(const QByteArray& data, const ProjectContainerSection& section, const ProjectContainerHeader& header, int stream_version, IProjectItem* item, QList<QPointer<QObject> >& import_list);
+
             ProjectPrivateData* d;
         };
     }
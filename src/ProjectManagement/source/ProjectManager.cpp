@@ -37,6 +37,8 @@ struct Qtilities::ProjectManagement::ProjectManagerPrivateData  {
         current_project_busy_count(0),
         open_last_project(false),
         use_project_file_locks(true),
+        incremental_project_saving(false),
+        project_file_backups(false),
         default_custom_project_paths_category( QObject::tr("Default")),
         is_initialized(false),
         project_types(IExportable::Binary | IExportable::XML),
@@ -59,6 +61,9 @@ struct Qtilities::ProjectManagement::ProjectManagerPrivateData  {
     QPointer<ProjectManagementConfig>       config_widget;
     bool                                    open_last_project;
     bool                                    use_project_file_locks;
+    QStringList                             lazy_project_items;
+    bool                                    incremental_project_saving;
+    bool                                    project_file_backups;
     bool                                    auto_create_new_project;
     bool                                    use_custom_projects_paths;
     // Keys = Categories, Values = Paths
@@ -616,6 +621,30 @@ bool ProjectManagement::ProjectManager::useProjectFileLocks() const {
     return d->use_project_file_locks;
 }
 
+void ProjectManagement::ProjectManager::setLazyProjectItems(const QStringList& item_names) {
+    d->lazy_project_items = item_names;
+}
+
+QStringList ProjectManagement::ProjectManager::lazyProjectItems() const {
+    return d->lazy_project_items;
+}
+
+void ProjectManagement::ProjectManager::setIncrementalProjectSaving(bool toggle) {
+    d->incremental_project_saving = toggle;
+}
+
+bool ProjectManagement::ProjectManager::incrementalProjectSaving() const {
+    return d->incremental_project_saving;
+}
+
+void ProjectManagement::ProjectManager::setProjectFileBackups(bool toggle) {
+    d->project_file_backups = toggle;
+}
+
+bool ProjectManagement::ProjectManager::projectFileBackups() const {
+    return d->project_file_backups;
+}
+
 void Qtilities::ProjectManagement::ProjectManager::setCreateNewProjectOnStartup(bool toggle) {
     d->auto_create_new_project = toggle;
     writeSettings();
@@ -316,6 +316,69 @@ namespace Qtilities {
              *\sa setUseProjectFileLocks()
              */
             bool useProjectFileLocks() const;
+            //! Sets the names of project items which are only loaded when they are first accessed.
+            /*!
+             * When a binary project file is opened, loading of the project items in this list is deferred until they are accessed
+             * through Project::projectItem(), loaded explicitly using Project::loadProjectItem(), or until the project is saved.
+             * This reduces the time it takes to open large projects when some project items are not needed immediately.
+             *
+             * Only set this for project items which are not accessed directly by your application before they were requested from
+             * the project. XML project files, and binary project files saved by earlier versions of %Qtilities, always load all
+             * project items.
+             *
+             * Default is an empty list.
+             *
+             *<i>This function was added in %Qtilities v1.5.</i>
+             *
+             *\sa lazyProjectItems()
+             */
+            void setLazyProjectItems(const QStringList& item_names);
+            //! Gets the names of project items which are only loaded when they are first accessed.
+            /*!
+             *<i>This function was added in %Qtilities v1.5.</i>
+             *
+             *\sa setLazyProjectItems()
+             */
+            QStringList lazyProjectItems() const;
+            //! Sets if only modified project items are saved when a project is saved to its current binary project file.
+            /*!
+             * See the Project class documentation for details on incremental saving.
+             *
+             * Default is false.
+             *
+             *<i>This function was added in %Qtilities v1.5.</i>
+             *
+             *\sa incrementalProjectSaving()
+             */
+            void setIncrementalProjectSaving(bool toggle);
+            //! Gets if only modified project items are saved when a project is saved to its current binary project file.
+            /*!
+             *<i>This function was added in %Qtilities v1.5.</i>
+             *
+             *\sa setIncrementalProjectSaving()
+             */
+            bool incrementalProjectSaving() const;
+            //! Sets if the previous version of a project file is kept as a backup when a project is saved.
+            /*!
+             * When enabled, the previous version of the project file is kept under the project file name followed by \p .bak right before
+             * the new version is renamed into its place, using a hard link or a copy. The project file itself is left in place until the new
+             * version replaces it. Earlier backups are replaced. Incremental saves do not create backups, since they
+             * append to the current project file.
+             *
+             * Default is false.
+             *
+             *<i>This function was added in %Qtilities v1.5.</i>
+             *
+             *\sa projectFileBackups()
+             */
+            void setProjectFileBackups(bool toggle);
+            //! Gets if the previous version of a project file is kept as a backup when a project is saved.
+            /*!
+             *<i>This function was added in %Qtilities v1.5.</i>
+             *
+             *\sa setProjectFileBackups()
+             */
+            bool projectFileBackups() const;
             //! Sets the configuration option to create a new project when the no last open project is available.
             /*!
               This configuration setting has no effect if the openLastProjectOnStartup() is false.
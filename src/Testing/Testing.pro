@@ -52,13 +52,16 @@ contains(DEFINES, QTILITIES_TESTING) {
             source/TestSubjectIterator.h \
             source/TestTreeIterator.h \
             source/BenchmarkTests.h \
+            source/BenchmarkLogging.h \
             source/TestNamingPolicyFilter.h \
             source/TestActivityPolicyFilter.h \
             source/TestSubjectTypeFilter.h \
             source/TestTreeFileItem.h \
             source/TestAbstractTreeItem.h \
             source/TestObjectManager.h \
-            source/TestTask.h
+            source/TestTask.h \
+            source/TestLogging.h \
+            source/LoggingTestFixtures.h
 
     SOURCES += source/TestObserver.cpp \
             source/TestObserverRelationalTable.cpp \
@@ -67,13 +70,16 @@ contains(DEFINES, QTILITIES_TESTING) {
             source/TestSubjectIterator.cpp \
             source/TestTreeIterator.cpp \
             source/BenchmarkTests.cpp \
+            source/BenchmarkLogging.cpp \
             source/TestNamingPolicyFilter.cpp \
             source/TestActivityPolicyFilter.cpp \
             source/TestSubjectTypeFilter.cpp \
             source/TestTreeFileItem.cpp \
             source/TestAbstractTreeItem.cpp \
             source/TestObjectManager.cpp \
-            source/TestTask.cpp
+            source/TestTask.cpp \
+            source/TestLogging.cpp \
+            source/LoggingTestFixtures.cpp
 }
 
 # --------------------------
@@ -0,0 +1,332 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#include "BenchmarkLogging.h"
+#include "LoggingTestFixtures.h"
+
+#include <QtilitiesCoreGui>
+using namespace QtilitiesCoreGui;
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+namespace {
+    // The number of messages logged by each benchmark, or by each thread in the threaded benchmark.
+    const int benchmark_message_count = 10000;
+
+    // Waits until engines which write to their files in the background wrote all messages which were delivered to them.
+    void flushLoggerEngine(AbstractLoggerEngine* engine) {
+        if (FileLoggerEngine* file_engine = qobject_cast<FileLoggerEngine*> (engine))
+            file_engine->flush();
+        else if (RollingFileLoggerEngine* rolling_engine = qobject_cast<RollingFileLoggerEngine*> (engine))
+            rolling_engine->flush();
+    }
+
+    QString jsonString(const QString& value) {
+        QString escaped = value;
+        escaped.replace("\\","\\\\");
+        escaped.replace("\"","\\\"");
+        return "\"" + escaped + "\"";
+    }
+
+    struct BenchmarkLoggingResult {
+        QString scenario;
+        QString variant;
+        int     message_count;
+        double  messages_per_second;
+        qint64  p50_nsecs;
+        qint64  p99_nsecs;
+    };
+}
+
+struct Qtilities::Testing::BenchmarkLoggingPrivateData {
+    QString                         results_file;
+    QList<BenchmarkLoggingResult>   results;
+    Logger::MessageType             global_log_level;
+};
+
+Qtilities::Testing::BenchmarkLogging::BenchmarkLogging(QObject* parent) : QObject(parent) {
+    d = new BenchmarkLoggingPrivateData;
+    d->global_log_level = Logger::Trace;
+}
+
+Qtilities::Testing::BenchmarkLogging::~BenchmarkLogging() {
+    delete d;
+}
+
+int Qtilities::Testing::BenchmarkLogging::execTest(int argc, char ** argv) {
+    return QTest::qExec(this,argc,argv);
+}
+
+void Qtilities::Testing::BenchmarkLogging::setResultsFile(const QString& file_name) {
+    d->results_file = file_name;
+}
+
+QString Qtilities::Testing::BenchmarkLogging::resultsFile() const {
+    return d->results_file;
+}
+
+void Qtilities::Testing::BenchmarkLogging::initTestCase() {
+    d->results.clear();
+    d->global_log_level = Log->globalLogLevel();
+    Log->setGlobalLogLevel(Logger::Trace);
+}
+
+void Qtilities::Testing::BenchmarkLogging::cleanupTestCase() {
+    Log->setGlobalLogLevel(d->global_log_level);
+    if (!d->results_file.isEmpty())
+        QVERIFY(writeResults());
+}
+
+void Qtilities::Testing::BenchmarkLogging::benchmarkLoggerEngines_data() {
+    QTest::addColumn<QString>("EngineType");
+    QTest::newRow("File Logger Engine") << QString("File");
+    QTest::newRow("Rolling File Logger Engine") << QString("RollingFile");
+    QTest::newRow("Binary Logger Engine") << QString("Binary");
+    QTest::newRow("Console Logger Engine") << QString("Console");
+    QTest::newRow("Qt Message Logger Engine") << QString("QtMsg");
+    QTest::newRow("Widget Logger Engine") << QString("Widget");
+}
+
+void Qtilities::Testing::BenchmarkLogging::benchmarkLoggerEngines() {
+    QFETCH(QString, EngineType);
+
+    // The console and Qt message engines are singletons which are attached to the logger during initialization, they are activated
+    // for the benchmark only. All other engines are created for the benchmark:
+    AbstractLoggerEngine* engine = 0;
+    bool was_active = false;
+    if (EngineType == "Console" || EngineType == "QtMsg") {
+        if (EngineType == "Console")
+            engine = ConsoleLoggerEngine::instance();
+        else
+            engine = QtMsgLoggerEngine::instance();
+        was_active = engine->isActive();
+        engine->setActive(true);
+    } else {
+        QString file_path = QDir::tempPath() + "/QtilitiesLoggingBenchmark";
+        if (EngineType == "File") {
+            FileLoggerEngine* file_engine = new FileLoggerEngine;
+            file_engine->setFileName(file_path + ".log");
+            engine = file_engine;
+        } else if (EngineType == "RollingFile") {
+            RollingFileLoggerEngine* rolling_engine = new RollingFileLoggerEngine;
+            rolling_engine->setFileName(file_path + "_rolling.log");
+            engine = rolling_engine;
+        } else if (EngineType == "Binary") {
+            BinaryLoggerEngine* binary_engine = new BinaryLoggerEngine;
+            binary_engine->setFileName(file_path + ".qlog");
+            engine = binary_engine;
+        } else {
+            engine = new WidgetLoggerEngine;
+            engine->installFormattingEngine(Log->formattingEngineReference(qti_def_FORMATTING_ENGINE_RICH_TEXT));
+        }
+        engine->setName(QString("Logging Benchmark %1 Engine").arg(EngineType));
+        QVERIFY(Log->attachLoggerEngine(engine));
+    }
+    QVERIFY(engine->isInitialized());
+
+    QElapsedTimer total_timer;
+    total_timer.start();
+    QVector<qint64> latencies = timedLogMessages(engine->name(),benchmark_message_count);
+    Log->flush();
+    flushLoggerEngine(engine);
+    qint64 total_nsecs = total_timer.nsecsElapsed();
+
+    if (EngineType == "Console" || EngineType == "QtMsg")
+        engine->setActive(was_active);
+    else
+        QVERIFY(Log->detachLoggerEngine(engine));
+
+    addResult("Logger Engine",EngineType,latencies,total_nsecs);
+}
+
+void Qtilities::Testing::BenchmarkLogging::benchmarkFormattingEngines_data() {
+    QTest::addColumn<QString>("FormattingEngine");
+    QTest::newRow("Default") << QString(qti_def_FORMATTING_ENGINE_DEFAULT);
+    QTest::newRow("Rich Text") << QString(qti_def_FORMATTING_ENGINE_RICH_TEXT);
+    QTest::newRow("XML") << QString(qti_def_FORMATTING_ENGINE_XML);
+    QTest::newRow("HTML") << QString(qti_def_FORMATTING_ENGINE_HTML);
+    QTest::newRow("Qt Messaging System") << QString(qti_def_FORMATTING_ENGINE_QT_MSG);
+}
+
+void Qtilities::Testing::BenchmarkLogging::benchmarkFormattingEngines() {
+    QFETCH(QString, FormattingEngine);
+
+    AbstractFormattingEngine* formatting_engine = Log->formattingEngineReference(FormattingEngine);
+    QVERIFY(formatting_engine != 0);
+
+    // Records remember their formatted messages, thus each iteration formats a new record:
+    QList<LogRecord> records;
+    for (int i = 0; i < benchmark_message_count; ++i) {
+        QList<QVariant> messages;
+        messages << QString("Benchmark message") << i;
+        records << LogRecord(Logger::Warning,messages);
+    }
+
+    QVector<qint64> latencies(benchmark_message_count);
+    QElapsedTimer total_timer;
+    total_timer.start();
+    QElapsedTimer timer;
+    for (int i = 0; i < benchmark_message_count; ++i) {
+        timer.start();
+        QString formatted_message = formatting_engine->formatRecord(records.at(i));
+        latencies[i] = timer.nsecsElapsed();
+        QVERIFY(!formatted_message.isEmpty());
+    }
+    qint64 total_nsecs = total_timer.nsecsElapsed();
+
+    addResult("Formatting Engine",FormattingEngine,latencies,total_nsecs);
+}
+
+void Qtilities::Testing::BenchmarkLogging::benchmarkDisabledMessageTypes_data() {
+    QTest::addColumn<bool>("UseMacro");
+    QTest::newRow("LOG_TRACE") << true;
+    QTest::newRow("Logger::logMessage()") << false;
+}
+
+void Qtilities::Testing::BenchmarkLogging::benchmarkDisabledMessageTypes() {
+    QFETCH(bool, UseMacro);
+
+    Log->setGlobalLogLevel(Logger::Error);
+    QVERIFY(!Logger::isMessageTypeLogged(Logger::Trace));
+
+    QVector<qint64> latencies(benchmark_message_count);
+    QElapsedTimer total_timer;
+    total_timer.start();
+    QElapsedTimer timer;
+    for (int i = 0; i < benchmark_message_count; ++i) {
+        timer.start();
+        if (UseMacro)
+            LOG_TRACE("Benchmark message");
+        else
+            Log->logMessage(QString(),Logger::Trace,QString("Benchmark message"),i);
+        latencies[i] = timer.nsecsElapsed();
+    }
+    qint64 total_nsecs = total_timer.nsecsElapsed();
+
+    Log->setGlobalLogLevel(Logger::Trace);
+    addResult("Disabled Message Type",UseMacro ? "LOG_TRACE" : "logMessage",latencies,total_nsecs);
+}
+
+void Qtilities::Testing::BenchmarkLogging::benchmarkEngineFanOut_data() {
+    QTest::addColumn<int>("EngineCount");
+    QTest::newRow("1 engine") << 1;
+    QTest::newRow("2 engines") << 2;
+    QTest::newRow("4 engines") << 4;
+    QTest::newRow("8 engines") << 8;
+}
+
+void Qtilities::Testing::BenchmarkLogging::benchmarkEngineFanOut() {
+    QFETCH(int, EngineCount);
+
+    QList<CountingLoggerEngine*> engines;
+    for (int i = 0; i < EngineCount; ++i) {
+        CountingLoggerEngine* engine = new CountingLoggerEngine(QString("Logging Benchmark Fan Out Engine %1").arg(i));
+        QVERIFY(Log->attachLoggerEngine(engine));
+        engines << engine;
+    }
+
+    // System wide messages are delivered to all active engines:
+    QElapsedTimer total_timer;
+    total_timer.start();
+    QVector<qint64> latencies = timedLogMessages(QString(),benchmark_message_count);
+    Log->flush();
+    qint64 total_nsecs = total_timer.nsecsElapsed();
+
+    for (int i = 0; i < engines.count(); ++i) {
+        QCOMPARE(engines.at(i)->received_count,benchmark_message_count);
+        QVERIFY(Log->detachLoggerEngine(engines.at(i)));
+    }
+
+    addResult("Engine Fan Out",QString::number(EngineCount),latencies,total_nsecs);
+}
+
+void Qtilities::Testing::BenchmarkLogging::benchmarkThreadedProducers_data() {
+    QTest::addColumn<int>("ThreadCount");
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("16 threads") << 16;
+}
+
+void Qtilities::Testing::BenchmarkLogging::benchmarkThreadedProducers() {
+    QFETCH(int, ThreadCount);
+
+    CountingLoggerEngine* engine = new CountingLoggerEngine("Logging Benchmark Threaded Engine");
+    QVERIFY(Log->attachLoggerEngine(engine));
+
+    QVector<qint64> latencies;
+    qint64 total_nsecs = logFromThreads(engine->name(),ThreadCount,benchmark_message_count,&latencies);
+
+    QCOMPARE(engine->received_count,ThreadCount * benchmark_message_count);
+    QCOMPARE(engine->out_of_order_count,0);
+    QVERIFY(Log->detachLoggerEngine(engine));
+
+    addResult("Threaded Producers",QString::number(ThreadCount),latencies,total_nsecs);
+}
+
+void Qtilities::Testing::BenchmarkLogging::addResult(const QString& scenario, const QString& variant, QVector<qint64> latencies, qint64 total_nsecs) {
+    BenchmarkLoggingResult result;
+    result.scenario = scenario;
+    result.variant = variant;
+    result.message_count = latencies.count();
+    result.messages_per_second = total_nsecs > 0 ? latencies.count() * 1000000000.0 / total_nsecs : 0;
+    result.p50_nsecs = 0;
+    result.p99_nsecs = 0;
+    if (!latencies.isEmpty()) {
+        qSort(latencies);
+        result.p50_nsecs = latencies.at((latencies.count() - 1) * 50 / 100);
+        result.p99_nsecs = latencies.at((latencies.count() - 1) * 99 / 100);
+    }
+    d->results << result;
+}
+
+bool Qtilities::Testing::BenchmarkLogging::writeResults() const {
+    QFile file(d->results_file);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        qWarning() << QString("Failed to open the logging benchmark results file: %1").arg(d->results_file);
+        return false;
+    }
+
+    QTextStream stream(&file);
+    if (d->results_file.endsWith(".json",Qt::CaseInsensitive)) {
+        stream << "{\n";
+        stream << "  \"benchmark\": " << jsonString("Qtilities Logging") << ",\n";
+        stream << "  \"qt_version\": " << jsonString(qVersion()) << ",\n";
+        stream << "  \"timestamp\": " << jsonString(QDateTime::currentDateTime().toString(Qt::ISODate)) << ",\n";
+        stream << "  \"results\": [\n";
+        for (int i = 0; i < d->results.count(); ++i) {
+            const BenchmarkLoggingResult& result = d->results.at(i);
+            stream << "    { \"scenario\": " << jsonString(result.scenario)
+                   << ", \"variant\": " << jsonString(result.variant)
+                   << ", \"messages\": " << result.message_count
+                   << ", \"messages_per_second\": " << QString::number(result.messages_per_second,'f',1)
+                   << ", \"p50_ns\": " << result.p50_nsecs
+                   << ", \"p99_ns\": " << result.p99_nsecs << " }";
+            if (i < d->results.count() - 1)
+                stream << ",";
+            stream << "\n";
+        }
+        stream << "  ]\n";
+        stream << "}\n";
+    } else {
+        stream << "scenario,variant,messages,messages_per_second,p50_ns,p99_ns\n";
+        for (int i = 0; i < d->results.count(); ++i) {
+            const BenchmarkLoggingResult& result = d->results.at(i);
+            stream << result.scenario << "," << result.variant << "," << result.message_count << ","
+                   << QString::number(result.messages_per_second,'f',1) << "," << result.p50_nsecs << "," << result.p99_nsecs << "\n";
+        }
+    }
+
+    stream.flush();
+    file.close();
+    return file.error() == QFile::NoError;
+}
@@ -0,0 +1,117 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#ifndef BENCHMARK_LOGGING_H
+#define BENCHMARK_LOGGING_H
+
+#include "Testing_global.h"
+
+#include "ITestable.h"
+
+#include <QtTest/QtTest>
+
+namespace Qtilities {
+    namespace Testing {
+        using namespace Interfaces;
+
+        /*!
+        \struct BenchmarkLoggingPrivateData
+        \brief The BenchmarkLogging class uses this struct to store its private data.
+          */
+        struct BenchmarkLoggingPrivateData;
+
+        /*!
+        \class BenchmarkLogging
+        \brief Benchmarks the throughput and latency of the %Qtilities logger.
+
+        Each benchmark logs a number of messages and measures:
+        - The number of messages delivered per second, from the first message logged until all messages were delivered to the logger engines.
+        - The 50th and 99th percentile of the time spent in a single logging call, in nanoseconds.
+
+        The following scenarios are measured:
+        - Each built-in logger engine receiving messages targeted at it.
+        - Each built-in formatting engine formatting a record.
+        - Logging messages of a type which is not logged.
+        - A number of logger engines receiving the same system wide messages.
+        - A number of threads logging messages at the same time.
+
+        When a results file is set using setResultsFile(), the results of all benchmarks are written to it when the test finishes. Files
+        ending in \p .json are written in JSON format, all other files are written as comma separated values. The benchmarks take a while
+        and their results are only useful in the results file, thus they are not part of the tests shown by the test frontend. They are run
+        using the QtilitiesTester tool:
+
+\code
+QtilitiesTester -benchmark-logging logging_results.csv
+\endcode
+
+        <i>This class was added in %Qtilities v1.5.</i>
+          */
+        class TESTING_SHARED_EXPORT BenchmarkLogging: public QObject, public ITestable
+        {
+            Q_OBJECT
+            Q_INTERFACES(Qtilities::Testing::Interfaces::ITestable)
+
+        public:
+            BenchmarkLogging(QObject* parent = 0);
+            ~BenchmarkLogging();
+
+            // --------------------------------
+            // IObjectBase Implementation
+            // --------------------------------
+            QObject* objectBase() { return this; }
+            const QObject* objectBase() const { return this; }
+
+            // --------------------------------
+            // ITestable Implementation
+            // --------------------------------
+            int execTest(int argc = 0, char ** argv = 0);
+            QString testName() const { return tr("Logging Benchmarks"); }
+
+            // --------------------------------
+            // BenchmarkLogging Implementation
+            // --------------------------------
+            //! Sets the file to which the results are written when the test finishes. When empty, the results are not written to a file.
+            void setResultsFile(const QString& file_name);
+            //! Returns the file to which the results are written.
+            QString resultsFile() const;
+
+        private slots:
+            void initTestCase();
+            void cleanupTestCase();
+
+            void benchmarkLoggerEngines_data();
+            //! Benchmarks each built-in logger engine receiving messages targeted at it.
+            void benchmarkLoggerEngines();
+            void benchmarkFormattingEngines_data();
+            //! Benchmarks each built-in formatting engine.
+            void benchmarkFormattingEngines();
+            void benchmarkDisabledMessageTypes_data();
+            //! Benchmarks the cost of logging messages of a type which is not logged.
+            void benchmarkDisabledMessageTypes();
+            void benchmarkEngineFanOut_data();
+            //! Benchmarks a number of logger engines receiving the same system wide messages.
+            void benchmarkEngineFanOut();
+            void benchmarkThreadedProducers_data();
+            //! Benchmarks a number of threads logging messages at the same time.
+            void benchmarkThreadedProducers();
+
+        private:
+            //! Adds the result of a benchmark from the latencies of the individual calls, in nanoseconds, and the total time in nanoseconds.
+            void addResult(const QString& scenario, const QString& variant, QVector<qint64> latencies, qint64 total_nsecs);
+            //! Writes the results to the results file.
+            bool writeResults() const;
+
+            BenchmarkLoggingPrivateData* d;
+        };
+    }
+}
+
+#endif // BENCHMARK_LOGGING_H
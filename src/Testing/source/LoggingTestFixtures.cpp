@@ -0,0 +1,87 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#include "LoggingTestFixtures.h"
+
+using namespace QtilitiesLogging;
+
+#include <QElapsedTimer>
+
+Qtilities::Testing::CountingLoggerEngine::CountingLoggerEngine(const QString& engine_name) : received_count(0),
+    out_of_order_count(0) {
+    setName(engine_name);
+    installFormattingEngine(Log->formattingEngineReference(qti_def_FORMATTING_ENGINE_DEFAULT));
+}
+
+bool Qtilities::Testing::CountingLoggerEngine::initialize() {
+    abstractLoggerEngineData->is_initialized = true;
+    return true;
+}
+
+void Qtilities::Testing::CountingLoggerEngine::logMessage(const QString& message, Logger::MessageType message_type) {
+    Q_UNUSED(message)
+    Q_UNUSED(message_type)
+}
+
+void Qtilities::Testing::CountingLoggerEngine::newLogRecord(const LogRecord& record) {
+    if (!acceptsRecord(record))
+        return;
+
+    // The second message of records logged by timedLogMessages() is their index:
+    if (record.messages().count() > 1) {
+        int index = record.messages().at(1).toInt();
+        if (last_indexes.contains(record.threadId()) && index <= last_indexes.value(record.threadId()))
+            ++out_of_order_count;
+        last_indexes[record.threadId()] = index;
+    }
+    ++received_count;
+
+    // Formatting is part of the work of a real engine:
+    logMessage(record.formattedMessage(abstractLoggerEngineData->formatting_engine),record.messageType());
+}
+
+QVector<qint64> Qtilities::Testing::timedLogMessages(const QString& engine_name, int message_count) {
+    QVector<qint64> latencies(message_count);
+    QElapsedTimer timer;
+    for (int i = 0; i < message_count; ++i) {
+        timer.start();
+        Log->logMessage(engine_name,Logger::Info,QString("Logged message"),i);
+        latencies[i] = timer.nsecsElapsed();
+    }
+    return latencies;
+}
+
+void Qtilities::Testing::LoggingThread::run() {
+    latencies = timedLogMessages(target_engine_name,count);
+}
+
+qint64 Qtilities::Testing::logFromThreads(const QString& engine_name, int thread_count, int message_count, QVector<qint64>* latencies) {
+    QList<LoggingThread*> threads;
+    for (int i = 0; i < thread_count; ++i)
+        threads << new LoggingThread(engine_name,message_count);
+
+    QElapsedTimer total_timer;
+    total_timer.start();
+    for (int i = 0; i < thread_count; ++i)
+        threads.at(i)->start();
+    for (int i = 0; i < thread_count; ++i)
+        threads.at(i)->wait();
+    // Deliver the messages which are still buffered:
+    Log->flush();
+    qint64 total_nsecs = total_timer.nsecsElapsed();
+
+    for (int i = 0; i < thread_count; ++i) {
+        if (latencies)
+            *latencies += threads.at(i)->latencies;
+        delete threads.at(i);
+    }
+    return total_nsecs;
+}
@@ -0,0 +1,70 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#ifndef LOGGING_TEST_FIXTURES_H
+#define LOGGING_TEST_FIXTURES_H
+
+#include <QtilitiesLogging>
+
+#include <QHash>
+#include <QThread>
+#include <QVector>
+
+namespace Qtilities {
+    namespace Testing {
+        // The logger engine and logging scenario shared by TestLogging and BenchmarkLogging.
+
+        // Formats the records it receives with the default formatting engine and counts them. Records logged by
+        // timedLogMessages() are checked to arrive in the order in which each thread logged them.
+        class CountingLoggerEngine : public Logging::AbstractLoggerEngine {
+        public:
+            CountingLoggerEngine(const QString& engine_name);
+
+            bool initialize();
+            void finalize() {}
+            QString description() const { return QString("Counts logged messages."); }
+            QString status() const { return QString(); }
+            bool isFormattingEngineConstant() const { return true; }
+            void logMessage(const QString& message, Logging::Logger::MessageType message_type);
+            void newLogRecord(const Logging::LogRecord& record);
+
+            int                 received_count;
+            int                 out_of_order_count;
+            QHash<quint64,int>  last_indexes;
+        };
+
+        // Logs a number of numbered messages to a logger engine on the calling thread and returns the time in nanoseconds spent in each logging call.
+        QVector<qint64> timedLogMessages(const QString& engine_name, int message_count);
+
+        // Logs a number of numbered messages to a logger engine using timedLogMessages().
+        class LoggingThread : public QThread {
+        public:
+            LoggingThread(const QString& engine_name, int message_count) : target_engine_name(engine_name),
+                count(message_count) {}
+
+            QVector<qint64> latencies;
+
+        protected:
+            void run();
+
+        private:
+            QString target_engine_name;
+            int     count;
+        };
+
+        // Logs message_count messages from each of thread_count threads at the same time and delivers them to the engine. Returns
+        // the time in nanoseconds from starting the threads until all messages were delivered. The latencies of all logging calls are
+        // appended to latencies when it is not null.
+        qint64 logFromThreads(const QString& engine_name, int thread_count, int message_count, QVector<qint64>* latencies = 0);
+    }
+}
+
+#endif // LOGGING_TEST_FIXTURES_H
@@ -19,6 +19,10 @@ using namespace QtilitiesExtensionSystem;
 
 #include <QDomDocument>
 #include <QDomElement>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <QThreadPool>
+#include <QDir>
 
 int Qtilities::Testing::TestExporting::execTest(int argc, char ** argv) {
     return QTest::qExec(this,argc,argv);
@@ -1139,3 +1143,294 @@ void Testing::TestExporting::testObserverHints_w1_1_r1_1() {
     delete obj_import_binary;
     delete obj_import_xml;
 }
+
+// --------------------------------------------------------------------
+// Test XML streaming and binary project containers
+// --------------------------------------------------------------------
+void Qtilities::Testing::TestExporting::testObserverXmlStream() {
+    TreeNode* obj_source = new TreeNode("Root Node");
+    TreeNode* obj_import_stream = new TreeNode;
+    TreeNode* obj_import_xml = new TreeNode;
+
+    obj_source->enableActivityControl(ObserverHints::CheckboxActivityDisplay);
+    obj_source->enableNamingControl(ObserverHints::ReadOnlyNames,NamingPolicyFilter::ProhibitDuplicateNames);
+    obj_source->enableCategorizedDisplay();
+    obj_source->addItem("Item 1",QtilitiesCategory("Category 1"));
+    obj_source->addItem("Item 2",QtilitiesCategory("Category 2::Sub Category","::"));
+    obj_source->addItem("Item 3");
+    TreeNode* child_node = obj_source->addNode("TestNode1",QtilitiesCategory("Category 1"));
+    child_node->addItem("TestChild1");
+    child_node->addItem("TestChild2");
+    QVERIFY(obj_source->supportedFormats() & IExportable::XMLStream);
+
+    // Stream the tree to a file:
+    QString file_stream = QString("%1/%2.xml").arg(QtilitiesApplication::applicationSessionPath()).arg("testObserverXmlStream");
+    QFile file(file_stream);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QXmlStreamWriter writer(&file);
+    writer.setAutoFormatting(true);
+    writer.writeStartDocument();
+    writer.writeStartElement("QtilitiesTesting");
+    writer.writeStartElement("object_node");
+    QVERIFY(obj_source->exportXmlStream(writer) == IExportable::Complete);
+    writer.writeEndElement();
+    writer.writeEndElement();
+    writer.writeEndDocument();
+    file.close();
+
+    // Read the streamed file back with the stream reader:
+    QList<QPointer<QObject> > import_list;
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QXmlStreamReader reader(&file);
+    QVERIFY(reader.readNextStartElement());
+    QVERIFY(reader.readNextStartElement());
+    QVERIFY(obj_import_stream->importXmlStream(reader,import_list) == IExportable::Complete);
+    QVERIFY(!reader.hasError());
+    file.close();
+
+    // Read the streamed file back using the DOM based import:
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QDomDocument doc("QtilitiesTesting");
+    QVERIFY(doc.setContent(&file));
+    file.close();
+    QDomElement rootItem = doc.documentElement().firstChildElement("object_node");
+    QVERIFY(obj_import_xml->importXml(&doc,&rootItem,import_list) == IExportable::Complete);
+
+    QCOMPARE(obj_import_stream->treeCount(),obj_source->treeCount());
+    QCOMPARE(obj_import_xml->treeCount(),obj_source->treeCount());
+    QCOMPARE(obj_import_stream->subjectNames(),obj_source->subjectNames());
+    QCOMPARE(obj_import_xml->subjectNames(),obj_source->subjectNames());
+    QVERIFY(obj_import_stream->displayHints()->hierarchicalDisplayHint() == ObserverHints::CategorizedHierarchy);
+    QVERIFY(obj_import_xml->displayHints()->hierarchicalDisplayHint() == ObserverHints::CategorizedHierarchy);
+
+    delete obj_source;
+    delete obj_import_stream;
+    delete obj_import_xml;
+}
+
+void Qtilities::Testing::TestExporting::testProjectLazyLoading() {
+    CodeEditorWidget code_editor_source_1;
+    code_editor_source_1.setObjectName("Code Editor 1");
+    CodeEditorWidget code_editor_source_2;
+    code_editor_source_2.setObjectName("Code Editor 2");
+    Project* obj_source = new Project;
+    obj_source->addProjectItem(new CodeEditorProjectItemWrapper(&code_editor_source_1));
+    obj_source->addProjectItem(new CodeEditorProjectItemWrapper(&code_editor_source_2));
+
+    CodeEditorWidget code_editor_import_1;
+    code_editor_import_1.setObjectName("Code Editor 1");
+    CodeEditorWidget code_editor_import_2;
+    code_editor_import_2.setObjectName("Code Editor 2");
+    Project* obj_import = new Project;
+    // The project items are added in a different order, sections are matched by name:
+    obj_import->addProjectItem(new CodeEditorProjectItemWrapper(&code_editor_import_2));
+    obj_import->addProjectItem(new CodeEditorProjectItemWrapper(&code_editor_import_1));
+
+    code_editor_source_1.codeEditor()->setPlainText("Loaded immediately");
+    code_editor_source_2.codeEditor()->setPlainText("Loaded on first access");
+
+    QString file_name = QtilitiesApplication::applicationSessionPath() + "/testProjectLazyLoading.prj";
+    QVERIFY(obj_source->saveProject(file_name));
+
+    QStringList lazy_items = PROJECT_MANAGER->lazyProjectItems();
+    PROJECT_MANAGER->setLazyProjectItems(QStringList() << obj_import->projectItemNames().at(0));
+    QVERIFY(obj_import->loadProject(file_name,false));
+    PROJECT_MANAGER->setLazyProjectItems(lazy_items);
+
+    QCOMPARE(obj_import->deferredProjectItemNames(),QStringList() << obj_import->projectItemNames().at(0));
+    QCOMPARE(code_editor_import_1.codeEditor()->toPlainText(),QString("Loaded immediately"));
+    QVERIFY(code_editor_import_2.codeEditor()->toPlainText().isEmpty());
+
+    // Accessing the deferred item loads it:
+    QVERIFY(obj_import->projectItem(0));
+    QVERIFY(obj_import->deferredProjectItemNames().isEmpty());
+    QCOMPARE(code_editor_import_2.codeEditor()->toPlainText(),QString("Loaded on first access"));
+
+    // Reload a single item from the project file:
+    code_editor_import_1.codeEditor()->setPlainText("Changed");
+    QVERIFY(obj_import->loadProjectItem(obj_import->projectItemNames().at(1)));
+    QCOMPARE(code_editor_import_1.codeEditor()->toPlainText(),QString("Loaded immediately"));
+
+    obj_import->closeProject();
+    delete obj_source;
+    delete obj_import;
+}
+
+void Qtilities::Testing::TestExporting::testProjectIncrementalSaving() {
+    CodeEditorWidget code_editor_source_1;
+    code_editor_source_1.setObjectName("Code Editor 1");
+    CodeEditorWidget code_editor_source_2;
+    code_editor_source_2.setObjectName("Code Editor 2");
+    Project* obj_source = new Project;
+    obj_source->addProjectItem(new CodeEditorProjectItemWrapper(&code_editor_source_1));
+    obj_source->addProjectItem(new CodeEditorProjectItemWrapper(&code_editor_source_2));
+
+    CodeEditorWidget code_editor_import_1;
+    code_editor_import_1.setObjectName("Code Editor 1");
+    CodeEditorWidget code_editor_import_2;
+    code_editor_import_2.setObjectName("Code Editor 2");
+    Project* obj_import = new Project;
+    obj_import->addProjectItem(new CodeEditorProjectItemWrapper(&code_editor_import_1));
+    obj_import->addProjectItem(new CodeEditorProjectItemWrapper(&code_editor_import_2));
+
+    code_editor_source_1.codeEditor()->setPlainText("Saved once");
+    code_editor_source_2.codeEditor()->setPlainText("Saved twice");
+
+    QString file_name = QtilitiesApplication::applicationSessionPath() + "/testProjectIncrementalSaving.prj";
+    QVERIFY(obj_source->saveProject(file_name));
+    QCOMPARE(obj_source->projectItemSaveTimes().count(),2);
+    qint64 full_size = QFileInfo(file_name).size();
+
+    bool incremental_saving = PROJECT_MANAGER->incrementalProjectSaving();
+    PROJECT_MANAGER->setIncrementalProjectSaving(true);
+    code_editor_source_2.codeEditor()->setPlainText("Saved twice, only this item was saved the second time");
+    QVERIFY(obj_source->isModified());
+    QVERIFY(obj_source->saveProject(file_name));
+    PROJECT_MANAGER->setIncrementalProjectSaving(incremental_saving);
+
+    // Only the modified item was saved and appended to the file:
+    QCOMPARE(obj_source->projectItemSaveTimes().keys(),QStringList() << obj_source->projectItemNames().at(1));
+    QVERIFY(QFileInfo(file_name).size() > full_size);
+
+    QVERIFY(obj_import->loadProject(file_name,false));
+    QCOMPARE(code_editor_import_1.codeEditor()->toPlainText(),QString("Saved once"));
+    QCOMPARE(code_editor_import_2.codeEditor()->toPlainText(),QString("Saved twice, only this item was saved the second time"));
+    obj_import->closeProject();
+
+    // Interrupt the next incremental save by cutting off the end of its appendix, the previous appendix is used instead:
+    PROJECT_MANAGER->setIncrementalProjectSaving(true);
+    code_editor_source_2.codeEditor()->setPlainText("Interrupted");
+    QVERIFY(obj_source->saveProject(file_name));
+    PROJECT_MANAGER->setIncrementalProjectSaving(incremental_saving);
+    QFile file(file_name);
+    QVERIFY(file.resize(file.size() - 1));
+
+    QVERIFY(obj_import->loadProject(file_name,false));
+    QCOMPARE(code_editor_import_1.codeEditor()->toPlainText(),QString("Saved once"));
+    QCOMPARE(code_editor_import_2.codeEditor()->toPlainText(),QString("Saved twice, only this item was saved the second time"));
+    obj_import->closeProject();
+
+    // The next save saves the complete project, which compacts the file:
+    PROJECT_MANAGER->setIncrementalProjectSaving(true);
+    code_editor_source_2.codeEditor()->setPlainText("Saved after the interrupted save");
+    QVERIFY(obj_source->saveProject(file_name));
+    PROJECT_MANAGER->setIncrementalProjectSaving(incremental_saving);
+    QCOMPARE(obj_source->projectItemSaveTimes().count(),2);
+
+    QVERIFY(obj_import->loadProject(file_name,false));
+    QCOMPARE(code_editor_import_1.codeEditor()->toPlainText(),QString("Saved once"));
+    QCOMPARE(code_editor_import_2.codeEditor()->toPlainText(),QString("Saved after the interrupted save"));
+
+    obj_import->closeProject();
+    obj_source->closeProject();
+    delete obj_source;
+    delete obj_import;
+}
+
+void Qtilities::Testing::TestExporting::testObserverParallelExport() {
+    TreeNode* obj_source = new TreeNode("Root Node");
+    TreeNode* obj_import = new TreeNode;
+    obj_source->addItem("Item 1");
+    for (int n = 0; n < 3; ++n) {
+        TreeNode* child_node = obj_source->addNode(QString("Node %1").arg(n));
+        for (int i = 0; i < 300; ++i)
+            child_node->addItem(QString("Node %1 Child %2").arg(n).arg(i));
+    }
+    QVERIFY(obj_source->supportsConcurrentExport());
+
+    // Export the tree using all threads, and once more using only the calling thread:
+    QByteArray parallel_data;
+    {
+        QDataStream stream(&parallel_data,QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_4_7);
+        QVERIFY(obj_source->exportBinary(stream) == IExportable::Complete);
+    }
+
+    int max_thread_count = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount(1);
+    QByteArray sequential_data;
+    {
+        QDataStream stream(&sequential_data,QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_4_7);
+        QVERIFY(obj_source->exportBinary(stream) == IExportable::Complete);
+    }
+    QThreadPool::globalInstance()->setMaxThreadCount(max_thread_count);
+    QVERIFY(parallel_data == sequential_data);
+
+    // The subtrees must be imported in the order in which they were added:
+    QList<QPointer<QObject> > import_list;
+    QDataStream stream_in(&parallel_data,QIODevice::ReadOnly);
+    stream_in.setVersion(QDataStream::Qt_4_7);
+    QVERIFY(obj_import->importBinary(stream_in,import_list) == IExportable::Complete);
+    QCOMPARE(obj_import->treeCount(),obj_source->treeCount());
+    QCOMPARE(obj_import->subjectNames(),obj_source->subjectNames());
+    TreeNode* imported_node = qobject_cast<TreeNode*> (obj_import->subjectAt(2));
+    QVERIFY(imported_node);
+    QCOMPARE(imported_node->subjectCount(),300);
+    QCOMPARE(imported_node->subjectAt(299)->objectName(),QString("Node 1 Child 299"));
+
+    // Project items wrapping the tree are only exported concurrently when the export does not set properties on the objects in the tree:
+    ObserverProjectItemWrapper* project_item = new ObserverProjectItemWrapper(obj_source);
+    QVERIFY(project_item->supportsConcurrentExport());
+    project_item->setExportItemFlags(ObserverData::ExportData | ObserverData::ExportVisitorIDs);
+    QVERIFY(!project_item->supportsConcurrentExport());
+    project_item->setExportItemFlags(ObserverData::ExportData | ObserverData::ExportRelationalData);
+    QVERIFY(!project_item->supportsConcurrentExport());
+    delete project_item;
+
+    // Objects observed in more than one context prevent concurrent exports:
+    TreeNode* other_node = new TreeNode("Other Node");
+    other_node->attachSubject(qobject_cast<Observer*> (obj_source->subjectAt(1))->subjectAt(0));
+    QVERIFY(!obj_source->supportsConcurrentExport());
+
+    delete other_node;
+    delete obj_source;
+    delete obj_import;
+}
+
+void Qtilities::Testing::TestExporting::testProjectAtomicSaving() {
+    CodeEditorWidget code_editor_source;
+    code_editor_source.setObjectName("Code Editor");
+    Project* obj_source = new Project;
+    obj_source->addProjectItem(new CodeEditorProjectItemWrapper(&code_editor_source));
+
+    CodeEditorWidget code_editor_import;
+    code_editor_import.setObjectName("Code Editor");
+    Project* obj_import = new Project;
+    obj_import->addProjectItem(new CodeEditorProjectItemWrapper(&code_editor_import));
+
+    QString file_name = QtilitiesApplication::applicationSessionPath() + "/testProjectAtomicSaving.prj";
+    QString backup_file_name = file_name + ".bak";
+    QFile::remove(backup_file_name);
+
+    code_editor_source.codeEditor()->setPlainText("First version");
+    QVERIFY(obj_source->saveProject(file_name));
+    QVERIFY(!QFile::exists(backup_file_name));
+
+    bool project_file_backups = PROJECT_MANAGER->projectFileBackups();
+    PROJECT_MANAGER->setProjectFileBackups(true);
+    code_editor_source.codeEditor()->setPlainText("Second version");
+    QVERIFY(obj_source->saveProject(file_name));
+    PROJECT_MANAGER->setProjectFileBackups(project_file_backups);
+
+    // Only the project file, its backup and its lock are left in the session path:
+    QStringList saved_files = QDir(QtilitiesApplication::applicationSessionPath()).entryList(QStringList() << "testProjectAtomicSaving.prj*",QDir::Files);
+    saved_files.removeAll("testProjectAtomicSaving.prj.lck");
+    QCOMPARE(saved_files,QStringList() << "testProjectAtomicSaving.prj" << "testProjectAtomicSaving.prj.bak");
+
+    QVERIFY(obj_import->loadProject(file_name,false));
+    QCOMPARE(code_editor_import.codeEditor()->toPlainText(),QString("Second version"));
+    obj_import->closeProject();
+
+    // The backup is restored by renaming it back to a project file:
+    QString restored_file_name = QtilitiesApplication::applicationSessionPath() + "/testProjectAtomicSaving_restored.prj";
+    QFile::remove(restored_file_name);
+    QVERIFY(QFile::copy(backup_file_name,restored_file_name));
+    QVERIFY(obj_import->loadProject(restored_file_name,false));
+    QCOMPARE(code_editor_import.codeEditor()->toPlainText(),QString("First version"));
+
+    obj_import->closeProject();
+    obj_source->closeProject();
+    delete obj_source;
+    delete obj_import;
+}
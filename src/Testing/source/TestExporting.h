@@ -83,6 +83,15 @@ namespace Qtilities {
             // --------------------------------------------------------------------
             void testObserverHints_w1_1_r1_1();
 
+            // --------------------------------------------------------------------
+            // Test XML streaming and binary project containers
+            // --------------------------------------------------------------------
+            void testObserverXmlStream();
+            void testProjectLazyLoading();
+            void testProjectIncrementalSaving();
+            void testObserverParallelExport();
+            void testProjectAtomicSaving();
+
         private:
             void genericTest(IExportable* obj_source,IExportable* obj_import_binary,IExportable* obj_import_xml,Qtilities::ExportVersion write_version, Qtilities::ExportVersion read_version, const QString& file_name);
         };
@@ -0,0 +1,1046 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#include "TestLogging.h"
+#include "LoggingTestFixtures.h"
+
+#include <QtilitiesCore>
+using namespace QtilitiesCore;
+
+#include <QDir>
+#include <QTextStream>
+
+namespace {
+    // The number of messages logged into the small queues used by the back pressure tests.
+    const int back_pressure_message_count = 2000;
+
+    // Creates an asynchronous file logger engine with a queue which fills up quickly. The engine is not attached to the logger,
+    // its logMessage() slot is called directly.
+    FileLoggerEngine* createSmallQueueEngine(const QString& file_name, FileLoggerEngine::BackPressurePolicy policy) {
+        QFile::remove(file_name);
+        FileLoggerEngine* engine = new FileLoggerEngine;
+        engine->setFileName(file_name);
+        engine->setAsynchronousWritingEnabled(true);
+        engine->setQueueCapacity(4);
+        engine->setBatchSize(4);
+        engine->setBackPressurePolicy(policy);
+        return engine;
+    }
+
+    // Returns the numbers of the "Message <number>" lines in the file, in the order in which they appear.
+    QList<int> readMessageNumbers(const QString& file_name) {
+        QList<int> numbers;
+        QFile file(file_name);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+            return numbers;
+
+        QTextStream in(&file);
+        while (!in.atEnd()) {
+            const QString line = in.readLine();
+            if (line.startsWith("Message "))
+                numbers << line.mid(8).toInt();
+        }
+        return numbers;
+    }
+
+    // Logs numbered messages to a file logger engine until it is stopped.
+    class FileLoggingThread : public QThread {
+    public:
+        FileLoggingThread(FileLoggerEngine* target_engine) : engine(target_engine) {}
+
+        void stopLogging() {
+            stopping.fetchAndStoreOrdered(1);
+        }
+
+    protected:
+        void run() {
+            int number = 0;
+            while (stopping.fetchAndAddOrdered(0) == 0)
+                engine->logMessage(QString("Message %1").arg(number++),Logger::Info);
+        }
+
+    private:
+        FileLoggerEngine*   engine;
+        QAtomicInt          stopping;
+    };
+
+    // Records the threads on which it receives records.
+    class DeliveryThreadLoggerEngine : public AbstractLoggerEngine {
+    public:
+        DeliveryThreadLoggerEngine(const QString& engine_name, bool engine_thread_safe) : thread_safe(engine_thread_safe) {
+            setName(engine_name);
+            setMessageContexts(Logger::EngineSpecificMessages);
+        }
+
+        bool initialize() {
+            abstractLoggerEngineData->is_initialized = true;
+            return true;
+        }
+        void finalize() {}
+        QString description() const { return QString("Records delivery threads."); }
+        QString status() const { return QString(); }
+        bool isFormattingEngineConstant() const { return true; }
+        bool isThreadSafe() const { return thread_safe; }
+        void logMessage(const QString& message, Logger::MessageType message_type) {
+            Q_UNUSED(message)
+            Q_UNUSED(message_type)
+        }
+
+        void newLogRecord(const LogRecord& record) {
+            if (acceptsRecord(record))
+                delivery_threads << QThread::currentThread();
+        }
+
+        bool                thread_safe;
+        QList<QThread*>     delivery_threads;
+    };
+
+    // Records the first message of each record it receives. The records delivered to the engine, including those it does not accept, are recorded separately.
+    class RecordingLoggerEngine : public AbstractLoggerEngine {
+    public:
+        RecordingLoggerEngine(const QString& engine_name) {
+            setName(engine_name);
+            setMessageContexts(Logger::EngineSpecificMessages);
+        }
+
+        bool initialize() {
+            abstractLoggerEngineData->is_initialized = true;
+            return true;
+        }
+        void finalize() {}
+        QString description() const { return QString("Records logged messages."); }
+        QString status() const { return QString(); }
+        bool isFormattingEngineConstant() const { return true; }
+        void logMessage(const QString& message, Logger::MessageType message_type) {
+            Q_UNUSED(message)
+            Q_UNUSED(message_type)
+        }
+
+        void newLogRecord(const LogRecord& record) {
+            delivered_messages << record.messages().front().toString();
+            delivered_message_types << record.messageType();
+            if (!acceptsRecord(record))
+                return;
+            messages << record.messages().front().toString();
+            message_types << record.messageType();
+        }
+
+        QStringList                 messages;
+        QList<Logger::MessageType>  message_types;
+        QStringList                 delivered_messages;
+        QList<Logger::MessageType>  delivered_message_types;
+    };
+
+    // The message types which are logged in the current build mode, in the order used by the routing tests.
+    QList<Logger::MessageType> routeTestMessageTypes() {
+        QList<Logger::MessageType> message_types;
+        message_types << Logger::Info << Logger::Warning << Logger::Error << Logger::Fatal;
+        #ifndef QT_NO_DEBUG
+        message_types << Logger::Debug << Logger::Trace;
+        #endif
+        return message_types;
+    }
+
+    // The message types of routeTestMessageTypes() which are part of message_type_flags.
+    QList<Logger::MessageType> routeTestMessageTypes(Logger::MessageTypeFlags message_type_flags) {
+        QList<Logger::MessageType> message_types;
+        QList<Logger::MessageType> all_message_types = routeTestMessageTypes();
+        for (int i = 0; i < all_message_types.count(); ++i) {
+            if (message_type_flags & all_message_types.at(i))
+                message_types << all_message_types.at(i);
+        }
+        return message_types;
+    }
+
+    // Logs a system wide routing test message of each type, or a priority message of each type when priority is true.
+    void logRouteTestMessages(bool priority) {
+        QList<Logger::MessageType> message_types = routeTestMessageTypes();
+        for (int i = 0; i < message_types.count(); ++i) {
+            const QString message = QString("Route test message %1").arg(Log->logLevelToString(message_types.at(i)));
+            if (priority)
+                Log->logPriorityMessage(QString(),message_types.at(i),message);
+            else
+                Log->logMessage(QString(),message_types.at(i),message);
+        }
+    }
+
+    // Returns the types of the routing test messages delivered to the engine, and clears the records of the engine.
+    QList<Logger::MessageType> takeRouteTestMessageTypes(RecordingLoggerEngine* engine) {
+        QList<Logger::MessageType> message_types;
+        for (int i = 0; i < engine->delivered_messages.count(); ++i) {
+            if (engine->delivered_messages.at(i).startsWith("Route test message"))
+                message_types << engine->delivered_message_types.at(i);
+        }
+        engine->messages.clear();
+        engine->message_types.clear();
+        engine->delivered_messages.clear();
+        engine->delivered_message_types.clear();
+        return message_types;
+    }
+
+    // Returns the number of suppressed messages in a rate limit report, or -1 when the message is not a rate limit report.
+    int rateLimitReportCount(const QString& message) {
+        QRegExp report_expression("(\\d+) messages were suppressed by the rate limit\\.");
+        if (!report_expression.exactMatch(message))
+            return -1;
+        return report_expression.cap(1).toInt();
+    }
+
+    // Removes the file of a rolling file logger engine and all of its generations.
+    void removeRollingFiles(const QString& file_name) {
+        QFile::remove(file_name);
+        for (int generation = 1; generation <= 10; ++generation) {
+            QFile::remove(QString("%1.%2").arg(file_name).arg(generation));
+            QFile::remove(QString("%1.%2").arg(file_name).arg(generation) + qti_def_SUFFIX_COMPRESSED_LOG);
+        }
+    }
+
+    // Creates a rolling file logger engine which is not attached to the logger, its logMessage() slot is called directly.
+    RollingFileLoggerEngine* createRollingEngine(const QString& file_name, qint64 maximum_file_size, int roll_interval, int generations, bool compress) {
+        removeRollingFiles(file_name);
+        RollingFileLoggerEngine* engine = new RollingFileLoggerEngine;
+        engine->setFileName(file_name);
+        engine->setMaximumFileSize(maximum_file_size);
+        engine->setRollInterval(roll_interval);
+        engine->setGenerations(generations);
+        engine->setCompressionEnabled(compress);
+        return engine;
+    }
+
+    // Logs a numbered message followed by a line which makes the file larger than the maximum size used by the rolling tests,
+    // and waits until both are written. Since the size is checked before each batch, the next message rolls the file over.
+    void logLargeMessage(RollingFileLoggerEngine* engine, int number) {
+        engine->logMessage(QString("Message %1").arg(number),Logger::Info);
+        engine->logMessage(QString(200,QChar('x')),Logger::Info);
+        engine->flush();
+    }
+
+    QString generationFileName(const QString& file_name, int generation) {
+        return QString("%1.%2").arg(file_name).arg(generation);
+    }
+
+    QByteArray readFileContents(const QString& file_name) {
+        QFile file(file_name);
+        if (!file.open(QIODevice::ReadOnly))
+            return QByteArray();
+        return file.readAll();
+    }
+
+    // A formatting engine which only exposes the color formatting hints of AbstractFormattingEngine.
+    class HintTestFormattingEngine : public AbstractFormattingEngine {
+    public:
+        QString initializeString() const { return QString(); }
+        QString finalizeString() const { return QString(); }
+        QString formatMessage(Logger::MessageType message_type, const QList<QVariant>& messages) const {
+            Q_UNUSED(message_type)
+            Q_UNUSED(messages)
+            return QString();
+        }
+        QString name() const { return QString("Hint Test Formatting Engine"); }
+        QString fileExtension() const { return QString(); }
+        QString endOfLineChar() const { return QString("\n"); }
+    };
+
+    // Formats a record the way FormattingEngine_Rich_Text did before it built its messages in a single buffer. The parameters after
+    // the first message are appended after a line break, which the old code intended but did not do.
+    QString referenceRichTextFormat(const LogRecord& record, const QString& custom_color_hint) {
+        Logger::MessageType message_type = record.messageType();
+        QList<QVariant> messages = record.messages();
+        QString message;
+
+        message.append(record.timestamp().time().toString());
+        message.append(QString(" [%1] ").arg(Log->logLevelToString(message_type),-8,QChar(QChar::Nbsp)));
+        message.append(AbstractFormattingEngine::escape(messages.front().toString()));
+        for (int i = 1; i < messages.count(); ++i)
+            message.append(QString("<br>            %1").arg(AbstractFormattingEngine::escape(messages.at(i).toString())));
+        message.append("</font>");
+
+        QString color;
+        switch (message_type) {
+        case Logger::Info:
+            color = "black";
+            break;
+        case Logger::Warning:
+            color = "orange";
+            break;
+        case Logger::Error:
+            color = "red";
+            break;
+        case Logger::Fatal:
+            color = "purple";
+            break;
+        case Logger::Debug:
+            color = "grey";
+            break;
+        case Logger::Trace:
+            color = "lightgrey";
+            break;
+        default:
+            break;
+        }
+        if (!color.isEmpty()) {
+            if (!custom_color_hint.isEmpty())
+                color = custom_color_hint;
+            message.prepend(QString("<font color='%1'>").arg(color));
+        }
+
+        if (message_type == Logger::Fatal)
+            message.append("</b>");
+        return message;
+    }
+
+    // Formats a record the way FormattingEngine_HTML did before it built its messages in a single buffer.
+    QString referenceHtmlFormat(const LogRecord& record) {
+        QList<QVariant> messages = record.messages();
+        if (messages.count() == 0)
+            return "";
+
+        QString color;
+        switch (record.messageType()) {
+        case Logger::Trace:
+        case Logger::Debug:
+            color = "grey";
+            break;
+        case Logger::Warning:
+            color = "orange";
+            break;
+        case Logger::Info:
+            color = "black";
+            break;
+        case Logger::Error:
+        case Logger::Fatal:
+            color = "red";
+            break;
+        default:
+            return QString();
+        }
+
+        QString message = QString("<td>%1</td><td><font color='%2'>%3</font></td>").arg(record.timestamp().time().toString()).arg(color).arg(AbstractFormattingEngine::escape(messages.front().toString()));
+        message.prepend("<tr><font size=\"5\" face=\"verdana\">");
+        message.append("</font></tr>");
+        return message;
+    }
+
+    // A formatting engine which counts how many times it formatted the records of a message.
+    class CountingFormattingEngine : public AbstractFormattingEngine {
+    public:
+        CountingFormattingEngine(const QString& message) : counted_message(message), format_count(0) {}
+
+        QString initializeString() const { return QString(); }
+        QString finalizeString() const { return QString(); }
+        QString formatMessage(Logger::MessageType message_type, const QList<QVariant>& messages) const {
+            return formatRecord(LogRecord(message_type,messages));
+        }
+        QString formatRecord(const LogRecord& record) const {
+            const QString message = record.messages().front().toString();
+            if (message == counted_message)
+                ++format_count;
+            return QString("Formatted: %1").arg(message);
+        }
+        QString name() const { return QString("Counting Formatting Engine"); }
+        QString fileExtension() const { return QString(); }
+        QString endOfLineChar() const { return QString("\n"); }
+
+        QString         counted_message;
+        mutable int     format_count;
+    };
+
+    // Formats records with its installed formatting engine, recording the formatted messages and the last record it received.
+    class FormattingLoggerEngine : public AbstractLoggerEngine {
+    public:
+        FormattingLoggerEngine(const QString& engine_name) {
+            setName(engine_name);
+            setMessageContexts(Logger::SystemWideMessages);
+        }
+
+        bool initialize() {
+            abstractLoggerEngineData->is_initialized = true;
+            return true;
+        }
+        void finalize() {}
+        QString description() const { return QString("Records formatted messages."); }
+        QString status() const { return QString(); }
+        bool isFormattingEngineConstant() const { return true; }
+        void logMessage(const QString& message, Logger::MessageType message_type) {
+            Q_UNUSED(message_type)
+            formatted_messages << message;
+        }
+
+        void newLogRecord(const LogRecord& record) {
+            last_record = record;
+            AbstractLoggerEngine::newLogRecord(record);
+        }
+
+        QStringList     formatted_messages;
+        LogRecord       last_record;
+    };
+
+    // Returns the message and counts how many times it was called, which shows if the logging macros evaluated their message.
+    QString countedMessage(int* evaluation_count, const QString& message) {
+        ++(*evaluation_count);
+        return message;
+    }
+
+    // Logs a fatal message to each of the given logger engines.
+    class FatalLoggingThread : public QThread {
+    public:
+        FatalLoggingThread(const QStringList& engine_names) : target_engine_names(engine_names) {}
+
+    protected:
+        void run() {
+            for (int i = 0; i < target_engine_names.count(); ++i)
+                Log->logSingleMessage(target_engine_names.at(i),Logger::Fatal,QString("Fatal test message"));
+        }
+
+    private:
+        QStringList target_engine_names;
+    };
+}
+
+int Qtilities::Testing::TestLogging::execTest(int argc, char ** argv) {
+    return QTest::qExec(this,argc,argv);
+}
+
+void Qtilities::Testing::TestLogging::testFileLoggerBlockWhenFull() {
+    const QString file_name = QDir::tempPath() + "/QtilitiesTestBlockWhenFull.log";
+    FileLoggerEngine* engine = createSmallQueueEngine(file_name,FileLoggerEngine::BlockWhenFull);
+    QVERIFY(engine->initialize());
+
+    for (int i = 0; i < back_pressure_message_count; ++i)
+        engine->logMessage(QString("Message %1").arg(i),Logger::Trace);
+    engine->flush();
+    QCOMPARE(engine->droppedMessageCount(),0);
+    delete engine;
+
+    // Blocking producers never lose messages, and messages are written in the order in which they were logged:
+    QList<int> numbers = readMessageNumbers(file_name);
+    QCOMPARE(numbers.count(),back_pressure_message_count);
+    for (int i = 0; i < numbers.count(); ++i)
+        QCOMPARE(numbers.at(i),i);
+    QFile::remove(file_name);
+}
+
+void Qtilities::Testing::TestLogging::testFileLoggerDropOldestWhenFull() {
+    const QString file_name = QDir::tempPath() + "/QtilitiesTestDropOldestWhenFull.log";
+    FileLoggerEngine* engine = createSmallQueueEngine(file_name,FileLoggerEngine::DropOldestWhenFull);
+    QVERIFY(engine->initialize());
+
+    for (int i = 0; i < back_pressure_message_count; ++i)
+        engine->logMessage(QString("Message %1").arg(i),Logger::Info);
+    engine->flush();
+    const int dropped = engine->droppedMessageCount();
+    delete engine;
+
+    // Every message is either written or counted as dropped, the order is kept and the newest message is never dropped:
+    QList<int> numbers = readMessageNumbers(file_name);
+    QCOMPARE(numbers.count() + dropped,back_pressure_message_count);
+    for (int i = 1; i < numbers.count(); ++i)
+        QVERIFY(numbers.at(i) > numbers.at(i-1));
+    QVERIFY(!numbers.isEmpty());
+    QCOMPARE(numbers.last(),back_pressure_message_count - 1);
+    QFile::remove(file_name);
+}
+
+void Qtilities::Testing::TestLogging::testFileLoggerDropTraceWhenFull() {
+    const QString file_name = QDir::tempPath() + "/QtilitiesTestDropTraceWhenFull.log";
+    FileLoggerEngine* engine = createSmallQueueEngine(file_name,FileLoggerEngine::DropTraceWhenFull);
+    QVERIFY(engine->initialize());
+
+    // Every fourth message is a warning, the rest are trace messages:
+    for (int i = 0; i < back_pressure_message_count; ++i)
+        engine->logMessage(QString("Message %1").arg(i),(i % 4 == 0) ? Logger::Warning : Logger::Trace);
+    engine->flush();
+    const int dropped = engine->droppedMessageCount();
+    delete engine;
+
+    QList<int> numbers = readMessageNumbers(file_name);
+    QCOMPARE(numbers.count() + dropped,back_pressure_message_count);
+    int warning_count = 0;
+    for (int i = 0; i < numbers.count(); ++i) {
+        if (i > 0)
+            QVERIFY(numbers.at(i) > numbers.at(i-1));
+        if (numbers.at(i) % 4 == 0)
+            ++warning_count;
+    }
+    // Producers of warnings block instead of dropping them:
+    QCOMPARE(warning_count,back_pressure_message_count / 4);
+    QFile::remove(file_name);
+}
+
+void Qtilities::Testing::TestLogging::testFileLoggerClearWhileLogging() {
+    const QString file_name = QDir::tempPath() + "/QtilitiesTestClearWhileLogging.log";
+    FileLoggerEngine* engine = createSmallQueueEngine(file_name,FileLoggerEngine::BlockWhenFull);
+    QVERIFY(engine->initialize());
+
+    QList<FileLoggingThread*> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads << new FileLoggingThread(engine);
+        threads.last()->start();
+    }
+
+    // The logging threads keep on enqueueing into the writer of the engine while it is cleared:
+    for (int i = 0; i < 50; ++i) {
+        engine->clearLog();
+        QTest::qWait(1);
+    }
+
+    for (int i = 0; i < threads.count(); ++i)
+        threads.at(i)->stopLogging();
+    for (int i = 0; i < threads.count(); ++i)
+        QVERIFY(threads.at(i)->wait(10000));
+    qDeleteAll(threads);
+
+    // After a final clear only messages logged afterwards end up in the file:
+    engine->clearLog();
+    engine->logMessage(QString("Message %1").arg(-1),Logger::Info);
+    engine->flush();
+    delete engine;
+
+    QList<int> numbers = readMessageNumbers(file_name);
+    QCOMPARE(numbers.count(),1);
+    QCOMPARE(numbers.first(),-1);
+    QFile::remove(file_name);
+}
+
+void Qtilities::Testing::TestLogging::testBinaryLoggerFollowing() {
+    const QString file_name = QDir::tempPath() + "/QtilitiesTestBinaryLoggerFollowing" + qti_def_SUFFIX_BINARY_LOG;
+    BinaryLoggerEngine* engine = new BinaryLoggerEngine;
+    engine->setFileName(file_name);
+    QVERIFY(engine->initialize());
+
+    BinaryLogReader reader(file_name);
+    QVERIFY(reader.open());
+    reader.setFollowing(true);
+    QCOMPARE(reader.entryCount(),(quint64) 0);
+
+    // A single info record is far below the index interval, it must still reach the file right away:
+    engine->logMessage("Followed message",Logger::Info);
+    for (int i = 0; i < 50 && reader.entryCount() == 0; ++i)
+        QTest::qWait(100);
+
+    QCOMPARE(reader.entryCount(),(quint64) 1);
+    QVERIFY(!reader.isComplete());
+    QList<BinaryLogEntry> entries = reader.entries();
+    QCOMPARE(entries.count(),1);
+    QCOMPARE(entries.first().message_type,Logger::Info);
+    QCOMPARE(entries.first().messages,QStringList("Followed message"));
+
+    reader.close();
+    delete engine;
+    QFile::remove(file_name);
+}
+
+void Qtilities::Testing::TestLogging::testThreadedLogging_data() {
+    QTest::addColumn<int>("ThreadCount");
+    QTest::addColumn<int>("MessageCount");
+    QTest::newRow("1 thread") << 1 << 10000;
+    QTest::newRow("4 threads") << 4 << 10000;
+    QTest::newRow("16 threads") << 16 << 10000;
+}
+
+void Qtilities::Testing::TestLogging::testThreadedLogging() {
+    QFETCH(int, ThreadCount);
+    QFETCH(int, MessageCount);
+
+    CountingLoggerEngine* engine = new CountingLoggerEngine("Threaded Logging Test Engine");
+    engine->setMessageContexts(Logger::EngineSpecificMessages);
+    QVERIFY(Log->attachLoggerEngine(engine));
+    QVERIFY(Logger::isMessageTypeLogged(Logger::Info));
+
+    logFromThreads(engine->name(),ThreadCount,MessageCount);
+
+    QCOMPARE(engine->received_count,ThreadCount * MessageCount);
+    QCOMPARE(engine->out_of_order_count,0);
+
+    Log->detachLoggerEngine(engine);
+}
+
+void Qtilities::Testing::TestLogging::testFatalDeliveryFromThreads() {
+    DeliveryThreadLoggerEngine* safe_engine = new DeliveryThreadLoggerEngine("Thread Safe Test Engine",true);
+    DeliveryThreadLoggerEngine* unsafe_engine = new DeliveryThreadLoggerEngine("Thread Unsafe Test Engine",false);
+    QVERIFY(Log->attachLoggerEngine(safe_engine));
+    QVERIFY(Log->attachLoggerEngine(unsafe_engine));
+
+    FatalLoggingThread thread(QStringList() << safe_engine->name() << unsafe_engine->name());
+    thread.start();
+    QVERIFY(thread.wait(10000));
+
+    // The thread safe engine received the fatal message on the logging thread, before the logging call returned:
+    QCOMPARE(safe_engine->delivery_threads.count(),1);
+    QVERIFY(safe_engine->delivery_threads.first() == &thread);
+
+    // The other engine receives it through the event loop of its own thread:
+    QCOMPARE(unsafe_engine->delivery_threads.count(),0);
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(unsafe_engine->delivery_threads.count(),1);
+    QVERIFY(unsafe_engine->delivery_threads.first() == QThread::currentThread());
+
+    Log->detachLoggerEngine(safe_engine);
+    Log->detachLoggerEngine(unsafe_engine);
+}
+
+void Qtilities::Testing::TestLogging::testDuplicateSuppression() {
+    RecordingLoggerEngine* engine = new RecordingLoggerEngine("Duplicate Suppression Test Engine");
+    QVERIFY(Log->attachLoggerEngine(engine));
+    Log->setDuplicateSuppressionEnabled(true);
+    const quint64 initial_duplicate_count = Log->duplicateMessageCount();
+
+    for (int i = 0; i < 5; ++i)
+        Log->logSingleMessage(engine->name(),Logger::Warning,QString("Repeated message"));
+    QCOMPARE(engine->messages,QStringList() << "Repeated message");
+
+    // A different message reports the repeats before it is delivered:
+    Log->logSingleMessage(engine->name(),Logger::Warning,QString("Different message"));
+    QCOMPARE(engine->messages,QStringList() << "Repeated message" << "Last message repeated 4 times." << "Different message");
+    QCOMPARE(engine->message_types.at(1),Logger::Warning);
+    QCOMPARE(Log->duplicateMessageCount() - initial_duplicate_count,(quint64) 4);
+
+    // Repeats which are not followed by a different message are reported by flush():
+    engine->messages.clear();
+    Log->logSingleMessage(engine->name(),Logger::Warning,QString("Different message"));
+    Log->logSingleMessage(engine->name(),Logger::Warning,QString("Different message"));
+    QVERIFY(engine->messages.isEmpty());
+    Log->flush();
+    QCOMPARE(engine->messages,QStringList() << "Last message repeated 2 times.");
+
+    // And when duplicate suppression is disabled:
+    engine->messages.clear();
+    Log->logSingleMessage(engine->name(),Logger::Warning,QString("Repeated message"));
+    Log->logSingleMessage(engine->name(),Logger::Warning,QString("Repeated message"));
+    Log->setDuplicateSuppressionEnabled(false);
+    QCOMPARE(engine->messages,QStringList() << "Repeated message" << "Last message repeated 1 time.");
+    Log->logSingleMessage(engine->name(),Logger::Warning,QString("Repeated message"));
+    QCOMPARE(engine->messages.count(),3);
+
+    Log->detachLoggerEngine(engine);
+}
+
+void Qtilities::Testing::TestLogging::testRateLimit() {
+    RecordingLoggerEngine* engine = new RecordingLoggerEngine("Rate Limit Test Engine");
+    QVERIFY(Log->attachLoggerEngine(engine));
+    // Other messages logged while the test runs use their own buckets:
+    Log->setRateLimit(10,5,Logger::RateLimitPerTargetEngine);
+    QVERIFY(Logger::isMessageTypeLogged(Logger::Info));
+
+    // A flood uses up the burst, after which messages are dropped:
+    const int flood_count = 100;
+    for (int i = 0; i < flood_count; ++i)
+        Log->logSingleMessage(engine->name(),Logger::Info,QString("Flood message %1").arg(i));
+    const int delivered_count = engine->messages.count();
+    QVERIFY(delivered_count >= 5);
+    QVERIFY(delivered_count < flood_count);
+    for (int i = 0; i < delivered_count; ++i)
+        QCOMPARE(rateLimitReportCount(engine->messages.at(i)),-1);
+
+    // The flood stops, flush() reports the dropped messages:
+    Log->flush();
+    QCOMPARE(engine->messages.count(),delivered_count + 1);
+    QCOMPARE(engine->message_types.last(),Logger::Warning);
+    QCOMPARE(rateLimitReportCount(engine->messages.last()),flood_count - delivered_count);
+
+    // Nothing is reported twice:
+    Log->flush();
+    QCOMPARE(engine->messages.count(),delivered_count + 1);
+
+    // The bucket refills over time, thus a new window delivers messages without a report:
+    engine->messages.clear();
+    engine->message_types.clear();
+    QTest::qWait(600);
+    for (int i = 0; i < 3; ++i)
+        Log->logSingleMessage(engine->name(),Logger::Info,QString("Window message %1").arg(i));
+    QCOMPARE(engine->messages,QStringList() << "Window message 0" << "Window message 1" << "Window message 2");
+
+    // Dropped messages are reported when the rate limit is changed:
+    engine->messages.clear();
+    engine->message_types.clear();
+    for (int i = 0; i < flood_count; ++i)
+        Log->logSingleMessage(engine->name(),Logger::Info,QString("Flood message %1").arg(i));
+    const int second_delivered_count = engine->messages.count();
+    QVERIFY(second_delivered_count < flood_count);
+    Log->setRateLimit(0);
+    QCOMPARE(engine->messages.count(),second_delivered_count + 1);
+    QCOMPARE(rateLimitReportCount(engine->messages.last()),flood_count - second_delivered_count);
+
+    Log->detachLoggerEngine(engine);
+}
+
+void Qtilities::Testing::TestLogging::testRollingFileLoggerSize() {
+    const QString file_name = QDir::tempPath() + "/QtilitiesTestRollingSize.log";
+    RollingFileLoggerEngine* engine = createRollingEngine(file_name,100,0,3,false);
+    QVERIFY(engine->initialize());
+
+    // Files below the maximum size are not rolled over:
+    engine->logMessage(QString("Message %1").arg(0),Logger::Info);
+    engine->flush();
+    engine->logMessage(QString("Message %1").arg(1),Logger::Info);
+    engine->flush();
+    QCOMPARE(engine->rollCount(),0);
+
+    logLargeMessage(engine,2);
+    QCOMPARE(engine->rollCount(),0);
+    engine->logMessage(QString("Message %1").arg(3),Logger::Info);
+    engine->flush();
+    QCOMPARE(engine->rollCount(),1);
+    delete engine;
+
+    QCOMPARE(readMessageNumbers(generationFileName(file_name,1)),QList<int>() << 0 << 1 << 2);
+    QCOMPARE(readMessageNumbers(file_name),QList<int>() << 3);
+    QVERIFY(!QFile::exists(generationFileName(file_name,2)));
+    removeRollingFiles(file_name);
+}
+
+void Qtilities::Testing::TestLogging::testRollingFileLoggerInterval() {
+    const QString file_name = QDir::tempPath() + "/QtilitiesTestRollingInterval.log";
+    RollingFileLoggerEngine* engine = createRollingEngine(file_name,0,2,3,false);
+    QVERIFY(engine->initialize());
+
+    // Large files are not rolled over when the maximum size is 0:
+    logLargeMessage(engine,0);
+    logLargeMessage(engine,1);
+    QCOMPARE(engine->rollCount(),0);
+
+    QTest::qWait(2100);
+    engine->logMessage(QString("Message %1").arg(2),Logger::Info);
+    engine->flush();
+    QCOMPARE(engine->rollCount(),1);
+    delete engine;
+
+    QCOMPARE(readMessageNumbers(generationFileName(file_name,1)),QList<int>() << 0 << 1);
+    QCOMPARE(readMessageNumbers(file_name),QList<int>() << 2);
+    removeRollingFiles(file_name);
+}
+
+void Qtilities::Testing::TestLogging::testRollingFileLoggerGenerations() {
+    const QString file_name = QDir::tempPath() + "/QtilitiesTestRollingGenerations.log";
+    RollingFileLoggerEngine* engine = createRollingEngine(file_name,100,0,2,false);
+    QVERIFY(engine->initialize());
+
+    // Every large message after the first one rolls the file over:
+    for (int i = 0; i < 5; ++i)
+        logLargeMessage(engine,i);
+    QCOMPARE(engine->rollCount(),4);
+    delete engine;
+
+    // The newest rolled file is the first generation, and only two generations are kept:
+    QCOMPARE(readMessageNumbers(file_name),QList<int>() << 4);
+    QCOMPARE(readMessageNumbers(generationFileName(file_name,1)),QList<int>() << 3);
+    QCOMPARE(readMessageNumbers(generationFileName(file_name,2)),QList<int>() << 2);
+    QVERIFY(!QFile::exists(generationFileName(file_name,3)));
+
+    // The file of a previous session becomes the first generation when the engine is initialized:
+    engine = new RollingFileLoggerEngine;
+    engine->setFileName(file_name);
+    engine->setMaximumFileSize(100);
+    engine->setGenerations(2);
+    engine->setCompressionEnabled(false);
+    QVERIFY(engine->initialize());
+    engine->logMessage(QString("Message %1").arg(5),Logger::Info);
+    engine->flush();
+    delete engine;
+
+    QCOMPARE(readMessageNumbers(file_name),QList<int>() << 5);
+    QCOMPARE(readMessageNumbers(generationFileName(file_name,1)),QList<int>() << 4);
+    QCOMPARE(readMessageNumbers(generationFileName(file_name,2)),QList<int>() << 3);
+    QVERIFY(!QFile::exists(generationFileName(file_name,3)));
+    removeRollingFiles(file_name);
+}
+
+void Qtilities::Testing::TestLogging::testRollingFileLoggerCompression() {
+    // The same messages are logged to an engine which compresses rolled files and one which does not:
+    const QString plain_file_name = QDir::tempPath() + "/QtilitiesTestRollingPlain.log";
+    const QString compressed_file_name = QDir::tempPath() + "/QtilitiesTestRollingCompressed.log";
+    RollingFileLoggerEngine* plain_engine = createRollingEngine(plain_file_name,100,0,2,false);
+    RollingFileLoggerEngine* compressed_engine = createRollingEngine(compressed_file_name,100,0,2,true);
+    // This formatting engine does not add the session date to the files, thus both engines write the same text:
+    plain_engine->installFormattingEngine(Log->formattingEngineReference(qti_def_FORMATTING_ENGINE_QT_MSG));
+    compressed_engine->installFormattingEngine(Log->formattingEngineReference(qti_def_FORMATTING_ENGINE_QT_MSG));
+    QVERIFY(plain_engine->initialize());
+    QVERIFY(compressed_engine->initialize());
+
+    for (int i = 0; i < 3; ++i) {
+        logLargeMessage(plain_engine,i);
+        logLargeMessage(compressed_engine,i);
+    }
+    QCOMPARE(compressed_engine->rollCount(),2);
+    // Finalizing the engine waits for the compression of the rolled files:
+    delete plain_engine;
+    delete compressed_engine;
+
+    for (int generation = 1; generation <= 2; ++generation) {
+        const QString compressed_generation = generationFileName(compressed_file_name,generation) + qti_def_SUFFIX_COMPRESSED_LOG;
+        QVERIFY(QFile::exists(compressed_generation));
+        QVERIFY(!QFile::exists(generationFileName(compressed_file_name,generation)));
+
+        const QByteArray expected = readFileContents(generationFileName(plain_file_name,generation));
+        QVERIFY(!expected.isEmpty());
+        QCOMPARE(qUncompress(readFileContents(compressed_generation)),expected);
+    }
+    QCOMPARE(readFileContents(compressed_file_name),readFileContents(plain_file_name));
+
+    removeRollingFiles(plain_file_name);
+    removeRollingFiles(compressed_file_name);
+}
+
+void Qtilities::Testing::TestLogging::testRollingFileLoggerSessionConfig() {
+    RollingFileLoggerEngine source_engine;
+    source_engine.setFileName(QDir::tempPath() + "/QtilitiesTestRollingSession.log");
+    source_engine.setMaximumFileSize(1234567);
+    source_engine.setRollInterval(3600);
+    source_engine.setGenerations(7);
+    source_engine.setCompressionEnabled(false);
+    QCOMPARE(source_engine.factoryTag(),QString(qti_def_FACTORY_TAG_ROLLING_FILE_LOGGER_ENGINE));
+
+    QByteArray config;
+    {
+        QDataStream stream(&config,QIODevice::WriteOnly);
+        QVERIFY(source_engine.exportBinary(stream));
+    }
+
+    RollingFileLoggerEngine import_engine;
+    {
+        QDataStream stream(&config,QIODevice::ReadOnly);
+        QVERIFY(import_engine.importBinary(stream));
+        QVERIFY(stream.atEnd());
+    }
+    QCOMPARE(import_engine.getFileName(),source_engine.getFileName());
+    QCOMPARE(import_engine.maximumFileSize(),(qint64) 1234567);
+    QCOMPARE(import_engine.rollInterval(),3600);
+    QCOMPARE(import_engine.generations(),7);
+    QCOMPARE(import_engine.compressionEnabled(),false);
+
+    // Truncated configurations are rejected:
+    RollingFileLoggerEngine truncated_engine;
+    QByteArray truncated_config = config.left(config.size() - 1);
+    QDataStream truncated_stream(&truncated_config,QIODevice::ReadOnly);
+    QVERIFY(!truncated_engine.importBinary(truncated_stream));
+}
+
+void Qtilities::Testing::TestLogging::testColorFormattingHints_data() {
+    QTest::addColumn<QString>("Pattern");
+    QTest::addColumn<int>("Syntax");
+    QTest::addColumn<int>("CaseSensitivity");
+    QTest::addColumn<QStringList>("Messages");
+
+    const QStringList quantified_messages = QStringList() << "" << "b" << "ab" << "aab" << "aaab" << "ba" << "abb" << "c";
+    QTest::newRow("literal prefix") << QString("Saved.*") << (int) QRegExp::RegExp << (int) Qt::CaseSensitive
+                                    << (QStringList() << "Saved" << "Saved file" << "saved file" << "Save" << "File Saved" << "");
+    QTest::newRow("star on first character") << QString("a*b") << (int) QRegExp::RegExp << (int) Qt::CaseSensitive << quantified_messages;
+    QTest::newRow("optional first character") << QString("a?b") << (int) QRegExp::RegExp << (int) Qt::CaseSensitive << quantified_messages;
+    QTest::newRow("plus on second character") << QString("ab+") << (int) QRegExp::RegExp << (int) Qt::CaseSensitive << quantified_messages;
+    QTest::newRow("interval on second character") << QString("ab{0,2}c") << (int) QRegExp::RegExp << (int) Qt::CaseSensitive
+                                                  << (QStringList() << "ac" << "abc" << "abbc" << "abbbc" << "a" << "bc");
+    QTest::newRow("alternation") << QString("Error|Warning: .*") << (int) QRegExp::RegExp << (int) Qt::CaseSensitive
+                                 << (QStringList() << "Error" << "Error: failed" << "Warning: careful" << "Warning" << "Info: fine" << "");
+    QTest::newRow("grouped alternation") << QString("(Saved|Loaded) file") << (int) QRegExp::RegExp << (int) Qt::CaseSensitive
+                                         << (QStringList() << "Saved file" << "Loaded file" << "Closed file" << "Saved" << "Loaded file twice");
+    QTest::newRow("case insensitive") << QString("Success.*") << (int) QRegExp::RegExp << (int) Qt::CaseInsensitive
+                                      << (QStringList() << "Success" << "success: done" << "SUCCESS" << "Succeeded" << "No success");
+    QTest::newRow("wildcard") << QString("?rror*") << (int) QRegExp::Wildcard << (int) Qt::CaseSensitive
+                              << (QStringList() << "Error" << "error: failed" << "rror" << "Errors" << "An error");
+    QTest::newRow("wildcard case insensitive") << QString("Success*") << (int) QRegExp::Wildcard << (int) Qt::CaseInsensitive
+                                               << (QStringList() << "Success" << "success: done" << "SUCCESS" << "Succeeded");
+    QTest::newRow("wildcard set") << QString("[EW]rror*") << (int) QRegExp::Wildcard << (int) Qt::CaseSensitive
+                                  << (QStringList() << "Error" << "Wrror" << "Xrror" << "[EW]rror");
+    QTest::newRow("wildcard unix escaped star") << QString("File\\*name*") << (int) QRegExp::WildcardUnix << (int) Qt::CaseSensitive
+                                                << (QStringList() << "File*name" << "File*name.txt" << "Filename" << "File_name" << "File\\name");
+    QTest::newRow("escaped characters") << QString("C:\\\\temp\\.log") << (int) QRegExp::RegExp << (int) Qt::CaseSensitive
+                                        << (QStringList() << "C:\\temp.log" << "C:\\tempxlog" << "C:temp.log" << "C:\\temp.log2");
+    QTest::newRow("escaped character class") << QString("\\d+ files") << (int) QRegExp::RegExp << (int) Qt::CaseSensitive
+                                             << (QStringList() << "3 files" << "42 files" << "d files" << " files");
+    QTest::newRow("fixed string") << QString("a.b") << (int) QRegExp::FixedString << (int) Qt::CaseSensitive
+                                  << (QStringList() << "a.b" << "axb" << "A.B" << "a.bc");
+    QTest::newRow("fixed string case insensitive") << QString("a.b") << (int) QRegExp::FixedString << (int) Qt::CaseInsensitive
+                                                   << (QStringList() << "a.b" << "axb" << "A.B" << "a.bc");
+}
+
+void Qtilities::Testing::TestLogging::testColorFormattingHints() {
+    QFETCH(QString, Pattern);
+    QFETCH(int, Syntax);
+    QFETCH(int, CaseSensitivity);
+    QFETCH(QStringList, Messages);
+
+    QRegExp regexp(Pattern,(Qt::CaseSensitivity) CaseSensitivity,(QRegExp::PatternSyntax) Syntax);
+    QVERIFY(regexp.isValid());
+    HintTestFormattingEngine engine;
+    QVERIFY(engine.addColorFormattingHint(CustomFormattingHint(regexp,"green",Logger::Info | Logger::Warning)));
+
+    for (int i = 0; i < Messages.count(); ++i) {
+        const QString& message = Messages.at(i);
+        QRegExp reference(regexp);
+        const QString expected_hint = reference.exactMatch(message) ? QString("green") : QString();
+
+        // A single message type uses the hints compiled for that type, other flags check all hints:
+        QCOMPARE(engine.matchColorFormattingHint(message,Logger::Info),expected_hint);
+        QCOMPARE(engine.matchColorFormattingHint(message,Logger::Warning),expected_hint);
+        QCOMPARE(engine.matchColorFormattingHint(message,Logger::Info | Logger::Error),expected_hint);
+        QCOMPARE(engine.matchColorFormattingHint(message,Logger::AllLogLevels),expected_hint);
+        QVERIFY(engine.matchColorFormattingHint(message,Logger::Error).isEmpty());
+    }
+}
+
+void Qtilities::Testing::TestLogging::testRichTextAndHtmlFormatting() {
+    AbstractFormattingEngine* rich_text_engine = Log->formattingEngineReference(qti_def_FORMATTING_ENGINE_RICH_TEXT);
+    AbstractFormattingEngine* html_engine = Log->formattingEngineReference(qti_def_FORMATTING_ENGINE_HTML);
+    QVERIFY(rich_text_engine);
+    QVERIFY(html_engine);
+
+    CustomFormattingHint hint(QRegExp("Special*",Qt::CaseSensitive,QRegExp::Wildcard),"green",Logger::Info | Logger::Error);
+    QVERIFY(rich_text_engine->addColorFormattingHint(hint));
+
+    QList<Logger::MessageType> message_types;
+    message_types << Logger::Trace << Logger::Debug << Logger::Info << Logger::Warning << Logger::Error << Logger::Fatal << Logger::None;
+    QList<QList<QVariant> > message_lists;
+    message_lists << (QList<QVariant>() << QString("Plain message"));
+    message_lists << (QList<QVariant>() << QString("<b>Markup</b> & \"quotes\""));
+    message_lists << (QList<QVariant>() << QString("Special message with <tags>"));
+    message_lists << (QList<QVariant>() << QString("First & last") << QString("Parameter <1>") << 42);
+    message_lists << (QList<QVariant>() << QString());
+
+    for (int t = 0; t < message_types.count(); ++t) {
+        for (int m = 0; m < message_lists.count(); ++m) {
+            LogRecord record(message_types.at(t),message_lists.at(m));
+            const QString custom_color_hint = rich_text_engine->matchColorFormattingHint(record.messages().front().toString(),record.messageType());
+            QCOMPARE(rich_text_engine->formatRecord(record),referenceRichTextFormat(record,custom_color_hint));
+            QCOMPARE(html_engine->formatRecord(record),referenceHtmlFormat(record));
+        }
+    }
+
+    // The hint is used for the types it applies to:
+    LogRecord special_record(Logger::Info,QList<QVariant>() << QString("Special message"));
+    QVERIFY(rich_text_engine->formatRecord(special_record).startsWith("<font color='green'>"));
+    LogRecord special_warning_record(Logger::Warning,QList<QVariant>() << QString("Special message"));
+    QVERIFY(rich_text_engine->formatRecord(special_warning_record).startsWith("<font color='orange'>"));
+
+    rich_text_engine->removeColorFormattingHint(hint);
+}
+
+void Qtilities::Testing::TestLogging::testLoggerEngineRoutes() {
+    RecordingLoggerEngine* warning_engine = new RecordingLoggerEngine("Route Test Warning Engine");
+    warning_engine->setMessageContexts(Logger::SystemWideMessages | Logger::PriorityMessages);
+    warning_engine->setEnabledMessageTypes(Logger::Warning | Logger::Error);
+    RecordingLoggerEngine* fatal_engine = new RecordingLoggerEngine("Route Test Fatal Engine");
+    fatal_engine->setMessageContexts(Logger::SystemWideMessages);
+    fatal_engine->setEnabledMessageTypes(Logger::Error | Logger::Fatal);
+    RecordingLoggerEngine* all_engine = new RecordingLoggerEngine("Route Test All Engine");
+    all_engine->setMessageContexts(Logger::SystemWideMessages | Logger::PriorityMessages);
+    all_engine->setEnabledMessageTypes(Logger::AllLogLevels);
+    QVERIFY(Log->attachLoggerEngine(warning_engine));
+    QVERIFY(Log->attachLoggerEngine(fatal_engine));
+    QVERIFY(Log->attachLoggerEngine(all_engine));
+    takeRouteTestMessageTypes(warning_engine);
+    takeRouteTestMessageTypes(fatal_engine);
+    takeRouteTestMessageTypes(all_engine);
+
+    // Each engine receives exactly the system wide messages of the types it accepts:
+    logRouteTestMessages(false);
+    QCOMPARE(takeRouteTestMessageTypes(warning_engine),routeTestMessageTypes(Logger::Warning | Logger::Error));
+    QCOMPARE(takeRouteTestMessageTypes(fatal_engine),routeTestMessageTypes(Logger::Error | Logger::Fatal));
+    QCOMPARE(takeRouteTestMessageTypes(all_engine),routeTestMessageTypes(Logger::AllLogLevels));
+
+    // Priority messages only reach the engines which accept priority messages:
+    logRouteTestMessages(true);
+    QCOMPARE(takeRouteTestMessageTypes(warning_engine),routeTestMessageTypes(Logger::Warning | Logger::Error));
+    QVERIFY(takeRouteTestMessageTypes(fatal_engine).isEmpty());
+    QCOMPARE(takeRouteTestMessageTypes(all_engine),routeTestMessageTypes(Logger::AllLogLevels));
+
+    // Inactive engines are removed from the routes, and added again when they are activated:
+    warning_engine->setActive(false);
+    logRouteTestMessages(false);
+    logRouteTestMessages(true);
+    QVERIFY(takeRouteTestMessageTypes(warning_engine).isEmpty());
+    QCOMPARE(takeRouteTestMessageTypes(fatal_engine),routeTestMessageTypes(Logger::Error | Logger::Fatal));
+    takeRouteTestMessageTypes(all_engine);
+    warning_engine->setActive(true);
+    logRouteTestMessages(false);
+    QCOMPARE(takeRouteTestMessageTypes(warning_engine),routeTestMessageTypes(Logger::Warning | Logger::Error));
+
+    // Changing the message types of an engine changes its routes:
+    warning_engine->setEnabledMessageTypes(Logger::Info | Logger::Fatal);
+    fatal_engine->setEnabledMessageTypes(Logger::Warning);
+    logRouteTestMessages(false);
+    QCOMPARE(takeRouteTestMessageTypes(warning_engine),routeTestMessageTypes(Logger::Info | Logger::Fatal));
+    QCOMPARE(takeRouteTestMessageTypes(fatal_engine),routeTestMessageTypes(Logger::Warning));
+    QCOMPARE(takeRouteTestMessageTypes(all_engine),routeTestMessageTypes(Logger::AllLogLevels));
+
+    Log->detachLoggerEngine(warning_engine);
+    Log->detachLoggerEngine(fatal_engine);
+    Log->detachLoggerEngine(all_engine);
+}
+
+void Qtilities::Testing::TestLogging::testMessageTypeLoggedCache() {
+    // No attached engine accepts warnings while the test runs:
+    QList<AbstractLoggerEngine*> attached_engines;
+    QList<Logger::MessageTypeFlags> attached_engine_types;
+    for (int i = 0; i < Log->attachedLoggerEngineCount(); ++i) {
+        AbstractLoggerEngine* engine = Log->loggerEngineReferenceAt(i);
+        if (!engine)
+            continue;
+        attached_engines << engine;
+        attached_engine_types << engine->getEnabledMessageTypes();
+        engine->setEnabledMessageTypes(engine->getEnabledMessageTypes() & ~Logger::Warning);
+    }
+
+    RecordingLoggerEngine* engine = new RecordingLoggerEngine("Message Type Cache Test Engine");
+    engine->setMessageContexts(Logger::SystemWideMessages);
+    engine->setEnabledMessageTypes(Logger::Info);
+    QVERIFY(Log->attachLoggerEngine(engine));
+    QVERIFY(Logger::isMessageTypeLogged(Logger::Info));
+    QVERIFY(!Logger::isMessageTypeLogged(Logger::Warning));
+
+    // The message of a disabled message type is not evaluated:
+    int evaluation_count = 0;
+    LOG_WARNING(countedMessage(&evaluation_count,"Cached warning message"));
+    LOG_WARNING_E(engine->name(),countedMessage(&evaluation_count,"Cached warning message"));
+    QCOMPARE(evaluation_count,0);
+    QVERIFY(!engine->delivered_messages.contains("Cached warning message"));
+
+    // Enabling the message type on an engine updates the cache before the next message is logged:
+    engine->setEnabledMessageTypes(Logger::Info | Logger::Warning);
+    QVERIFY(Logger::isMessageTypeLogged(Logger::Warning));
+    LOG_WARNING(countedMessage(&evaluation_count,"Cached warning message"));
+    QCOMPARE(evaluation_count,1);
+    QCOMPARE(engine->messages.count("Cached warning message"),1);
+
+    // And so does deactivating the engine:
+    engine->setActive(false);
+    QVERIFY(!Logger::isMessageTypeLogged(Logger::Warning));
+    LOG_WARNING(countedMessage(&evaluation_count,"Cached warning message"));
+    QCOMPARE(evaluation_count,1);
+
+    Log->detachLoggerEngine(engine);
+    for (int i = 0; i < attached_engines.count(); ++i)
+        attached_engines.at(i)->setEnabledMessageTypes(attached_engine_types.at(i));
+    QVERIFY(Logger::isMessageTypeLogged(Logger::Info));
+}
+
+void Qtilities::Testing::TestLogging::testSharedRecordFormatting() {
+    const QString message = "Shared formatting message";
+    CountingFormattingEngine formatting_engine(message);
+    FormattingLoggerEngine* first_engine = new FormattingLoggerEngine("Shared Formatting First Test Engine");
+    FormattingLoggerEngine* second_engine = new FormattingLoggerEngine("Shared Formatting Second Test Engine");
+    first_engine->installFormattingEngine(&formatting_engine);
+    second_engine->installFormattingEngine(&formatting_engine);
+    QVERIFY(Log->attachLoggerEngine(first_engine));
+    QVERIFY(Log->attachLoggerEngine(second_engine));
+    QVERIFY(Logger::isMessageTypeLogged(Logger::Info));
+
+    // Both engines log the message, but the record is formatted only once:
+    Log->logMessage(QString(),Logger::Info,message);
+    QVERIFY(first_engine->formatted_messages.contains("Formatted: " + message));
+    QVERIFY(second_engine->formatted_messages.contains("Formatted: " + message));
+    QCOMPARE(formatting_engine.format_count,1);
+    QCOMPARE(first_engine->last_record.messages().front().toString(),message);
+    QCOMPARE(first_engine->last_record.formattedMessageCount(),1);
+    QCOMPARE(second_engine->last_record.formattedMessageCount(),1);
+
+    Log->detachLoggerEngine(first_engine);
+    Log->detachLoggerEngine(second_engine);
+}
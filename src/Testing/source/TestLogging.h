@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (c) 2009-2013, Jaco Naudé
+**
+** This file is part of Qtilities.
+**
+** For licensing information, please see
+** http://jpnaude.github.io/Qtilities/page_licensing.html
+**
+****************************************************************************/
+
+#ifndef TEST_LOGGING_H
+#define TEST_LOGGING_H
+
+#include "Testing_global.h"
+#include "ITestable.h"
+
+#include <QtTest/QtTest>
+
+namespace Qtilities {
+    namespace Testing {
+        using namespace Interfaces;
+
+        /*!
+        \class TestLogging
+        \brief Allows testing of the Qtilities::Logging module.
+
+        <i>This class was added in %Qtilities v1.5.</i>
+          */
+        class TESTING_SHARED_EXPORT TestLogging: public QObject, public ITestable
+        {
+            Q_OBJECT
+            Q_INTERFACES(Qtilities::Testing::Interfaces::ITestable)
+
+        public:
+            // --------------------------------
+            // IObjectBase Implementation
+            // --------------------------------
+            QObject* objectBase() { return this; }
+            const QObject* objectBase() const { return this; }
+
+            // --------------------------------
+            // ITestable Implementation
+            // --------------------------------
+            int execTest(int argc = 0, char ** argv = 0);
+            QString testName() const { return tr("Logging"); }
+
+        private slots:
+            //! Tests that an asynchronous FileLoggerEngine with a small queue using FileLoggerEngine::BlockWhenFull writes all messages in order.
+            void testFileLoggerBlockWhenFull();
+            //! Tests that an asynchronous FileLoggerEngine with a small queue using FileLoggerEngine::DropOldestWhenFull only drops older messages.
+            void testFileLoggerDropOldestWhenFull();
+            //! Tests that an asynchronous FileLoggerEngine with a small queue using FileLoggerEngine::DropTraceWhenFull only drops trace and debug messages.
+            void testFileLoggerDropTraceWhenFull();
+            //! Tests clearing an asynchronous FileLoggerEngine while other threads are logging to it.
+            void testFileLoggerClearWhileLogging();
+            //! Tests that a BinaryLogReader following a binary log file sees a single info record as soon as it is logged.
+            void testBinaryLoggerFollowing();
+            void testThreadedLogging_data();
+            //! Tests logging from a number of threads at the same time, checking that no messages are lost and that the messages of each thread arrive in order.
+            void testThreadedLogging();
+            //! Tests that fatal messages logged from other threads are only delivered on the logging thread to thread safe engines.
+            void testFatalDeliveryFromThreads();
+            //! Tests that identical consecutive messages are collapsed, and that the repeats are reported.
+            void testDuplicateSuppression();
+            //! Tests that the rate limit drops messages above the rate, and that the dropped messages are reported when a flood stops.
+            void testRateLimit();
+            //! Tests that a RollingFileLoggerEngine rolls its file over when it reaches the maximum file size.
+            void testRollingFileLoggerSize();
+            //! Tests that a RollingFileLoggerEngine rolls its file over when the roll interval passed.
+            void testRollingFileLoggerInterval();
+            //! Tests that rolled files of a RollingFileLoggerEngine are shifted through the generations, and that only the configured number of generations is kept.
+            void testRollingFileLoggerGenerations();
+            //! Tests that the compressed generations of a RollingFileLoggerEngine decompress to the text of the rolled file.
+            void testRollingFileLoggerCompression();
+            //! Tests that the settings of a RollingFileLoggerEngine survive a round trip through its session configuration.
+            void testRollingFileLoggerSessionConfig();
+            void testColorFormattingHints_data();
+            //! Tests that the compiled color formatting hints of a formatting engine match the same messages as QRegExp::exactMatch() on their expressions.
+            void testColorFormattingHints();
+            //! Tests that the rich text and HTML formatting engines format records exactly like they did before they built their messages in a single buffer.
+            void testRichTextAndHtmlFormatting();
+            //! Tests that system wide and priority messages are routed to the engines which accept their types, and that the routes follow changes to the engines.
+            void testLoggerEngineRoutes();
+            //! Tests that the logging macros do not evaluate messages of types which no engine accepts, and that enabling a type on an engine is seen by Logger::isMessageTypeLogged() right away.
+            void testMessageTypeLoggedCache();
+            //! Tests that a record logged to two engines which share a formatting engine is formatted once.
+            void testSharedRecordFormatting();
+        };
+    }
+}
+
+#endif // TEST_LOGGING_H
@@ -190,3 +190,44 @@ void Qtilities::Testing::TestObjectManager::testCompareDynamicPropertiesDiff() {
 void Qtilities::Testing::TestObjectManager::testMoveSubjects() {
 
 }
+
+void Qtilities::Testing::TestObjectManager::testPropertyStore() {
+    QObject* obj = new QObject;
+
+    // Properties set through the ObjectManager:
+    MultiContextProperty multi_context_property("Multi Context Property");
+    multi_context_property.setValue(QVariant(10),1);
+    multi_context_property.setValue(QVariant(30),3);
+    ObjectManager::setMultiContextProperty(obj,multi_context_property);
+    ObjectManager::setSharedProperty(obj,"Shared Property",QVariant(QString("Shared")));
+
+    QVERIFY(ObjectManager::getPropertyValue(obj,"Multi Context Property",1).toInt() == 10);
+    QVERIFY(ObjectManager::getPropertyValue(obj,"Multi Context Property",3).toInt() == 30);
+    QVERIFY(!ObjectManager::getPropertyValue(obj,"Multi Context Property",2).isValid());
+    QVERIFY(ObjectManager::getPropertyValue(obj,"Shared Property",1).toString() == QString("Shared"));
+    QVERIFY(ObjectManager::getPropertyValue(obj,"Shared Property",5).toString() == QString("Shared"));
+    QVERIFY(!ObjectManager::getPropertyValue(obj,"Missing Property").isValid());
+
+    // Changing a value must be reflected:
+    multi_context_property.setValue(QVariant(20),2);
+    ObjectManager::setMultiContextProperty(obj,multi_context_property);
+    QVERIFY(ObjectManager::getPropertyValue(obj,"Multi Context Property",2).toInt() == 20);
+
+    // Properties changed directly on the object must be picked up:
+    SharedProperty direct_property("Shared Property",QVariant(QString("Direct")));
+    obj->setProperty("Shared Property",qVariantFromValue(direct_property));
+    QVERIFY(ObjectManager::getPropertyValue(obj,"Shared Property").toString() == QString("Direct"));
+
+    // Removed properties must not be returned:
+    obj->setProperty("Multi Context Property",QVariant());
+    QVERIFY(!ObjectManager::getPropertyValue(obj,"Multi Context Property",1).isValid());
+
+    // Non Qtilities properties are not returned:
+    obj->setProperty("Normal Property",QVariant(5));
+    QVERIFY(!ObjectManager::getPropertyValue(obj,"Normal Property").isValid());
+
+    // Deleted objects must be removed from the store:
+    int count = ObjectPropertyStore::instance()->count();
+    delete obj;
+    QVERIFY(ObjectPropertyStore::instance()->count() == count - 1);
+}
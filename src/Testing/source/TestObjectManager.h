@@ -49,6 +49,8 @@ namespace Qtilities {
             void testCompareDynamicPropertiesDiff();
             //! Tests moving of subjects between observers using ObjectManager::moveSubjects().
             void testMoveSubjects();
+            //! Tests getting property values through ObjectManager::getPropertyValue() and the object property store.
+            void testPropertyStore();
         };
     }
 }
@@ -14,6 +14,72 @@
 #include <QtilitiesCoreGui>
 using namespace QtilitiesCoreGui;
 
+namespace {
+    // Reads an observer with concurrent reads enabled from a worker thread and counts the inconsistent views it gets.
+    class ObserverReaderThread : public QThread {
+    public:
+        ObserverReaderThread(Observer* observer, int iterations, int full_count) : QThread(),
+            observer(observer),
+            iterations(iterations),
+            full_count(full_count),
+            inconsistent_views(0) {}
+
+        void run() {
+            for (int i = 0; i < iterations; ++i) {
+                // Subjects are attached and detached in batches, thus readers must only see empty or full observers:
+                QList<QObject*> snapshot = observer->subjectSnapshot();
+                if (snapshot.count() != 0 && snapshot.count() != full_count)
+                    ++inconsistent_views;
+                int count = observer->subjectCount();
+                if (count != 0 && count != full_count)
+                    ++inconsistent_views;
+                QList<QObject*> references = observer->subjectReferences();
+                if (references.count() != 0 && references.count() != full_count)
+                    ++inconsistent_views;
+            }
+        }
+
+        Observer*   observer;
+        int         iterations;
+        int         full_count;
+        int         inconsistent_views;
+    };
+}
+
+namespace {
+    // Counts the items visited and the items visited in the context of each parent.
+    class ItemCountVisitor : public AbstractTreeVisitor {
+    public:
+        ItemCountVisitor() : item_count(0), reduce_count(0) {}
+
+        AbstractTreeVisitor* createPartialVisitor() const {
+            return new ItemCountVisitor;
+        }
+        void visit(QObject* obj, Observer* parent) {
+            Q_UNUSED(obj)
+            ++item_count;
+            ++parent_counts[parent];
+            visited << obj;
+        }
+        void reduce(AbstractTreeVisitor* partial_visitor) {
+            ItemCountVisitor* partial = static_cast<ItemCountVisitor*> (partial_visitor);
+            item_count += partial->item_count;
+            QMap<Observer*,int>::const_iterator itr = partial->parent_counts.constBegin();
+            while (itr != partial->parent_counts.constEnd()) {
+                parent_counts[itr.key()] += itr.value();
+                ++itr;
+            }
+            visited << partial->visited;
+            ++reduce_count;
+        }
+
+        int                 item_count;
+        int                 reduce_count;
+        QMap<Observer*,int> parent_counts;
+        QList<QObject*>     visited;
+    };
+}
+
 int Qtilities::Testing::TestObserver::execTest(int argc, char ** argv) {
     return QTest::qExec(this,argc,argv);
 }
@@ -60,6 +126,336 @@ void Qtilities::Testing::TestObserver::testSubjectLimit() {
     QVERIFY(node.addItem("Item 3") != 0);
 }
 
+void Qtilities::Testing::TestObserver::testSubjectLookups() {
+    Observer observer("Observer");
+    QPointer<QObject> object1 = new QObject();
+    object1->setObjectName("Object 1");
+    QPointer<QObject> object2 = new QObject();
+    object2->setObjectName("Object 2");
+    QObject* object3 = new QObject();
+    object3->setObjectName("Object 3");
+
+    QVERIFY(observer.attachSubject(object1));
+    QVERIFY(observer.attachSubject(object2));
+    QVERIFY(observer.attachSubject(object3));
+
+    // Lookups by pointer, ID and name:
+    QVERIFY(observer.contains(object1));
+    QVERIFY(observer.contains(object3));
+    int id2 = observer.subjectID(1);
+    QVERIFY(id2 != -1);
+    QVERIFY(observer.subjectReference(id2) == object2);
+    QVERIFY(observer.subjectID("Object 2") == id2);
+    QVERIFY(observer.subjectReference("Object 2") == object2);
+    QVERIFY(observer.subjectReference("object 2") == 0);
+    QVERIFY(observer.subjectReference("object 2",Qt::CaseInsensitive) == object2);
+
+    // Renaming:
+    object2->setObjectName("Renamed Object");
+    QVERIFY(observer.subjectReference("Object 2") == 0);
+    QVERIFY(observer.subjectReference("Renamed Object") == object2);
+    QVERIFY(observer.containsSubjectWithName("renamed object",Qt::CaseInsensitive));
+
+    // Detaching:
+    QVERIFY(observer.detachSubject(object2));
+    QVERIFY(!observer.contains(object2));
+    QVERIFY(observer.subjectReference(id2) == 0);
+    QVERIFY(observer.subjectReference("Renamed Object") == 0);
+
+    // Deleting:
+    delete object3;
+    QVERIFY(observer.subjectCount() == 1);
+    QVERIFY(observer.subjectReference("Object 3") == 0);
+    QVERIFY(observer.contains(object1));
+
+    observer.detachAll();
+    QVERIFY(!observer.contains(object1));
+    delete object1;
+    delete object2;
+}
+
+void Qtilities::Testing::TestObserver::testBatchAttachDetach() {
+    Observer observer("Observer");
+    ActivityPolicyFilter* activity_filter = new ActivityPolicyFilter;
+    activity_filter->setActivityPolicy(ActivityPolicyFilter::UniqueActivity);
+    activity_filter->setNewSubjectActivityPolicy(ActivityPolicyFilter::SetNewActive);
+    observer.installSubjectFilter(activity_filter);
+    QSignalSpy spy(&observer, SIGNAL(layoutChanged(QList<QPointer<QObject> >)));
+
+    QList<QObject*> objects;
+    for (int i = 0; i < 100; ++i) {
+        QObject* obj = new QObject;
+        obj->setObjectName(QString("Object %1").arg(i));
+        objects << obj;
+    }
+
+    // Duplicates and null objects in the list must be ignored:
+    QList<QObject*> attach_list = objects;
+    attach_list << objects.at(0) << 0;
+    QList<QPointer<QObject> > attached = observer.attachSubjects(attach_list);
+    QCOMPARE(attached.count(), 100);
+    QCOMPARE(observer.subjectCount(), 100);
+    QCOMPARE(spy.count(), 1);
+    for (int i = 0; i < objects.count(); ++i) {
+        QVERIFY(observer.subjectAt(i) == objects.at(i));
+        QVERIFY(observer.subjectReference(observer.subjectID(i)) == objects.at(i));
+    }
+
+    // Activity must match the result of attaching the objects one after the other:
+    QCOMPARE(activity_filter->activeSubjects().count(), 1);
+    QVERIFY(activity_filter->activeSubjects().front() == objects.last());
+
+    // Attaching again must be rejected:
+    spy.clear();
+    QVERIFY(observer.attachSubjects(objects).isEmpty());
+    QCOMPARE(observer.subjectCount(), 100);
+
+    // The subject limit must be respected in a batch:
+    Observer limited_observer("Limited Observer");
+    limited_observer.setSubjectLimit(10);
+    QCOMPARE(limited_observer.attachSubjects(objects).count(), 10);
+    QCOMPARE(limited_observer.subjectCount(), 10);
+    limited_observer.detachAll();
+
+    // Batch detachment:
+    QList<QObject*> detach_list = objects.mid(0,50);
+    QList<QPointer<QObject> > detached = observer.detachSubjects(detach_list);
+    QCOMPARE(detached.count(), 50);
+    QCOMPARE(observer.subjectCount(), 50);
+    QCOMPARE(spy.count(), 1);
+    for (int i = 0; i < detach_list.count(); ++i) {
+        QVERIFY(!observer.contains(detach_list.at(i)));
+        QVERIFY(Observer::parentCount(detach_list.at(i)) == 0);
+    }
+    for (int i = 0; i < observer.subjectCount(); ++i)
+        QVERIFY(observer.subjectAt(i) == objects.at(i + 50));
+
+    observer.detachAll();
+    qDeleteAll(objects);
+}
+
+void Qtilities::Testing::TestObserver::testConcurrentReads() {
+    Observer observer("Observer");
+    QVERIFY(!observer.concurrentReadsEnabled());
+
+    QList<QObject*> objects;
+    for (int i = 0; i < 100; ++i) {
+        QObject* obj = new QObject;
+        obj->setObjectName(QString("Object %1").arg(i));
+        objects << obj;
+    }
+    observer.attachSubjects(objects,Observer::ManualOwnership);
+
+    observer.setConcurrentReadsEnabled(true);
+    QVERIFY(observer.concurrentReadsEnabled());
+    QCOMPARE(observer.subjectSnapshot().count(), 100);
+
+    ObserverReaderThread reader(&observer,2000,objects.count());
+    reader.start();
+    while (!reader.isFinished()) {
+        observer.detachSubjects(objects);
+        observer.attachSubjects(objects,Observer::ManualOwnership);
+    }
+    reader.wait();
+    QCOMPARE(reader.inconsistent_views, 0);
+
+    // Reads from the thread in which the observer lives see the subject list itself:
+    QCOMPARE(observer.subjectCount(), 100);
+    for (int i = 0; i < objects.count(); ++i)
+        QVERIFY(observer.subjectAt(i) == objects.at(i));
+
+    // Snapshots are only published at the end of processing cycles:
+    observer.startProcessingCycle();
+    observer.detachSubject(objects.front());
+    QCOMPARE(observer.subjectCount(), 99);
+    ObserverReaderThread cycle_reader(&observer,1,100);
+    cycle_reader.start();
+    cycle_reader.wait();
+    QCOMPARE(cycle_reader.inconsistent_views, 0);
+    observer.endProcessingCycle();
+    cycle_reader.full_count = 99;
+    cycle_reader.start();
+    cycle_reader.wait();
+    QCOMPARE(cycle_reader.inconsistent_views, 0);
+
+    observer.setConcurrentReadsEnabled(false);
+    QVERIFY(!observer.concurrentReadsEnabled());
+    observer.detachAll();
+    qDeleteAll(objects);
+}
+
+void Qtilities::Testing::TestObserver::testPropertyChangeDispatch() {
+    Observer observer_with_filter("Observer With Filter");
+    NamingPolicyFilter* naming_filter = new NamingPolicyFilter;
+    QVERIFY(observer_with_filter.installSubjectFilter(naming_filter));
+    Observer observer("Observer");
+
+    QObject* obj = new QObject;
+    obj->setObjectName("Object");
+
+    // Properties which are not reserved or monitored are never filtered:
+    QDynamicPropertyChangeEvent unknown_event("Unknown Property");
+    QVERIFY(!observer.eventFilter(obj,&unknown_event));
+    QVERIFY(!observer_with_filter.eventFilter(obj,&unknown_event));
+
+    // Reserved properties of the observer are always filtered:
+    QDynamicPropertyChangeEvent ownership_event(qti_prop_OWNERSHIP);
+    QVERIFY(observer.eventFilter(obj,&ownership_event));
+    QVERIFY(observer_with_filter.eventFilter(obj,&ownership_event));
+
+    // Reserved properties of subject filters are only filtered in contexts where the filter is installed:
+    QDynamicPropertyChangeEvent name_manager_event(qti_prop_NAME_MANAGER_ID);
+    QVERIFY(!observer.eventFilter(obj,&name_manager_event));
+    QVERIFY(observer_with_filter.eventFilter(obj,&name_manager_event));
+
+    // Valid changes to monitored properties are not filtered:
+    QDynamicPropertyChangeEvent decoration_event(qti_prop_DECORATION);
+    QVERIFY(!observer.eventFilter(obj,&decoration_event));
+    QVERIFY(observer.subjectEventFilteringEnabled());
+
+    // After uninstalling the filter its reserved properties are not filtered anymore:
+    QVERIFY(observer_with_filter.uninstallSubjectFilter(naming_filter));
+    QVERIFY(!observer_with_filter.eventFilter(obj,&name_manager_event));
+    QVERIFY(observer_with_filter.eventFilter(obj,&ownership_event));
+
+    delete obj;
+}
+
+void Qtilities::Testing::TestObserver::testDeferredNotifications() {
+    Observer observer("Observer");
+    observer.setDeferredNotificationsEnabled(true);
+    QVERIFY(observer.deferredNotificationsEnabled());
+    QSignalSpy count_spy(&observer, SIGNAL(numberOfSubjectsChanged(Observer::SubjectChangeIndication,QList<QPointer<QObject> >)));
+    QSignalSpy layout_spy(&observer, SIGNAL(layoutChanged(QList<QPointer<QObject> >)));
+    QSignalSpy flush_spy(&observer, SIGNAL(deferredNotificationsFlushed(QList<QPointer<QObject> >,QList<QPointer<QObject> >,QList<QPointer<QObject> >)));
+
+    QObject* obj1 = new QObject;
+    obj1->setObjectName("Object 1");
+    QObject* obj2 = new QObject;
+    obj2->setObjectName("Object 2");
+    QObject* obj3 = new QObject;
+    obj3->setObjectName("Object 3");
+
+    // Changes are collected until control returns to the event loop:
+    QVERIFY(observer.attachSubject(obj1));
+    QVERIFY(observer.attachSubject(obj2));
+    QVERIFY(observer.attachSubject(obj3));
+    QVERIFY(observer.detachSubject(obj2));
+    QCOMPARE(observer.subjectCount(), 2);
+    QVERIFY(observer.hasPendingNotifications());
+    QCOMPARE(count_spy.count(), 0);
+    QCOMPARE(layout_spy.count(), 0);
+
+    QApplication::processEvents();
+    QVERIFY(!observer.hasPendingNotifications());
+    QCOMPARE(count_spy.count(), 1);
+    QCOMPARE(layout_spy.count(), 1);
+    QCOMPARE(flush_spy.count(), 1);
+
+    // Processing cycles work as before, the change set is flushed when they end:
+    count_spy.clear();
+    layout_spy.clear();
+    observer.startProcessingCycle();
+    QVERIFY(observer.detachSubject(obj3));
+    QVERIFY(!observer.hasPendingNotifications());
+    observer.endProcessingCycle();
+    QCOMPARE(count_spy.count(), 1);
+    QCOMPARE(layout_spy.count(), 1);
+
+    // Layout changes in the tree underneath the observer are collected as well:
+    TreeNode root_node("Root");
+    root_node.setDeferredNotificationsEnabled(true);
+    TreeNode* node_1 = root_node.addNode("Node 1");
+    TreeNode* node_2 = root_node.addNode("Node 2");
+    QApplication::processEvents();
+    QSignalSpy tree_layout_spy(&root_node, SIGNAL(layoutChanged(QList<QPointer<QObject> >)));
+    for (int i = 0; i < 10; ++i) {
+        node_1->addItem(QString("Item 1.%1").arg(i));
+        node_2->addItem(QString("Item 2.%1").arg(i));
+    }
+    QCOMPARE(tree_layout_spy.count(), 0);
+    root_node.flushDeferredNotifications();
+    QCOMPARE(tree_layout_spy.count(), 1);
+
+    // Disabling deferred notifications flushes pending changes:
+    layout_spy.clear();
+    QVERIFY(observer.attachSubject(obj3));
+    QCOMPARE(layout_spy.count(), 0);
+    observer.setDeferredNotificationsEnabled(false);
+    QCOMPARE(layout_spy.count(), 1);
+    QVERIFY(observer.detachSubject(obj3));
+    QCOMPARE(layout_spy.count(), 2);
+
+    delete obj1;
+    delete obj2;
+    delete obj3;
+}
+
+void Qtilities::Testing::TestObserver::testParentReferences() {
+    Observer* observer1 = new Observer("Observer 1");
+    Observer* observer2 = new Observer("Observer 2");
+    Observer* observer3 = new Observer("Observer 3");
+
+    QObject* obj = new QObject;
+    obj->setObjectName("Object");
+    QCOMPARE(Observer::parentCount(obj), 0);
+    QCOMPARE(Observer::parentCount(0), -1);
+
+    // Parents are returned in the order of their observer IDs, not in the order of attachment:
+    QVERIFY(observer3->attachSubject(obj));
+    QVERIFY(observer1->attachSubject(obj));
+    QVERIFY(observer2->attachSubject(obj));
+    QCOMPARE(Observer::parentCount(obj), 3);
+    QList<Observer*> parents = Observer::parentReferences(obj);
+    QCOMPARE(parents.count(), 3);
+    QVERIFY(parents.at(0) == observer1);
+    QVERIFY(parents.at(1) == observer2);
+    QVERIFY(parents.at(2) == observer3);
+
+    QVERIFY(observer2->detachSubject(obj));
+    QCOMPARE(Observer::parentCount(obj), 2);
+    QVERIFY(!Observer::parentReferences(obj).contains(observer2));
+
+    // Deleted observers are removed:
+    delete observer3;
+    QCOMPARE(Observer::parentCount(obj), 1);
+    QVERIFY(Observer::parentReferences(obj).front() == observer1);
+
+    // Deleted objects are removed:
+    QObject* obj2 = new QObject;
+    obj2->setObjectName("Object 2");
+    QVERIFY(observer2->attachSubject(obj2));
+    QCOMPARE(Observer::parentCount(obj2), 1);
+    delete obj2;
+    QCOMPARE(observer2->subjectCount(), 0);
+
+    QVERIFY(observer1->detachSubject(obj));
+    QCOMPARE(Observer::parentCount(obj), 0);
+    QVERIFY(Observer::parentReferences(obj).isEmpty());
+
+    // Objects deleted using deleteLater() are removed as soon as they leave the observer, and never leave entries behind:
+    int index_count = ParentObserverIndex::instance()->count();
+    observer2->setObjectDeletionPolicy(Observer::DeleteLater);
+    QPointer<QObject> obj3 = new QObject;
+    obj3->setObjectName("Object 3");
+    QVERIFY(observer2->attachSubject(obj3,Observer::ObserverScopeOwnership));
+    QCOMPARE(Observer::parentCount(obj3), 1);
+    QVERIFY(observer2->detachSubject(obj3));
+    if (obj3)
+        QCOMPARE(Observer::parentCount(obj3), 0);
+    QCoreApplication::sendPostedEvents(0,QEvent::DeferredDelete);
+    QVERIFY(obj3.isNull());
+    QCOMPARE(ParentObserverIndex::instance()->count(), index_count);
+    QObject* obj4 = new QObject;
+    QCOMPARE(Observer::parentCount(obj4), 0);
+    QVERIFY(Observer::parentReferences(obj4).isEmpty());
+    delete obj4;
+
+    delete observer1;
+    delete observer2;
+    delete obj;
+}
+
 void Qtilities::Testing::TestObserver::testOwnershipManual() {
     LOG_INFO("TestObserver::testOwnershipManual() start:");
 
@@ -279,6 +675,83 @@ void Qtilities::Testing::TestObserver::testTreeChildren() {
     QVERIFY(items_verify.count() == 5);
 }
 
+void Qtilities::Testing::TestObserver::testTreeCache() {
+    TreeNode* rootNode = new TreeNode("Root");
+    TreeNode* parentNode1 = rootNode->addNode("Parent 1");
+    TreeNode* parentNode2 = rootNode->addNode("Parent 2");
+    parentNode1->addItem("Child 1");
+    parentNode2->addItem("Child 2");
+
+    QCOMPARE(rootNode->treeCount(), 4);
+    QCOMPARE(rootNode->treeCount("Qtilities::CoreGui::TreeItem"), 2);
+    int generation = rootNode->treeGeneration();
+
+    // Reading the tree does not change its generation:
+    QCOMPARE(rootNode->treeChildren().count(), 4);
+    QCOMPARE(rootNode->treeGeneration(), generation);
+
+    // Changes deeper in the tree must be propagated to the top of the tree:
+    TreeItem* item = parentNode2->addItem("Child 3");
+    QVERIFY(rootNode->treeGeneration() != generation);
+    QCOMPARE(rootNode->treeCount(), 5);
+    QCOMPARE(rootNode->treeCount("Qtilities::CoreGui::TreeItem"), 3);
+    QVERIFY(rootNode->treeContains(item));
+    QVERIFY(rootNode->treeAt(4) == item);
+
+    // The same item attached to a second parent appears twice in the tree:
+    QVERIFY(parentNode1->attachSubject(item));
+    QCOMPARE(rootNode->treeCount(), 6);
+    QVERIFY(rootNode->treeAt(2) == item);
+
+    // Deleted items must be removed from the tree:
+    delete item;
+    QCOMPARE(rootNode->treeCount(), 4);
+    QVERIFY(!rootNode->treeContains(item));
+    QCOMPARE(rootNode->treeCount("Qtilities::CoreGui::TreeItem"), 2);
+
+    // Detaching a node removes its complete tree:
+    generation = rootNode->treeGeneration();
+    rootNode->detachSubject(parentNode1);
+    QVERIFY(rootNode->treeGeneration() != generation);
+    QCOMPARE(rootNode->treeCount(), 2);
+    QVERIFY(!rootNode->treeContains(parentNode1));
+
+    delete rootNode;
+}
+
+void Qtilities::Testing::TestObserver::testVisitTree() {
+    TreeNode* rootNode = new TreeNode("Root");
+    QList<TreeNode*> nodes;
+    for (int n = 0; n < 10; ++n) {
+        TreeNode* node = rootNode->addNode(QString("Node %1").arg(n));
+        nodes << node;
+        // Subtrees of very different sizes:
+        for (int i = 0; i < n * n * 20; ++i)
+            node->addItem(QString("Item %1").arg(i));
+    }
+
+    ItemCountVisitor visitor;
+    QVERIFY(rootNode->visitTree(&visitor));
+    QCOMPARE(visitor.item_count, rootNode->treeCount());
+    QVERIFY(visitor.reduce_count > 0);
+    QCOMPARE(visitor.parent_counts.value(rootNode), 10);
+    for (int n = 0; n < nodes.count(); ++n)
+        QCOMPARE(visitor.parent_counts.value(nodes.at(n)), n * n * 20);
+
+    // Results are reduced in the order in which the items appear in the tree:
+    QVERIFY(visitor.visited == rootNode->treeChildren());
+
+    // Visits are cancelled when the task is stopped:
+    Task task("Visit Tree",false);
+    task.startTask();
+    task.stopTask();
+    ItemCountVisitor cancelled_visitor;
+    QVERIFY(!rootNode->visitTree(&cancelled_visitor,&task));
+    QVERIFY(cancelled_visitor.item_count < rootNode->treeCount());
+
+    delete rootNode;
+}
+
 void Qtilities::Testing::TestObserver::testTreeCountContainment() {
     // Example tree using tree node classes to simplify test:
     TreeNode* rootNode = new TreeNode("Root");
@@ -56,6 +56,18 @@ namespace Qtilities {
             void testAttachWithObserverLimit();
             //! Tests the subject limit functionality Observer.
             void testSubjectLimit();
+            //! Tests the subject lookup functions: contains(), subjectReference() and subjectID().
+            void testSubjectLookups();
+            //! Tests batch attachment and detachment using attachSubjects() and detachSubjects().
+            void testBatchAttachDetach();
+            //! Tests reading an observer from a worker thread while it is changed, see Observer::setConcurrentReadsEnabled().
+            void testConcurrentReads();
+            //! Tests the handling of changes to reserved and monitored properties in Observer::eventFilter().
+            void testPropertyChangeDispatch();
+            //! Tests the coalescing of change notifications, see Observer::setDeferredNotificationsEnabled().
+            void testDeferredNotifications();
+            //! Tests that parentCount() and parentReferences() follow attachments, detachments and deletions.
+            void testParentReferences();
 
             // -----------------------------
             // Ownership related tests
@@ -82,6 +94,10 @@ namespace Qtilities {
             void testTreeContains();
             //! A test which tests treeChildren() function.
             void testTreeChildren();
+            //! A test which tests that the tree functions follow changes to the tree, see Observer::treeGeneration().
+            void testTreeCache();
+            //! A test which tests visiting a tree in parallel using visitTree().
+            void testVisitTree();
             //! A test which tests treeCount() function where the tree was constructed using the containment approach.
             void testTreeCountContainment();
             //! A test which tests treeAt() function where the tree was constructed using the containment approach.
@@ -15,6 +15,7 @@
 using namespace QtilitiesCoreGui;
 
 #include <TreeIterator>
+#include <TreeTraversal>
 
 int Qtilities::Testing::TestTreeIterator::execTest(int argc, char ** argv) {
     return QTest::qExec(this,argc,argv);
@@ -371,3 +372,97 @@ void Testing::TestTreeIterator::testIterationForwardMultipleParentsC() {
 //    }
 }
 
+
+void Qtilities::Testing::TestTreeIterator::testTraversalOrders() {
+    TreeNode* rootNode = new TreeNode("1");
+    TreeNode* nodeA = rootNode->addNode("2");
+    nodeA->addItem("3");
+    nodeA->addItem("4");
+    TreeNode* nodeB = rootNode->addNode("5");
+    nodeB->addItem("6");
+    nodeB->addItem("7");
+
+    QStringList expected_pre_order;
+    expected_pre_order << "1" << "2" << "3" << "4" << "5" << "6" << "7";
+    QStringList expected_post_order;
+    expected_post_order << "3" << "4" << "2" << "6" << "7" << "5" << "1";
+    QStringList expected_breadth_first;
+    expected_breadth_first << "1" << "2" << "5" << "3" << "4" << "6" << "7";
+
+    QList<TreeTraversal::TraversalOrder> orders;
+    orders << TreeTraversal::PreOrder << TreeTraversal::PostOrder << TreeTraversal::BreadthFirst;
+    QList<QStringList> expected_lists;
+    expected_lists << expected_pre_order << expected_post_order << expected_breadth_first;
+
+    for (int i = 0; i < orders.count(); ++i) {
+        const QStringList& expected = expected_lists.at(i);
+        TreeTraversal traversal(rootNode,orders.at(i));
+
+        // Forward:
+        QStringList forward_list;
+        QObject* obj = traversal.current();
+        while (obj) {
+            forward_list << obj->objectName();
+            obj = traversal.next();
+        }
+        QCOMPARE(forward_list, expected);
+        QVERIFY(!traversal.hasNext());
+        QCOMPARE(traversal.current()->objectName(), expected.last());
+
+        // Reverse:
+        QStringList reverse_list;
+        obj = traversal.last();
+        while (obj) {
+            reverse_list.prepend(obj->objectName());
+            obj = traversal.previous();
+        }
+        QCOMPARE(reverse_list, expected);
+        QVERIFY(!traversal.hasPrevious());
+        QCOMPARE(traversal.current()->objectName(), expected.first());
+
+        // Collecting the tree without the top node:
+        QStringList collected_list;
+        QList<QObject*> collected = TreeTraversal::collect(rootNode,orders.at(i));
+        for (int c = 0; c < collected.count(); ++c)
+            collected_list << collected.at(c)->objectName();
+        QStringList expected_without_top = expected;
+        expected_without_top.removeAll("1");
+        QCOMPARE(collected_list, expected_without_top);
+    }
+
+    // The path to the current item is known:
+    TreeTraversal traversal(rootNode);
+    QVERIFY(traversal.setCurrent(nodeB->subjectAt(0)));
+    QVERIFY(traversal.currentParent() == nodeB);
+    QCOMPARE(traversal.depth(), 2);
+
+    delete rootNode;
+}
+
+void Qtilities::Testing::TestTreeIterator::testIterationLeavesItemsUnchanged() {
+    TreeNode* rootNode = new TreeNode("Root");
+    TreeNode* parentNode1 = rootNode->addNode("Parent 1");
+    TreeNode* parentNode2 = rootNode->addNode("Parent 2");
+    parentNode1->addItem("Child 1");
+    TreeItem* shared_item = parentNode2->addItem("Shared");
+    parentNode1->attachSubject(shared_item);
+
+    TreeIterator itr(rootNode);
+    int count = 0;
+    while (itr.hasNext()) {
+        itr.next();
+        ++count;
+    }
+    QCOMPARE(count, 5);
+    while (itr.hasPrevious())
+        itr.previous();
+    QVERIFY(itr.current() == rootNode);
+    QCOMPARE(rootNode->treeChildren().count(), 5);
+
+    // Nothing may be stored on the items in the tree:
+    QList<QObject*> items = rootNode->treeChildren();
+    for (int i = 0; i < items.count(); ++i)
+        QVERIFY(!items.at(i)->property(qti_prop_TREE_ITERATOR_SOURCE_OBS).isValid());
+
+    delete rootNode;
+}
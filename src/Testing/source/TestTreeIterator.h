@@ -60,6 +60,10 @@ namespace Qtilities {
             void testIterationBackwardComplexA();
             //! Tests forward interation through a tree with items that appear in more than once tree.
             void testIterationForwardMultipleParentsC();
+            //! Tests the pre-order, post-order and breadth first orders of TreeTraversal in both directions.
+            void testTraversalOrders();
+            //! Tests that iterating through a tree does not set properties on the items in the tree.
+            void testIterationLeavesItemsUnchanged();
         };
     }
 }
@@ -56,6 +56,27 @@ int main(int argc, char *argv[])
     Log->setIsQtMessageHandler(false);
     Log->toggleQtMsgEngine(false);
     Log->toggleConsoleEngine(false);
+
+    #ifdef QTILITIES_TESTING
+    // ---------------------------------------------
+    // Run the logging benchmarks without showing the testing frontend when requested:
+    // QtilitiesTester -benchmark-logging <results file> [QTest arguments]
+    // ---------------------------------------------
+    for (int i = 1; i < argc - 1; ++i) {
+        if (qstrcmp(argv[i],"-benchmark-logging") == 0) {
+            BenchmarkLogging benchmarkLogging;
+            benchmarkLogging.setResultsFile(QString::fromLocal8Bit(argv[i+1]));
+
+            QVector<char*> test_argv;
+            for (int a = 0; a < argc; ++a) {
+                if (a != i && a != i + 1)
+                    test_argv << argv[a];
+            }
+            return benchmarkLogging.execTest(test_argv.count(),test_argv.data());
+        }
+    }
+    #endif
+
     TestFrontend testFrontend(argc,argv);
 
     // ---------------------------------------------
@@ -104,6 +125,9 @@ int main(int argc, char *argv[])
     TestTask* testTask = new TestTask;
     testFrontend.addTest(testTask,QtilitiesCategory("Qtilities::Core","::"));
 
+    TestLogging* testLogging = new TestLogging;
+    testFrontend.addTest(testLogging,QtilitiesCategory("Qtilities::Logging","::"));
+
     TestFileSetInfo* testFileSetInfo = new TestFileSetInfo;
     testFrontend.addTest(testFileSetInfo,QtilitiesCategory("Qtilities::Core","::"));
     #endif